@@ -197,6 +197,31 @@ typedef struct vccrypt_block_options
         void* options, void* context, const void* iv, const void* input,
         void* output);
 
+    /**
+     * \brief Decrypt a run of blocks of data using the block cipher.
+     *
+     * This is optional.  If it is NULL, vccrypt_block_decrypt_blocks()
+     * decrypts one block at a time.
+     *
+     * \param options       Opaque pointer to this options structure.
+     * \param context       An opaque pointer to the vccrypt_block_context_t
+     *                      structure.
+     * \param iv            The initialization vector to use for the first
+     *                      block.  Must be the block size in length.
+     * \param input         A pointer to the ciphertext input to decrypt.
+     *                      Must be blocks times the block size in length.
+     * \param output        The output buffer where data is written.  Must be
+     *                      at least blocks times the block size in length.
+     *                      It may be the same as input, but must not
+     *                      otherwise overlap it.
+     * \param blocks        The number of blocks to decrypt.
+     *
+     * \returns VCCRYPT_STATUS_SUCCESS on success and non-zero on failure.
+     */
+    int (*vccrypt_block_alg_decrypt_blocks)(
+        void* options, void* context, const void* iv, const void* input,
+        void* output, size_t blocks);
+
     /**
      * \brief Algorithm-specific data for a block cipher.
      */
@@ -325,6 +350,33 @@ int VCCRYPT_DECL_MUST_CHECK vccrypt_block_decrypt(
     vccrypt_block_context_t* context, const void* iv, const void* input,
     void* output);
 
+/**
+ * \brief Decrypt a run of blocks of data using the block cipher.
+ *
+ * This is the same as calling vccrypt_block_decrypt() for each block, with
+ * the previous block of ciphertext as the IV of the next block.  Because the
+ * blocks can be decrypted independently, the block cipher can work on several
+ * of them at once.
+ *
+ * \param context       The block cipher context to use.
+ * \param iv            The initialization vector to use for the first block.
+ *                      Must be the block size in length.
+ * \param input         A pointer to the ciphertext input to decrypt.  Must be
+ *                      blocks times the block size in length.
+ * \param output        The output buffer where data is written.  Must be at
+ *                      least blocks times the block size in length.  It may
+ *                      be the same as input, but must not otherwise overlap
+ *                      it.
+ * \param blocks        The number of blocks to decrypt.
+ *
+ * \returns a status indicating success or failure.
+ *      - \ref VCCRYPT_STATUS_SUCCESS on success.
+ *      - a non-zero return code on failure.
+ */
+int VCCRYPT_DECL_MUST_CHECK vccrypt_block_decrypt_blocks(
+    vccrypt_block_context_t* context, const void* iv, const void* input,
+    void* output, size_t blocks);
+
 /* make this header C++ friendly. */
 #ifdef __cplusplus
 }
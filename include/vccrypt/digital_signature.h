@@ -59,6 +59,17 @@ extern "C" {
  * \brief Public key size for ed25519.
  */
 #define VCCRYPT_DIGITAL_SIGNATURE_ED25519_PUBLIC_KEY_SIZE 32
+
+/**
+ * \brief Expanded private key size for ed25519.
+ */
+#define VCCRYPT_DIGITAL_SIGNATURE_ED25519_EXPANDED_PRIVATE_KEY_SIZE 96
+
+/**
+ * \brief Prepared public key size for ed25519.
+ */
+#define VCCRYPT_DIGITAL_SIGNATURE_ED25519_PREPARED_PUBLIC_KEY_SIZE 1056
+
 /**
  * @}
  */
@@ -147,6 +158,22 @@ typedef struct vccrypt_digital_signature_options
      */
     size_t public_key_size;
 
+    /**
+     * \brief The expanded private key size in bytes.
+     *
+     * This is the same as private_key_size for algorithms without an
+     * expanded form of the private key.
+     */
+    size_t expanded_private_key_size;
+
+    /**
+     * \brief The prepared public key size in bytes.
+     *
+     * This is the same as public_key_size for algorithms without a prepared
+     * form of the public key.
+     */
+    size_t prepared_public_key_size;
+
     /**
      * \brief Algorithm-specific initialization for digital signatures.
      *
@@ -221,6 +248,116 @@ typedef struct vccrypt_digital_signature_options
     int (*vccrypt_digital_signature_alg_keypair_create)(
         void* context, vccrypt_buffer_t* priv, vccrypt_buffer_t* pub);
 
+    /**
+     * \brief Optional algorithm-specific batch verification.
+     *
+     * Algorithms that can check many signatures together faster than one at
+     * a time set this.  When it is NULL,
+     * vccrypt_digital_signature_batch_verify() checks each signature in turn.
+     * The arguments have already been checked, and the results bitmap has
+     * been cleared.
+     *
+     * \param context       An opaque pointer to the
+     *                      vccrypt_digital_signature_context_t structure.
+     * \param signatures    Array of signatures.
+     * \param pubs          Array of public keys.
+     * \param messages      Array of pointers to the messages.
+     * \param sizes         Array of message sizes, in bytes.
+     * \param count         The number of signatures.
+     * \param results       Bitmap receiving a set bit for each valid
+     *                      signature.
+     *
+     * \returns VCCRYPT_STATUS_SUCCESS on success and non-zero on failure.
+     */
+    int (*vccrypt_digital_signature_alg_batch_verify)(
+        void* context, const vccrypt_buffer_t* signatures,
+        const vccrypt_buffer_t* pubs, const uint8_t* const* messages,
+        const size_t* sizes, size_t count, uint8_t* results);
+
+    /**
+     * \brief Optional algorithm-specific private key expansion.
+     *
+     * Algorithms that derive signing values from the private key set this,
+     * along with vccrypt_digital_signature_alg_sign_expanded.  When it is
+     * NULL, the expanded key is a copy of the private key.  The arguments have
+     * already been checked.
+     *
+     * \param context       An opaque pointer to the
+     *                      vccrypt_digital_signature_context_t structure.
+     * \param expanded      The buffer to receive the expanded private key.
+     * \param priv          The private key to expand.
+     *
+     * \returns VCCRYPT_STATUS_SUCCESS on success and non-zero on failure.
+     */
+    int (*vccrypt_digital_signature_alg_expand_private_key)(
+        void* context, vccrypt_buffer_t* expanded,
+        const vccrypt_buffer_t* priv);
+
+    /**
+     * \brief Optional algorithm-specific signing with an expanded private
+     * key.
+     *
+     * When it is NULL, the expanded key is the private key, and
+     * vccrypt_digital_signature_alg_sign is used.  The arguments have already
+     * been checked.
+     *
+     * \param context       An opaque pointer to the
+     *                      vccrypt_digital_signature_context_t structure.
+     * \param sign_buffer   The buffer to receive the signature.
+     * \param expanded      The expanded private key to use for the signature.
+     * \param message       The input message.
+     * \param size          The size of the message in bytes.
+     *
+     * \returns VCCRYPT_STATUS_SUCCESS on success and non-zero on failure.
+     */
+    int (*vccrypt_digital_signature_alg_sign_expanded)(
+        void* context, vccrypt_buffer_t* sign_buffer,
+        const vccrypt_buffer_t* expanded, const uint8_t* message,
+        size_t size);
+
+    /**
+     * \brief Optional algorithm-specific public key preparation.
+     *
+     * Algorithms that can precompute values from the public key for
+     * verification set this, along with
+     * vccrypt_digital_signature_alg_verify_prepared.  When it is NULL, the
+     * prepared key is a copy of the public key.  The arguments have already
+     * been checked.
+     *
+     * \param context       An opaque pointer to the
+     *                      vccrypt_digital_signature_context_t structure.
+     * \param prepared      The buffer to receive the prepared public key.
+     * \param pub           The public key to prepare.
+     *
+     * \returns VCCRYPT_STATUS_SUCCESS on success and non-zero on failure.
+     */
+    int (*vccrypt_digital_signature_alg_prepare_public_key)(
+        void* context, vccrypt_buffer_t* prepared,
+        const vccrypt_buffer_t* pub);
+
+    /**
+     * \brief Optional algorithm-specific verification with a prepared public
+     * key.
+     *
+     * When it is NULL, the prepared key is the public key, and
+     * vccrypt_digital_signature_alg_verify is used.  The arguments have
+     * already been checked.
+     *
+     * \param context       An opaque pointer to the
+     *                      vccrypt_digital_signature_context_t structure.
+     * \param signature     The signature to verify.
+     * \param prepared      The prepared public key.
+     * \param message       The input message.
+     * \param size          The size of the message in bytes.
+     *
+     * \returns VCCRYPT_STATUS_SUCCESS if the message signature is valid, and
+     * non-zero otherwise.
+     */
+    int (*vccrypt_digital_signature_alg_verify_prepared)(
+        void* context, const vccrypt_buffer_t* signature,
+        const vccrypt_buffer_t* prepared, const uint8_t* message,
+        size_t size);
+
 } vccrypt_digital_signature_options_t;
 
 /**
@@ -251,6 +388,36 @@ typedef struct vccrypt_digital_signature_context
 
 } vccrypt_digital_signature_context_t;
 
+/**
+ * \brief A bounded cache of prepared public keys, keyed by the public key.
+ *
+ * When the cache is full, the least recently used key is evicted.  A cache is
+ * not safe to use from several threads at once.
+ */
+typedef struct vccrypt_digital_signature_public_key_cache
+{
+    /**
+     * \brief This cache is disposable.
+     */
+    disposable_t hdr;
+
+    /**
+     * \brief The digital signature instance used to prepare and verify.
+     */
+    vccrypt_digital_signature_context_t* context;
+
+    /**
+     * \brief The maximum number of public keys in the cache.
+     */
+    size_t capacity;
+
+    /**
+     * \brief The opaque state structure holding the cached keys.
+     */
+    void* cache_state;
+
+} vccrypt_digital_signature_public_key_cache_t;
+
 /**
  * \brief Initialize digital signature options, looking up an appropriate
  * digital signature algorithm registered in the abstract factory.
@@ -360,6 +527,213 @@ vccrypt_digital_signature_keypair_create(
     vccrypt_digital_signature_context_t* context, vccrypt_buffer_t* priv,
     vccrypt_buffer_t* pub);
 
+/**
+ * \brief Verify a batch of signatures.
+ *
+ * Item \p i is valid if \p signatures[i] is a valid signature of
+ * \p messages[i] under \p pubs[i].  Algorithms that support it check the
+ * whole batch at once, which is much cheaper per signature than
+ * vccrypt_digital_signature_verify() for large batches.  If the batch as a
+ * whole fails, it is narrowed down to the bad signatures.
+ *
+ * Ed25519 batches check the cofactored verification equation, so that a
+ * signature gets the same result in any batch.  This is the equation that
+ * vccrypt_digital_signature_verify() checks, so a signature gets the same
+ * result from both, even if it is built on points with a small-order
+ * component.
+ *
+ * The result for item \p i is bit (i % 8) of \p results[i / 8], which is set
+ * if the signature is valid and clear otherwise.  A success status only means
+ * that the batch was processed; the caller must check the bitmap.
+ *
+ * \param context       The digital signature instance.  Its PRNG is used to
+ *                      weight the signatures of the batch.
+ * \param signatures    Array of \p count signatures.
+ * \param pubs          Array of \p count public keys.
+ * \param messages      Array of \p count pointers to the messages.  A pointer
+ *                      may only be NULL if its size is 0.
+ * \param sizes         Array of \p count message sizes, in bytes.
+ * \param count         The number of signatures to verify.
+ * \param results       Bitmap of (count + 7) / 8 bytes to receive the result
+ *                      for each signature.
+ *
+ * \returns a status indicating success or failure.
+ *      - \ref VCCRYPT_STATUS_SUCCESS if the batch was processed.
+ *      - \ref VCCRYPT_ERROR_DIGITAL_SIGNATURE_BATCH_VERIFY_INVALID_ARG if an
+ *             invalid argument is provided.
+ *      - \ref VCCRYPT_ERROR_DIGITAL_SIGNATURE_BATCH_VERIFY_OUT_OF_MEMORY if
+ *             the batch could not be allocated.
+ *      - a non-zero return code on error.
+ */
+int VCCRYPT_DECL_MUST_CHECK
+vccrypt_digital_signature_batch_verify(
+    vccrypt_digital_signature_context_t* context,
+    const vccrypt_buffer_t* signatures, const vccrypt_buffer_t* pubs,
+    const uint8_t* const* messages, const size_t* sizes, size_t count,
+    uint8_t* results);
+
+/**
+ * \brief Expand a private key for repeated signing.
+ *
+ * Signing derives some values from the private key each time, which for
+ * ed25519 is a SHA-512 hash of the seed.  The expanded private key holds these
+ * values, so that vccrypt_digital_signature_sign_expanded() does not derive
+ * them again.  For ed25519, it holds the clamped secret scalar, the nonce
+ * prefix, and the public key.
+ *
+ * The expanded key is as secret as the private key.  It should be kept in a
+ * buffer that is disposed when no longer needed, which clears it.
+ *
+ * \param context       The digital signature instance.
+ * \param expanded      The buffer to receive the expanded private key.  Its
+ *                      size must be expanded_private_key_size.
+ * \param priv          The private key to expand.
+ *
+ * \returns a status indicating success or failure.
+ *      - \ref VCCRYPT_STATUS_SUCCESS on success.
+ *      - \ref VCCRYPT_ERROR_DIGITAL_SIGNATURE_EXPAND_PRIVATE_KEY_INVALID_ARG
+ *             if an invalid argument is provided.
+ *      - a non-zero error code indicating failure.
+ */
+int VCCRYPT_DECL_MUST_CHECK
+vccrypt_digital_signature_expand_private_key(
+    vccrypt_digital_signature_context_t* context, vccrypt_buffer_t* expanded,
+    const vccrypt_buffer_t* priv);
+
+/**
+ * \brief Sign a message with an expanded private key.
+ *
+ * The signature is the same as the one vccrypt_digital_signature_sign()
+ * produces with the private key that was expanded.
+ *
+ * \param context       The digital signature instance.
+ * \param sign_buffer   The buffer to receive the signature.  Must be large
+ *                      enough for the given digital signature algorithm.
+ * \param expanded      The expanded private key, from
+ *                      vccrypt_digital_signature_expand_private_key().
+ * \param message       The input message.
+ * \param message_size  The size of the message in bytes.
+ *
+ * \returns a status indicating success or failure.
+ *      - \ref VCCRYPT_STATUS_SUCCESS on success.
+ *      - \ref VCCRYPT_ERROR_DIGITAL_SIGNATURE_SIGN_EXPANDED_INVALID_ARG if an
+ *             invalid argument is provided.
+ *      - a non-zero error code indicating failure.
+ */
+int VCCRYPT_DECL_MUST_CHECK
+vccrypt_digital_signature_sign_expanded(
+    vccrypt_digital_signature_context_t* context, vccrypt_buffer_t* sign_buffer,
+    const vccrypt_buffer_t* expanded, const uint8_t* message,
+    size_t message_size);
+
+/**
+ * \brief Prepare a public key for repeated verification.
+ *
+ * Verification derives some values from the public key each time.  For
+ * ed25519, it decompresses the public key point and computes its odd
+ * multiples for the sliding window, which is a good part of the cost of
+ * verifying a short message.  The prepared public key holds these values, so
+ * that vccrypt_digital_signature_verify_prepared() does not derive them again.
+ *
+ * \param context       The digital signature instance.
+ * \param prepared      The buffer to receive the prepared public key.  Its
+ *                      size must be prepared_public_key_size.
+ * \param pub           The public key to prepare.
+ *
+ * \returns a status indicating success or failure.
+ *      - \ref VCCRYPT_STATUS_SUCCESS on success.
+ *      - \ref VCCRYPT_ERROR_DIGITAL_SIGNATURE_PREPARE_PUBLIC_KEY_INVALID_ARG
+ *             if an invalid argument is provided.
+ *      - a non-zero error code indicating failure, such as a public key that
+ *        the algorithm rejects.
+ */
+int VCCRYPT_DECL_MUST_CHECK
+vccrypt_digital_signature_prepare_public_key(
+    vccrypt_digital_signature_context_t* context, vccrypt_buffer_t* prepared,
+    const vccrypt_buffer_t* pub);
+
+/**
+ * \brief Verify a message with a prepared public key.
+ *
+ * The result is the same as vccrypt_digital_signature_verify() gives with the
+ * public key that was prepared.
+ *
+ * The prepared public key is trusted as it is.  Checking it against the
+ * public key would cost as much as preparing it again, so it is not checked.
+ * A prepared public key that has been altered can make a forged signature
+ * verify.  Keep prepared public keys in process memory, and never load one
+ * from storage or a peer that is not trusted.  Store the public key instead,
+ * and prepare it again after loading it.
+ *
+ * \param context       The digital signature instance.
+ * \param signature     The signature to verify.
+ * \param prepared      The prepared public key, from
+ *                      vccrypt_digital_signature_prepare_public_key().
+ * \param message       The input message.
+ * \param message_size  The size of the message in bytes.
+ *
+ * \returns a status indicating success or failure.
+ *      - \ref VCCRYPT_STATUS_SUCCESS if the signature is valid.
+ *      - \ref VCCRYPT_ERROR_DIGITAL_SIGNATURE_VERIFY_PREPARED_INVALID_ARG if
+ *             an invalid argument is provided.
+ *      - a non-zero error code indicating failure.
+ */
+int VCCRYPT_DECL_MUST_CHECK
+vccrypt_digital_signature_verify_prepared(
+    vccrypt_digital_signature_context_t* context,
+    const vccrypt_buffer_t* signature, const vccrypt_buffer_t* prepared,
+    const uint8_t* message, size_t message_size);
+
+/**
+ * \brief Initialize a cache of prepared public keys.
+ *
+ * If initialization is successful, then this cache is owned by the caller and
+ * must be disposed by calling dispose() when no longer needed.  The digital
+ * signature instance must outlive the cache.
+ *
+ * \param cache         The cache to initialize.
+ * \param context       The digital signature instance to use.
+ * \param capacity      The maximum number of public keys to keep.
+ *
+ * \returns a status indicating success or failure.
+ *      - \ref VCCRYPT_STATUS_SUCCESS on success.
+ *      - \ref VCCRYPT_ERROR_DIGITAL_SIGNATURE_PUBLIC_KEY_CACHE_INIT_INVALID_ARG
+ *             if an invalid argument is provided.
+ *      - \ref VCCRYPT_ERROR_DIGITAL_SIGNATURE_PUBLIC_KEY_CACHE_OUT_OF_MEMORY
+ *             if the cache could not be allocated.
+ *      - a non-zero error code indicating failure.
+ */
+int VCCRYPT_DECL_MUST_CHECK
+vccrypt_digital_signature_public_key_cache_init(
+    vccrypt_digital_signature_public_key_cache_t* cache,
+    vccrypt_digital_signature_context_t* context, size_t capacity);
+
+/**
+ * \brief Verify a message, preparing the public key through a cache.
+ *
+ * A public key found in the cache is verified with its prepared form.
+ * Otherwise, the public key is prepared and added to the cache, evicting the
+ * least recently used key if the cache is full.  A public key that can't be
+ * prepared fails verification and is not added.
+ *
+ * \param cache         The public key cache.
+ * \param signature     The signature to verify.
+ * \param pub           The public key to use for signature verification.
+ * \param message       The input message.
+ * \param message_size  The size of the message in bytes.
+ *
+ * \returns a status indicating success or failure.
+ *      - \ref VCCRYPT_STATUS_SUCCESS if the signature is valid.
+ *      - \ref VCCRYPT_ERROR_DIGITAL_SIGNATURE_VERIFY_CACHED_INVALID_ARG if an
+ *             invalid argument is provided.
+ *      - a non-zero error code indicating failure.
+ */
+int VCCRYPT_DECL_MUST_CHECK
+vccrypt_digital_signature_verify_cached(
+    vccrypt_digital_signature_public_key_cache_t* cache,
+    const vccrypt_buffer_t* signature, const vccrypt_buffer_t* pub,
+    const uint8_t* message, size_t message_size);
+
 /* make this header C++ friendly. */
 #ifdef __cplusplus
 }
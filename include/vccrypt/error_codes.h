@@ -276,6 +276,142 @@ extern "C" {
  */
 #define VCCRYPT_ERROR_KEY_DERIVATION_DERIVE_KEY_INVALID_ARG 0x2180
 
+/**
+ * \brief An invalid argument was provided to vccrypt_hash_batch_digest().
+ */
+#define VCCRYPT_ERROR_HASH_BATCH_DIGEST_INVALID_ARG 0x2184
+
+/**
+ * \brief An invalid argument was provided to vccrypt_hash_clone().
+ */
+#define VCCRYPT_ERROR_HASH_CLONE_INVALID_ARG 0x2188
+
+/**
+ * \brief An invalid argument was provided to vccrypt_hash_oneshot().
+ */
+#define VCCRYPT_ERROR_HASH_ONESHOT_INVALID_ARG 0x218C
+
+/**
+ * \brief An invalid argument was provided to vccrypt_hash_digest_fd().
+ */
+#define VCCRYPT_ERROR_HASH_DIGEST_FD_INVALID_ARG 0x2190
+
+/**
+ * \brief vccrypt_hash_digest_fd() could not allocate its read buffers.
+ */
+#define VCCRYPT_ERROR_HASH_DIGEST_FD_OUT_OF_MEMORY 0x2194
+
+/**
+ * \brief vccrypt_hash_digest_fd() failed to read from the file descriptor.
+ */
+#define VCCRYPT_ERROR_HASH_DIGEST_FD_READ_FAILURE 0x2198
+
+/**
+ * \brief An invalid argument was provided to vccrypt_hash_digest_file().
+ */
+#define VCCRYPT_ERROR_HASH_DIGEST_FILE_INVALID_ARG 0x219C
+
+/**
+ * \brief vccrypt_hash_digest_file() could not open the file.
+ */
+#define VCCRYPT_ERROR_HASH_DIGEST_FILE_OPEN_FAILURE 0x21A0
+
+/**
+ * \brief An invalid argument was provided to vccrypt_mac_reset().
+ */
+#define VCCRYPT_ERROR_MAC_RESET_INVALID_ARG 0x21A4
+
+/**
+ * \brief An invalid argument was provided to vccrypt_mac_batch_verify().
+ */
+#define VCCRYPT_ERROR_MAC_BATCH_VERIFY_INVALID_ARG 0x21A8
+
+/**
+ * \brief An attempt was made to call vccrypt_key_derivation_extract() with an
+ * invalid argument.
+ */
+#define VCCRYPT_ERROR_KEY_DERIVATION_EXTRACT_INVALID_ARG 0x21AC
+
+/**
+ * \brief An attempt was made to call vccrypt_key_derivation_expand() with an
+ * invalid argument.
+ */
+#define VCCRYPT_ERROR_KEY_DERIVATION_EXPAND_INVALID_ARG 0x21B0
+
+/**
+ * \brief An invalid argument was passed to hkdf_extract() or hkdf_expand().
+ */
+#define VCCRYPT_ERROR_HKDF_INVALID_ARG 0x21B4
+
+/**
+ * \brief An attempt was made to call vccrypt_key_derivation_derive_key_batch()
+ * with an invalid argument.
+ */
+#define VCCRYPT_ERROR_KEY_DERIVATION_DERIVE_KEY_BATCH_INVALID_ARG 0x21B8
+
+/**
+ * \brief An invalid argument was provided to vccrypt_mac_verify().
+ */
+#define VCCRYPT_ERROR_MAC_VERIFY_INVALID_ARG 0x21BC
+
+/**
+ * \brief The message authentication code checked by vccrypt_mac_verify() does
+ * not match.
+ */
+#define VCCRYPT_ERROR_MAC_VERIFY_MISMATCH 0x21C0
+
+/**
+ * \brief An attempt was made to call
+ * vccrypt_digital_signature_batch_verify() with an invalid argument.
+ */
+#define VCCRYPT_ERROR_DIGITAL_SIGNATURE_BATCH_VERIFY_INVALID_ARG 0x21C4
+
+/**
+ * \brief Out of memory when verifying a batch of digital signatures.
+ */
+#define VCCRYPT_ERROR_DIGITAL_SIGNATURE_BATCH_VERIFY_OUT_OF_MEMORY 0x21C8
+
+/**
+ * \brief An attempt was made to call
+ * vccrypt_digital_signature_expand_private_key() with an invalid argument.
+ */
+#define VCCRYPT_ERROR_DIGITAL_SIGNATURE_EXPAND_PRIVATE_KEY_INVALID_ARG 0x21CC
+
+/**
+ * \brief An attempt was made to call
+ * vccrypt_digital_signature_sign_expanded() with an invalid argument.
+ */
+#define VCCRYPT_ERROR_DIGITAL_SIGNATURE_SIGN_EXPANDED_INVALID_ARG 0x21D0
+
+/**
+ * \brief An attempt was made to call
+ * vccrypt_digital_signature_prepare_public_key() with an invalid argument.
+ */
+#define VCCRYPT_ERROR_DIGITAL_SIGNATURE_PREPARE_PUBLIC_KEY_INVALID_ARG 0x21D4
+
+/**
+ * \brief An attempt was made to call
+ * vccrypt_digital_signature_verify_prepared() with an invalid argument.
+ */
+#define VCCRYPT_ERROR_DIGITAL_SIGNATURE_VERIFY_PREPARED_INVALID_ARG 0x21D8
+
+/**
+ * \brief An attempt was made to call
+ * vccrypt_digital_signature_public_key_cache_init() with an invalid argument.
+ */
+#define VCCRYPT_ERROR_DIGITAL_SIGNATURE_PUBLIC_KEY_CACHE_INIT_INVALID_ARG 0x21DC
+
+/**
+ * \brief Out of memory when creating a public key cache.
+ */
+#define VCCRYPT_ERROR_DIGITAL_SIGNATURE_PUBLIC_KEY_CACHE_OUT_OF_MEMORY 0x21E0
+
+/**
+ * \brief An attempt was made to call
+ * vccrypt_digital_signature_verify_cached() with an invalid argument.
+ */
+#define VCCRYPT_ERROR_DIGITAL_SIGNATURE_VERIFY_CACHED_INVALID_ARG 0x21E4
+
 /**
  * @}
  */
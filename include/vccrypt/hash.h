@@ -23,6 +23,7 @@ extern "C" {
 #include <vccrypt/buffer.h>
 #include <vccrypt/function_decl.h>
 #include <vccrypt/interfaces.h>
+#include <vccrypt/os.h>
 #include <vpr/allocator.h>
 #include <vpr/disposable.h>
 
@@ -34,6 +35,26 @@ extern "C" {
  * @{
  */
 
+/**
+ * \brief Digest size for SHA-2 256.
+ */
+#define VCCRYPT_HASH_SHA_256_DIGEST_SIZE 32
+
+/**
+ * \brief Block size for SHA-2 256.
+ */
+#define VCCRYPT_HASH_SHA_256_BLOCK_SIZE 64
+
+/**
+ * \brief Digest size for SHA-2 512/224.
+ */
+#define VCCRYPT_HASH_SHA_512_224_DIGEST_SIZE 28
+
+/**
+ * \brief Block size for SHA-2 512/224.
+ */
+#define VCCRYPT_HASH_SHA_512_224_BLOCK_SIZE 128
+
 /**
  * \brief Digest size for SHA-2 512/256.
  */
@@ -63,6 +84,11 @@ extern "C" {
  * \brief Block size for SHA-2 512.
  */
 #define VCCRYPT_HASH_SHA_512_BLOCK_SIZE 128
+
+/**
+ * \brief Size of the inline hash state storage in \ref vccrypt_hash_context_t.
+ */
+#define VCCRYPT_HASH_CONTEXT_INLINE_STATE_SIZE 256
 /**
  * @}
  */
@@ -221,6 +247,57 @@ typedef struct vccrypt_hash_options
     int (*vccrypt_hash_alg_finalize)(
         void* context, vccrypt_buffer_t* hash_buffer);
 
+    /**
+     * \brief Optional algorithm-specific batch hash.
+     *
+     * Algorithms that can hash several independent messages in lockstep set
+     * this.  When it is NULL, vccrypt_hash_batch_digest() hashes each message
+     * in turn.
+     *
+     * \param options       Opaque pointer to this options structure.
+     * \param data          Array of pointers to the messages to hash.
+     * \param sizes         Array of message sizes, in bytes.
+     * \param hash_buffers  Array of buffers to receive each hash.
+     * \param count         The number of messages.
+     *
+     * \returns \ref VCCRYPT_STATUS_SUCCESS on success and non-zero on failure.
+     */
+    int (*vccrypt_hash_alg_batch_digest)(
+        void* options, const uint8_t* const* data, const size_t* sizes,
+        vccrypt_buffer_t* hash_buffers, size_t count);
+
+    /**
+     * \brief Copy the hash state of one hash instance into another.
+     *
+     * \param options       Opaque pointer to this options structure.
+     * \param dest          Opaque pointer to the vccrypt_hash_context_t
+     *                      structure receiving the copy.  Only its options
+     *                      field has been set.
+     * \param src           Opaque pointer to the vccrypt_hash_context_t
+     *                      structure to copy.
+     *
+     * \returns \ref VCCRYPT_STATUS_SUCCESS on success and non-zero on failure.
+     */
+    int (*vccrypt_hash_alg_clone)(
+        void* options, void* dest, const void* src);
+
+    /**
+     * \brief Optional algorithm-specific one-shot hash.
+     *
+     * Algorithms set this to hash a single message without setting up a hash
+     * instance.  When it is NULL, vccrypt_hash_oneshot() uses a hash instance.
+     *
+     * \param options       Opaque pointer to this options structure.
+     * \param data          The message to hash.
+     * \param size          The size of the message, in bytes.
+     * \param md            The memory to receive the hash.  It is at least
+     *                      hash_size bytes long.
+     *
+     * \returns \ref VCCRYPT_STATUS_SUCCESS on success and non-zero on failure.
+     */
+    int (*vccrypt_hash_alg_oneshot)(
+        void* options, const uint8_t* data, size_t size, uint8_t* md);
+
 } vccrypt_hash_options_t;
 
 /**
@@ -244,6 +321,16 @@ typedef struct vccrypt_hash_context
      */
     void* hash_state;
 
+    /**
+     * \brief Inline storage for the hash state.
+     *
+     * Algorithms whose state fits here point hash_state at this storage, so
+     * that init and dispose never need the allocator.  Since hash_state can
+     * point into the context itself, a context must not be copied by value.
+     */
+    uint64_t hash_state_inline[
+        VCCRYPT_HASH_CONTEXT_INLINE_STATE_SIZE / sizeof(uint64_t)];
+
 } vccrypt_hash_context_t;
 
 /**
@@ -325,6 +412,123 @@ int VCCRYPT_DECL_MUST_CHECK
 vccrypt_hash_finalize(
     vccrypt_hash_context_t* context, vccrypt_buffer_t* hash_buffer);
 
+/**
+ * \brief Clone a hash instance, including any data digested so far.
+ *
+ * This allows data shared by several messages, such as a common header, to be
+ * digested once.  The clone and the original can then be continued and
+ * finalized independently.
+ *
+ * If cloning is successful, then the clone is owned by the caller and must be
+ * disposed by calling dispose() when no longer needed.
+ *
+ * \param dest          The hash instance to initialize as a clone.
+ * \param src           The hash instance to clone.
+ *
+ * \returns a status code indicating success or failure.
+ *      - \ref VCCRYPT_STATUS_SUCCESS on success.
+ *      - \ref VCCRYPT_ERROR_HASH_CLONE_INVALID_ARG if an invalid argument is
+ *             provided.
+ *      - a non-zero error code on failure.
+ */
+int VCCRYPT_DECL_MUST_CHECK
+vccrypt_hash_clone(
+    vccrypt_hash_context_t* dest, const vccrypt_hash_context_t* src);
+
+/**
+ * \brief Hash a single message, writing the hash to caller-owned memory.
+ *
+ * This is equivalent to vccrypt_hash_init(), vccrypt_hash_digest(), and
+ * vccrypt_hash_finalize() followed by dispose(), but it needs neither a hash
+ * instance nor an output buffer, which makes hashing short messages cheaper.
+ *
+ * \param options       The options for the hash algorithm to use.
+ * \param data          The message to hash.  May only be NULL if \p size is
+ *                      0.
+ * \param size          The size of the message, in bytes.
+ * \param md            The memory to receive the hash.
+ * \param md_size       The size of \p md, in bytes.  Must be at least the
+ *                      hash size of the given hash algorithm.
+ *
+ * \returns a status code indicating success or failure.
+ *      - \ref VCCRYPT_STATUS_SUCCESS on success.
+ *      - \ref VCCRYPT_ERROR_HASH_ONESHOT_INVALID_ARG if an invalid argument is
+ *             provided.
+ *      - a non-zero error code on failure.
+ */
+int VCCRYPT_DECL_MUST_CHECK
+vccrypt_hash_oneshot(
+    vccrypt_hash_options_t* options, const uint8_t* data, size_t size,
+    uint8_t* md, size_t md_size);
+
+#if defined(VCCRYPT_OS_UNIX)
+/**
+ * \brief Digest the remaining contents of a file descriptor.
+ *
+ * Data is read from the current file offset until end of file.  Large files
+ * are read ahead on a helper thread, so that reading overlaps with hashing.
+ *
+ * \param context       The hash instance.
+ * \param fd            The file descriptor to read.
+ *
+ * \returns a status code indicating success or failure.
+ *      - \ref VCCRYPT_STATUS_SUCCESS on success.
+ *      - \ref VCCRYPT_ERROR_HASH_DIGEST_FD_INVALID_ARG if an invalid argument
+ *             is provided.
+ *      - \ref VCCRYPT_ERROR_HASH_DIGEST_FD_OUT_OF_MEMORY if the read buffers
+ *             could not be allocated.
+ *      - \ref VCCRYPT_ERROR_HASH_DIGEST_FD_READ_FAILURE if reading from the
+ *             file descriptor failed.
+ *      - a non-zero error code on failure.
+ */
+int VCCRYPT_DECL_MUST_CHECK
+vccrypt_hash_digest_fd(vccrypt_hash_context_t* context, int fd);
+
+/**
+ * \brief Digest the contents of the file at the given path.
+ *
+ * \param context       The hash instance.
+ * \param path          The path of the file to digest.
+ *
+ * \returns a status code indicating success or failure.
+ *      - \ref VCCRYPT_STATUS_SUCCESS on success.
+ *      - \ref VCCRYPT_ERROR_HASH_DIGEST_FILE_INVALID_ARG if an invalid
+ *             argument is provided.
+ *      - \ref VCCRYPT_ERROR_HASH_DIGEST_FILE_OPEN_FAILURE if the file could
+ *             not be opened.
+ *      - a non-zero error code on failure.
+ */
+int VCCRYPT_DECL_MUST_CHECK
+vccrypt_hash_digest_file(vccrypt_hash_context_t* context, const char* path);
+#endif /*defined(VCCRYPT_OS_UNIX)*/
+
+/**
+ * \brief Hash a batch of independent messages.
+ *
+ * Each message is hashed on its own, exactly as if by vccrypt_hash_init(),
+ * vccrypt_hash_digest(), and vccrypt_hash_finalize().  Algorithms that support
+ * it hash several messages in lockstep, which is much faster than hashing
+ * many short messages one at a time.
+ *
+ * \param options       The options for the hash algorithm to use.
+ * \param data          Array of \p count pointers to the messages to hash.  A
+ *                      pointer may only be NULL if its size is 0.
+ * \param sizes         Array of \p count message sizes, in bytes.
+ * \param hash_buffers  Array of \p count buffers to receive each hash.  Each
+ *                      must be large enough for the given hash algorithm.
+ * \param count         The number of messages to hash.
+ *
+ * \returns a status code indicating success or failure.
+ *      - \ref VCCRYPT_STATUS_SUCCESS on success.
+ *      - \ref VCCRYPT_ERROR_HASH_BATCH_DIGEST_INVALID_ARG if an invalid
+ *             argument is provided.
+ *      - a non-zero error code on failure.
+ */
+int VCCRYPT_DECL_MUST_CHECK
+vccrypt_hash_batch_digest(
+    vccrypt_hash_options_t* options, const uint8_t* const* data,
+    const size_t* sizes, vccrypt_buffer_t* hash_buffers, size_t count);
+
 /* make this header C++ friendly. */
 #ifdef __cplusplus
 }
@@ -29,6 +29,11 @@ extern "C" {
  */
 #define VCCRYPT_KEY_DERIVATION_ALGORITHM_PBKDF2 0x00010000
 
+/**
+ * \brief Selector for HKDF (RFC 5869)
+ */
+#define VCCRYPT_KEY_DERIVATION_ALGORITHM_HKDF 0x00020000
+
 
 /**
  * \defgroup KeyDerivationRegistration Registration functions for Key
@@ -48,6 +53,12 @@ extern "C" {
  */
 void vccrypt_key_derivation_register_pbkdf2();
 
+/**
+ * \brief Register the HKDF key derivation algorithm.
+ *
+ */
+void vccrypt_key_derivation_register_hkdf();
+
 
 /* forward decls */
 typedef struct vccrypt_key_derivation_options vccrypt_key_derivation_options_t;
@@ -126,6 +137,61 @@ struct vccrypt_key_derivation_options
         vccrypt_key_derivation_context_t* context,
         const vccrypt_buffer_t* pass, const vccrypt_buffer_t* salt,
         unsigned int rounds);
+
+    /**
+     * \brief Optional extract step of an extract-and-expand KDF.
+     *
+     * \param prk               A crypto buffer of hmac_digest_length bytes to
+     *                          receive the pseudorandom key.
+     * \param context           Pointer to the
+     *                          vccrypt_key_derivation_context_t structure.
+     * \param ikm               The input keying material.
+     * \param salt              An optional salt value, or NULL.
+     *
+     * \returns \ref VCCRYPT_STATUS_SUCCESS on success and non-zero on error.
+     */
+    int (*vccrypt_key_derivation_alg_extract)(
+        vccrypt_buffer_t* prk, vccrypt_key_derivation_context_t* context,
+        const vccrypt_buffer_t* ikm, const vccrypt_buffer_t* salt);
+
+    /**
+     * \brief Optional expand step of an extract-and-expand KDF.
+     *
+     * \param derived_key       A crypto buffer to receive the derived key.
+     *                          The buffer should be the size of the desired
+     *                          key length.
+     * \param context           Pointer to the
+     *                          vccrypt_key_derivation_context_t structure.
+     * \param prk               The pseudorandom key from the extract step.
+     * \param info              Optional context information, or NULL.
+     *
+     * \returns \ref VCCRYPT_STATUS_SUCCESS on success and non-zero on error.
+     */
+    int (*vccrypt_key_derivation_alg_expand)(
+        vccrypt_buffer_t* derived_key,
+        vccrypt_key_derivation_context_t* context,
+        const vccrypt_buffer_t* prk, const vccrypt_buffer_t* info);
+
+    /**
+     * \brief Optional lockstep implementation of key derivation for a batch
+     * of independent passwords.
+     *
+     * \param derived_keys      Array of count crypto buffers to receive the
+     *                          derived keys.
+     * \param context           Pointer to the
+     *                          vccrypt_key_derivation_context_t structure.
+     * \param passes            Array of count passwords or passphrases.
+     * \param salts             Array of count salt values.
+     * \param count             The number of keys to derive.
+     * \param rounds            The number of rounds to process for each key.
+     *
+     * \returns \ref VCCRYPT_STATUS_SUCCESS on success and non-zero on error.
+     */
+    int (*vccrypt_key_derivation_alg_derive_key_batch)(
+        vccrypt_buffer_t* derived_keys,
+        vccrypt_key_derivation_context_t* context,
+        const vccrypt_buffer_t* passes, const vccrypt_buffer_t* salts,
+        size_t count, unsigned int rounds);
 };
 
 /**
@@ -219,6 +285,96 @@ vccrypt_key_derivation_derive_key(
     const vccrypt_buffer_t* pass, const vccrypt_buffer_t* salt,
     unsigned int rounds);
 
+/**
+ * \brief Derive a cryptographic key for each of a batch of independent
+ * passwords.
+ *
+ * Key \p i is the key that vccrypt_key_derivation_derive_key() derives from
+ * \p passes[i] and \p salts[i], with the size of \p derived_keys[i].  All keys
+ * use the same number of rounds.  Algorithms that support it run the
+ * derivations in lockstep, which is much faster than deriving many keys one at
+ * a time, for instance when re-deriving the keys of many stored credentials.
+ *
+ * \param derived_keys      Array of \p count crypto buffers to receive the
+ *                          derived keys.  Each buffer should be the size of
+ *                          the desired key length.
+ * \param context           The vccrypt_key_derivation_context_t instance to
+ *                          use for these derivations
+ * \param passes            Array of \p count passwords or passphrases.
+ * \param salts             Array of \p count salt values.
+ * \param count             The number of keys to derive.
+ * \param rounds            The number of rounds to process for each key.
+ *
+ * \returns a status indicating success or failure.
+ *      - \ref VCCRYPT_STATUS_SUCCESS on success.
+ *      - \ref VCCRYPT_ERROR_KEY_DERIVATION_DERIVE_KEY_BATCH_INVALID_ARG if one
+ *             of the provided arguments is invalid.
+ *      - a non-zero error code indicating failure.
+ */
+int VCCRYPT_DECL_MUST_CHECK
+vccrypt_key_derivation_derive_key_batch(
+    vccrypt_buffer_t* derived_keys, vccrypt_key_derivation_context_t* context,
+    const vccrypt_buffer_t* passes, const vccrypt_buffer_t* salts,
+    size_t count, unsigned int rounds);
+
+/**
+ * \brief Extract a pseudorandom key from input keying material.
+ *
+ * This is the first step of an extract-and-expand key derivation function
+ * such as HKDF.  The pseudorandom key can then be expanded any number of
+ * times with vccrypt_key_derivation_expand(), for instance to derive several
+ * subkeys from one shared secret.
+ *
+ * \param prk               A crypto buffer to receive the pseudorandom key.
+ *                          Its size must be the hmac_digest_length of the
+ *                          options.
+ * \param context           The vccrypt_key_derivation_context_t instance to
+ *                          use for this derivation
+ * \param ikm               The input keying material, such as a shared
+ *                          secret.
+ * \param salt              An optional salt value, or NULL.
+ *
+ * \returns a status indicating success or failure.
+ *      - \ref VCCRYPT_STATUS_SUCCESS on success.
+ *      - \ref VCCRYPT_ERROR_KEY_DERIVATION_EXTRACT_INVALID_ARG if one of the
+ *             provided arguments is invalid, or if the algorithm does not
+ *             support extract-and-expand.
+ *      - a non-zero error code indicating failure.
+ */
+int VCCRYPT_DECL_MUST_CHECK
+vccrypt_key_derivation_extract(
+    vccrypt_buffer_t* prk, vccrypt_key_derivation_context_t* context,
+    const vccrypt_buffer_t* ikm, const vccrypt_buffer_t* salt);
+
+/**
+ * \brief Expand a pseudorandom key into a derived key.
+ *
+ * This is the second step of an extract-and-expand key derivation function
+ * such as HKDF.  Different info values yield independent keys from the same
+ * pseudorandom key.
+ *
+ * \param derived_key       A crypto buffer to receive the derived key.
+ *                          The buffer should be the size of the desired
+ *                          key length.
+ * \param context           The vccrypt_key_derivation_context_t instance to
+ *                          use for this derivation
+ * \param prk               The pseudorandom key, typically from
+ *                          vccrypt_key_derivation_extract().
+ * \param info              Optional context and application specific
+ *                          information, or NULL.
+ *
+ * \returns a status indicating success or failure.
+ *      - \ref VCCRYPT_STATUS_SUCCESS on success.
+ *      - \ref VCCRYPT_ERROR_KEY_DERIVATION_EXPAND_INVALID_ARG if one of the
+ *             provided arguments is invalid, or if the algorithm does not
+ *             support extract-and-expand.
+ *      - a non-zero error code indicating failure.
+ */
+int VCCRYPT_DECL_MUST_CHECK
+vccrypt_key_derivation_expand(
+    vccrypt_buffer_t* derived_key, vccrypt_key_derivation_context_t* context,
+    const vccrypt_buffer_t* prk, const vccrypt_buffer_t* info);
+
 /* make this header C++ friendly. */
 #ifdef __cplusplus
 }
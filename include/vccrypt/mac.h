@@ -33,6 +33,21 @@ extern "C" {
  * @{
  */
 
+/**
+ * \brief Key size for HMAC SHA-2 256.
+ */
+#define VCCRYPT_MAC_SHA_256_KEY_SIZE 32
+
+/**
+ * \brief MAC size for HMAC SHA-2 256.
+ */
+#define VCCRYPT_MAC_SHA_256_MAC_SIZE 32
+
+/**
+ * \brief Block size for HMAC SHA-2 256.
+ */
+#define VCCRYPT_MAC_SHA_256_BLOCK_SIZE 64
+
 /**
  * \brief Key size for HMAC SHA-2 512/256.
  */
@@ -77,6 +92,11 @@ extern "C" {
  * \brief Block size for HMAC SHA-2 512.
  */
 #define VCCRYPT_MAC_SHA_512_BLOCK_SIZE 128
+
+/**
+ * \brief The largest MAC size of any of the MAC algorithms.
+ */
+#define VCCRYPT_MAC_MAX_MAC_SIZE VCCRYPT_MAC_SHA_512_MAC_SIZE
 /**
  * @}
  */
@@ -248,6 +268,57 @@ typedef struct vccrypt_mac_options
     int (*vccrypt_mac_alg_finalize)(
         void* context, vccrypt_buffer_t* mac_buffer);
 
+    /**
+     * \brief Return the MAC instance to the state it had just after keying.
+     *
+     * \param context       An opaque pointer to the vccrypt_mac_context_t
+     *                      structure.
+     *
+     * \returns \ref VCCRYPT_STATUS_SUCCESS on success and non-zero on failure.
+     */
+    int (*vccrypt_mac_alg_reset)(void* context);
+
+    /**
+     * \brief Optional algorithm-specific batch verification.
+     *
+     * Algorithms that can authenticate several independent messages in
+     * lockstep set this.  When it is NULL, vccrypt_mac_batch_verify() checks
+     * each message in turn.  The arguments have already been checked, and the
+     * results bitmap has been cleared.
+     *
+     * \param options       Opaque pointer to this options structure.
+     * \param keys          Array of keys.
+     * \param data          Array of pointers to the messages.
+     * \param sizes         Array of message sizes, in bytes.
+     * \param tags          Array of pointers to the expected MACs.
+     * \param count         The number of messages.
+     * \param results       Bitmap receiving a set bit for each valid MAC.
+     *
+     * \returns \ref VCCRYPT_STATUS_SUCCESS on success and non-zero on failure.
+     */
+    int (*vccrypt_mac_alg_batch_verify)(
+        void* options, const vccrypt_buffer_t* keys,
+        const uint8_t* const* data, const size_t* sizes,
+        const uint8_t* const* tags, size_t count, uint8_t* results);
+
+    /**
+     * \brief Optional algorithm-specific truncated finalization.
+     *
+     * Algorithms that can write the first bytes of the MAC directly to caller
+     * memory set this.  When it is NULL, vccrypt_mac_finalize_truncated() and
+     * vccrypt_mac_verify() finalize the full MAC on the stack.  The arguments
+     * have already been checked.
+     *
+     * \param context       An opaque pointer to the vccrypt_mac_context_t
+     *                      structure.
+     * \param mac           Memory to receive the first size bytes of the MAC.
+     * \param size          The number of bytes to write.
+     *
+     * \returns \ref VCCRYPT_STATUS_SUCCESS on success and non-zero on failure.
+     */
+    int (*vccrypt_mac_alg_finalize_truncated)(
+        void* context, uint8_t* mac, size_t size);
+
 } vccrypt_mac_options_t;
 
 /**
@@ -348,6 +419,9 @@ vccrypt_mac_digest(
  * \brief Finalize the message authentication code, copying the output data to
  * the given buffer.
  *
+ * The MAC instance is then ready to authenticate another message with the same
+ * key, without the cost of calling vccrypt_mac_init() again.
+ *
  * \param context       The MAC instance.
  * \param mac_buffer    The buffer to receive the MAC.  Must be large enough for
  *                      the given MAC algorithm.
@@ -362,6 +436,107 @@ int VCCRYPT_DECL_MUST_CHECK
 vccrypt_mac_finalize(
     vccrypt_mac_context_t* context, vccrypt_buffer_t* mac_buffer);
 
+/**
+ * \brief Finalize the message authentication code, writing only its first
+ * bytes to caller memory.
+ *
+ * This is the same as vccrypt_mac_finalize() followed by copying the first
+ * \p size bytes of the MAC, without an intermediate buffer for the full MAC.
+ * The MAC instance is then ready to authenticate another message with the same
+ * key.
+ *
+ * \param context       The MAC instance.
+ * \param mac           Memory to receive the first \p size bytes of the MAC.
+ * \param size          The number of bytes to write, from 1 to mac_size.
+ *
+ * \returns a status indicating success or failure.
+ *      - \ref VCCRYPT_STATUS_SUCCESS on success.
+ *      - \ref VCCRYPT_ERROR_MAC_FINALIZE_INVALID_ARG if an invalid argument is
+ *             provided.
+ *      - a non-zero return code on error.
+ */
+int VCCRYPT_DECL_MUST_CHECK
+vccrypt_mac_finalize_truncated(
+    vccrypt_mac_context_t* context, uint8_t* mac, size_t size);
+
+/**
+ * \brief Finalize the message authentication code, and compare its first
+ * bytes with an expected MAC in constant time.
+ *
+ * The MAC instance is then ready to authenticate another message with the same
+ * key, whether or not the MAC matched.
+ *
+ * \param context       The MAC instance.
+ * \param mac           The expected MAC, or its first \p size bytes.
+ * \param size          The number of bytes to compare, from 1 to mac_size.
+ *
+ * \returns a status indicating success or failure.
+ *      - \ref VCCRYPT_STATUS_SUCCESS if the MAC matches.
+ *      - \ref VCCRYPT_ERROR_MAC_VERIFY_MISMATCH if the MAC does not match.
+ *      - \ref VCCRYPT_ERROR_MAC_VERIFY_INVALID_ARG if an invalid argument is
+ *             provided.
+ *      - a non-zero return code on error.
+ */
+int VCCRYPT_DECL_MUST_CHECK
+vccrypt_mac_verify(
+    vccrypt_mac_context_t* context, const uint8_t* mac, size_t size);
+
+/**
+ * \brief Discard any data digested so far, returning the MAC instance to the
+ * state it had just after vccrypt_mac_init().
+ *
+ * The key is kept, so a stream of messages can be authenticated under one key
+ * without disposing and initializing the MAC instance for each message.  Reset
+ * does not use the allocator.
+ *
+ * \param context       The MAC instance.
+ *
+ * \returns a status indicating success or failure.
+ *      - \ref VCCRYPT_STATUS_SUCCESS on success.
+ *      - \ref VCCRYPT_ERROR_MAC_RESET_INVALID_ARG if an invalid argument is
+ *             provided.
+ *      - a non-zero return code on error.
+ */
+int VCCRYPT_DECL_MUST_CHECK
+vccrypt_mac_reset(vccrypt_mac_context_t* context);
+
+/**
+ * \brief Verify the MACs of a batch of independent messages.
+ *
+ * Item \p i is valid if the MAC of \p data[i] under \p keys[i] matches the
+ * first mac_size bytes of \p tags[i], exactly as if it were checked with
+ * vccrypt_mac_init(), vccrypt_mac_digest(), vccrypt_mac_finalize(), and
+ * crypto_memcmp().  Algorithms that support it authenticate several messages
+ * in lockstep, which is much faster than checking many short messages one at
+ * a time.
+ *
+ * The result for item \p i is bit (i % 8) of \p results[i / 8], which is set
+ * if the MAC is valid and clear otherwise.  A success status only means that
+ * the batch was processed; the caller must check the bitmap.
+ *
+ * \param options       The options for the MAC algorithm to use.
+ * \param keys          Array of \p count keys.
+ * \param data          Array of \p count pointers to the messages.  A pointer
+ *                      may only be NULL if its size is 0.
+ * \param sizes         Array of \p count message sizes, in bytes.
+ * \param tags          Array of \p count pointers to the expected MACs, each
+ *                      at least mac_size bytes.
+ * \param count         The number of messages to verify.
+ * \param results       Bitmap of (count + 7) / 8 bytes to receive the result
+ *                      for each message.
+ *
+ * \returns a status indicating success or failure.
+ *      - \ref VCCRYPT_STATUS_SUCCESS if the batch was processed.
+ *      - \ref VCCRYPT_ERROR_MAC_BATCH_VERIFY_INVALID_ARG if an invalid
+ *             argument is provided.
+ *      - a non-zero return code on error.
+ */
+int VCCRYPT_DECL_MUST_CHECK
+vccrypt_mac_batch_verify(
+    vccrypt_mac_options_t* options, const vccrypt_buffer_t* keys,
+    const uint8_t* const* data, const size_t* sizes,
+    const uint8_t* const* tags, size_t count, uint8_t* results);
+
 /* make this header C++ friendly. */
 #ifdef __cplusplus
 }
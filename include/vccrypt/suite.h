@@ -451,6 +451,55 @@ vccrypt_suite_mac_short_init(
     vccrypt_suite_options_t* options, vccrypt_mac_context_t* context,
     vccrypt_buffer_t* key);
 
+/**
+ * \brief Compute the short message authentication code of a message.
+ *
+ * This digests the message and writes the MAC straight to caller memory, with
+ * no intermediate buffer.  The MAC instance, created by
+ * vccrypt_suite_mac_short_init(), is then ready for the next message with the
+ * same key, so a stream of short messages is authenticated without keying the
+ * MAC again.
+ *
+ * \param options       The options structure for this crypto suite.
+ * \param context       The short MAC instance, with no data digested yet.
+ * \param data          The message.
+ * \param size          The size of the message, in bytes.
+ * \param mac           Memory to receive the MAC, which is
+ *                      mac_short_opts.mac_size bytes long.
+ *
+ * \returns a status indicating success or failure.
+ *      - \ref VCCRYPT_STATUS_SUCCESS on success.
+ *      - a non-zero return code on failure.
+ */
+int VCCRYPT_DECL_MUST_CHECK
+vccrypt_suite_mac_short_compute(
+    vccrypt_suite_options_t* options, vccrypt_mac_context_t* context,
+    const uint8_t* data, size_t size, uint8_t* mac);
+
+/**
+ * \brief Verify the short message authentication code of a message in
+ * constant time.
+ *
+ * The MAC instance, created by vccrypt_suite_mac_short_init(), is then ready
+ * for the next message with the same key, whether or not the MAC matched.
+ *
+ * \param options       The options structure for this crypto suite.
+ * \param context       The short MAC instance, with no data digested yet.
+ * \param data          The message.
+ * \param size          The size of the message, in bytes.
+ * \param mac           The expected MAC, which is mac_short_opts.mac_size
+ *                      bytes long.
+ *
+ * \returns a status indicating success or failure.
+ *      - \ref VCCRYPT_STATUS_SUCCESS if the MAC matches.
+ *      - \ref VCCRYPT_ERROR_MAC_VERIFY_MISMATCH if the MAC does not match.
+ *      - a non-zero return code on failure.
+ */
+int VCCRYPT_DECL_MUST_CHECK
+vccrypt_suite_mac_short_verify(
+    vccrypt_suite_options_t* options, vccrypt_mac_context_t* context,
+    const uint8_t* data, size_t size, const uint8_t* mac);
+
 /**
  * \brief Create an appropriate authentication key agreement algorithm instance
  * for this crypto suite.
@@ -511,6 +560,21 @@ int VCCRYPT_DECL_MUST_CHECK
 vccrypt_suite_buffer_init_for_signature_private_key(
     vccrypt_suite_options_t* options, vccrypt_buffer_t* buffer);
 
+/**
+ * \brief Create a buffer sized appropriately for the expanded private key of
+ * this crypto suite's digital signature algorithm.
+ *
+ * \param options       The options structure for this crypto suite.
+ * \param buffer        The buffer to instance initialize.
+ *
+ * \returns a status indicating success or failure.
+ *      - \ref VCCRYPT_STATUS_SUCCESS on success.
+ *      - a non-zero return code on failure.
+ */
+int VCCRYPT_DECL_MUST_CHECK
+vccrypt_suite_buffer_init_for_signature_expanded_private_key(
+    vccrypt_suite_options_t* options, vccrypt_buffer_t* buffer);
+
 /**
  * \brief Create a buffer sized appropriately for the public key of this crypto
  * suite's digital signature algorithm.
@@ -526,6 +590,21 @@ int VCCRYPT_DECL_MUST_CHECK
 vccrypt_suite_buffer_init_for_signature_public_key(
     vccrypt_suite_options_t* options, vccrypt_buffer_t* buffer);
 
+/**
+ * \brief Create a buffer sized appropriately for the prepared public key of
+ * this crypto suite's digital signature algorithm.
+ *
+ * \param options       The options structure for this crypto suite.
+ * \param buffer        The buffer to instance initialize.
+ *
+ * \returns a status indicating success or failure.
+ *      - \ref VCCRYPT_STATUS_SUCCESS on success.
+ *      - a non-zero return code on failure.
+ */
+int VCCRYPT_DECL_MUST_CHECK
+vccrypt_suite_buffer_init_for_signature_prepared_public_key(
+    vccrypt_suite_options_t* options, vccrypt_buffer_t* buffer);
+
 /**
  * \brief Create a buffer sized appropriately for the signature of this crypto
  * suite's digital signature algorithm.
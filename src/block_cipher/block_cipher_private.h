@@ -27,6 +27,10 @@ extern "C" {
 
 #define VCCRYPT_AES_CBC_ALG_AES_256_KEY_SIZE 32
 
+/* the number of blocks decrypted at once by the batch decrypt path.  This is
+ * the widest pass of the AES backends. */
+#define VCCRYPT_AES_CBC_ALG_DECRYPT_BLOCKS 8
+
 /**
  * AES CBC Mode specific options data.
  */
@@ -102,4 +106,26 @@ int vccrypt_aes_cbc_alg_decrypt(
     void* options, void* context, const void* iv, const void* input,
     void* output);
 
+/**
+ * Decrypt a run of blocks of data using the block cipher.
+ *
+ * \param options       Opaque pointer to this options structure.
+ * \param context       An opaque pointer to the vccrypt_block_context_t
+ *                      structure.
+ * \param iv            The initialization vector to use for the first block.
+ *                      Must be the block size in length.
+ * \param input         A pointer to the ciphertext input to decrypt.  Must be
+ *                      blocks times the block size in length.
+ * \param output        The output buffer where data is written.  Must be at
+ *                      least blocks times the block size in length.  It may
+ *                      be the same as input, but must not otherwise overlap
+ *                      it.
+ * \param blocks        The number of blocks to decrypt.
+ *
+ * \returns 0 on success and non-zero on failure.
+ */
+int vccrypt_aes_cbc_alg_decrypt_blocks(
+    void* options, void* context, const void* iv, const void* input,
+    void* output, size_t blocks);
+
 #endif /*VCCRYPT_BLOCK_CIPHER_PRIVATE_HEADER_GUARD*/
@@ -0,0 +1,77 @@
+/**
+ * \file vccrypt_aes_cbc_alg_decrypt_blocks.c
+ *
+ * Decrypt a run of blocks using AES CBC Mode.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <cbmc/model_assert.h>
+#include <string.h>
+#include <vpr/parameters.h>
+
+#include "block_cipher_private.h"
+
+/**
+ * Decrypt a run of blocks of data using the block cipher.
+ *
+ * The blocks are decrypted VCCRYPT_AES_CBC_ALG_DECRYPT_BLOCKS at a time, so
+ * that the AES backend can work on them in parallel.
+ *
+ * \param options       Opaque pointer to this options structure.
+ * \param context       An opaque pointer to the vccrypt_block_context_t
+ *                      structure.
+ * \param iv            The initialization vector to use for the first block.
+ *                      Must be the block size in length.
+ * \param input         A pointer to the ciphertext input to decrypt.  Must be
+ *                      blocks times the block size in length.
+ * \param output        The output buffer where data is written.  Must be at
+ *                      least blocks times the block size in length.  It may
+ *                      be the same as input, but must not otherwise overlap
+ *                      it.
+ * \param blocks        The number of blocks to decrypt.
+ *
+ * \returns 0 on success and non-zero on failure.
+ */
+int vccrypt_aes_cbc_alg_decrypt_blocks(
+    void* UNUSED(options), void* context, const void* iv, const void* input,
+    void* output, size_t blocks)
+{
+    uint8_t plain[16 * VCCRYPT_AES_CBC_ALG_DECRYPT_BLOCKS];
+    vccrypt_block_context_t* ctx = (vccrypt_block_context_t*)context;
+    aes_cbc_context_data_t* ctx_data =
+        (aes_cbc_context_data_t*)ctx->block_state;
+
+    const uint8_t* in = (const uint8_t*)input;
+    uint8_t* out = (uint8_t*)output;
+
+    /* work from the last group of blocks back to the first, so that
+     * in-place decryption only overwrites ciphertext that is no longer
+     * needed for chaining. */
+    while (blocks > 0)
+    {
+        size_t n = blocks % VCCRYPT_AES_CBC_ALG_DECRYPT_BLOCKS;
+        if (0 == n)
+        {
+            n = VCCRYPT_AES_CBC_ALG_DECRYPT_BLOCKS;
+        }
+
+        blocks -= n;
+
+        AES_decrypt_blocks(in + 16 * blocks, plain, n, &ctx_data->key);
+
+        for (size_t i = n; i-- > 0;)
+        {
+            size_t block = blocks + i;
+            const uint8_t* vec =
+                (block > 0) ? in + 16 * (block - 1) : (const uint8_t*)iv;
+
+            for (int j = 0; j < 16; ++j)
+                out[16 * block + j] = plain[16 * i + j] ^ vec[j];
+        }
+    }
+
+    memset(plain, 0, sizeof(plain));
+
+    return VCCRYPT_STATUS_SUCCESS;
+}
@@ -0,0 +1,80 @@
+/**
+ * \file vccrypt_block_decrypt_blocks.c
+ *
+ * Generic method for decrypting a run of blocks using a block cipher
+ * instance.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <cbmc/model_assert.h>
+#include <stdint.h>
+#include <vccrypt/block_cipher.h>
+#include <vpr/parameters.h>
+
+/**
+ * \brief Decrypt a run of blocks of data using the block cipher.
+ *
+ * This is the same as calling vccrypt_block_decrypt() for each block, with
+ * the previous block of ciphertext as the IV of the next block.  Because the
+ * blocks can be decrypted independently, the block cipher can work on several
+ * of them at once.
+ *
+ * \param context       The block cipher context to use.
+ * \param iv            The initialization vector to use for the first block.
+ *                      Must be the block size in length.
+ * \param input         A pointer to the ciphertext input to decrypt.  Must be
+ *                      blocks times the block size in length.
+ * \param output        The output buffer where data is written.  Must be at
+ *                      least blocks times the block size in length.  It may
+ *                      be the same as input, but must not otherwise overlap
+ *                      it.
+ * \param blocks        The number of blocks to decrypt.
+ *
+ * \returns a status indicating success or failure.
+ *      - \ref VCCRYPT_STATUS_SUCCESS on success.
+ *      - a non-zero return code on failure.
+ */
+int vccrypt_block_decrypt_blocks(
+    vccrypt_block_context_t* context, const void* iv, const void* input,
+    void* output, size_t blocks)
+{
+    MODEL_ASSERT(NULL != context);
+    MODEL_ASSERT(NULL != context->options);
+    MODEL_ASSERT(NULL != context->options->vccrypt_block_alg_decrypt);
+    MODEL_ASSERT(NULL != iv);
+    MODEL_ASSERT(NULL != input);
+    MODEL_ASSERT(NULL != output);
+
+    /* use the algorithm's batch decryption if it has one. */
+    if (NULL != context->options->vccrypt_block_alg_decrypt_blocks)
+    {
+        return context->options->vccrypt_block_alg_decrypt_blocks(
+            context->options, context, iv, input, output, blocks);
+    }
+
+    const uint8_t* in = (const uint8_t*)input;
+    uint8_t* out = (uint8_t*)output;
+    size_t block_size = context->options->IV_size;
+
+    /* otherwise, decrypt one block at a time.  Working from the last block
+     * back to the first means that in-place decryption only overwrites
+     * ciphertext that is no longer needed as an IV. */
+    while (blocks > 0)
+    {
+        --blocks;
+
+        const void* vec = (blocks > 0) ? in + (blocks - 1) * block_size : iv;
+
+        int retval =
+            context->options->vccrypt_block_alg_decrypt(
+                context->options, context, vec, in + blocks * block_size,
+                out + blocks * block_size);
+        if (VCCRYPT_STATUS_SUCCESS != retval)
+        {
+            return retval;
+        }
+    }
+
+    return VCCRYPT_STATUS_SUCCESS;
+}
@@ -48,6 +48,8 @@ void vccrypt_block_register_AES_256_4X_CBC()
     aes_4x_options.vccrypt_block_alg_init = &vccrypt_aes_cbc_alg_init;
     aes_4x_options.vccrypt_block_alg_encrypt = &vccrypt_aes_cbc_alg_encrypt;
     aes_4x_options.vccrypt_block_alg_decrypt = &vccrypt_aes_cbc_alg_decrypt;
+    aes_4x_options.vccrypt_block_alg_decrypt_blocks =
+        &vccrypt_aes_cbc_alg_decrypt_blocks;
     aes_4x_options.data = &aes_4x_options_data;
 
     /* set up this registration for the abstract factory. */
@@ -47,6 +47,8 @@ void vccrypt_block_register_AES_256_CBC_FIPS()
     aes_fips_options.vccrypt_block_alg_init = &vccrypt_aes_cbc_alg_init;
     aes_fips_options.vccrypt_block_alg_encrypt = &vccrypt_aes_cbc_alg_encrypt;
     aes_fips_options.vccrypt_block_alg_decrypt = &vccrypt_aes_cbc_alg_decrypt;
+    aes_fips_options.vccrypt_block_alg_decrypt_blocks =
+        &vccrypt_aes_cbc_alg_decrypt_blocks;
     aes_fips_options.data = &aes_fips_options_data;
 
     /* set up this registration for the abstract factory. */
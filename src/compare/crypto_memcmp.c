@@ -3,13 +3,26 @@
  *
  * Timing-attack resistant memory comparison implementation.
  *
+ * The buffers are compared a vector or a machine word at a time.  Every byte
+ * is always read, differences are only ever ORed together, and the only
+ * branches depend on the length, which is not secret.
+ *
  * \copyright 2017 Velo Payments, Inc.  All rights reserved.
  */
 
 #include <cbmc/model_assert.h>
+#include <stdint.h>
+#include <string.h>
 #include <vccrypt/compare.h>
 #include <vpr/parameters.h>
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+/* forward decls */
+static inline uint64_t crypto_memcmp_load64(const uint8_t* p);
+
 /**
  * Compare two buffers in a timing-safe way.  Note that while this function is
  * named like memcmp and shares the same arguments, its behavior is different
@@ -28,14 +41,92 @@
  */
 int crypto_memcmp(const void* lhs, const void* rhs, size_t length)
 {
-    uint8_t* l = (uint8_t*)lhs;
-    uint8_t* r = (uint8_t*)rhs;
-    uint8_t cmp = 0;
+    const uint8_t* l = (const uint8_t*)lhs;
+    const uint8_t* r = (const uint8_t*)rhs;
+    uint64_t cmp = 0;
+    size_t i = 0;
+
+    /* buffers shorter than a word, such as short tags, go a byte at a time. */
+    if (length < sizeof(uint64_t))
+    {
+        for (; i < length; ++i)
+        {
+            cmp |= l[i] ^ r[i];
+        }
+
+        return (int)((cmp | (0 - cmp)) >> 63);
+    }
+
+#if defined(__SSE2__)
+    /* large buffers go 64 bytes at a time, across four accumulators. */
+    if (length >= 64)
+    {
+        __m128i acc0 = _mm_setzero_si128();
+        __m128i acc1 = _mm_setzero_si128();
+        __m128i acc2 = _mm_setzero_si128();
+        __m128i acc3 = _mm_setzero_si128();
+        uint64_t lanes[2];
+
+        for (; i + 64 <= length; i += 64)
+        {
+            acc0 =
+                _mm_or_si128(acc0,
+                    _mm_xor_si128(
+                        _mm_loadu_si128((const __m128i*)(l + i)),
+                        _mm_loadu_si128((const __m128i*)(r + i))));
+            acc1 =
+                _mm_or_si128(acc1,
+                    _mm_xor_si128(
+                        _mm_loadu_si128((const __m128i*)(l + i + 16)),
+                        _mm_loadu_si128((const __m128i*)(r + i + 16))));
+            acc2 =
+                _mm_or_si128(acc2,
+                    _mm_xor_si128(
+                        _mm_loadu_si128((const __m128i*)(l + i + 32)),
+                        _mm_loadu_si128((const __m128i*)(r + i + 32))));
+            acc3 =
+                _mm_or_si128(acc3,
+                    _mm_xor_si128(
+                        _mm_loadu_si128((const __m128i*)(l + i + 48)),
+                        _mm_loadu_si128((const __m128i*)(r + i + 48))));
+        }
+
+        acc0 = _mm_or_si128(_mm_or_si128(acc0, acc1), _mm_or_si128(acc2, acc3));
+        _mm_storeu_si128((__m128i*)lanes, acc0);
+        cmp |= lanes[0] | lanes[1];
+    }
+#endif
 
-    for (size_t i = 0; i < length; ++i)
+    /* whole words. */
+    for (; i + sizeof(uint64_t) <= length; i += sizeof(uint64_t))
     {
-        cmp |= l[i] ^ r[i];
+        cmp |= crypto_memcmp_load64(l + i) ^ crypto_memcmp_load64(r + i);
     }
 
-    return (int)cmp;
+    /* the tail is covered by the last word of the buffers, which overlaps
+     * bytes that were already compared. */
+    if (i < length)
+    {
+        i = length - sizeof(uint64_t);
+        cmp |= crypto_memcmp_load64(l + i) ^ crypto_memcmp_load64(r + i);
+    }
+
+    /* saturate to 0 or 1 without branching on the differences. */
+    return (int)((cmp | (0 - cmp)) >> 63);
+}
+
+/**
+ * Load a word from a possibly unaligned address.
+ *
+ * \param p         The address to load from.
+ *
+ * \returns the word at this address.
+ */
+static inline uint64_t crypto_memcmp_load64(const uint8_t* p)
+{
+    uint64_t v;
+
+    memcpy(&v, p, sizeof(v));
+
+    return v;
 }
@@ -0,0 +1,112 @@
+/**
+ * \file cpu_features.c
+ *
+ * Probe the CPU features used by the runtime-selected backends.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "cpu_features.h"
+
+#if defined(__GNUC__) && (defined(__x86_64) || defined(__x86_64__))
+#include <cpuid.h>
+#define VCCRYPT_CPU_HAVE_CPUID 1
+#endif
+
+/* set in the cache once the CPU has been probed. */
+#define VCCRYPT_CPU_FEATURE_PROBED 0x80000000
+
+/* forward decls */
+static uint32_t vccrypt_cpu_probe(void);
+
+/**
+ * \brief Returns non-zero if this CPU supports all of the given features.
+ *
+ * The CPU is probed on the first call, and the answer is cached.
+ *
+ * \param features      The VCCRYPT_CPU_FEATURE_* flags to check.
+ *
+ * \returns non-zero if every requested feature is supported.
+ */
+int vccrypt_cpu_supports(uint32_t features)
+{
+    /* every thread probes the same CPU and stores the same answer, so
+     * threads racing on the first call are harmless. */
+    static volatile uint32_t cached = 0;
+    uint32_t supported = cached;
+
+    if (0 == (supported & VCCRYPT_CPU_FEATURE_PROBED))
+    {
+        supported = vccrypt_cpu_probe() | VCCRYPT_CPU_FEATURE_PROBED;
+        cached = supported;
+    }
+
+    return (supported & features) == features;
+}
+
+/**
+ * Query the CPU for the features it supports.
+ *
+ * \returns the VCCRYPT_CPU_FEATURE_* flags supported by this CPU.
+ */
+static uint32_t vccrypt_cpu_probe(void)
+{
+    uint32_t features = 0;
+
+#ifdef VCCRYPT_CPU_HAVE_CPUID
+    unsigned int eax, ebx, ecx, edx;
+    int os_ymm = 0;
+
+    if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx))
+    {
+        return 0;
+    }
+
+    if (ecx & bit_SSSE3)
+    {
+        features |= VCCRYPT_CPU_FEATURE_SSSE3;
+    }
+    if (ecx & bit_SSE4_1)
+    {
+        features |= VCCRYPT_CPU_FEATURE_SSE4_1;
+    }
+    if (ecx & bit_AES)
+    {
+        features |= VCCRYPT_CPU_FEATURE_AESNI;
+    }
+
+    /* the OS must save the YMM registers for AVX2 to be usable. */
+    if ((ecx & bit_OSXSAVE) && (ecx & bit_AVX))
+    {
+        unsigned int xcr0_lo, xcr0_hi;
+
+        __asm__ ("xgetbv" : "=a" (xcr0_lo), "=d" (xcr0_hi) : "c" (0));
+        (void)xcr0_hi;
+
+        os_ymm = (xcr0_lo & 6) == 6;
+    }
+
+    if (__get_cpuid_max(0, NULL) >= 7)
+    {
+        __cpuid_count(7, 0, eax, ebx, ecx, edx);
+
+        if (os_ymm && (ebx & bit_AVX2))
+        {
+            features |= VCCRYPT_CPU_FEATURE_AVX2;
+        }
+        if (ebx & bit_BMI2)
+        {
+            features |= VCCRYPT_CPU_FEATURE_BMI2;
+        }
+        if (ebx & bit_SHA)
+        {
+            features |= VCCRYPT_CPU_FEATURE_SHA;
+        }
+    }
+#endif
+
+    return features;
+}
@@ -0,0 +1,48 @@
+/**
+ * \file cpu_features.h
+ *
+ * \brief Private CPU feature detection for the runtime-selected backends.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#ifndef VCCRYPT_CPU_FEATURES_PRIVATE_HEADER_GUARD
+#define VCCRYPT_CPU_FEATURES_PRIVATE_HEADER_GUARD
+
+#include <stdint.h>
+
+/* make this header C++ friendly. */
+#ifdef __cplusplus
+extern "C" {
+#endif /*__cplusplus*/
+
+/**
+ * \brief CPU features that the backends select on.
+ *
+ * VCCRYPT_CPU_FEATURE_AVX2 is only reported when the OS also saves the YMM
+ * registers.  No features are reported on targets other than x86-64.
+ */
+#define VCCRYPT_CPU_FEATURE_SSSE3   0x00000001
+#define VCCRYPT_CPU_FEATURE_SSE4_1  0x00000002
+#define VCCRYPT_CPU_FEATURE_AESNI   0x00000004
+#define VCCRYPT_CPU_FEATURE_AVX2    0x00000008
+#define VCCRYPT_CPU_FEATURE_BMI2    0x00000010
+#define VCCRYPT_CPU_FEATURE_SHA     0x00000020
+
+/**
+ * \brief Returns non-zero if this CPU supports all of the given features.
+ *
+ * The CPU is probed on the first call, and the answer is cached.
+ *
+ * \param features      The VCCRYPT_CPU_FEATURE_* flags to check.
+ *
+ * \returns non-zero if every requested feature is supported.
+ */
+int vccrypt_cpu_supports(uint32_t features);
+
+/* make this header C++ friendly. */
+#ifdef __cplusplus
+}
+#endif /*__cplusplus*/
+
+#endif  //VCCRYPT_CPU_FEATURES_PRIVATE_HEADER_GUARD
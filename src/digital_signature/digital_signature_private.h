@@ -0,0 +1,77 @@
+/**
+ * \file digital_signature_private.h
+ *
+ * Private implementation details shared by the digital signature functions.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#ifndef VCCRYPT_DIGITAL_SIGNATURE_PRIVATE_HEADER_GUARD
+#define VCCRYPT_DIGITAL_SIGNATURE_PRIVATE_HEADER_GUARD
+
+#include <stdint.h>
+#include <vccrypt/digital_signature.h>
+
+/* make this header C++ friendly. */
+#ifdef __cplusplus
+extern "C" {
+#endif /*__cplusplus*/
+
+/**
+ * \brief The index used for the end of a list of public key cache entries.
+ */
+#define VCCRYPT_PUBLIC_KEY_CACHE_NONE SIZE_MAX
+
+/**
+ * \brief A public key in the cache.
+ */
+typedef struct vccrypt_public_key_cache_entry
+{
+    /** The slot holding the public key and its prepared form. */
+    size_t slot;
+    /** The next entry in the same hash bucket. */
+    size_t bucket_next;
+    /** The next more recently used entry. */
+    size_t lru_prev;
+    /** The next less recently used entry. */
+    size_t lru_next;
+} vccrypt_public_key_cache_entry_t;
+
+/**
+ * \brief The state of a public key cache.
+ *
+ * This is a single allocation, followed by the entries, the hash buckets, the
+ * public keys, and the prepared public keys.  There is one more slot than
+ * there are entries, so that a public key can be prepared before deciding
+ * which entry to evict.
+ */
+typedef struct vccrypt_public_key_cache_state
+{
+    /** The size of the whole allocation, in bytes. */
+    size_t alloc_size;
+    /** The cache entries, of which count are in use. */
+    vccrypt_public_key_cache_entry_t* entries;
+    /** The first entry of each hash bucket. */
+    size_t* buckets;
+    /** The number of buckets, less one. */
+    size_t bucket_mask;
+    /** The public key of each slot. */
+    uint8_t* keys;
+    /** The prepared public key of each slot. */
+    uint8_t* prepared;
+    /** The slot that is not used by any entry. */
+    size_t spare_slot;
+    /** The number of entries in use. */
+    size_t count;
+    /** The most recently used entry. */
+    size_t lru_head;
+    /** The least recently used entry. */
+    size_t lru_tail;
+} vccrypt_public_key_cache_state_t;
+
+/* make this header C++ friendly. */
+#ifdef __cplusplus
+}
+#endif /*__cplusplus*/
+
+#endif  //VCCRYPT_DIGITAL_SIGNATURE_PRIVATE_HEADER_GUARD
@@ -71,10 +71,60 @@ int ED25519_sign(
     uint8_t* out_sig, const uint8_t* message, size_t message_len,
     const uint8_t private_key[64], vccrypt_hash_options_t* sha512_opts);
 
+/*
+ * ED25519_expand_private_key writes the 96 byte expanded form of
+ * |private_key| to |out_expanded_key|: the clamped scalar, the nonce prefix and
+ * the public key.  ED25519_sign_expanded signs with an expanded key, without
+ * hashing the seed again.  Both return zero on success and non-zero on error.
+ */
+int ED25519_expand_private_key(
+    uint8_t out_expanded_key[96], const uint8_t private_key[64],
+    vccrypt_hash_options_t* sha512_opts);
+
+int ED25519_sign_expanded(
+    uint8_t* out_sig, const uint8_t* message, size_t message_len,
+    const uint8_t expanded_key[96], vccrypt_hash_options_t* sha512_opts);
+
 int ED25519_verify(
     const uint8_t* message, size_t message_len, const uint8_t signature[64],
     const uint8_t public_key[32], vccrypt_hash_options_t* sha512_opts);
 
+/*
+ * A prepared public key is the public key followed by the odd multiples -A,
+ * -3A, ..., -15A of its negated point, each as four encoded field elements.
+ */
+#define ED25519_PREPARED_PUBLIC_KEY_LENGTH (32 + 8 * 4 * 32)
+
+/*
+ * ED25519_prepare_public_key decompresses |public_key| and writes its prepared
+ * form to |out_prepared|.  It returns zero on success and non-zero if the
+ * public key is not a valid point.  ED25519_verify_prepared then verifies like
+ * ED25519_verify, without decompressing the key or building its table again.
+ * The table in |prepared| is not checked against the public key, so it must
+ * come from ED25519_prepare_public_key in this process.
+ */
+int ED25519_prepare_public_key(
+    uint8_t out_prepared[ED25519_PREPARED_PUBLIC_KEY_LENGTH],
+    const uint8_t public_key[32]);
+
+int ED25519_verify_prepared(
+    const uint8_t* message, size_t message_len, const uint8_t signature[64],
+    const uint8_t prepared[ED25519_PREPARED_PUBLIC_KEY_LENGTH],
+    vccrypt_hash_options_t* sha512_opts);
+
+/*
+ * ED25519_batch_verify checks |count| signatures at once, setting bit i % 8 of
+ * |results|[i / 8] for each valid signature.  The caller clears |results|.  A
+ * signature is valid when [8]([S]B - R - [h]A) is the identity, which is the
+ * equation ED25519_verify checks, so both agree even for R or A with a
+ * small-order component.  It returns zero on success and non-zero on error.
+ */
+int ED25519_batch_verify(
+    const uint8_t* const* messages, const size_t* message_lens,
+    const vccrypt_buffer_t* signatures, const vccrypt_buffer_t* public_keys,
+    size_t count, uint8_t* results, vccrypt_prng_context_t* prng_ctx,
+    vccrypt_hash_options_t* sha512_opts);
+
 #if defined(__cplusplus)
 } /* extern C */
 #endif
@@ -0,0 +1,750 @@
+/**
+ * \file curve25519_avx2.c
+ *
+ * Curve25519 point arithmetic using AVX2.
+ *
+ * Four field elements are computed at once, one per 64-bit lane.  Each element
+ * is held as ten limbs of 26 and 25 bits, so that the 32x32 bit multiplies of
+ * AVX2 give each limb product in full.  The 25.5-bit limbs split the 51-bit
+ * limbs of the scalar field code exactly, which keeps conversion cheap.
+ *
+ * An extended point (X:Y:Z:T) keeps its four coordinates in the four lanes.
+ * Point addition and doubling are then arranged, following Hisil, Wong,
+ * Carter, and Dawson, so that the products of each step are independent:
+ * an addition is two four-lane multiplies, and a doubling is a four-lane
+ * square and a four-lane multiply.  The X25519 ladder step is likewise three
+ * four-lane multiplies.
+ *
+ * All limbs are unsigned.  Subtraction adds 2p first, and every multiply
+ * input is at most one addition or subtraction away from a reduced element,
+ * which keeps 19 times a limb within 32 bits and every column sum within 64
+ * bits.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+#include "curve25519_internal.h"
+
+#ifdef CURVE25519_HAVE_AVX2
+
+#include <immintrin.h>
+
+#include "../../cpu/cpu_features.h"
+
+#define CURVE25519_AVX2_TARGET __attribute__((target("avx2")))
+
+/* blend masks selecting the 64-bit lanes of a vector. */
+#define LANE_A 0x03
+#define LANE_B 0x0c
+#define LANE_C 0x30
+#define LANE_D 0xc0
+
+/* lane permutations; the result takes its lanes from (a, b, c, d). */
+#define LANES(a, b, c, d) _MM_SHUFFLE(d, c, b, a)
+#define A_ 0
+#define B_ 1
+#define C_ 2
+#define D_ 3
+
+/* hide x from the optimizer at this point.  Without this, GCC computes all
+ * 100 products of a multiplication up front and spills them to the stack. */
+#define FE4_BARRIER(x) __asm__ volatile("" : "+x"(x))
+
+/* z + a * b, for the low 32 bits of each lane of a and b. */
+#define MAC(z, a, b) _mm256_add_epi64(z, _mm256_mul_epu32(a, b))
+
+/* swap the two halves of h if mask is all ones, in constant time. */
+#define FE4_CSWAP_HALVES(h, mask) \
+    do \
+    { \
+        for (int l_ = 0; l_ < 10; ++l_) \
+        { \
+            __m256i x_ = \
+                _mm256_permute4x64_epi64((h)->v[l_], LANES(C_, D_, A_, B_)); \
+            x_ = _mm256_and_si256(_mm256_xor_si256((h)->v[l_], x_), mask); \
+            (h)->v[l_] = _mm256_xor_si256((h)->v[l_], x_); \
+        } \
+    } while (0)
+
+/**
+ * \brief Four field elements, one per lane.
+ *
+ * Limb i of each element is a multiple of 2^ceil(25.5 i).  A reduced element
+ * has limbs of at most 26 or 25 bits, plus a small carry in limbs 0 and 1.
+ */
+typedef struct fe4
+{
+    __m256i v[10];
+} fe4;
+
+/* forward decls */
+static CURVE25519_AVX2_TARGET void fe4_from_fe(
+    fe4* h, const fe a, const fe b, const fe c, const fe d);
+static CURVE25519_AVX2_TARGET void fe4_to_fe(
+    fe a, fe b, fe c, fe d, const fe4* h);
+static CURVE25519_AVX2_TARGET void fe4_carry(fe4* h);
+static CURVE25519_AVX2_TARGET __m256i fe4_two_p(int i);
+static CURVE25519_AVX2_TARGET void fe4_mul(
+    fe4* h, const fe4* f, const fe4* g);
+static CURVE25519_AVX2_TARGET void fe4_sq(fe4* h, const fe4* f);
+static CURVE25519_AVX2_TARGET void ge4_dbl(fe4* r, const fe4* p);
+static CURVE25519_AVX2_TARGET void ge4_sum_diff(fe4* t, const fe4* p);
+static CURVE25519_AVX2_TARGET void ge4_add(
+    fe4* r, const fe4* p, const fe4* q);
+static CURVE25519_AVX2_TARGET void ge4_to_cached(fe4* r, const fe4* p);
+static CURVE25519_AVX2_TARGET void ge4_cached_neg(fe4* r, const fe4* q);
+static CURVE25519_AVX2_TARGET void ge4_double_scalarmult_vartime(
+    ge_p2* r, const uint8_t* a, const fe4 Ai[8], const uint8_t* b,
+    const ge_precomp Bi[8]);
+
+/* 2p, in the limbs of each lane. */
+#define TWO_P0 0x7ffffdaULL
+#define TWO_P_EVEN 0x7fffffeULL
+#define TWO_P_ODD 0x3fffffeULL
+
+static const uint64_t kBottom26Bits = 0x3ffffffULL;
+static const uint64_t kBottom25Bits = 0x1ffffffULL;
+static const uint64_t kBottom51Bits = 0x7ffffffffffffULL;
+
+/* d2 = 2 * d, in radix 2^25.5. */
+static const uint32_t kD2[10] = {
+    0x2b2f159, 0x1a6e509, 0x22add7a, 0x0d4141d, 0x0038052,
+    0x0f3d130, 0x3407977, 0x19ce331, 0x1c56dff, 0x0901b67,
+};
+
+/**
+ * Returns non-zero if this CPU and OS support the AVX2 point arithmetic.
+ */
+int curve25519_avx2_capable(void)
+{
+    return vccrypt_cpu_supports(VCCRYPT_CPU_FEATURE_AVX2);
+}
+
+/**
+ * Compute a * A + b * B, where B is the Ed25519 base point.
+ *
+ * This is the same as x25519_ge_double_scalarmult_vartime_generic, with the
+ * point kept as four lanes throughout.
+ *
+ * \param r     The result.
+ * \param a     The scalar to multiply A by.
+ * \param A     The point A.
+ * \param b     The scalar to multiply the base point by.
+ * \param Bi    The odd multiples B, 3B, ..., 15B of the base point.
+ */
+CURVE25519_AVX2_TARGET void x25519_ge_double_scalarmult_vartime_avx2(
+    ge_p2* r, const uint8_t* a, const ge_p3* A, const uint8_t* b,
+    const ge_precomp Bi[8])
+{
+    fe4 Ai[8]; /* A,3A,5A,7A,9A,11A,13A,15A */
+    fe4 A2, u, t;
+    int i;
+
+    /* the odd multiples of A. */
+    fe4_from_fe(&u, A->X, A->Y, A->Z, A->T);
+    ge4_to_cached(&Ai[0], &u);
+    ge4_dbl(&A2, &u);
+    for (i = 1; i < 8; ++i)
+    {
+        ge4_add(&t, &A2, &Ai[i - 1]);
+        ge4_to_cached(&Ai[i], &t);
+    }
+
+    ge4_double_scalarmult_vartime(r, a, Ai, b, Bi);
+}
+
+/**
+ * Compute a * A + b * B, where B is the Ed25519 base point, for a point A
+ * given by its odd multiples.
+ *
+ * \param r     The result.
+ * \param a     The scalar to multiply A by.
+ * \param Ai    The odd multiples A, 3A, ..., 15A, in the cached form of the
+ *              scalar field code.
+ * \param b     The scalar to multiply the base point by.
+ * \param Bi    The odd multiples B, 3B, ..., 15B of the base point.
+ */
+CURVE25519_AVX2_TARGET void x25519_ge_double_scalarmult_vartime_table_avx2(
+    ge_p2* r, const uint8_t* a, const ge_cached Ai[8], const uint8_t* b,
+    const ge_precomp Bi[8])
+{
+    fe4 Ai4[8];
+    int i, l;
+
+    /* (Y + X, Y - X, Z, 2dT) becomes (Y - X, Y + X, 2Z, 2dT). */
+    for (i = 0; i < 8; ++i)
+    {
+        fe4_from_fe(&Ai4[i], Ai[i].YminusX, Ai[i].YplusX, Ai[i].Z, Ai[i].T2d);
+        for (l = 0; l < 10; ++l)
+        {
+            __m256i x = Ai4[i].v[l];
+
+            Ai4[i].v[l] =
+                _mm256_add_epi64(
+                    x, _mm256_blend_epi32(_mm256_setzero_si256(), x, LANE_C));
+        }
+
+        /* the table may come straight from the scalar field code, whose
+         * limbs can be a bit over 51 bits. */
+        fe4_carry(&Ai4[i]);
+    }
+
+    ge4_double_scalarmult_vartime(r, a, Ai4, b, Bi);
+}
+
+/**
+ * Compute a * A + b * B from the four-lane odd multiples of A and the odd
+ * multiples of B.
+ *
+ * \param r     The result.
+ * \param a     The scalar to multiply A by.
+ * \param Ai    The odd multiples A, 3A, ..., 15A, as cached points.
+ * \param b     The scalar to multiply the base point by.
+ * \param Bi    The odd multiples B, 3B, ..., 15B of the base point.
+ */
+static CURVE25519_AVX2_TARGET void ge4_double_scalarmult_vartime(
+    ge_p2* r, const uint8_t* a, const fe4 Ai[8], const uint8_t* b,
+    const ge_precomp Bi[8])
+{
+    signed char aslide[256];
+    signed char bslide[256];
+    fe4 Ai_neg[8];
+    fe4 Bc[8];
+    fe4 Bc_neg[8];
+    fe4 u, t;
+    fe one, two, unused;
+    int i;
+
+    x25519_slide(aslide, a);
+    x25519_slide(bslide, b);
+
+    /* the precomputed points are affine, so 2Z is 2. */
+    memset(one, 0, sizeof(one));
+    one[0] = 1;
+    memset(two, 0, sizeof(two));
+    two[0] = 2;
+    for (i = 0; i < 8; ++i)
+    {
+        fe4_from_fe(&Bc[i], Bi[i].yminusx, Bi[i].yplusx, two, Bi[i].xy2d);
+        ge4_cached_neg(&Ai_neg[i], &Ai[i]);
+        ge4_cached_neg(&Bc_neg[i], &Bc[i]);
+    }
+
+    for (i = 255; i >= 0; --i)
+    {
+        if (aslide[i] || bslide[i])
+        {
+            break;
+        }
+    }
+
+    /* start from the identity, (0 : 1 : 1 : 0). */
+    memset(unused, 0, sizeof(unused));
+    fe4_from_fe(&u, unused, one, one, unused);
+
+    for (; i >= 0; --i)
+    {
+        ge4_dbl(&t, &u);
+
+        if (aslide[i] > 0)
+        {
+            ge4_add(&t, &t, &Ai[aslide[i] / 2]);
+        }
+        else if (aslide[i] < 0)
+        {
+            ge4_add(&t, &t, &Ai_neg[(-aslide[i]) / 2]);
+        }
+
+        if (bslide[i] > 0)
+        {
+            ge4_add(&t, &t, &Bc[bslide[i] / 2]);
+        }
+        else if (bslide[i] < 0)
+        {
+            ge4_add(&t, &t, &Bc_neg[(-bslide[i]) / 2]);
+        }
+
+        u = t;
+    }
+
+    fe4_to_fe(r->X, r->Y, r->Z, unused, &u);
+}
+
+/**
+ * Run the X25519 Montgomery ladder.
+ *
+ * The ladder state (x2, z2, x3, z3) is kept in the four lanes.  Each step
+ * computes (x2+z2, x2-z2, x3+z3, x3-z3), then the products
+ * (AA, BB, DA, CB), then (x2, z2, x3, (DA-CB)^2), and finally multiplies the
+ * last lane by x1.  The conditional swap exchanges the two halves of the
+ * vector under a mask, so the ladder stays constant time.
+ *
+ * \param x2    The x coordinate of the result, projectively.
+ * \param z2    The z coordinate of the result.
+ * \param e     The clamped scalar.
+ * \param x1    The x coordinate of the input point.
+ */
+CURVE25519_AVX2_TARGET void x25519_ladder_avx2(
+    fe x2, fe z2, const uint8_t e[32], const fe x1)
+{
+    const __m256i k121665 = _mm256_set_epi64x(0, 0, 121665, 0);
+    fe4 v, s, left, right, t;
+    fe4 kx1;
+    fe one, zero, unused;
+    unsigned swap = 0;
+    int pos, i;
+
+    memset(zero, 0, sizeof(zero));
+    memset(one, 0, sizeof(one));
+    one[0] = 1;
+
+    /* (x2, z2, x3, z3) = (1, 0, x1, 1) */
+    fe4_from_fe(&v, one, zero, x1, one);
+    fe4_from_fe(&kx1, one, one, one, x1);
+
+    for (pos = 254; pos >= 0; --pos)
+    {
+        unsigned b = 1 & (e[pos / 8] >> (pos & 7));
+
+        swap ^= b;
+        FE4_CSWAP_HALVES(&v, _mm256_set1_epi64x(-(int64_t)swap));
+        swap = b;
+
+        /* (A, B, C, D) = (x2 + z2, x2 - z2, x3 + z3, x3 - z3), and then
+         * t = (A, B, D, C) * (A, B, A, B) = (AA, BB, DA, CB). */
+        for (i = 0; i < 10; ++i)
+        {
+            __m256i x = v.v[i];
+            __m256i y = _mm256_permute4x64_epi64(x, LANES(B_, A_, D_, C_));
+
+            x = _mm256_blend_epi32(
+                    x, _mm256_sub_epi64(fe4_two_p(i), x), LANE_B | LANE_D);
+            x = _mm256_add_epi64(x, y);
+
+            left.v[i] = _mm256_permute4x64_epi64(x, LANES(A_, B_, D_, C_));
+            right.v[i] = _mm256_permute4x64_epi64(x, LANES(A_, B_, A_, B_));
+        }
+
+        fe4_mul(&t, &left, &right);
+
+        /* left = (AA, E, DA + CB, DA - CB), where E = AA - BB, and
+         * right = (BB, AA + 121665 E, DA + CB, DA - CB). */
+        for (i = 0; i < 10; ++i)
+        {
+            __m256i x = t.v[i];
+            __m256i y = _mm256_permute4x64_epi64(x, LANES(B_, A_, D_, C_));
+            __m256i u;
+
+            u = _mm256_blend_epi32(
+                    x, _mm256_sub_epi64(fe4_two_p(i), x), LANE_B | LANE_D);
+            u = _mm256_add_epi64(u, y);
+
+            s.v[i] = y;
+            left.v[i] = _mm256_blend_epi32(u, x, LANE_A);
+            right.v[i] = _mm256_mul_epu32(u, k121665);
+        }
+
+        fe4_carry(&right);
+
+        for (i = 0; i < 10; ++i)
+        {
+            __m256i x = _mm256_add_epi64(right.v[i], s.v[i]);
+
+            x = _mm256_blend_epi32(x, s.v[i], LANE_A);
+            right.v[i] = _mm256_blend_epi32(x, left.v[i], LANE_C | LANE_D);
+        }
+
+        /* t = (x2, z2, x3, (DA - CB)^2), then z3 = x1 (DA - CB)^2. */
+        fe4_mul(&t, &left, &right);
+        fe4_mul(&v, &t, &kx1);
+    }
+
+    FE4_CSWAP_HALVES(&v, _mm256_set1_epi64x(-(int64_t)swap));
+
+    fe4_to_fe(x2, z2, unused, unused, &v);
+}
+
+/**
+ * Load four field elements from the 51-bit limbs of the scalar field code.
+ */
+static CURVE25519_AVX2_TARGET void fe4_from_fe(
+    fe4* h, const fe a, const fe b, const fe c, const fe d)
+{
+    int i;
+
+    for (i = 0; i < 5; ++i)
+    {
+        h->v[2 * i] =
+            _mm256_set_epi64x(
+                d[i] & kBottom26Bits, c[i] & kBottom26Bits,
+                b[i] & kBottom26Bits, a[i] & kBottom26Bits);
+        h->v[2 * i + 1] =
+            _mm256_set_epi64x(d[i] >> 26, c[i] >> 26, b[i] >> 26, a[i] >> 26);
+    }
+}
+
+/**
+ * Store four field elements as 51-bit limbs for the scalar field code.
+ */
+static CURVE25519_AVX2_TARGET void fe4_to_fe(
+    fe a, fe b, fe c, fe d, const fe4* h)
+{
+    uint64_t l[10][4] __attribute__((aligned(32)));
+    uint64_t* out[4] = { a, b, c, d };
+    fe4 t = *h;
+    int i, j;
+
+    fe4_carry(&t);
+    for (i = 0; i < 10; ++i)
+    {
+        _mm256_store_si256((__m256i*)l[i], t.v[i]);
+    }
+
+    for (j = 0; j < 4; ++j)
+    {
+        uint64_t* f = out[j];
+
+        for (i = 0; i < 5; ++i)
+        {
+            f[i] = l[2 * i][j] + (l[2 * i + 1][j] << 26);
+        }
+
+        /* limbs 1 and 5 may carry a little past 25 bits. */
+        for (i = 0; i < 4; ++i)
+        {
+            f[i + 1] += f[i] >> 51;
+            f[i] &= kBottom51Bits;
+        }
+        f[0] += (f[4] >> 51) * 19;
+        f[4] &= kBottom51Bits;
+    }
+}
+
+/**
+ * Carry each limb into the next one, leaving h reduced.
+ */
+static CURVE25519_AVX2_TARGET void fe4_carry(fe4* h)
+{
+    const __m256i m26 = _mm256_set1_epi64x(kBottom26Bits);
+    const __m256i m25 = _mm256_set1_epi64x(kBottom25Bits);
+    __m256i* z = h->v;
+    __m256i c;
+
+#define CARRY(i, bits, mask) \
+    c = _mm256_srli_epi64(z[i], bits); \
+    z[i] = _mm256_and_si256(z[i], mask); \
+    z[(i) + 1] = _mm256_add_epi64(z[(i) + 1], c)
+
+    /* two interleaved chains, as in the scalar code. */
+    CARRY(0, 26, m26);
+    CARRY(4, 26, m26);
+    CARRY(1, 25, m25);
+    CARRY(5, 25, m25);
+    CARRY(2, 26, m26);
+    CARRY(6, 26, m26);
+    CARRY(3, 25, m25);
+    CARRY(7, 25, m25);
+    CARRY(4, 26, m26);
+    CARRY(8, 26, m26);
+
+    /* 2^255 = 19, and 19 c = 16 c + 2 c + c. */
+    c = _mm256_srli_epi64(z[9], 25);
+    z[9] = _mm256_and_si256(z[9], m25);
+    z[0] =
+        _mm256_add_epi64(
+            z[0],
+            _mm256_add_epi64(
+                c,
+                _mm256_add_epi64(
+                    _mm256_slli_epi64(c, 4), _mm256_slli_epi64(c, 1))));
+
+    CARRY(0, 26, m26);
+
+#undef CARRY
+}
+
+/**
+ * h = f * g
+ *
+ * Each input may be one addition or subtraction away from reduced.  The
+ * output is reduced.
+ *
+ * The products are summed a row at a time, so that only the ten sums and
+ * one limb of f are kept in registers.
+ */
+static CURVE25519_AVX2_TARGET void fe4_mul(
+    fe4* h, const fe4* f, const fe4* g)
+{
+    const __m256i k19 = _mm256_set1_epi64x(19);
+    __m256i z[10];
+    __m256i g19[10];
+    int i, j;
+
+#pragma GCC unroll 10
+    for (j = 1; j < 10; ++j)
+    {
+        g19[j] = _mm256_mul_epu32(g->v[j], k19);
+    }
+
+#pragma GCC unroll 10
+    for (i = 0; i < 10; ++i)
+    {
+        __m256i fi = f->v[i];
+        __m256i fi2;
+
+        FE4_BARRIER(fi);
+        fi2 = _mm256_add_epi64(fi, fi);
+
+#pragma GCC unroll 10
+        for (j = 0; j < 10; ++j)
+        {
+            __m256i a = (i & j & 1) ? fi2 : fi;
+            __m256i b = (i + j < 10) ? g->v[j] : g19[j];
+            int k = (i + j) % 10;
+
+            z[k] = (0 == i) ? _mm256_mul_epu32(a, b) : MAC(z[k], a, b);
+        }
+
+#pragma GCC unroll 10
+        for (j = 0; j < 10; ++j)
+        {
+            FE4_BARRIER(z[j]);
+        }
+    }
+
+#pragma GCC unroll 10
+    for (i = 0; i < 10; ++i)
+    {
+        h->v[i] = z[i];
+    }
+
+    fe4_carry(h);
+}
+
+/**
+ * h = f * f
+ *
+ * The input may be one addition or subtraction away from reduced.  The output
+ * is reduced.
+ */
+static CURVE25519_AVX2_TARGET void fe4_sq(fe4* h, const fe4* f)
+{
+    const __m256i k19 = _mm256_set1_epi64x(19);
+    __m256i z[10];
+    __m256i f19[10];
+    int i, j;
+
+#pragma GCC unroll 10
+    for (j = 5; j < 10; ++j)
+    {
+        f19[j] = _mm256_mul_epu32(f->v[j], k19);
+    }
+
+#pragma GCC unroll 10
+    for (i = 0; i < 10; ++i)
+    {
+        __m256i fi = f->v[i];
+        __m256i fi2, fi4;
+
+        FE4_BARRIER(fi);
+        fi2 = _mm256_add_epi64(fi, fi);
+        fi4 = _mm256_add_epi64(fi2, fi2);
+
+#pragma GCC unroll 10
+        for (j = i; j < 10; ++j)
+        {
+            __m256i a = (i == j) ? ((i & 1) ? fi2 : fi)
+                                 : ((i & j & 1) ? fi4 : fi2);
+            __m256i b = (i + j < 10) ? f->v[j] : f19[j];
+            int k = (i + j) % 10;
+
+            z[k] = (0 == i) ? _mm256_mul_epu32(a, b) : MAC(z[k], a, b);
+        }
+
+#pragma GCC unroll 10
+        for (j = 0; j < 10; ++j)
+        {
+            FE4_BARRIER(z[j]);
+        }
+    }
+
+#pragma GCC unroll 10
+    for (i = 0; i < 10; ++i)
+    {
+        h->v[i] = z[i];
+    }
+
+    fe4_carry(h);
+}
+
+/**
+ * Limb i of 2p.  Subtracting a reduced limb from it negates the limb without
+ * going below zero.
+ */
+static CURVE25519_AVX2_TARGET __m256i fe4_two_p(int i)
+{
+    if (0 == i)
+    {
+        return _mm256_set1_epi64x(TWO_P0);
+    }
+
+    return _mm256_set1_epi64x((i & 1) ? TWO_P_ODD : TWO_P_EVEN);
+}
+
+/**
+ * r = 2 * p, for extended points.
+ *
+ * With S1 = X^2, S2 = Y^2, S3 = Z^2 and S4 = (X + Y)^2, the result is
+ * (S8 S9 : S5 S6 : S8 S6 : S5 S9), where S5 = S1 + S2, S6 = S1 - S2,
+ * S8 = S6 + 2 S3 and S9 = S5 - S4.
+ */
+static CURVE25519_AVX2_TARGET void ge4_dbl(fe4* r, const fe4* p)
+{
+    fe4 t, s;
+    int i;
+
+    /* t = (X, Y, Z, X + Y) */
+    for (i = 0; i < 10; ++i)
+    {
+        __m256i x = p->v[i];
+        __m256i y =
+            _mm256_add_epi64(
+                _mm256_permute4x64_epi64(x, LANES(A_, B_, C_, A_)),
+                _mm256_permute4x64_epi64(x, LANES(A_, B_, C_, B_)));
+
+        t.v[i] = _mm256_blend_epi32(x, y, LANE_D);
+    }
+
+    /* t = (S1, S2, S3, S4) */
+    fe4_sq(&t, &t);
+
+    /* s = (S1, S1, S1, S1) + (S2, -S2, -S2, S2) + (0, 0, 2 S3, -S4)
+     *   = (S5, S6, S8, S9) */
+    for (i = 0; i < 10; ++i)
+    {
+        __m256i x = t.v[i];
+        __m256i s1 = _mm256_permute4x64_epi64(x, LANES(A_, A_, A_, A_));
+        __m256i s2 = _mm256_permute4x64_epi64(x, LANES(B_, B_, B_, B_));
+        __m256i u, w;
+
+        u = _mm256_sub_epi64(fe4_two_p(i), s2);
+        u = _mm256_blend_epi32(s2, u, LANE_B | LANE_C);
+        w = _mm256_sub_epi64(fe4_two_p(i), x);
+        w = _mm256_blend_epi32(_mm256_add_epi64(x, x), w, LANE_D);
+        w = _mm256_blend_epi32(w, _mm256_setzero_si256(), LANE_A | LANE_B);
+
+        s.v[i] = _mm256_add_epi64(_mm256_add_epi64(s1, u), w);
+    }
+
+    fe4_carry(&s);
+
+    /* (S8, S5, S8, S5) * (S9, S6, S6, S9) */
+    for (i = 0; i < 10; ++i)
+    {
+        __m256i x = s.v[i];
+
+        t.v[i] = _mm256_permute4x64_epi64(x, LANES(C_, A_, C_, A_));
+        s.v[i] = _mm256_permute4x64_epi64(x, LANES(D_, B_, B_, D_));
+    }
+
+    fe4_mul(r, &t, &s);
+}
+
+/**
+ * t = (Y - X, Y + X, Z, T), for an extended point p.
+ */
+static CURVE25519_AVX2_TARGET void ge4_sum_diff(fe4* t, const fe4* p)
+{
+    int i;
+
+    for (i = 0; i < 10; ++i)
+    {
+        __m256i x = p->v[i];
+        __m256i y = _mm256_permute4x64_epi64(x, LANES(B_, B_, C_, D_));
+        __m256i u = _mm256_permute4x64_epi64(x, LANES(A_, A_, A_, A_));
+
+        u = _mm256_blend_epi32(u, _mm256_sub_epi64(fe4_two_p(i), u), LANE_A);
+        u = _mm256_blend_epi32(u, _mm256_setzero_si256(), LANE_C | LANE_D);
+
+        t->v[i] = _mm256_add_epi64(y, u);
+    }
+}
+
+/**
+ * r = p + q, for an extended point p and a cached point q.
+ *
+ * The cached point holds (Y - X, Y + X, 2Z, 2dT).  With the products
+ * (A, B, C, D) = ((Y1 - X1)(Y2 - X2), (Y1 + X1)(Y2 + X2), 2 Z1 Z2,
+ * 2d T1 T2), and E = B - A, H = B + A, G = C + D, F = C - D, the result is
+ * (E F : H G : G F : E H).
+ */
+static CURVE25519_AVX2_TARGET void ge4_add(
+    fe4* r, const fe4* p, const fe4* q)
+{
+    fe4 t, s;
+    int i;
+
+    /* t = (A, B, C, D) */
+    ge4_sum_diff(&t, p);
+    fe4_mul(&t, &t, q);
+
+    /* (E, H, G, F) = (B, A, D, C) + (-A, B, C, -D), and then
+     * (E, H, G, E) * (F, G, F, H). */
+    for (i = 0; i < 10; ++i)
+    {
+        __m256i x = t.v[i];
+        __m256i y = _mm256_permute4x64_epi64(x, LANES(B_, A_, D_, C_));
+
+        x = _mm256_blend_epi32(
+                x, _mm256_sub_epi64(fe4_two_p(i), x), LANE_A | LANE_D);
+        x = _mm256_add_epi64(x, y);
+
+        s.v[i] = _mm256_permute4x64_epi64(x, LANES(A_, B_, C_, A_));
+        t.v[i] = _mm256_permute4x64_epi64(x, LANES(D_, C_, D_, B_));
+    }
+
+    fe4_mul(r, &s, &t);
+}
+
+/**
+ * r = (Y - X, Y + X, 2Z, 2dT), the cached form of the extended point p.
+ */
+static CURVE25519_AVX2_TARGET void ge4_to_cached(fe4* r, const fe4* p)
+{
+    fe4 t, k;
+    int i;
+
+    ge4_sum_diff(&t, p);
+
+    /* k = (1, 1, 2, 2d) */
+    for (i = 0; i < 10; ++i)
+    {
+        k.v[i] = _mm256_set_epi64x(kD2[i], 0, 0, 0);
+    }
+    k.v[0] = _mm256_set_epi64x(kD2[0], 2, 1, 1);
+
+    fe4_mul(r, &t, &k);
+}
+
+/**
+ * r = -q, for a cached point q: (Y + X, Y - X, 2Z, -2dT).
+ */
+static CURVE25519_AVX2_TARGET void ge4_cached_neg(fe4* r, const fe4* q)
+{
+    int i;
+
+    for (i = 0; i < 10; ++i)
+    {
+        __m256i x =
+            _mm256_permute4x64_epi64(q->v[i], LANES(B_, A_, C_, D_));
+
+        r->v[i] =
+            _mm256_blend_epi32(
+                x, _mm256_sub_epi64(fe4_two_p(i), x), LANE_D);
+    }
+}
+
+#endif /*CURVE25519_HAVE_AVX2*/
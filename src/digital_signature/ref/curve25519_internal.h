@@ -21,11 +21,30 @@
 
 #include <stdint.h>
 
+#ifdef __cplusplus
+extern "C" {
+#endif /*__cplusplus*/
+
+/* 64-bit targets with 128-bit products use five 51-bit limbs, and everything
+ * else, e.g. ARMv7 and wasm32, uses ten 25.5-bit limbs.  Define
+ * CURVE25519_NO_64BIT to build the 32-bit field code on a 64-bit target. */
+#if defined(__SIZEOF_INT128__) && UINTPTR_MAX > 0xffffffffU && \
+    !defined(CURVE25519_NO_64BIT)
+#define CURVE25519_64BIT 1
+#endif
+
+#if defined(CURVE25519_64BIT)
+/* fe means field element. Here the field is \Z/(2^255-19). An element t,
+ * entries t[0]...t[4], represents the integer t[0]+2^51 t[1]+2^102 t[2]+2^153
+ * t[3]+2^204 t[4]. Each t[i] is a little over 51 bits between operations. */
+typedef uint64_t fe[5];
+#else
 /* fe means field element. Here the field is \Z/(2^255-19). An element t,
  * entries t[0]...t[9], represents the integer t[0]+2^26 t[1]+2^51 t[2]+2^77
  * t[3]+2^102 t[4]+...+2^230 t[9]. Bounds on each t[i] vary depending on
  * context.  */
 typedef int32_t fe[10];
+#endif
 
 /* ge means group element.
 
@@ -78,7 +97,11 @@ typedef struct
 } ge_cached;
 
 void x25519_ge_tobytes(uint8_t* s, const ge_p2* h);
+void x25519_ge_p3_0(ge_p3* h);
+void x25519_ge_p3_dbl(ge_p1p1* r, const ge_p3* p);
+void x25519_ge_mul_by_cofactor(ge_p2* r, const ge_p2* p);
 int x25519_ge_frombytes_vartime(ge_p3* h, const uint8_t* s);
+int x25519_ge_is_canonical(const uint8_t* s);
 void x25519_ge_p3_to_cached(ge_cached* r, const ge_p3* p);
 void x25519_ge_p1p1_to_p2(ge_p2* r, const ge_p1p1* p);
 void x25519_ge_p1p1_to_p3(ge_p3* r, const ge_p1p1* p);
@@ -89,6 +112,23 @@ void x25519_ge_scalarmult_small_precomp(ge_p3* h, const uint8_t a[32],
 void x25519_ge_scalarmult_base(ge_p3* h, const uint8_t a[32]);
 void x25519_ge_scalarmult(ge_p2* r, const uint8_t* scalar, const ge_p3* A);
 void x25519_sc_reduce(uint8_t* s);
+void x25519_sc_muladd(
+    uint8_t* s, const uint8_t* a, const uint8_t* b, const uint8_t* c);
+void x25519_slide(signed char* r, const uint8_t* a);
+void x25519_ge_double_scalarmult_vartime(
+    ge_p2* r, const uint8_t* a, const ge_p3* A, const uint8_t* b);
+void x25519_ge_double_scalarmult_vartime_generic(
+    ge_p2* r, const uint8_t* a, const ge_p3* A, const uint8_t* b);
+
+/* Ai = A, 3A, 5A, ..., 15A, the table used for the sliding window of A. */
+void x25519_ge_odd_multiples(ge_cached Ai[8], const ge_p3* A);
+
+/* r = a * A + b * B, as x25519_ge_double_scalarmult_vartime, for a point A
+ * given by its table of odd multiples. */
+void x25519_ge_double_scalarmult_vartime_table(
+    ge_p2* r, const uint8_t* a, const ge_cached Ai[8], const uint8_t* b);
+void x25519_ge_double_scalarmult_vartime_table_generic(
+    ge_p2* r, const uint8_t* a, const ge_cached Ai[8], const uint8_t* b);
 
 void x25519_public_from_private(uint8_t out_public_value[32],
     const uint8_t private_key[32]);
@@ -98,4 +138,32 @@ void x25519_scalar_mult(uint8_t out[32], const uint8_t scalar[32],
 void x25519_scalar_mult_generic(uint8_t out[32], const uint8_t scalar[32],
     const uint8_t point[32]);
 
+/* The AVX2 point arithmetic is available on x86-64 builds using the 64-bit
+ * field code, and is selected at runtime when the CPU supports it. */
+#if defined(CURVE25519_64BIT) && defined(__GNUC__) && \
+    (defined(__x86_64) || defined(__x86_64__))
+#define CURVE25519_HAVE_AVX2 1
+
+/* Returns non-zero if this CPU and OS support the AVX2 point arithmetic. */
+int curve25519_avx2_capable(void);
+
+/* r = a * A + b * B, where B is the base point and Bi holds its odd multiples
+ * B, 3B, ..., 15B. */
+void x25519_ge_double_scalarmult_vartime_avx2(ge_p2* r, const uint8_t* a,
+    const ge_p3* A, const uint8_t* b, const ge_precomp Bi[8]);
+
+/* The same, for a point A given by its odd multiples A, 3A, ..., 15A. */
+void x25519_ge_double_scalarmult_vartime_table_avx2(ge_p2* r,
+    const uint8_t* a, const ge_cached Ai[8], const uint8_t* b,
+    const ge_precomp Bi[8]);
+
+/* Run the X25519 ladder for the clamped scalar e and the point x1, leaving
+ * the projective result in x2 and z2. */
+void x25519_ladder_avx2(fe x2, fe z2, const uint8_t e[32], const fe x1);
+#endif
+
+#ifdef __cplusplus
+}
+#endif /*__cplusplus*/
+
 #endif  //PRIVATE_CURVE25519_INTERNAL_HEADER_GUARD
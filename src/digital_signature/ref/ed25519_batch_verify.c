@@ -0,0 +1,794 @@
+/**
+ * \file ed25519_batch_verify.c
+ *
+ * Verify a batch of ed25519 signatures with one multi-scalar multiplication.
+ *
+ * A signature (R, S) on message M under public key A is checked against
+ * [8]([S]B - R - [h]A) == 0, where h = SHA-512(R || A || M).  Given random
+ * 128-bit weights z_i, a whole batch is checked at once with
+ *
+ *     [8]([-sum(z_i S_i)]B + sum([z_i]R_i) + sum([z_i h_i]A_i)) == 0
+ *
+ * which is a single multi-scalar multiplication of 2n + 1 points.  A forged
+ * signature passes this with probability 2^-128.  Small batches use Straus'
+ * interleaved sliding windows, and larger batches use Pippenger's bucket
+ * method, whose cost per point falls as the batch grows.  When a batch fails,
+ * it is split in half until the bad signatures are found.
+ *
+ * The batch equation includes the cofactor, so a signature gets the same
+ * result in any batch.  ED25519_verify() checks the same cofactored equation,
+ * so a signature whose R or A has a small-order component gets the same result
+ * on its own as in a batch.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <cbmc/model_assert.h>
+#include <stdbool.h>
+#include <string.h>
+#include <vccrypt/digital_signature.h>
+#include <vccrypt/hash.h>
+#include <vpr/allocator.h>
+#include <vpr/parameters.h>
+
+#include "curve25519.h"
+#include "curve25519_internal.h"
+
+/**
+ * \brief Batches with at least this many points use Pippenger's method.
+ */
+#define ED25519_BATCH_PIPPENGER_POINTS 190
+
+/**
+ * \brief The number of bytes in each random weight.
+ */
+#define ED25519_BATCH_WEIGHT_SIZE 16
+
+/**
+ * \brief A signature in the batch, decoded and weighted.
+ */
+typedef struct ed25519_batch_item
+{
+    ge_p3 R;
+    ge_p3 A;
+    uint8_t z[32];
+    uint8_t zs[32];
+    uint8_t zh[32];
+    size_t index;
+} ed25519_batch_item_t;
+
+/**
+ * \brief The state shared by all of the checks of one batch.
+ */
+typedef struct ed25519_batch
+{
+    allocator_options_t* alloc_opts;
+    const ge_p3** points;
+    const uint8_t** scalars;
+    ge_p3 base;
+    uint8_t* results;
+} ed25519_batch_t;
+
+/* l - 1, which is -1 mod l. */
+static const uint8_t ed25519_minus_one[32] = {
+    0xec, 0xd3, 0xf5, 0x5c, 0x1a, 0x63, 0x12, 0x58, 0xd6, 0x9c, 0xf7, 0xa2,
+    0xde, 0xf9, 0xde, 0x14, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x10 };
+
+static const uint8_t ed25519_one[32] = { 1 };
+static const uint8_t ed25519_zero[32] = { 0 };
+
+/* forward decls */
+static int ed25519_batch_decode(
+    ed25519_batch_item_t* item, const uint8_t* message, size_t message_len,
+    const uint8_t* signature, const uint8_t* public_key,
+    vccrypt_hash_options_t* sha512_opts, bool* valid);
+static int ed25519_batch_check(
+    ed25519_batch_t* batch, const ed25519_batch_item_t* items, size_t count,
+    bool* valid);
+static int ed25519_batch_find_invalid(
+    ed25519_batch_t* batch, const ed25519_batch_item_t* items, size_t count);
+static void ed25519_batch_mark_valid(
+    ed25519_batch_t* batch, const ed25519_batch_item_t* items, size_t count);
+static int ed25519_msm_straus(
+    ge_p3* r, allocator_options_t* alloc_opts, const ge_p3* const* points,
+    const uint8_t* const* scalars, size_t n);
+static int ed25519_msm_pippenger(
+    ge_p3* r, allocator_options_t* alloc_opts, const ge_p3* const* points,
+    const uint8_t* const* scalars, size_t n);
+static void ed25519_msm_recode(
+    signed char* digits, const uint8_t* scalar, unsigned int c,
+    size_t windows);
+static bool ed25519_is_small_order(const ge_p3* p);
+
+/**
+ * \brief Verify a batch of ed25519 signatures.
+ *
+ * \param messages      Array of count pointers to the messages.
+ * \param message_lens  Array of count message lengths.
+ * \param signatures    Array of count 64-byte signatures.
+ * \param public_keys   Array of count 32-byte public keys.
+ * \param count         The number of signatures.
+ * \param results       Cleared bitmap that receives a set bit for each valid
+ *                      signature.
+ * \param prng_ctx      The PRNG used for the batch weights.
+ * \param sha512_opts   The SHA-512 options to use.
+ *
+ * \returns 0 on success and non-zero on failure.
+ */
+int ED25519_batch_verify(
+    const uint8_t* const* messages, const size_t* message_lens,
+    const vccrypt_buffer_t* signatures, const vccrypt_buffer_t* public_keys,
+    size_t count, uint8_t* results, vccrypt_prng_context_t* prng_ctx,
+    vccrypt_hash_options_t* sha512_opts)
+{
+    int retval;
+    ed25519_batch_t batch;
+    ed25519_batch_item_t* items;
+    uint8_t* weights;
+    size_t n = 0;
+    bool valid;
+
+    MODEL_ASSERT(count > 0);
+    MODEL_ASSERT(NULL != messages);
+    MODEL_ASSERT(NULL != message_lens);
+    MODEL_ASSERT(NULL != signatures);
+    MODEL_ASSERT(NULL != public_keys);
+    MODEL_ASSERT(NULL != results);
+    MODEL_ASSERT(NULL != prng_ctx);
+    MODEL_ASSERT(NULL != sha512_opts);
+
+    memset(&batch, 0, sizeof(batch));
+    batch.alloc_opts = sha512_opts->alloc_opts;
+    batch.results = results;
+
+    items =
+        (ed25519_batch_item_t*)
+            allocate(batch.alloc_opts, count * sizeof(ed25519_batch_item_t));
+    weights =
+        (uint8_t*)allocate(batch.alloc_opts, count * ED25519_BATCH_WEIGHT_SIZE);
+    batch.points =
+        (const ge_p3**)
+            allocate(batch.alloc_opts, (2 * count + 1) * sizeof(ge_p3*));
+    batch.scalars =
+        (const uint8_t**)
+            allocate(batch.alloc_opts, (2 * count + 1) * sizeof(uint8_t*));
+    if (NULL == items || NULL == weights || NULL == batch.points ||
+        NULL == batch.scalars)
+    {
+        retval = VCCRYPT_ERROR_DIGITAL_SIGNATURE_BATCH_VERIFY_OUT_OF_MEMORY;
+        goto cleanup;
+    }
+
+    /* the weights must be unknown to whoever made the signatures. */
+    retval =
+        vccrypt_prng_read_c(
+            prng_ctx, weights, count * ED25519_BATCH_WEIGHT_SIZE);
+    if (VCCRYPT_STATUS_SUCCESS != retval)
+    {
+        goto cleanup;
+    }
+
+    /* decode each signature, leaving out the ones that can't be valid. */
+    for (size_t i = 0; i < count; ++i)
+    {
+        ed25519_batch_item_t* item = items + n;
+
+        memset(item->z, 0, sizeof(item->z));
+        memcpy(
+            item->z, weights + i * ED25519_BATCH_WEIGHT_SIZE,
+            ED25519_BATCH_WEIGHT_SIZE);
+
+        retval =
+            ed25519_batch_decode(
+                item, messages[i], message_lens[i],
+                (const uint8_t*)signatures[i].data,
+                (const uint8_t*)public_keys[i].data, sha512_opts, &valid);
+        if (VCCRYPT_STATUS_SUCCESS != retval)
+        {
+            goto cleanup;
+        }
+
+        if (valid)
+        {
+            item->index = i;
+            ++n;
+        }
+    }
+
+    if (0 == n)
+    {
+        retval = VCCRYPT_STATUS_SUCCESS;
+        goto cleanup;
+    }
+
+    x25519_ge_scalarmult_base(&batch.base, ed25519_one);
+
+    retval = ed25519_batch_check(&batch, items, n, &valid);
+    if (VCCRYPT_STATUS_SUCCESS != retval)
+    {
+        goto cleanup;
+    }
+
+    if (valid)
+    {
+        ed25519_batch_mark_valid(&batch, items, n);
+    }
+    else
+    {
+        retval = ed25519_batch_find_invalid(&batch, items, n);
+    }
+
+cleanup:
+    if (NULL != batch.scalars)
+    {
+        release(batch.alloc_opts, batch.scalars);
+    }
+
+    if (NULL != batch.points)
+    {
+        release(batch.alloc_opts, batch.points);
+    }
+
+    if (NULL != weights)
+    {
+        release(batch.alloc_opts, weights);
+    }
+
+    if (NULL != items)
+    {
+        release(batch.alloc_opts, items);
+    }
+
+    return retval;
+}
+
+/**
+ * Decode a signature and its public key, and compute its weighted scalars.
+ *
+ * \param item          The item to fill in.  Its weight is already set.
+ * \param message       The message.
+ * \param message_len   The length of the message.
+ * \param signature     The 64-byte signature.
+ * \param public_key    The 32-byte public key.
+ * \param sha512_opts   The SHA-512 options to use.
+ * \param valid         Set to false if the signature can't be valid.
+ *
+ * \returns 0 on success and non-zero on failure.
+ */
+static int ed25519_batch_decode(
+    ed25519_batch_item_t* item, const uint8_t* message, size_t message_len,
+    const uint8_t* signature, const uint8_t* public_key,
+    vccrypt_hash_options_t* sha512_opts, bool* valid)
+{
+    vccrypt_hash_context_t sha512_ctx;
+    vccrypt_buffer_t h_buf;
+    uint8_t h[64];
+    int retval;
+
+    *valid = false;
+
+    /* ED25519_verify() only accepts an R in canonical form. */
+    if ((signature[63] & 224) != 0 || !x25519_ge_is_canonical(signature) ||
+        0 != x25519_ge_frombytes_vartime(&item->A, public_key) ||
+        0 != x25519_ge_frombytes_vartime(&item->R, signature))
+    {
+        return VCCRYPT_STATUS_SUCCESS;
+    }
+
+    /* h = SHA-512(R || A || M).  The digest buffer borrows h, so it is never
+     * disposed. */
+    memset(&h_buf, 0, sizeof(h_buf));
+    h_buf.data = h;
+    h_buf.size = sizeof(h);
+
+    retval = vccrypt_hash_init(sha512_opts, &sha512_ctx);
+    if (VCCRYPT_STATUS_SUCCESS != retval)
+    {
+        return retval;
+    }
+
+    retval = vccrypt_hash_digest(&sha512_ctx, signature, 32);
+    if (VCCRYPT_STATUS_SUCCESS != retval)
+    {
+        goto cleanup;
+    }
+
+    retval = vccrypt_hash_digest(&sha512_ctx, public_key, 32);
+    if (VCCRYPT_STATUS_SUCCESS != retval)
+    {
+        goto cleanup;
+    }
+
+    if (message_len > 0)
+    {
+        retval = vccrypt_hash_digest(&sha512_ctx, message, message_len);
+        if (VCCRYPT_STATUS_SUCCESS != retval)
+        {
+            goto cleanup;
+        }
+    }
+
+    retval = vccrypt_hash_finalize(&sha512_ctx, &h_buf);
+    if (VCCRYPT_STATUS_SUCCESS != retval)
+    {
+        goto cleanup;
+    }
+
+    x25519_sc_reduce(h);
+
+    /* z * S and z * h, mod l. */
+    x25519_sc_muladd(item->zs, item->z, signature + 32, ed25519_zero);
+    x25519_sc_muladd(item->zh, item->z, h, ed25519_zero);
+
+    *valid = true;
+
+cleanup:
+    dispose((disposable_t*)&sha512_ctx);
+
+    return retval;
+}
+
+/**
+ * Check the batch equation for some of the items of a batch.
+ *
+ * \param batch         The batch.
+ * \param items         The items to check.
+ * \param count         The number of items.
+ * \param valid         Set to true if the items all pass.
+ *
+ * \returns 0 on success and non-zero on failure.
+ */
+static int ed25519_batch_check(
+    ed25519_batch_t* batch, const ed25519_batch_item_t* items, size_t count,
+    bool* valid)
+{
+    uint8_t sum[32];
+    uint8_t b[32];
+    ge_p3 q;
+    size_t n = 2 * count + 1;
+    int retval;
+
+    /* b = -sum(z_i S_i) mod l */
+    memset(sum, 0, sizeof(sum));
+    for (size_t i = 0; i < count; ++i)
+    {
+        x25519_sc_muladd(sum, ed25519_one, items[i].zs, sum);
+    }
+    x25519_sc_muladd(b, sum, ed25519_minus_one, ed25519_zero);
+
+    batch->points[0] = &batch->base;
+    batch->scalars[0] = b;
+    for (size_t i = 0; i < count; ++i)
+    {
+        batch->points[2 * i + 1] = &items[i].R;
+        batch->scalars[2 * i + 1] = items[i].z;
+        batch->points[2 * i + 2] = &items[i].A;
+        batch->scalars[2 * i + 2] = items[i].zh;
+    }
+
+    if (n < ED25519_BATCH_PIPPENGER_POINTS)
+    {
+        retval =
+            ed25519_msm_straus(
+                &q, batch->alloc_opts, batch->points, batch->scalars, n);
+    }
+    else
+    {
+        retval =
+            ed25519_msm_pippenger(
+                &q, batch->alloc_opts, batch->points, batch->scalars, n);
+    }
+
+    if (VCCRYPT_STATUS_SUCCESS == retval)
+    {
+        *valid = ed25519_is_small_order(&q);
+    }
+
+    return retval;
+}
+
+/**
+ * Find the invalid signatures of a batch that is known to fail, by splitting
+ * it in half until each part either passes or holds a single signature.
+ *
+ * \param batch         The batch.
+ * \param items         The items that failed together.
+ * \param count         The number of items.
+ *
+ * \returns 0 on success and non-zero on failure.
+ */
+static int ed25519_batch_find_invalid(
+    ed25519_batch_t* batch, const ed25519_batch_item_t* items, size_t count)
+{
+    size_t half = count / 2;
+    bool valid;
+    int retval;
+
+    if (count == 1)
+    {
+        return VCCRYPT_STATUS_SUCCESS;
+    }
+
+    retval = ed25519_batch_check(batch, items, half, &valid);
+    if (VCCRYPT_STATUS_SUCCESS != retval)
+    {
+        return retval;
+    }
+
+    if (valid)
+    {
+        /* the bad signatures are all in the second half. */
+        ed25519_batch_mark_valid(batch, items, half);
+
+        return
+            ed25519_batch_find_invalid(
+                batch, items + half, count - half);
+    }
+
+    retval = ed25519_batch_find_invalid(batch, items, half);
+    if (VCCRYPT_STATUS_SUCCESS != retval)
+    {
+        return retval;
+    }
+
+    retval = ed25519_batch_check(batch, items + half, count - half, &valid);
+    if (VCCRYPT_STATUS_SUCCESS != retval)
+    {
+        return retval;
+    }
+
+    if (valid)
+    {
+        ed25519_batch_mark_valid(batch, items + half, count - half);
+
+        return VCCRYPT_STATUS_SUCCESS;
+    }
+
+    return ed25519_batch_find_invalid(batch, items + half, count - half);
+}
+
+/**
+ * Set the result bit of each item.
+ *
+ * \param batch         The batch.
+ * \param items         The valid items.
+ * \param count         The number of items.
+ */
+static void ed25519_batch_mark_valid(
+    ed25519_batch_t* batch, const ed25519_batch_item_t* items, size_t count)
+{
+    for (size_t i = 0; i < count; ++i)
+    {
+        size_t index = items[i].index;
+
+        batch->results[index / 8] |= (uint8_t)(1U << (index % 8));
+    }
+}
+
+/**
+ * Compute r = sum([scalars[i]]points[i]) by Straus' method, with a shared
+ * chain of doublings and a sliding window of odd multiples for each point.
+ *
+ * \param r             The result.
+ * \param alloc_opts    The allocator to use.
+ * \param points        The points.
+ * \param scalars       The 32-byte scalars, each below 2^253.
+ * \param n             The number of points.
+ *
+ * \returns 0 on success and non-zero on failure.
+ */
+static int ed25519_msm_straus(
+    ge_p3* r, allocator_options_t* alloc_opts, const ge_p3* const* points,
+    const uint8_t* const* scalars, size_t n)
+{
+    ge_cached* tables;
+    signed char* digits;
+    ge_p1p1 t;
+    int top = -1;
+    int retval;
+
+    tables = (ge_cached*)allocate(alloc_opts, n * 8 * sizeof(ge_cached));
+    digits = (signed char*)allocate(alloc_opts, n * 256);
+    if (NULL == tables || NULL == digits)
+    {
+        retval = VCCRYPT_ERROR_DIGITAL_SIGNATURE_BATCH_VERIFY_OUT_OF_MEMORY;
+        goto cleanup;
+    }
+
+    /* P, 3P, 5P, ..., 15P for each point. */
+    for (size_t j = 0; j < n; ++j)
+    {
+        x25519_ge_odd_multiples(tables + 8 * j, points[j]);
+
+        x25519_slide(digits + 256 * j, scalars[j]);
+        for (int i = 255; i > top; --i)
+        {
+            if (digits[256 * j + i])
+            {
+                top = i;
+            }
+        }
+    }
+
+    x25519_ge_p3_0(r);
+
+    for (int i = top; i >= 0; --i)
+    {
+        x25519_ge_p3_dbl(&t, r);
+        x25519_ge_p1p1_to_p3(r, &t);
+
+        for (size_t j = 0; j < n; ++j)
+        {
+            signed char d = digits[256 * j + i];
+
+            if (d > 0)
+            {
+                x25519_ge_add(&t, r, &tables[8 * j + d / 2]);
+                x25519_ge_p1p1_to_p3(r, &t);
+            }
+            else if (d < 0)
+            {
+                x25519_ge_sub(&t, r, &tables[8 * j + (-d) / 2]);
+                x25519_ge_p1p1_to_p3(r, &t);
+            }
+        }
+    }
+
+    retval = VCCRYPT_STATUS_SUCCESS;
+
+cleanup:
+    if (NULL != digits)
+    {
+        release(alloc_opts, digits);
+    }
+
+    if (NULL != tables)
+    {
+        release(alloc_opts, tables);
+    }
+
+    return retval;
+}
+
+/**
+ * Compute r = sum([scalars[i]]points[i]) by Pippenger's bucket method.
+ *
+ * The scalars are split into signed c-bit digits.  For each window, every
+ * point is added to the bucket for its digit, and the buckets are summed so
+ * that bucket k counts k times.  Each point costs one addition per window,
+ * and the buckets cost about 2^c additions per window.
+ *
+ * \param r             The result.
+ * \param alloc_opts    The allocator to use.
+ * \param points        The points.
+ * \param scalars       The 32-byte scalars, each below 2^253.
+ * \param n             The number of points.
+ *
+ * \returns 0 on success and non-zero on failure.
+ */
+static int ed25519_msm_pippenger(
+    ge_p3* r, allocator_options_t* alloc_opts, const ge_p3* const* points,
+    const uint8_t* const* scalars, size_t n)
+{
+    ge_cached* cached;
+    signed char* digits;
+    ge_p3* buckets;
+    bool* used;
+    ge_cached c_tmp;
+    ge_p1p1 t;
+    ge_p3 running;
+    ge_p3 sum;
+    unsigned int c = 4;
+    int retval;
+
+    /* about log2(n) - 2 bits per window. */
+    while (c < 8 && ((size_t)1 << (c + 3)) <= n)
+    {
+        ++c;
+    }
+
+    size_t bucket_count = (size_t)1 << (c - 1);
+    size_t windows = (253 + c - 1) / c + 1;
+
+    cached = (ge_cached*)allocate(alloc_opts, n * sizeof(ge_cached));
+    digits = (signed char*)allocate(alloc_opts, n * windows);
+    buckets = (ge_p3*)allocate(alloc_opts, bucket_count * sizeof(ge_p3));
+    used = (bool*)allocate(alloc_opts, bucket_count * sizeof(bool));
+    if (NULL == cached || NULL == digits || NULL == buckets || NULL == used)
+    {
+        retval = VCCRYPT_ERROR_DIGITAL_SIGNATURE_BATCH_VERIFY_OUT_OF_MEMORY;
+        goto cleanup;
+    }
+
+    for (size_t j = 0; j < n; ++j)
+    {
+        x25519_ge_p3_to_cached(&cached[j], points[j]);
+        ed25519_msm_recode(digits + windows * j, scalars[j], c, windows);
+    }
+
+    x25519_ge_p3_0(r);
+
+    for (size_t w = windows; w-- > 0;)
+    {
+        if (w + 1 < windows)
+        {
+            for (unsigned int k = 0; k < c; ++k)
+            {
+                x25519_ge_p3_dbl(&t, r);
+                x25519_ge_p1p1_to_p3(r, &t);
+            }
+        }
+
+        memset(used, 0, bucket_count * sizeof(bool));
+
+        /* add each point to the bucket for its digit. */
+        for (size_t j = 0; j < n; ++j)
+        {
+            int d = digits[windows * j + w];
+            size_t b;
+
+            if (0 == d)
+            {
+                continue;
+            }
+
+            b = (size_t)((d > 0) ? d : -d) - 1;
+            if (!used[b])
+            {
+                x25519_ge_p3_0(&buckets[b]);
+                used[b] = true;
+            }
+
+            if (d > 0)
+            {
+                x25519_ge_add(&t, &buckets[b], &cached[j]);
+            }
+            else
+            {
+                x25519_ge_sub(&t, &buckets[b], &cached[j]);
+            }
+            x25519_ge_p1p1_to_p3(&buckets[b], &t);
+        }
+
+        /* sum = sum((b + 1) * buckets[b]), as a running sum from the top. */
+        bool have_running = false;
+        bool have_sum = false;
+        for (size_t b = bucket_count; b-- > 0;)
+        {
+            if (used[b])
+            {
+                if (have_running)
+                {
+                    x25519_ge_p3_to_cached(&c_tmp, &buckets[b]);
+                    x25519_ge_add(&t, &running, &c_tmp);
+                    x25519_ge_p1p1_to_p3(&running, &t);
+                }
+                else
+                {
+                    memcpy(&running, &buckets[b], sizeof(running));
+                    have_running = true;
+                }
+            }
+
+            if (have_running)
+            {
+                if (have_sum)
+                {
+                    x25519_ge_p3_to_cached(&c_tmp, &running);
+                    x25519_ge_add(&t, &sum, &c_tmp);
+                    x25519_ge_p1p1_to_p3(&sum, &t);
+                }
+                else
+                {
+                    memcpy(&sum, &running, sizeof(sum));
+                    have_sum = true;
+                }
+            }
+        }
+
+        if (have_sum)
+        {
+            x25519_ge_p3_to_cached(&c_tmp, &sum);
+            x25519_ge_add(&t, r, &c_tmp);
+            x25519_ge_p1p1_to_p3(r, &t);
+        }
+    }
+
+    retval = VCCRYPT_STATUS_SUCCESS;
+
+cleanup:
+    if (NULL != used)
+    {
+        release(alloc_opts, used);
+    }
+
+    if (NULL != buckets)
+    {
+        release(alloc_opts, buckets);
+    }
+
+    if (NULL != digits)
+    {
+        release(alloc_opts, digits);
+    }
+
+    if (NULL != cached)
+    {
+        release(alloc_opts, cached);
+    }
+
+    return retval;
+}
+
+/**
+ * Split a scalar into signed c-bit digits, from -2^(c-1) to 2^(c-1) - 1.
+ *
+ * \param digits        The digits, least significant first.
+ * \param scalar        The 32-byte scalar, below 2^253.
+ * \param c             The number of bits in each digit, at most 8.
+ * \param windows       The number of digits, enough to absorb the carry.
+ */
+static void ed25519_msm_recode(
+    signed char* digits, const uint8_t* scalar, unsigned int c,
+    size_t windows)
+{
+    int carry = 0;
+
+    for (size_t w = 0; w < windows; ++w)
+    {
+        size_t bit = w * c;
+        unsigned int v = 0;
+
+        if (bit < 256)
+        {
+            size_t byte = bit / 8;
+
+            v = scalar[byte];
+            if (byte + 1 < 32)
+            {
+                v |= (unsigned int)scalar[byte + 1] << 8;
+            }
+            v = (v >> (bit % 8)) & ((1U << c) - 1);
+        }
+
+        int d = (int)v + carry;
+        if (d >= (1 << (c - 1)))
+        {
+            d -= 1 << c;
+            carry = 1;
+        }
+        else
+        {
+            carry = 0;
+        }
+
+        digits[w] = (signed char)d;
+    }
+}
+
+/**
+ * Check whether [8]p is the identity.
+ *
+ * \param p             The point.
+ *
+ * \returns true if p has small order.
+ */
+static bool ed25519_is_small_order(const ge_p3* p)
+{
+    static const uint8_t identity[32] = { 1 };
+    uint8_t s[32];
+    ge_p1p1 t;
+    ge_p3 q;
+    ge_p2 r;
+
+    x25519_ge_p3_dbl(&t, p);
+    x25519_ge_p1p1_to_p3(&q, &t);
+    x25519_ge_p3_dbl(&t, &q);
+    x25519_ge_p1p1_to_p3(&q, &t);
+    x25519_ge_p3_dbl(&t, &q);
+    x25519_ge_p1p1_to_p2(&r, &t);
+    x25519_ge_tobytes(s, &r);
+
+    return 0 == memcmp(s, identity, sizeof(s));
+}
@@ -0,0 +1,148 @@
+/**
+ * \file vccrypt_digital_signature_batch_verify.c
+ *
+ * Verify a batch of signatures using a digital signature scheme.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <cbmc/model_assert.h>
+#include <string.h>
+#include <vccrypt/digital_signature.h>
+#include <vpr/parameters.h>
+
+/* forward decls */
+static int vccrypt_digital_signature_batch_verify_each(
+    vccrypt_digital_signature_context_t* context,
+    const vccrypt_buffer_t* signatures, const vccrypt_buffer_t* pubs,
+    const uint8_t* const* messages, const size_t* sizes, size_t count,
+    uint8_t* results);
+
+/**
+ * \brief Verify a batch of signatures.
+ *
+ * Item \p i is valid if \p signatures[i] is a valid signature of
+ * \p messages[i] under \p pubs[i].  Algorithms that support it check the
+ * whole batch at once, which is much cheaper per signature than
+ * vccrypt_digital_signature_verify() for large batches.  If the batch as a
+ * whole fails, it is narrowed down to the bad signatures.
+ *
+ * The result for item \p i is bit (i % 8) of \p results[i / 8], which is set
+ * if the signature is valid and clear otherwise.  A success status only means
+ * that the batch was processed; the caller must check the bitmap.
+ *
+ * \param context       The digital signature instance.  Its PRNG is used to
+ *                      weight the signatures of the batch.
+ * \param signatures    Array of \p count signatures.
+ * \param pubs          Array of \p count public keys.
+ * \param messages      Array of \p count pointers to the messages.  A pointer
+ *                      may only be NULL if its size is 0.
+ * \param sizes         Array of \p count message sizes, in bytes.
+ * \param count         The number of signatures to verify.
+ * \param results       Bitmap of (count + 7) / 8 bytes to receive the result
+ *                      for each signature.
+ *
+ * \returns a status indicating success or failure.
+ *      - \ref VCCRYPT_STATUS_SUCCESS if the batch was processed.
+ *      - \ref VCCRYPT_ERROR_DIGITAL_SIGNATURE_BATCH_VERIFY_INVALID_ARG if an
+ *             invalid argument is provided.
+ *      - \ref VCCRYPT_ERROR_DIGITAL_SIGNATURE_BATCH_VERIFY_OUT_OF_MEMORY if
+ *             the batch could not be allocated.
+ *      - a non-zero return code on error.
+ */
+int vccrypt_digital_signature_batch_verify(
+    vccrypt_digital_signature_context_t* context,
+    const vccrypt_buffer_t* signatures, const vccrypt_buffer_t* pubs,
+    const uint8_t* const* messages, const size_t* sizes, size_t count,
+    uint8_t* results)
+{
+    MODEL_ASSERT(context != NULL);
+    MODEL_ASSERT(context->options != NULL);
+    MODEL_ASSERT(
+        context->options->vccrypt_digital_signature_alg_verify != NULL);
+    MODEL_ASSERT(count == 0 || signatures != NULL);
+    MODEL_ASSERT(count == 0 || pubs != NULL);
+    MODEL_ASSERT(count == 0 || messages != NULL);
+    MODEL_ASSERT(count == 0 || sizes != NULL);
+    MODEL_ASSERT(count == 0 || results != NULL);
+
+    /* sanity check on parameters */
+    if (context == NULL || context->options == NULL ||
+        context->options->vccrypt_digital_signature_alg_verify == NULL ||
+        (count > 0 &&
+         (signatures == NULL || pubs == NULL || messages == NULL ||
+          sizes == NULL || results == NULL)))
+    {
+        return VCCRYPT_ERROR_DIGITAL_SIGNATURE_BATCH_VERIFY_INVALID_ARG;
+    }
+
+    /* check each item before verifying any of them. */
+    for (size_t i = 0; i < count; ++i)
+    {
+        if (signatures[i].data == NULL ||
+            signatures[i].size != context->options->signature_size ||
+            pubs[i].data == NULL ||
+            pubs[i].size != context->options->public_key_size ||
+            (messages[i] == NULL && sizes[i] > 0))
+        {
+            return VCCRYPT_ERROR_DIGITAL_SIGNATURE_BATCH_VERIFY_INVALID_ARG;
+        }
+    }
+
+    if (0 == count)
+    {
+        return VCCRYPT_STATUS_SUCCESS;
+    }
+
+    /* every item starts out as invalid. */
+    memset(results, 0, (count + 7) / 8);
+
+    /* use the batch implementation if this algorithm has one. */
+    if (context->options->vccrypt_digital_signature_alg_batch_verify != NULL)
+    {
+        return
+            context->options->vccrypt_digital_signature_alg_batch_verify(
+                context, signatures, pubs, messages, sizes, count, results);
+    }
+
+    return
+        vccrypt_digital_signature_batch_verify_each(
+            context, signatures, pubs, messages, sizes, count, results);
+}
+
+/**
+ * Verify each signature of a batch in turn.
+ *
+ * \param context       The digital signature instance.
+ * \param signatures    Array of signatures.
+ * \param pubs          Array of public keys.
+ * \param messages      Array of pointers to the messages.
+ * \param sizes         Array of message sizes, in bytes.
+ * \param count         The number of signatures.
+ * \param results       Bitmap receiving a set bit for each valid signature.
+ *
+ * \returns \ref VCCRYPT_STATUS_SUCCESS on success and non-zero on failure.
+ */
+static int vccrypt_digital_signature_batch_verify_each(
+    vccrypt_digital_signature_context_t* context,
+    const vccrypt_buffer_t* signatures, const vccrypt_buffer_t* pubs,
+    const uint8_t* const* messages, const size_t* sizes, size_t count,
+    uint8_t* results)
+{
+    static const uint8_t empty[1] = { 0 };
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        const uint8_t* message = (messages[i] != NULL) ? messages[i] : empty;
+
+        /* an invalid signature is a result, not an error. */
+        if (VCCRYPT_STATUS_SUCCESS ==
+                context->options->vccrypt_digital_signature_alg_verify(
+                    context, signatures + i, pubs + i, message, sizes[i]))
+        {
+            results[i / 8] |= (uint8_t)(1U << (i % 8));
+        }
+    }
+
+    return VCCRYPT_STATUS_SUCCESS;
+}
@@ -0,0 +1,65 @@
+/**
+ * \file vccrypt_digital_signature_expand_private_key.c
+ *
+ * Expand a private key for repeated signing.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <cbmc/model_assert.h>
+#include <string.h>
+#include <vccrypt/digital_signature.h>
+#include <vpr/parameters.h>
+
+/**
+ * \brief Expand a private key for repeated signing.
+ *
+ * \param context       The digital signature instance.
+ * \param expanded      The buffer to receive the expanded private key.  Its
+ *                      size must be expanded_private_key_size.
+ * \param priv          The private key to expand.
+ *
+ * \returns a status indicating success or failure.
+ *      - \ref VCCRYPT_STATUS_SUCCESS on success.
+ *      - \ref VCCRYPT_ERROR_DIGITAL_SIGNATURE_EXPAND_PRIVATE_KEY_INVALID_ARG
+ *             if an invalid argument is provided.
+ *      - a non-zero error code indicating failure.
+ */
+int vccrypt_digital_signature_expand_private_key(
+    vccrypt_digital_signature_context_t* context, vccrypt_buffer_t* expanded,
+    const vccrypt_buffer_t* priv)
+{
+    MODEL_ASSERT(context != NULL);
+    MODEL_ASSERT(context->options != NULL);
+    MODEL_ASSERT(expanded != NULL);
+    MODEL_ASSERT(expanded->data != NULL);
+    MODEL_ASSERT(
+        expanded->size == context->options->expanded_private_key_size);
+    MODEL_ASSERT(priv != NULL);
+    MODEL_ASSERT(priv->data != NULL);
+    MODEL_ASSERT(priv->size == context->options->private_key_size);
+
+    /* sanity check on parameters */
+    if (context == NULL || context->options == NULL ||
+        expanded == NULL || expanded->data == NULL ||
+        expanded->size != context->options->expanded_private_key_size ||
+        priv == NULL || priv->data == NULL ||
+        priv->size != context->options->private_key_size)
+    {
+        return VCCRYPT_ERROR_DIGITAL_SIGNATURE_EXPAND_PRIVATE_KEY_INVALID_ARG;
+    }
+
+    /* use the algorithm's expansion if it has one. */
+    if (NULL !=
+            context->options->vccrypt_digital_signature_alg_expand_private_key)
+    {
+        return
+            context->options->vccrypt_digital_signature_alg_expand_private_key(
+                context, expanded, priv);
+    }
+
+    /* otherwise, the expanded key is the private key. */
+    memcpy(expanded->data, priv->data, priv->size);
+
+    return VCCRYPT_STATUS_SUCCESS;
+}
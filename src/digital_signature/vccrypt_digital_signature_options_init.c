@@ -63,6 +63,18 @@ int vccrypt_digital_signature_options_init(
     /* the context structure is the options structure to copy. */
     memcpy(options, reg->context, sizeof(vccrypt_digital_signature_options_t));
 
+    /* without an expanded form, the expanded key is the private key. */
+    if (NULL == options->vccrypt_digital_signature_alg_expand_private_key)
+    {
+        options->expanded_private_key_size = options->private_key_size;
+    }
+
+    /* likewise, without a prepared form, the prepared key is the public key. */
+    if (NULL == options->vccrypt_digital_signature_alg_prepare_public_key)
+    {
+        options->prepared_public_key_size = options->public_key_size;
+    }
+
     /* set the allocator. */
     options->alloc_opts = alloc_opts;
 
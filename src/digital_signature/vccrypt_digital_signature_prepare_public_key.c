@@ -0,0 +1,65 @@
+/**
+ * \file vccrypt_digital_signature_prepare_public_key.c
+ *
+ * Prepare a public key for repeated verification.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <cbmc/model_assert.h>
+#include <string.h>
+#include <vccrypt/digital_signature.h>
+#include <vpr/parameters.h>
+
+/**
+ * \brief Prepare a public key for repeated verification.
+ *
+ * \param context       The digital signature instance.
+ * \param prepared      The buffer to receive the prepared public key.  Its
+ *                      size must be prepared_public_key_size.
+ * \param pub           The public key to prepare.
+ *
+ * \returns a status indicating success or failure.
+ *      - \ref VCCRYPT_STATUS_SUCCESS on success.
+ *      - \ref VCCRYPT_ERROR_DIGITAL_SIGNATURE_PREPARE_PUBLIC_KEY_INVALID_ARG
+ *             if an invalid argument is provided.
+ *      - a non-zero error code indicating failure.
+ */
+int vccrypt_digital_signature_prepare_public_key(
+    vccrypt_digital_signature_context_t* context, vccrypt_buffer_t* prepared,
+    const vccrypt_buffer_t* pub)
+{
+    MODEL_ASSERT(context != NULL);
+    MODEL_ASSERT(context->options != NULL);
+    MODEL_ASSERT(prepared != NULL);
+    MODEL_ASSERT(prepared->data != NULL);
+    MODEL_ASSERT(
+        prepared->size == context->options->prepared_public_key_size);
+    MODEL_ASSERT(pub != NULL);
+    MODEL_ASSERT(pub->data != NULL);
+    MODEL_ASSERT(pub->size == context->options->public_key_size);
+
+    /* sanity check on parameters */
+    if (context == NULL || context->options == NULL ||
+        prepared == NULL || prepared->data == NULL ||
+        prepared->size != context->options->prepared_public_key_size ||
+        pub == NULL || pub->data == NULL ||
+        pub->size != context->options->public_key_size)
+    {
+        return VCCRYPT_ERROR_DIGITAL_SIGNATURE_PREPARE_PUBLIC_KEY_INVALID_ARG;
+    }
+
+    /* use the algorithm's preparation if it has one. */
+    if (NULL !=
+            context->options->vccrypt_digital_signature_alg_prepare_public_key)
+    {
+        return
+            context->options->vccrypt_digital_signature_alg_prepare_public_key(
+                context, prepared, pub);
+    }
+
+    /* otherwise, the prepared key is the public key. */
+    memcpy(prepared->data, pub->data, pub->size);
+
+    return VCCRYPT_STATUS_SUCCESS;
+}
@@ -0,0 +1,144 @@
+/**
+ * \file vccrypt_digital_signature_public_key_cache_init.c
+ *
+ * Initialize a cache of prepared public keys.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <cbmc/model_assert.h>
+#include <string.h>
+#include <vccrypt/digital_signature.h>
+#include <vpr/allocator.h>
+#include <vpr/parameters.h>
+
+#include "digital_signature_private.h"
+
+/* forward decls */
+static void vccrypt_digital_signature_public_key_cache_dispose(void* cache);
+
+/**
+ * \brief Initialize a cache of prepared public keys.
+ *
+ * If initialization is successful, then this cache is owned by the caller and
+ * must be disposed by calling dispose() when no longer needed.  The digital
+ * signature instance must outlive the cache.
+ *
+ * \param cache         The cache to initialize.
+ * \param context       The digital signature instance to use.
+ * \param capacity      The maximum number of public keys to keep.
+ *
+ * \returns a status indicating success or failure.
+ *      - \ref VCCRYPT_STATUS_SUCCESS on success.
+ *      - \ref VCCRYPT_ERROR_DIGITAL_SIGNATURE_PUBLIC_KEY_CACHE_INIT_INVALID_ARG
+ *             if an invalid argument is provided.
+ *      - \ref VCCRYPT_ERROR_DIGITAL_SIGNATURE_PUBLIC_KEY_CACHE_OUT_OF_MEMORY
+ *             if the cache could not be allocated.
+ */
+int vccrypt_digital_signature_public_key_cache_init(
+    vccrypt_digital_signature_public_key_cache_t* cache,
+    vccrypt_digital_signature_context_t* context, size_t capacity)
+{
+    vccrypt_public_key_cache_state_t* state;
+    size_t buckets, slot_size, entries_size, buckets_size, alloc_size;
+
+    MODEL_ASSERT(cache != NULL);
+    MODEL_ASSERT(context != NULL);
+    MODEL_ASSERT(context->options != NULL);
+    MODEL_ASSERT(context->options->alloc_opts != NULL);
+    MODEL_ASSERT(capacity > 0);
+
+    /* sanity check on parameters */
+    if (cache == NULL || context == NULL || context->options == NULL ||
+        context->options->alloc_opts == NULL || capacity == 0)
+    {
+        return
+            VCCRYPT_ERROR_DIGITAL_SIGNATURE_PUBLIC_KEY_CACHE_INIT_INVALID_ARG;
+    }
+
+    /* refuse sizes that would overflow the allocation size. */
+    slot_size =
+        context->options->public_key_size +
+        context->options->prepared_public_key_size;
+    if (capacity >= SIZE_MAX / 4 / (slot_size + 2 * sizeof(*state->entries)))
+    {
+        return VCCRYPT_ERROR_DIGITAL_SIGNATURE_PUBLIC_KEY_CACHE_OUT_OF_MEMORY;
+    }
+
+    /* the smallest power of two that is at least the capacity. */
+    for (buckets = 1; buckets < capacity;)
+    {
+        buckets *= 2;
+    }
+
+    entries_size = capacity * sizeof(vccrypt_public_key_cache_entry_t);
+    buckets_size = buckets * sizeof(size_t);
+    alloc_size =
+        sizeof(vccrypt_public_key_cache_state_t) + entries_size +
+        buckets_size + (capacity + 1) * slot_size;
+
+    state =
+        (vccrypt_public_key_cache_state_t*)allocate(
+            context->options->alloc_opts, alloc_size);
+    if (NULL == state)
+    {
+        return VCCRYPT_ERROR_DIGITAL_SIGNATURE_PUBLIC_KEY_CACHE_OUT_OF_MEMORY;
+    }
+
+    /* carve the allocation up. */
+    memset(state, 0, alloc_size);
+    state->alloc_size = alloc_size;
+    state->entries = (vccrypt_public_key_cache_entry_t*)(state + 1);
+    state->buckets = (size_t*)(state->entries + capacity);
+    state->bucket_mask = buckets - 1;
+    state->keys = (uint8_t*)(state->buckets + buckets);
+    state->prepared =
+        state->keys + (capacity + 1) * context->options->public_key_size;
+    state->spare_slot = capacity;
+    state->count = 0;
+    state->lru_head = VCCRYPT_PUBLIC_KEY_CACHE_NONE;
+    state->lru_tail = VCCRYPT_PUBLIC_KEY_CACHE_NONE;
+
+    /* each entry starts out with its own slot, and the last is spare. */
+    for (size_t i = 0; i < capacity; ++i)
+    {
+        state->entries[i].slot = i;
+    }
+
+    for (size_t i = 0; i < buckets; ++i)
+    {
+        state->buckets[i] = VCCRYPT_PUBLIC_KEY_CACHE_NONE;
+    }
+
+    memset(cache, 0, sizeof(vccrypt_digital_signature_public_key_cache_t));
+    cache->hdr.dispose = &vccrypt_digital_signature_public_key_cache_dispose;
+    cache->context = context;
+    cache->capacity = capacity;
+    cache->cache_state = state;
+
+    return VCCRYPT_STATUS_SUCCESS;
+}
+
+/**
+ * Dispose of a public key cache.
+ *
+ * \param cache             The opaque pointer to this cache.
+ */
+static void vccrypt_digital_signature_public_key_cache_dispose(void* cache)
+{
+    vccrypt_digital_signature_public_key_cache_t* c =
+        (vccrypt_digital_signature_public_key_cache_t*)cache;
+    vccrypt_public_key_cache_state_t* state =
+        (vccrypt_public_key_cache_state_t*)c->cache_state;
+
+    MODEL_ASSERT(c != NULL);
+    MODEL_ASSERT(c->context != NULL);
+    MODEL_ASSERT(state != NULL);
+
+    /* clear and release the state */
+    memset(state, 0, state->alloc_size);
+    release(c->context->options->alloc_opts, state);
+
+    /* clear out the structure */
+    memset(c, 0, sizeof(vccrypt_digital_signature_public_key_cache_t));
+}
@@ -18,6 +18,12 @@
 
 #include "ref/curve25519.h"
 
+/* the prepared key size is part of the interface, so it must not drift from
+ * the reference implementation. */
+typedef char vccrypt_ed25519_prepared_public_key_size_matches[
+    (ED25519_PREPARED_PUBLIC_KEY_LENGTH ==
+        VCCRYPT_DIGITAL_SIGNATURE_ED25519_PREPARED_PUBLIC_KEY_SIZE) ? 1 : -1];
+
 /* forward decls */
 static int vccrypt_ed25519_init(
     void* options, void* context);
@@ -30,6 +36,20 @@ static int vccrypt_ed25519_verify(
     const vccrypt_buffer_t* pub, const uint8_t* message, size_t size);
 static int vccrypt_ed25519_keypair_create(
     void* context, vccrypt_buffer_t* priv, vccrypt_buffer_t* pub);
+static int vccrypt_ed25519_batch_verify(
+    void* context, const vccrypt_buffer_t* signatures,
+    const vccrypt_buffer_t* pubs, const uint8_t* const* messages,
+    const size_t* sizes, size_t count, uint8_t* results);
+static int vccrypt_ed25519_expand_private_key(
+    void* context, vccrypt_buffer_t* expanded, const vccrypt_buffer_t* priv);
+static int vccrypt_ed25519_sign_expanded(
+    void* context, vccrypt_buffer_t* sign_buffer,
+    const vccrypt_buffer_t* expanded, const uint8_t* data, size_t size);
+static int vccrypt_ed25519_prepare_public_key(
+    void* context, vccrypt_buffer_t* prepared, const vccrypt_buffer_t* pub);
+static int vccrypt_ed25519_verify_prepared(
+    void* context, const vccrypt_buffer_t* signature,
+    const vccrypt_buffer_t* prepared, const uint8_t* message, size_t size);
 
 /* static data for this instance */
 static abstract_factory_registration_t ed25519_impl;
@@ -63,6 +83,10 @@ void vccrypt_digital_signature_register_ed25519()
         VCCRYPT_DIGITAL_SIGNATURE_ED25519_PRIVATE_KEY_SIZE;
     ed25519_options.public_key_size =
         VCCRYPT_DIGITAL_SIGNATURE_ED25519_PUBLIC_KEY_SIZE;
+    ed25519_options.expanded_private_key_size =
+        VCCRYPT_DIGITAL_SIGNATURE_ED25519_EXPANDED_PRIVATE_KEY_SIZE;
+    ed25519_options.prepared_public_key_size =
+        VCCRYPT_DIGITAL_SIGNATURE_ED25519_PREPARED_PUBLIC_KEY_SIZE;
     ed25519_options.vccrypt_digital_signature_alg_init =
         &vccrypt_ed25519_init;
     ed25519_options.vccrypt_digital_signature_alg_dispose =
@@ -73,6 +97,16 @@ void vccrypt_digital_signature_register_ed25519()
         &vccrypt_ed25519_verify;
     ed25519_options.vccrypt_digital_signature_alg_keypair_create =
         &vccrypt_ed25519_keypair_create;
+    ed25519_options.vccrypt_digital_signature_alg_batch_verify =
+        &vccrypt_ed25519_batch_verify;
+    ed25519_options.vccrypt_digital_signature_alg_expand_private_key =
+        &vccrypt_ed25519_expand_private_key;
+    ed25519_options.vccrypt_digital_signature_alg_sign_expanded =
+        &vccrypt_ed25519_sign_expanded;
+    ed25519_options.vccrypt_digital_signature_alg_prepare_public_key =
+        &vccrypt_ed25519_prepare_public_key;
+    ed25519_options.vccrypt_digital_signature_alg_verify_prepared =
+        &vccrypt_ed25519_verify_prepared;
 
     /* set up this registration for the abstract factory. */
     ed25519_impl.interface =
@@ -214,3 +248,132 @@ static int vccrypt_ed25519_keypair_create(
 
     return retval;
 }
+
+/**
+ * Verify a batch of signatures with a single multi-scalar multiplication.
+ *
+ * \param context       An opaque pointer to the
+ *                      vccrypt_digital_signature_context_t structure.
+ * \param signatures    Array of signatures.
+ * \param pubs          Array of public keys.
+ * \param messages      Array of pointers to the messages.
+ * \param sizes         Array of message sizes, in bytes.
+ * \param count         The number of signatures.
+ * \param results       Bitmap receiving a set bit for each valid signature.
+ *
+ * \returns 0 on success and non-zero on failure.
+ */
+static int vccrypt_ed25519_batch_verify(
+    void* context, const vccrypt_buffer_t* signatures,
+    const vccrypt_buffer_t* pubs, const uint8_t* const* messages,
+    const size_t* sizes, size_t count, uint8_t* results)
+{
+    vccrypt_digital_signature_context_t* ctx =
+        (vccrypt_digital_signature_context_t*)context;
+    int retval = VCCRYPT_STATUS_SUCCESS;
+
+    /* create a PRNG context for the batch weights. */
+    vccrypt_prng_context_t prng_ctx;
+    retval = vccrypt_prng_init(ctx->options->prng_opts, &prng_ctx);
+    if (VCCRYPT_STATUS_SUCCESS != retval)
+    {
+        return retval;
+    }
+
+    retval =
+        ED25519_batch_verify(
+            messages, sizes, signatures, pubs, count, results, &prng_ctx,
+            &ctx->hash_opts);
+
+    /* dispose of the prng */
+    dispose((disposable_t*)&prng_ctx);
+
+    return retval;
+}
+
+/**
+ * Expand a private key into the clamped scalar, the nonce prefix, and the
+ * public key.
+ *
+ * \param context       An opaque pointer to the
+ *                      vccrypt_digital_signature_context_t structure.
+ * \param expanded      The buffer to receive the expanded private key.
+ * \param priv          The private key to expand.
+ *
+ * \returns 0 on success and non-zero on failure.
+ */
+static int vccrypt_ed25519_expand_private_key(
+    void* context, vccrypt_buffer_t* expanded, const vccrypt_buffer_t* priv)
+{
+    vccrypt_digital_signature_context_t* ctx =
+        (vccrypt_digital_signature_context_t*)context;
+
+    return ED25519_expand_private_key((uint8_t*)expanded->data,
+        (const uint8_t*)priv->data, &ctx->hash_opts);
+}
+
+/**
+ * Sign a message with an expanded private key.
+ *
+ * \param context       An opaque pointer to the
+ *                      vccrypt_digital_signature_context_t structure.
+ * \param sign_buffer   The buffer to receive the signature.
+ * \param expanded      The expanded private key to use for the signature.
+ * \param message       The input message.
+ * \param size          The size of the message in bytes.
+ *
+ * \returns 0 on success and non-zero on failure.
+ */
+static int vccrypt_ed25519_sign_expanded(
+    void* context, vccrypt_buffer_t* sign_buffer,
+    const vccrypt_buffer_t* expanded, const uint8_t* data, size_t size)
+{
+    vccrypt_digital_signature_context_t* ctx =
+        (vccrypt_digital_signature_context_t*)context;
+
+    return ED25519_sign_expanded((uint8_t*)sign_buffer->data, data, size,
+        (const uint8_t*)expanded->data, &ctx->hash_opts);
+}
+
+/**
+ * Prepare a public key by decompressing it and computing the odd multiples of
+ * its point.
+ *
+ * \param context       An opaque pointer to the
+ *                      vccrypt_digital_signature_context_t structure.
+ * \param prepared      The buffer to receive the prepared public key.
+ * \param pub           The public key to prepare.
+ *
+ * \returns 0 on success and non-zero on failure.
+ */
+static int vccrypt_ed25519_prepare_public_key(
+    void* UNUSED(context), vccrypt_buffer_t* prepared,
+    const vccrypt_buffer_t* pub)
+{
+    return ED25519_prepare_public_key((uint8_t*)prepared->data,
+        (const uint8_t*)pub->data);
+}
+
+/**
+ * Verify a message with a prepared public key.
+ *
+ * \param context       An opaque pointer to the
+ *                      vccrypt_digital_signature_context_t structure.
+ * \param signature     The signature to verify.
+ * \param prepared      The prepared public key.
+ * \param message       The input message.
+ * \param size          The size of the message in bytes.
+ *
+ * \returns 0 if the message signature is valid, and non-zero otherwise.
+ */
+static int vccrypt_ed25519_verify_prepared(
+    void* context, const vccrypt_buffer_t* signature,
+    const vccrypt_buffer_t* prepared, const uint8_t* message, size_t size)
+{
+    vccrypt_digital_signature_context_t* ctx =
+        (vccrypt_digital_signature_context_t*)context;
+
+    return ED25519_verify_prepared(message, size,
+        (const uint8_t*)signature->data, (const uint8_t*)prepared->data,
+        &ctx->hash_opts);
+}
@@ -0,0 +1,72 @@
+/**
+ * \file vccrypt_digital_signature_sign_expanded.c
+ *
+ * Sign a message using an expanded private key.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <cbmc/model_assert.h>
+#include <string.h>
+#include <vccrypt/digital_signature.h>
+#include <vpr/parameters.h>
+
+/**
+ * \brief Sign a message with an expanded private key.
+ *
+ * \param context       The digital signature instance.
+ * \param sign_buffer   The buffer to receive the signature.  Must be large
+ *                      enough for the given digital signature algorithm.
+ * \param expanded      The expanded private key, from
+ *                      vccrypt_digital_signature_expand_private_key().
+ * \param message       The input message.
+ * \param message_size  The size of the message in bytes.
+ *
+ * \returns a status indicating success or failure.
+ *      - \ref VCCRYPT_STATUS_SUCCESS on success.
+ *      - \ref VCCRYPT_ERROR_DIGITAL_SIGNATURE_SIGN_EXPANDED_INVALID_ARG if an
+ *             invalid argument is provided.
+ *      - a non-zero error code indicating failure.
+ */
+int vccrypt_digital_signature_sign_expanded(
+    vccrypt_digital_signature_context_t* context, vccrypt_buffer_t* sign_buffer,
+    const vccrypt_buffer_t* expanded, const uint8_t* message,
+    size_t message_size)
+{
+    MODEL_ASSERT(context != NULL);
+    MODEL_ASSERT(context->options != NULL);
+    MODEL_ASSERT(context->options->vccrypt_digital_signature_alg_sign != NULL);
+    MODEL_ASSERT(sign_buffer != NULL);
+    MODEL_ASSERT(sign_buffer->data != NULL);
+    MODEL_ASSERT(sign_buffer->size >= context->options->signature_size);
+    MODEL_ASSERT(expanded != NULL);
+    MODEL_ASSERT(expanded->data != NULL);
+    MODEL_ASSERT(
+        expanded->size == context->options->expanded_private_key_size);
+    MODEL_ASSERT(message != NULL);
+
+    /* sanity check on parameters */
+    if (context == NULL || context->options == NULL ||
+        context->options->vccrypt_digital_signature_alg_sign == NULL ||
+        sign_buffer == NULL || sign_buffer->data == NULL ||
+        sign_buffer->size < context->options->signature_size ||
+        expanded == NULL || expanded->data == NULL ||
+        expanded->size != context->options->expanded_private_key_size ||
+        message == NULL)
+    {
+        return VCCRYPT_ERROR_DIGITAL_SIGNATURE_SIGN_EXPANDED_INVALID_ARG;
+    }
+
+    /* use the algorithm's expanded signing if it has one. */
+    if (NULL != context->options->vccrypt_digital_signature_alg_sign_expanded)
+    {
+        return
+            context->options->vccrypt_digital_signature_alg_sign_expanded(
+                context, sign_buffer, expanded, message, message_size);
+    }
+
+    /* otherwise, the expanded key is the private key. */
+    return
+        context->options->vccrypt_digital_signature_alg_sign(
+            context, sign_buffer, expanded, message, message_size);
+}
@@ -0,0 +1,255 @@
+/**
+ * \file vccrypt_digital_signature_verify_cached.c
+ *
+ * Verify a message, preparing the public key through a cache.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <cbmc/model_assert.h>
+#include <string.h>
+#include <vccrypt/digital_signature.h>
+#include <vpr/parameters.h>
+
+#include "digital_signature_private.h"
+
+/* forward decls */
+static size_t vccrypt_public_key_cache_bucket(
+    const vccrypt_public_key_cache_state_t* state, const uint8_t* key,
+    size_t size);
+static void vccrypt_public_key_cache_insert(
+    vccrypt_public_key_cache_state_t* state, size_t capacity,
+    size_t key_size, size_t bucket, const uint8_t* key);
+static void vccrypt_public_key_cache_lru_unlink(
+    vccrypt_public_key_cache_state_t* state, size_t index);
+static void vccrypt_public_key_cache_lru_push(
+    vccrypt_public_key_cache_state_t* state, size_t index);
+
+/**
+ * \brief Verify a message, preparing the public key through a cache.
+ *
+ * \param cache         The public key cache.
+ * \param signature     The signature to verify.
+ * \param pub           The public key to use for signature verification.
+ * \param message       The input message.
+ * \param message_size  The size of the message in bytes.
+ *
+ * \returns a status indicating success or failure.
+ *      - \ref VCCRYPT_STATUS_SUCCESS if the signature is valid.
+ *      - \ref VCCRYPT_ERROR_DIGITAL_SIGNATURE_VERIFY_CACHED_INVALID_ARG if an
+ *             invalid argument is provided.
+ *      - a non-zero error code indicating failure.
+ */
+int vccrypt_digital_signature_verify_cached(
+    vccrypt_digital_signature_public_key_cache_t* cache,
+    const vccrypt_buffer_t* signature, const vccrypt_buffer_t* pub,
+    const uint8_t* message, size_t message_size)
+{
+    MODEL_ASSERT(cache != NULL);
+    MODEL_ASSERT(cache->context != NULL);
+    MODEL_ASSERT(cache->context->options != NULL);
+    MODEL_ASSERT(cache->cache_state != NULL);
+    MODEL_ASSERT(signature != NULL);
+    MODEL_ASSERT(signature->data != NULL);
+    MODEL_ASSERT(pub != NULL);
+    MODEL_ASSERT(pub->data != NULL);
+    MODEL_ASSERT(pub->size == cache->context->options->public_key_size);
+    MODEL_ASSERT(message != NULL);
+
+    /* sanity check on parameters */
+    if (cache == NULL || cache->context == NULL ||
+        cache->context->options == NULL || cache->cache_state == NULL ||
+        signature == NULL || signature->data == NULL ||
+        pub == NULL || pub->data == NULL ||
+        pub->size != cache->context->options->public_key_size ||
+        message == NULL)
+    {
+        return VCCRYPT_ERROR_DIGITAL_SIGNATURE_VERIFY_CACHED_INVALID_ARG;
+    }
+
+    vccrypt_digital_signature_context_t* context = cache->context;
+    vccrypt_public_key_cache_state_t* state =
+        (vccrypt_public_key_cache_state_t*)cache->cache_state;
+    size_t key_size = context->options->public_key_size;
+    size_t prepared_size = context->options->prepared_public_key_size;
+    size_t bucket =
+        vccrypt_public_key_cache_bucket(state, pub->data, key_size);
+    size_t index;
+    int retval;
+
+    /* the prepared key is borrowed from the cache.  This buffer is never
+     * initialized, so it must not be disposed. */
+    vccrypt_buffer_t prepared;
+    memset(&prepared, 0, sizeof(prepared));
+    prepared.size = prepared_size;
+
+    /* look for the public key in its bucket. */
+    for (index = state->buckets[bucket];
+         index != VCCRYPT_PUBLIC_KEY_CACHE_NONE;
+         index = state->entries[index].bucket_next)
+    {
+        size_t slot = state->entries[index].slot;
+
+        if (0 == memcmp(state->keys + slot * key_size, pub->data, key_size))
+        {
+            /* it is now the most recently used. */
+            vccrypt_public_key_cache_lru_unlink(state, index);
+            vccrypt_public_key_cache_lru_push(state, index);
+
+            prepared.data = state->prepared + slot * prepared_size;
+
+            return
+                vccrypt_digital_signature_verify_prepared(
+                    context, signature, &prepared, message, message_size);
+        }
+    }
+
+    /* prepare the key in the spare slot, so that a key which fails to
+     * prepare doesn't evict anything. */
+    prepared.data = state->prepared + state->spare_slot * prepared_size;
+    retval =
+        vccrypt_digital_signature_prepare_public_key(
+            context, &prepared, pub);
+    if (VCCRYPT_STATUS_SUCCESS != retval)
+    {
+        return retval;
+    }
+
+    vccrypt_public_key_cache_insert(
+        state, cache->capacity, key_size, bucket, (const uint8_t*)pub->data);
+
+    return
+        vccrypt_digital_signature_verify_prepared(
+            context, signature, &prepared, message, message_size);
+}
+
+/**
+ * Find the hash bucket for a public key, using FNV-1a.
+ *
+ * \param state         The cache state.
+ * \param key           The public key.
+ * \param size          The size of the public key.
+ *
+ * \returns the bucket index.
+ */
+static size_t vccrypt_public_key_cache_bucket(
+    const vccrypt_public_key_cache_state_t* state, const uint8_t* key,
+    size_t size)
+{
+    uint64_t hash = 0xcbf29ce484222325ULL;
+
+    for (size_t i = 0; i < size; ++i)
+    {
+        hash ^= key[i];
+        hash *= 0x100000001b3ULL;
+    }
+
+    return (size_t)(hash ^ (hash >> 32)) & state->bucket_mask;
+}
+
+/**
+ * Add the public key prepared in the spare slot to the cache, evicting the
+ * least recently used entry if the cache is full.
+ *
+ * \param state         The cache state.
+ * \param capacity      The number of entries in the cache.
+ * \param key_size      The size of a public key.
+ * \param bucket        The hash bucket of the public key.
+ * \param key           The public key.
+ */
+static void vccrypt_public_key_cache_insert(
+    vccrypt_public_key_cache_state_t* state, size_t capacity,
+    size_t key_size, size_t bucket, const uint8_t* key)
+{
+    vccrypt_public_key_cache_entry_t* entry;
+    size_t index, slot;
+
+    if (state->count < capacity)
+    {
+        index = state->count++;
+        entry = state->entries + index;
+    }
+    else
+    {
+        /* evict the least recently used entry. */
+        index = state->lru_tail;
+        entry = state->entries + index;
+        vccrypt_public_key_cache_lru_unlink(state, index);
+
+        size_t* link =
+            state->buckets +
+                vccrypt_public_key_cache_bucket(
+                    state, state->keys + entry->slot * key_size, key_size);
+        while (*link != index)
+        {
+            link = &state->entries[*link].bucket_next;
+        }
+        *link = entry->bucket_next;
+    }
+
+    /* the spare slot becomes this entry's, and its old slot the spare. */
+    slot = state->spare_slot;
+    state->spare_slot = entry->slot;
+    entry->slot = slot;
+    memcpy(state->keys + slot * key_size, key, key_size);
+
+    entry->bucket_next = state->buckets[bucket];
+    state->buckets[bucket] = index;
+    vccrypt_public_key_cache_lru_push(state, index);
+}
+
+/**
+ * Remove an entry from the recently used list.
+ *
+ * \param state         The cache state.
+ * \param index         The entry to remove.
+ */
+static void vccrypt_public_key_cache_lru_unlink(
+    vccrypt_public_key_cache_state_t* state, size_t index)
+{
+    vccrypt_public_key_cache_entry_t* entry = state->entries + index;
+
+    if (VCCRYPT_PUBLIC_KEY_CACHE_NONE != entry->lru_prev)
+    {
+        state->entries[entry->lru_prev].lru_next = entry->lru_next;
+    }
+    else
+    {
+        state->lru_head = entry->lru_next;
+    }
+
+    if (VCCRYPT_PUBLIC_KEY_CACHE_NONE != entry->lru_next)
+    {
+        state->entries[entry->lru_next].lru_prev = entry->lru_prev;
+    }
+    else
+    {
+        state->lru_tail = entry->lru_prev;
+    }
+}
+
+/**
+ * Make an entry the most recently used.
+ *
+ * \param state         The cache state.
+ * \param index         The entry, which must not be in the list.
+ */
+static void vccrypt_public_key_cache_lru_push(
+    vccrypt_public_key_cache_state_t* state, size_t index)
+{
+    vccrypt_public_key_cache_entry_t* entry = state->entries + index;
+
+    entry->lru_prev = VCCRYPT_PUBLIC_KEY_CACHE_NONE;
+    entry->lru_next = state->lru_head;
+
+    if (VCCRYPT_PUBLIC_KEY_CACHE_NONE != state->lru_head)
+    {
+        state->entries[state->lru_head].lru_prev = index;
+    }
+    else
+    {
+        state->lru_tail = index;
+    }
+
+    state->lru_head = index;
+}
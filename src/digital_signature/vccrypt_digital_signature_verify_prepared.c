@@ -0,0 +1,73 @@
+/**
+ * \file vccrypt_digital_signature_verify_prepared.c
+ *
+ * Verify a message using a prepared public key.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <cbmc/model_assert.h>
+#include <string.h>
+#include <vccrypt/digital_signature.h>
+#include <vpr/parameters.h>
+
+/**
+ * \brief Verify a message with a prepared public key.
+ *
+ * \param context       The digital signature instance.
+ * \param signature     The signature to verify.
+ * \param prepared      The prepared public key, from
+ *                      vccrypt_digital_signature_prepare_public_key().
+ * \param message       The input message.
+ * \param message_size  The size of the message in bytes.
+ *
+ * \returns a status indicating success or failure.
+ *      - \ref VCCRYPT_STATUS_SUCCESS if the signature is valid.
+ *      - \ref VCCRYPT_ERROR_DIGITAL_SIGNATURE_VERIFY_PREPARED_INVALID_ARG if
+ *             an invalid argument is provided.
+ *      - a non-zero error code indicating failure.
+ */
+int vccrypt_digital_signature_verify_prepared(
+    vccrypt_digital_signature_context_t* context,
+    const vccrypt_buffer_t* signature, const vccrypt_buffer_t* prepared,
+    const uint8_t* message, size_t message_size)
+{
+    MODEL_ASSERT(context != NULL);
+    MODEL_ASSERT(context->options != NULL);
+    MODEL_ASSERT(
+        context->options->vccrypt_digital_signature_alg_verify != NULL);
+    MODEL_ASSERT(signature != NULL);
+    MODEL_ASSERT(signature->data != NULL);
+    MODEL_ASSERT(signature->size == context->options->signature_size);
+    MODEL_ASSERT(prepared != NULL);
+    MODEL_ASSERT(prepared->data != NULL);
+    MODEL_ASSERT(
+        prepared->size == context->options->prepared_public_key_size);
+    MODEL_ASSERT(message != NULL);
+
+    /* sanity check on parameters */
+    if (context == NULL || context->options == NULL ||
+        context->options->vccrypt_digital_signature_alg_verify == NULL ||
+        signature == NULL || signature->data == NULL ||
+        signature->size != context->options->signature_size ||
+        prepared == NULL || prepared->data == NULL ||
+        prepared->size != context->options->prepared_public_key_size ||
+        message == NULL)
+    {
+        return VCCRYPT_ERROR_DIGITAL_SIGNATURE_VERIFY_PREPARED_INVALID_ARG;
+    }
+
+    /* use the algorithm's prepared verification if it has one. */
+    if (NULL !=
+            context->options->vccrypt_digital_signature_alg_verify_prepared)
+    {
+        return
+            context->options->vccrypt_digital_signature_alg_verify_prepared(
+                context, signature, prepared, message, message_size);
+    }
+
+    /* otherwise, the prepared key is the public key. */
+    return
+        context->options->vccrypt_digital_signature_alg_verify(
+            context, signature, prepared, message, message_size);
+}
@@ -0,0 +1,93 @@
+/**
+ * \file hash_private.h
+ *
+ * Private implementation details shared by the hash registrations.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#ifndef VCCRYPT_HASH_PRIVATE_HEADER_GUARD
+#define VCCRYPT_HASH_PRIVATE_HEADER_GUARD
+
+#include <vccrypt/hash.h>
+
+#include "ref/sha256.h"
+#include "ref/sha512.h"
+
+/* make this header C++ friendly. */
+#ifdef __cplusplus
+extern "C" {
+#endif /*__cplusplus*/
+
+/**
+ * The SHA-2 family state is kept in the context's inline state storage.
+ * This fails to compile if it ever outgrows that storage.
+ */
+typedef char vccrypt_sha512_ctx_fits_inline[
+    (sizeof(SHA512_CTX) <= VCCRYPT_HASH_CONTEXT_INLINE_STATE_SIZE) ? 1 : -1];
+
+/**
+ * Likewise for the SHA-256 state.
+ */
+typedef char vccrypt_sha256_ctx_fits_inline[
+    (sizeof(SHA256_CTX) <= VCCRYPT_HASH_CONTEXT_INLINE_STATE_SIZE) ? 1 : -1];
+
+/**
+ * A message in a SHA-512 family batch.
+ */
+typedef struct vccrypt_sha512_batch_item
+{
+    /** An optional block of SHA512_CBLOCK bytes hashed before the data, or
+     * NULL. */
+    const uint8_t* prefix;
+    /** The message. */
+    const uint8_t* data;
+    /** The size of the message, in bytes. */
+    size_t size;
+    /** The memory to receive the digest. */
+    uint8_t* md;
+} vccrypt_sha512_batch_item_t;
+
+/**
+ * Hash a batch of messages with a member of the SHA-512 family, interleaving
+ * several messages across the lanes of the multi-buffer block function.
+ *
+ * Messages are fetched with the given callback as lanes become free, so the
+ * caller doesn't need to build an array of items.
+ *
+ * \param init          The SHA-512 family init function, which selects the
+ *                      initial state and digest length.
+ * \param get_item      Callback that describes the message at the given
+ *                      index.
+ * \param user          Opaque pointer passed to get_item.
+ * \param count         The number of messages to hash.
+ */
+void vccrypt_sha512_batch_run(
+    void (*init)(SHA512_CTX*),
+    void (*get_item)(
+        void* user, size_t index, vccrypt_sha512_batch_item_t* item),
+    void* user, size_t count);
+
+/**
+ * Hash a batch of messages with a member of the SHA-512 family, interleaving
+ * several messages across the lanes of the multi-buffer block function.
+ *
+ * \param init          The SHA-512 family init function, which selects the
+ *                      initial state and digest length.
+ * \param data          Array of pointers to the messages to hash.
+ * \param sizes         Array of message sizes, in bytes.
+ * \param hash_buffers  Array of buffers to receive each hash.
+ * \param count         The number of messages to hash.
+ *
+ * \returns \ref VCCRYPT_STATUS_SUCCESS on success and non-zero on failure.
+ */
+int vccrypt_sha512_batch_digest(
+    void (*init)(SHA512_CTX*), const uint8_t* const* data,
+    const size_t* sizes, vccrypt_buffer_t* hash_buffers, size_t count);
+
+/* make this header C++ friendly. */
+#ifdef __cplusplus
+}
+#endif /*__cplusplus*/
+
+#endif  //VCCRYPT_HASH_PRIVATE_HEADER_GUARD
@@ -0,0 +1,326 @@
+/**
+ * \file hash/ref/sha256.c
+ *
+ * Reference implementation of SHA-256, following the structure of the
+ * SHA-512 reference implementation.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "sha256_internal.h"
+
+/**
+ * Initialize a SHA context for SHA-256 operation.
+ *
+ * \param c     The SHA context to initialize.
+ */
+void SHA256_Init(SHA256_CTX* c)
+{
+    c->h[0] = UINT32_C(0x6a09e667);
+    c->h[1] = UINT32_C(0xbb67ae85);
+    c->h[2] = UINT32_C(0x3c6ef372);
+    c->h[3] = UINT32_C(0xa54ff53a);
+    c->h[4] = UINT32_C(0x510e527f);
+    c->h[5] = UINT32_C(0x9b05688c);
+    c->h[6] = UINT32_C(0x1f83d9ab);
+    c->h[7] = UINT32_C(0x5be0cd19);
+
+    c->N = 0;
+    c->num = 0;
+    c->md_len = SHA256_DIGEST_LENGTH;
+}
+
+/**
+ * Add the given data to a SHA-256 context.
+ *
+ * \param c     The SHA-256 context to update.
+ * \param data  A pointer to the data to digest.
+ * \param len   The length of the data to digest.
+ */
+void SHA256_Update(SHA256_CTX* c, const void* _data, size_t len)
+{
+    uint8_t* p = c->u.p;
+    const uint8_t* data = (const uint8_t*)_data;
+
+    if (len == 0)
+    {
+        return;
+    }
+
+    c->N += ((uint64_t)len) << 3;
+
+    /* top off a partially filled block first. */
+    if (c->num != 0)
+    {
+        size_t n = sizeof(c->u) - c->num;
+
+        if (len < n)
+        {
+            memcpy(p + c->num, data, len);
+            c->num += (unsigned int)len;
+            return;
+        }
+        else
+        {
+            memcpy(p + c->num, data, n);
+            c->num = 0;
+            len -= n;
+            data += n;
+            sha256_block(c, p, 1);
+        }
+    }
+
+    if (len >= sizeof(c->u))
+    {
+        sha256_block(c, data, len / sizeof(c->u));
+        data += len;
+        len %= sizeof(c->u);
+        data -= len;
+    }
+
+    if (len != 0)
+    {
+        memcpy(p, data, len);
+        c->num = (unsigned int)len;
+    }
+}
+
+/**
+ * Finalize a SHA-256 context and generate the final hash.
+ *
+ * \param c     The SHA-256 context to finalize.
+ * \param md    A pointer to a buffer to hold the SHA-256 hash.  Must be at
+ *              least 32 bytes in length.
+ *
+ * \returns 0 on success and non-zero on failure.
+ */
+int SHA256_Final(SHA256_CTX* c, uint8_t* md)
+{
+    uint8_t* p = c->u.p;
+    size_t n = c->num;
+    int i;
+
+    p[n] = 0x80; /* There always is a room for one */
+    n++;
+    if (n > (sizeof(c->u) - 8))
+    {
+        memset(p + n, 0, sizeof(c->u) - n);
+        n = 0;
+        sha256_block(c, p, 1);
+    }
+
+    memset(p + n, 0, sizeof(c->u) - 8 - n);
+
+    for (i = 0; i < 8; ++i)
+    {
+        p[sizeof(c->u) - 1 - i] = (uint8_t)(c->N >> (8 * i));
+    }
+
+    sha256_block(c, p, 1);
+
+    /* return an error if the message digest buffer is null. */
+    if (md == 0)
+    {
+        return 1;
+    }
+
+    /* unsupported message digest length. */
+    if (c->md_len != SHA256_DIGEST_LENGTH)
+    {
+        return 1;
+    }
+
+    for (i = 0; i < SHA256_DIGEST_LENGTH / 4; ++i)
+    {
+        uint32_t t = c->h[i];
+
+        *(md++) = (uint8_t)(t >> 24);
+        *(md++) = (uint8_t)(t >> 16);
+        *(md++) = (uint8_t)(t >> 8);
+        *(md++) = (uint8_t)(t);
+    }
+
+    return 0;
+}
+
+/**
+ * Digest whole blocks, using the fastest block function this CPU supports.
+ *
+ * \param ctx   The SHA-256 context to update.
+ * \param in    The blocks to digest.
+ * \param num   The number of 64 byte blocks to digest.
+ */
+void sha256_block(SHA256_CTX* ctx, const void* in, size_t num)
+{
+#ifdef SHA256_HAVE_SHANI
+    if (sha256_shani_capable())
+    {
+        sha256_block_data_order_shani(ctx, in, num);
+        return;
+    }
+#endif
+
+#ifdef SHA256_HAVE_AVX2
+    if (sha256_avx2_capable())
+    {
+        sha256_block_data_order_avx2(ctx, in, num);
+        return;
+    }
+#endif
+
+    sha256_block_data_order(ctx, in, num);
+}
+
+/**
+ * Constants for the SHA-256 block operation.
+ */
+const uint32_t sha256_K256[64] = {
+    UINT32_C(0x428a2f98), UINT32_C(0x71374491),
+    UINT32_C(0xb5c0fbcf), UINT32_C(0xe9b5dba5),
+    UINT32_C(0x3956c25b), UINT32_C(0x59f111f1),
+    UINT32_C(0x923f82a4), UINT32_C(0xab1c5ed5),
+    UINT32_C(0xd807aa98), UINT32_C(0x12835b01),
+    UINT32_C(0x243185be), UINT32_C(0x550c7dc3),
+    UINT32_C(0x72be5d74), UINT32_C(0x80deb1fe),
+    UINT32_C(0x9bdc06a7), UINT32_C(0xc19bf174),
+    UINT32_C(0xe49b69c1), UINT32_C(0xefbe4786),
+    UINT32_C(0x0fc19dc6), UINT32_C(0x240ca1cc),
+    UINT32_C(0x2de92c6f), UINT32_C(0x4a7484aa),
+    UINT32_C(0x5cb0a9dc), UINT32_C(0x76f988da),
+    UINT32_C(0x983e5152), UINT32_C(0xa831c66d),
+    UINT32_C(0xb00327c8), UINT32_C(0xbf597fc7),
+    UINT32_C(0xc6e00bf3), UINT32_C(0xd5a79147),
+    UINT32_C(0x06ca6351), UINT32_C(0x14292967),
+    UINT32_C(0x27b70a85), UINT32_C(0x2e1b2138),
+    UINT32_C(0x4d2c6dfc), UINT32_C(0x53380d13),
+    UINT32_C(0x650a7354), UINT32_C(0x766a0abb),
+    UINT32_C(0x81c2c92e), UINT32_C(0x92722c85),
+    UINT32_C(0xa2bfe8a1), UINT32_C(0xa81a664b),
+    UINT32_C(0xc24b8b70), UINT32_C(0xc76c51a3),
+    UINT32_C(0xd192e819), UINT32_C(0xd6990624),
+    UINT32_C(0xf40e3585), UINT32_C(0x106aa070),
+    UINT32_C(0x19a4c116), UINT32_C(0x1e376c08),
+    UINT32_C(0x2748774c), UINT32_C(0x34b0bcb5),
+    UINT32_C(0x391c0cb3), UINT32_C(0x4ed8aa4a),
+    UINT32_C(0x5b9cca4f), UINT32_C(0x682e6ff3),
+    UINT32_C(0x748f82ee), UINT32_C(0x78a5636f),
+    UINT32_C(0x84c87814), UINT32_C(0x8cc70208),
+    UINT32_C(0x90befffa), UINT32_C(0xa4506ceb),
+    UINT32_C(0xbef9a3f7), UINT32_C(0xc67178f2)
+};
+
+#define ROTR(x, s) (((x) >> (s)) | ((x) << (32 - (s))))
+
+#define PULL32(p) \
+    (((uint32_t)(p)[0] << 24) | ((uint32_t)(p)[1] << 16) | \
+     ((uint32_t)(p)[2] << 8) | ((uint32_t)(p)[3]))
+
+#define Sigma0(x) (ROTR((x), 2) ^ ROTR((x), 13) ^ ROTR((x), 22))
+#define Sigma1(x) (ROTR((x), 6) ^ ROTR((x), 11) ^ ROTR((x), 25))
+#define sigma0(x) (ROTR((x), 7) ^ ROTR((x), 18) ^ ((x) >> 3))
+#define sigma1(x) (ROTR((x), 17) ^ ROTR((x), 19) ^ ((x) >> 10))
+
+#define Ch(x, y, z) (((x) & (y)) ^ ((~(x)) & (z)))
+#define Maj(x, y, z) (((x) & (y)) ^ ((x) & (z)) ^ ((y) & (z)))
+
+#define ROUND_00_15(i, a, b, c, d, e, f, g, h) \
+    do \
+    { \
+        T1 += h + Sigma1(e) + Ch(e, f, g) + sha256_K256[i]; \
+        h = Sigma0(a) + Maj(a, b, c); \
+        d += T1; \
+        h += T1; \
+    } while (0)
+
+#define ROUND_16_63(i, j, a, b, c, d, e, f, g, h, X) \
+    do \
+    { \
+        s0 = X[(j + 1) & 0x0f]; \
+        s0 = sigma0(s0); \
+        s1 = X[(j + 14) & 0x0f]; \
+        s1 = sigma1(s1); \
+        T1 = X[(j)&0x0f] += s0 + s1 + X[(j + 9) & 0x0f]; \
+        ROUND_00_15(i + j, a, b, c, d, e, f, g, h); \
+    } while (0)
+
+/**
+ * Digest whole blocks using the portable block function.
+ *
+ * \param ctx   The SHA-256 context to update.
+ * \param in    The blocks to digest.
+ * \param num   The number of 64 byte blocks to digest.
+ */
+void sha256_block_data_order(SHA256_CTX* ctx, const void* in, size_t num)
+{
+    const uint8_t* W = (const uint8_t*)in;
+    uint32_t a, b, c, d, e, f, g, h, s0, s1, T1;
+    uint32_t X[16];
+    int i, j;
+
+    while (num--)
+    {
+        a = ctx->h[0];
+        b = ctx->h[1];
+        c = ctx->h[2];
+        d = ctx->h[3];
+        e = ctx->h[4];
+        f = ctx->h[5];
+        g = ctx->h[6];
+        h = ctx->h[7];
+
+        for (j = 0; j < 16; j += 8)
+        {
+            T1 = X[j + 0] = PULL32(W + 4 * (j + 0));
+            ROUND_00_15(j + 0, a, b, c, d, e, f, g, h);
+            T1 = X[j + 1] = PULL32(W + 4 * (j + 1));
+            ROUND_00_15(j + 1, h, a, b, c, d, e, f, g);
+            T1 = X[j + 2] = PULL32(W + 4 * (j + 2));
+            ROUND_00_15(j + 2, g, h, a, b, c, d, e, f);
+            T1 = X[j + 3] = PULL32(W + 4 * (j + 3));
+            ROUND_00_15(j + 3, f, g, h, a, b, c, d, e);
+            T1 = X[j + 4] = PULL32(W + 4 * (j + 4));
+            ROUND_00_15(j + 4, e, f, g, h, a, b, c, d);
+            T1 = X[j + 5] = PULL32(W + 4 * (j + 5));
+            ROUND_00_15(j + 5, d, e, f, g, h, a, b, c);
+            T1 = X[j + 6] = PULL32(W + 4 * (j + 6));
+            ROUND_00_15(j + 6, c, d, e, f, g, h, a, b);
+            T1 = X[j + 7] = PULL32(W + 4 * (j + 7));
+            ROUND_00_15(j + 7, b, c, d, e, f, g, h, a);
+        }
+
+        for (i = 16; i < 64; i += 16)
+        {
+            ROUND_16_63(i, 0, a, b, c, d, e, f, g, h, X);
+            ROUND_16_63(i, 1, h, a, b, c, d, e, f, g, X);
+            ROUND_16_63(i, 2, g, h, a, b, c, d, e, f, X);
+            ROUND_16_63(i, 3, f, g, h, a, b, c, d, e, X);
+            ROUND_16_63(i, 4, e, f, g, h, a, b, c, d, X);
+            ROUND_16_63(i, 5, d, e, f, g, h, a, b, c, X);
+            ROUND_16_63(i, 6, c, d, e, f, g, h, a, b, X);
+            ROUND_16_63(i, 7, b, c, d, e, f, g, h, a, X);
+            ROUND_16_63(i, 8, a, b, c, d, e, f, g, h, X);
+            ROUND_16_63(i, 9, h, a, b, c, d, e, f, g, X);
+            ROUND_16_63(i, 10, g, h, a, b, c, d, e, f, X);
+            ROUND_16_63(i, 11, f, g, h, a, b, c, d, e, X);
+            ROUND_16_63(i, 12, e, f, g, h, a, b, c, d, X);
+            ROUND_16_63(i, 13, d, e, f, g, h, a, b, c, X);
+            ROUND_16_63(i, 14, c, d, e, f, g, h, a, b, X);
+            ROUND_16_63(i, 15, b, c, d, e, f, g, h, a, X);
+        }
+
+        ctx->h[0] += a;
+        ctx->h[1] += b;
+        ctx->h[2] += c;
+        ctx->h[3] += d;
+        ctx->h[4] += e;
+        ctx->h[5] += f;
+        ctx->h[6] += g;
+        ctx->h[7] += h;
+
+        W += SHA256_CBLOCK;
+    }
+}
@@ -0,0 +1,67 @@
+/**
+ * \file hash/ref/sha256.h
+ *
+ * Reference implementation of SHA-256.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#ifndef HASH_REF_SHA256_HEADER_GUARD
+#define HASH_REF_SHA256_HEADER_GUARD
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif /*__cplusplus*/
+
+/**
+ * Context data structure for SHA-256.
+ */
+typedef struct SHA256state
+{
+    uint32_t h[8];
+    uint64_t N;
+    union
+    {
+        uint32_t d[16];
+        uint8_t p[64];
+    } u;
+    unsigned int num, md_len;
+} SHA256_CTX;
+
+#define SHA256_DIGEST_LENGTH 32
+
+/**
+ * Initialize a SHA context for SHA-256 operation.
+ *
+ * \param c     The SHA context to initialize.
+ */
+void SHA256_Init(SHA256_CTX* c);
+
+/**
+ * Add the given data to a SHA-256 context.
+ *
+ * \param c     The SHA-256 context to update.
+ * \param data  A pointer to the data to digest.
+ * \param len   The length of the data to digest.
+ */
+void SHA256_Update(SHA256_CTX* c, const void* _data, size_t len);
+
+/**
+ * Finalize a SHA-256 context and generate the final hash.
+ *
+ * \param c     The SHA-256 context to finalize.
+ * \param md    A pointer to a buffer to hold the SHA-256 hash.  Must be at
+ *              least 32 bytes in length.
+ *
+ * \returns 0 on success and non-zero on failure.
+ */
+int SHA256_Final(SHA256_CTX* c, uint8_t* md);
+
+#ifdef __cplusplus
+}
+#endif /*__cplusplus*/
+
+#endif  //HASH_REF_SHA256_HEADER_GUARD
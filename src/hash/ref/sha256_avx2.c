@@ -0,0 +1,213 @@
+/**
+ * \file hash/ref/sha256_avx2.c
+ *
+ * SHA-256 block function using AVX2 for the message schedule.
+ *
+ * As with the SHA-512 variant, two blocks are expanded together, one per
+ * 128-bit lane, with each lane holding four consecutive schedule words.  The
+ * expanded words are pre-added to the round constants, and the rounds stay
+ * scalar.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+#include "sha256_internal.h"
+
+#ifdef SHA256_HAVE_AVX2
+
+#include <immintrin.h>
+
+#include "../../cpu/cpu_features.h"
+
+#define SHA256_AVX2_TARGET __attribute__((target("avx2,bmi2")))
+
+/* the number of blocks expanded together. */
+#define SHA256_AVX2_LANES 2
+
+#define ROTR(x, s) (((x) >> (s)) | ((x) << (32 - (s))))
+#define Sigma0(x) (ROTR((x), 2) ^ ROTR((x), 13) ^ ROTR((x), 22))
+#define Sigma1(x) (ROTR((x), 6) ^ ROTR((x), 11) ^ ROTR((x), 25))
+#define Ch(x, y, z) (((x) & (y)) ^ ((~(x)) & (z)))
+#define Maj(x, y, z) (((x) & (y)) ^ ((x) & (z)) ^ ((y) & (z)))
+
+#define ROUND(i, a, b, c, d, e, f, g, h) \
+    do \
+    { \
+        uint32_t T1 = h + Sigma1(e) + Ch(e, f, g) + wk[i]; \
+        h = Sigma0(a) + Maj(a, b, c); \
+        d += T1; \
+        h += T1; \
+    } while (0)
+
+#define VROTR(x, s) \
+    _mm256_or_si256( \
+        _mm256_srli_epi32((x), (s)), _mm256_slli_epi32((x), 32 - (s)))
+#define vsigma0(x) \
+    _mm256_xor_si256( \
+        _mm256_xor_si256(VROTR((x), 7), VROTR((x), 18)), \
+        _mm256_srli_epi32((x), 3))
+#define vsigma1(x) \
+    _mm256_xor_si256( \
+        _mm256_xor_si256(VROTR((x), 17), VROTR((x), 19)), \
+        _mm256_srli_epi32((x), 10))
+
+/* forward decls */
+static SHA256_AVX2_TARGET void sha256_avx2_schedule(
+    uint32_t wk[SHA256_AVX2_LANES][64], const uint8_t* b0, const uint8_t* b1);
+static SHA256_AVX2_TARGET void sha256_avx2_rounds(
+    SHA256_CTX* ctx, const uint32_t* wk);
+
+/**
+ * Returns non-zero if this CPU and OS support the AVX2 block function.
+ */
+int sha256_avx2_capable(void)
+{
+    return vccrypt_cpu_supports(
+        VCCRYPT_CPU_FEATURE_AVX2 | VCCRYPT_CPU_FEATURE_BMI2);
+}
+
+/**
+ * Digest whole blocks using the AVX2 message schedule.
+ *
+ * \param ctx   The SHA-256 context to update.
+ * \param in    The blocks to digest.
+ * \param num   The number of 64 byte blocks to digest.
+ */
+void sha256_block_data_order_avx2(
+    SHA256_CTX* ctx, const void* in, size_t num)
+{
+    const uint8_t* p = (const uint8_t*)in;
+    uint32_t wk[SHA256_AVX2_LANES][64];
+
+    while (num >= SHA256_AVX2_LANES)
+    {
+        sha256_avx2_schedule(wk, p, p + SHA256_CBLOCK);
+        sha256_avx2_rounds(ctx, wk[0]);
+        sha256_avx2_rounds(ctx, wk[1]);
+
+        p += SHA256_AVX2_LANES * SHA256_CBLOCK;
+        num -= SHA256_AVX2_LANES;
+    }
+
+    /* a trailing odd block is expanded in both lanes. */
+    if (num > 0)
+    {
+        sha256_avx2_schedule(wk, p, p);
+        sha256_avx2_rounds(ctx, wk[0]);
+    }
+
+    /* the schedule is derived from the message, so don't leave it behind. */
+    memset(wk, 0, sizeof(wk));
+}
+
+/**
+ * Expand the message schedule for two blocks and add the round constants.
+ *
+ * \param wk    The expanded W + K words for each block.
+ * \param b0    The first block.
+ * \param b1    The second block.
+ */
+static SHA256_AVX2_TARGET void sha256_avx2_schedule(
+    uint32_t wk[SHA256_AVX2_LANES][64], const uint8_t* b0, const uint8_t* b1)
+{
+    /* byte swap each 32-bit word from big-endian. */
+    const __m256i bswap =
+        _mm256_set_epi8(
+            12, 13, 14, 15, 8, 9, 10, 11, 4, 5, 6, 7, 0, 1, 2, 3,
+            12, 13, 14, 15, 8, 9, 10, 11, 4, 5, 6, 7, 0, 1, 2, 3);
+    const __m256i zero = _mm256_setzero_si256();
+    __m256i x[16];
+    __m256i t, s;
+    int j;
+
+    /* x[j] holds words 4j .. 4j + 3 of b0 in the low lane and of b1 in the
+     * high lane. */
+    for (j = 0; j < 4; ++j)
+    {
+        x[j] =
+            _mm256_shuffle_epi8(
+                _mm256_loadu2_m128i(
+                    (const __m128i*)(b1 + 16 * j),
+                    (const __m128i*)(b0 + 16 * j)),
+                bswap);
+    }
+
+    /* W[t] = sigma1(W[t-2]) + W[t-7] + sigma0(W[t-15]) + W[t-16] */
+    for (j = 4; j < 16; ++j)
+    {
+        t = _mm256_add_epi32(
+                x[j - 4],
+                vsigma0(_mm256_alignr_epi8(x[j - 3], x[j - 4], 4)));
+        t = _mm256_add_epi32(t, _mm256_alignr_epi8(x[j - 1], x[j - 2], 4));
+
+        /* the first two words depend on the previous group... */
+        s = vsigma1(_mm256_shuffle_epi32(x[j - 1], 0xEE));
+        t = _mm256_add_epi32(t, _mm256_blend_epi32(s, zero, 0xCC));
+
+        /* ...and the last two depend on the first two. */
+        s = vsigma1(_mm256_shuffle_epi32(t, 0x40));
+        x[j] = _mm256_add_epi32(t, _mm256_blend_epi32(zero, s, 0xCC));
+    }
+
+    for (j = 0; j < 16; ++j)
+    {
+        t = _mm256_add_epi32(
+                x[j],
+                _mm256_broadcastsi128_si256(
+                    _mm_loadu_si128((const __m128i*)(sha256_K256 + 4 * j))));
+
+        _mm_storeu_si128(
+            (__m128i*)(wk[0] + 4 * j), _mm256_castsi256_si128(t));
+        _mm_storeu_si128(
+            (__m128i*)(wk[1] + 4 * j), _mm256_extracti128_si256(t, 1));
+    }
+}
+
+/**
+ * Run the 64 compression rounds for one block.
+ *
+ * \param ctx   The SHA-256 context to update.
+ * \param wk    The expanded W + K words for this block.
+ */
+static SHA256_AVX2_TARGET void sha256_avx2_rounds(
+    SHA256_CTX* ctx, const uint32_t* wk)
+{
+    uint32_t a, b, c, d, e, f, g, h;
+    int i;
+
+    a = ctx->h[0];
+    b = ctx->h[1];
+    c = ctx->h[2];
+    d = ctx->h[3];
+    e = ctx->h[4];
+    f = ctx->h[5];
+    g = ctx->h[6];
+    h = ctx->h[7];
+
+    /* rotate the variable names instead of the values. */
+    for (i = 0; i < 64; i += 8)
+    {
+        ROUND(i + 0, a, b, c, d, e, f, g, h);
+        ROUND(i + 1, h, a, b, c, d, e, f, g);
+        ROUND(i + 2, g, h, a, b, c, d, e, f);
+        ROUND(i + 3, f, g, h, a, b, c, d, e);
+        ROUND(i + 4, e, f, g, h, a, b, c, d);
+        ROUND(i + 5, d, e, f, g, h, a, b, c);
+        ROUND(i + 6, c, d, e, f, g, h, a, b);
+        ROUND(i + 7, b, c, d, e, f, g, h, a);
+    }
+
+    ctx->h[0] += a;
+    ctx->h[1] += b;
+    ctx->h[2] += c;
+    ctx->h[3] += d;
+    ctx->h[4] += e;
+    ctx->h[5] += f;
+    ctx->h[6] += g;
+    ctx->h[7] += h;
+}
+
+#endif /*SHA256_HAVE_AVX2*/
@@ -0,0 +1,92 @@
+/**
+ * \file hash/ref/sha256_internal.h
+ *
+ * Internal interface shared by the SHA-256 block function variants.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#ifndef HASH_REF_SHA256_INTERNAL_HEADER_GUARD
+#define HASH_REF_SHA256_INTERNAL_HEADER_GUARD
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "sha256.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif /*__cplusplus*/
+
+/**
+ * The size of a SHA-256 block, in bytes.
+ */
+#define SHA256_CBLOCK 64
+
+/**
+ * Constants for the SHA-256 block operation.
+ */
+extern const uint32_t sha256_K256[64];
+
+/**
+ * Digest whole blocks, using the fastest block function this CPU supports.
+ *
+ * \param ctx   The SHA-256 context to update.
+ * \param in    The blocks to digest.
+ * \param num   The number of 64 byte blocks to digest.
+ */
+void sha256_block(SHA256_CTX* ctx, const void* in, size_t num);
+
+/**
+ * Digest whole blocks using the portable block function.
+ *
+ * \param ctx   The SHA-256 context to update.
+ * \param in    The blocks to digest.
+ * \param num   The number of 64 byte blocks to digest.
+ */
+void sha256_block_data_order(SHA256_CTX* ctx, const void* in, size_t num);
+
+/*
+ * The AVX2 and SHA extension block functions are available on x86-64 builds,
+ * and are selected at runtime when the CPU supports them.
+ */
+#if defined(__GNUC__) && (defined(__x86_64) || defined(__x86_64__))
+#define SHA256_HAVE_AVX2 1
+#define SHA256_HAVE_SHANI 1
+
+/**
+ * Returns non-zero if this CPU and OS support the AVX2 block function.
+ */
+int sha256_avx2_capable(void);
+
+/**
+ * Digest whole blocks using the AVX2 message schedule.
+ *
+ * \param ctx   The SHA-256 context to update.
+ * \param in    The blocks to digest.
+ * \param num   The number of 64 byte blocks to digest.
+ */
+void sha256_block_data_order_avx2(
+    SHA256_CTX* ctx, const void* in, size_t num);
+
+/**
+ * Returns non-zero if this CPU supports the SHA extension block function.
+ */
+int sha256_shani_capable(void);
+
+/**
+ * Digest whole blocks using the SHA extension instructions.
+ *
+ * \param ctx   The SHA-256 context to update.
+ * \param in    The blocks to digest.
+ * \param num   The number of 64 byte blocks to digest.
+ */
+void sha256_block_data_order_shani(
+    SHA256_CTX* ctx, const void* in, size_t num);
+#endif
+
+#ifdef __cplusplus
+}
+#endif /*__cplusplus*/
+
+#endif  //HASH_REF_SHA256_INTERNAL_HEADER_GUARD
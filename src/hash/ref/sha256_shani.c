@@ -0,0 +1,112 @@
+/**
+ * \file hash/ref/sha256_shani.c
+ *
+ * SHA-256 block function using the x86 SHA extension instructions.
+ *
+ * The SHA extensions keep the state as two registers, ABEF and CDGH, and run
+ * two rounds per sha256rnds2 instruction.  The message schedule is computed
+ * four words at a time with sha256msg1 and sha256msg2.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <stdint.h>
+
+#include "sha256_internal.h"
+
+#ifdef SHA256_HAVE_SHANI
+
+#include <immintrin.h>
+
+#include "../../cpu/cpu_features.h"
+
+#define SHA256_SHANI_TARGET __attribute__((target("sha,sse4.1,ssse3")))
+
+/**
+ * Returns non-zero if this CPU supports the SHA extension block function.
+ */
+int sha256_shani_capable(void)
+{
+    return vccrypt_cpu_supports(
+        VCCRYPT_CPU_FEATURE_SHA | VCCRYPT_CPU_FEATURE_SSE4_1
+        | VCCRYPT_CPU_FEATURE_SSSE3);
+}
+
+/**
+ * Digest whole blocks using the SHA extension instructions.
+ *
+ * \param ctx   The SHA-256 context to update.
+ * \param in    The blocks to digest.
+ * \param num   The number of 64 byte blocks to digest.
+ */
+SHA256_SHANI_TARGET void sha256_block_data_order_shani(
+    SHA256_CTX* ctx, const void* in, size_t num)
+{
+    /* byte swap each 32-bit word from big-endian. */
+    const __m128i bswap =
+        _mm_set_epi8(12, 13, 14, 15, 8, 9, 10, 11, 4, 5, 6, 7, 0, 1, 2, 3);
+    const uint8_t* p = (const uint8_t*)in;
+    __m128i state0, state1, abef, cdgh, msg, tmp;
+    __m128i m[4];
+    int i;
+
+    /* rearrange the state from ABCD EFGH into ABEF CDGH. */
+    tmp = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i*)ctx->h), 0xB1);
+    state1 =
+        _mm_shuffle_epi32(_mm_loadu_si128((const __m128i*)(ctx->h + 4)), 0x1B);
+    state0 = _mm_alignr_epi8(tmp, state1, 8);
+    state1 = _mm_blend_epi16(state1, tmp, 0xF0);
+
+    while (num--)
+    {
+        abef = state0;
+        cdgh = state1;
+
+        /* each pass runs four rounds on message words 4i .. 4i + 3. */
+        for (i = 0; i < 16; ++i)
+        {
+            if (i < 4)
+            {
+                m[i] =
+                    _mm_shuffle_epi8(
+                        _mm_loadu_si128((const __m128i*)(p + 16 * i)), bswap);
+            }
+            else
+            {
+                /* W[i] from W[i-4], W[i-3], W[i-2], and W[i-1]. */
+                tmp =
+                    _mm_alignr_epi8(m[(i - 1) & 3], m[(i - 2) & 3], 4);
+                m[i & 3] =
+                    _mm_sha256msg2_epu32(
+                        _mm_add_epi32(
+                            _mm_sha256msg1_epu32(m[i & 3], m[(i - 3) & 3]),
+                            tmp),
+                        m[(i - 1) & 3]);
+            }
+
+            msg =
+                _mm_add_epi32(
+                    m[i & 3],
+                    _mm_loadu_si128((const __m128i*)(sha256_K256 + 4 * i)));
+            state1 = _mm_sha256rnds2_epu32(state1, state0, msg);
+            msg = _mm_shuffle_epi32(msg, 0x0E);
+            state0 = _mm_sha256rnds2_epu32(state0, state1, msg);
+        }
+
+        state0 = _mm_add_epi32(state0, abef);
+        state1 = _mm_add_epi32(state1, cdgh);
+
+        p += SHA256_CBLOCK;
+    }
+
+    /* rearrange the state back into ABCD EFGH. */
+    tmp = _mm_shuffle_epi32(state0, 0x1B);
+    state1 = _mm_shuffle_epi32(state1, 0xB1);
+    state0 = _mm_blend_epi16(tmp, state1, 0xF0);
+    state1 = _mm_alignr_epi8(state1, tmp, 8);
+
+    _mm_storeu_si128((__m128i*)ctx->h, state0);
+    _mm_storeu_si128((__m128i*)(ctx->h + 4), state1);
+}
+
+#endif /*SHA256_HAVE_SHANI*/
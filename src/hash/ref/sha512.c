@@ -11,7 +11,7 @@
 #include <stdlib.h>
 #include <string.h>
 
-#include "sha512.h"
+#include "sha512_internal.h"
 
 /*
  * By using __asm__ on GCC we avoid the need to compile with gnu11. 
@@ -22,9 +22,6 @@
 #define __asm__ asm
 #endif
 
-/* forward decls */
-static void sha512_block_data_order(SHA512_CTX* ctx, const void* in, size_t num);
-
 /**
  * Initialize a SHA context for SHA-384 operation.
  *
@@ -69,6 +66,28 @@ void SHA512_256_Init(SHA512_CTX* c)
     c->md_len = SHA512_256_DIGEST_LENGTH;
 }
 
+/**
+ * Initialize a SHA context for SHA-512/224 operation.
+ *
+ * \param c     The SHA context to initialize.
+ */
+void SHA512_224_Init(SHA512_CTX* c)
+{
+    c->h[0] = UINT64_C(0x8c3d37c819544da2);
+    c->h[1] = UINT64_C(0x73e1996689dcd4d6);
+    c->h[2] = UINT64_C(0x1dfab7ae32ff9c82);
+    c->h[3] = UINT64_C(0x679dd514582f9fcf);
+    c->h[4] = UINT64_C(0x0f6d2b697bd44da8);
+    c->h[5] = UINT64_C(0x77e36f7304c48942);
+    c->h[6] = UINT64_C(0x3f9d85a86a1d36c8);
+    c->h[7] = UINT64_C(0x1112e6ad91d692a1);
+
+    c->Nl = 0;
+    c->Nh = 0;
+    c->num = 0;
+    c->md_len = SHA512_224_DIGEST_LENGTH;
+}
+
 /**
  * Initialize a SHA context for SHA-512 operation.
  *
@@ -111,7 +130,7 @@ int SHA512_Final(SHA512_CTX* c, uint8_t* md)
     {
         memset(p + n, 0, sizeof(c->u) - n);
         n = 0;
-        sha512_block_data_order(c, p, 1);
+        sha512_block(c, p, 1);
     }
 
     memset(p + n, 0, sizeof(c->u) - 16 - n);
@@ -133,7 +152,7 @@ int SHA512_Final(SHA512_CTX* c, uint8_t* md)
     p[sizeof(c->u) - 15] = (uint8_t)(c->Nh >> 48);
     p[sizeof(c->u) - 16] = (uint8_t)(c->Nh >> 56);
 
-    sha512_block_data_order(c, p, 1);
+    sha512_block(c, p, 1);
 
     /* return an error if the message digest buffer is null. */
     if (md == 0)
@@ -176,6 +195,31 @@ int SHA512_Final(SHA512_CTX* c, uint8_t* md)
             }
             break;
 
+        case SHA512_224_DIGEST_LENGTH:
+            for (n = 0; n < SHA512_224_DIGEST_LENGTH / 8; n++)
+            {
+                uint64_t t = c->h[n];
+
+                *(md++) = (uint8_t)(t >> 56);
+                *(md++) = (uint8_t)(t >> 48);
+                *(md++) = (uint8_t)(t >> 40);
+                *(md++) = (uint8_t)(t >> 32);
+                *(md++) = (uint8_t)(t >> 24);
+                *(md++) = (uint8_t)(t >> 16);
+                *(md++) = (uint8_t)(t >> 8);
+                *(md++) = (uint8_t)(t);
+            }
+            {
+                /* the last 4 bytes are the top half of the next word. */
+                uint64_t t = c->h[n];
+
+                *(md++) = (uint8_t)(t >> 56);
+                *(md++) = (uint8_t)(t >> 48);
+                *(md++) = (uint8_t)(t >> 40);
+                *(md++) = (uint8_t)(t >> 32);
+            }
+            break;
+
         case SHA512_DIGEST_LENGTH:
             for (n = 0; n < SHA512_DIGEST_LENGTH / 8; n++)
             {
@@ -278,13 +322,13 @@ void SHA512_Update(SHA512_CTX* c, const void* _data, size_t len)
             c->num = 0;
             len -= n;
             data += n;
-            sha512_block_data_order(c, p, 1);
+            sha512_block(c, p, 1);
         }
     }
 
     if (len >= sizeof(c->u))
     {
-        sha512_block_data_order(c, data, len / sizeof(c->u));
+        sha512_block(c, data, len / sizeof(c->u));
         data += len;
         len %= sizeof(c->u);
         data -= len;
@@ -311,6 +355,32 @@ void SHA384_Update(SHA512_CTX* c, const void* data, size_t len)
     SHA512_Update(c, data, len);
 }
 
+/**
+ * Finalize a SHA-512/224 context and generate the final hash.
+ *
+ * \param c     The SHA-512/224 context to finalize.
+ * \param md    A pointer to a buffer to hold the SHA-512/224 hash.  Must be at
+ *              least 28 bytes in length.
+ *
+ * \returns 0 on success and non-zero on failure.
+ */
+int SHA512_224_Final(SHA512_CTX* c, uint8_t* md)
+{
+    return SHA512_Final(c, md);
+}
+
+/**
+ * Add the given data to a SHA-512/224 context.
+ *
+ * \param c     The SHA-512/224 context to update.
+ * \param data  A pointer to the data to digest.
+ * \param len   The length of the data to digest.
+ */
+void SHA512_224_Update(SHA512_CTX* c, const void* data, size_t len)
+{
+    SHA512_Update(c, data, len);
+}
+
 /**
  * Add the given data to a SHA-512/256 context.
  *
@@ -323,10 +393,30 @@ void SHA512_256_Update(SHA512_CTX* c, const void* data, size_t len)
     SHA512_Update(c, data, len);
 }
 
+/**
+ * Digest whole blocks, using the fastest block function this CPU supports.
+ *
+ * \param ctx   The SHA-512 context to update.
+ * \param in    The blocks to digest.
+ * \param num   The number of 128 byte blocks to digest.
+ */
+void sha512_block(SHA512_CTX* ctx, const void* in, size_t num)
+{
+#ifdef SHA512_HAVE_AVX2
+    if (sha512_avx2_capable())
+    {
+        sha512_block_data_order_avx2(ctx, in, num);
+        return;
+    }
+#endif
+
+    sha512_block_data_order(ctx, in, num);
+}
+
 /**
  * Constants for the SHA-512 block operation.
  */
-static const uint64_t K512[80] = {
+const uint64_t sha512_K512[80] = {
     UINT64_C(0x428a2f98d728ae22), UINT64_C(0x7137449123ef65cd),
     UINT64_C(0xb5c0fbcfec4d3b2f), UINT64_C(0xe9b5dba58189dbbc),
     UINT64_C(0x3956c25bf348b538), UINT64_C(0x59f111f1b605d019),
@@ -418,7 +508,7 @@ static const uint64_t K512[80] = {
  * This code should give better results on 32-bit CPU with less than
  * ~24 registers, both size and performance wise...
  */
-static void sha512_block_data_order(SHA512_CTX* ctx, const void* in, size_t num)
+void sha512_block_data_order(SHA512_CTX* ctx, const void* in, size_t num)
 {
     const uint64_t* W = in;
     uint64_t A, E, T;
@@ -443,7 +533,7 @@ static void sha512_block_data_order(SHA512_CTX* ctx, const void* in, size_t num)
             F[0] = A;
             F[4] = E;
             F[8] = T;
-            T += F[7] + Sigma1(E) + Ch(E, F[5], F[6]) + K512[i];
+            T += F[7] + Sigma1(E) + Ch(E, F[5], F[6]) + sha512_K512[i];
             E = F[3] + T;
             A = T + Sigma0(A) + Maj(A, F[1], F[2]);
         }
@@ -457,7 +547,7 @@ static void sha512_block_data_order(SHA512_CTX* ctx, const void* in, size_t num)
             F[0] = A;
             F[4] = E;
             F[8] = T;
-            T += F[7] + Sigma1(E) + Ch(E, F[5], F[6]) + K512[i];
+            T += F[7] + Sigma1(E) + Ch(E, F[5], F[6]) + sha512_K512[i];
             E = F[3] + T;
             A = T + Sigma0(A) + Maj(A, F[1], F[2]);
         }
@@ -477,7 +567,7 @@ static void sha512_block_data_order(SHA512_CTX* ctx, const void* in, size_t num)
 
 #elif defined(SMALL_FOOTPRINT)
 
-static void sha512_block_data_order(SHA512_CTX* ctx, const void* in, size_t num)
+void sha512_block_data_order(SHA512_CTX* ctx, const void* in, size_t num)
 {
     const SHA_LONG64* W = in;
     uint64_t a, b, c, d, e, f, g, h, s0, s1, T1, T2;
@@ -498,7 +588,7 @@ static void sha512_block_data_order(SHA512_CTX* ctx, const void* in, size_t num)
         for (i = 0; i < 16; i++)
         {
             T1 = X[i] = PULL64(W[i]);
-            T1 += h + Sigma1(e) + Ch(e, f, g) + K512[i];
+            T1 += h + Sigma1(e) + Ch(e, f, g) + sha512_K512[i];
             T2 = Sigma0(a) + Maj(a, b, c);
             h = g;
             g = f;
@@ -518,7 +608,7 @@ static void sha512_block_data_order(SHA512_CTX* ctx, const void* in, size_t num)
             s1 = sigma1(s1);
 
             T1 = X[i & 0xf] += s0 + s1 + X[(i + 9) & 0xf];
-            T1 += h + Sigma1(e) + Ch(e, f, g) + K512[i];
+            T1 += h + Sigma1(e) + Ch(e, f, g) + sha512_K512[i];
             T2 = Sigma0(a) + Maj(a, b, c);
             h = g;
             g = f;
@@ -548,7 +638,7 @@ static void sha512_block_data_order(SHA512_CTX* ctx, const void* in, size_t num)
 #define ROUND_00_15(i, a, b, c, d, e, f, g, h) \
     do \
     { \
-        T1 += h + Sigma1(e) + Ch(e, f, g) + K512[i]; \
+        T1 += h + Sigma1(e) + Ch(e, f, g) + sha512_K512[i]; \
         h = Sigma0(a) + Maj(a, b, c); \
         d += T1; \
         h += T1; \
@@ -565,7 +655,7 @@ static void sha512_block_data_order(SHA512_CTX* ctx, const void* in, size_t num)
         ROUND_00_15(i + j, a, b, c, d, e, f, g, h); \
     } while (0)
 
-static void sha512_block_data_order(SHA512_CTX* ctx, const void* in, size_t num)
+void sha512_block_data_order(SHA512_CTX* ctx, const void* in, size_t num)
 {
     const uint64_t* W = in;
     uint64_t a, b, c, d, e, f, g, h, s0, s1, T1;
@@ -12,6 +12,10 @@
 
 #include <stdint.h>
 
+#ifdef __cplusplus
+extern "C" {
+#endif /*__cplusplus*/
+
 /**
  * Context data structure for SHA-512 and SHA-384.
  */
@@ -114,4 +118,37 @@ void SHA512_256_Update(SHA512_CTX* c, const void* _data, size_t len);
  */
 int SHA512_256_Final(SHA512_CTX* c, uint8_t* md);
 
+#define SHA512_224_DIGEST_LENGTH 28
+
+/**
+ * Initialize a SHA context for SHA-512/224 operation.
+ *
+ * \param c     The SHA context to initialize.
+ */
+void SHA512_224_Init(SHA512_CTX* c);
+
+/**
+ * Add the given data to a SHA-512/224 context.
+ *
+ * \param c     The SHA-512/224 context to update.
+ * \param data  A pointer to the data to digest.
+ * \param len   The length of the data to digest.
+ */
+void SHA512_224_Update(SHA512_CTX* c, const void* _data, size_t len);
+
+/**
+ * Finalize a SHA-512/224 context and generate the final hash.
+ *
+ * \param c     The SHA-512/224 context to finalize.
+ * \param md    A pointer to a buffer to hold the SHA-512/224 hash.  Must be at
+ *              least 28 bytes in length.
+ *
+ * \returns 0 on success and non-zero on failure.
+ */
+int SHA512_224_Final(SHA512_CTX* c, uint8_t* md);
+
+#ifdef __cplusplus
+}
+#endif /*__cplusplus*/
+
 #endif  //HASH_REF_SHA512_HEADER_GUARD
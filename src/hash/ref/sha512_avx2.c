@@ -0,0 +1,353 @@
+/**
+ * \file hash/ref/sha512_avx2.c
+ *
+ * SHA-512 block function using AVX2 for the message schedule.
+ *
+ * Two blocks are expanded together, one per 128-bit lane, with each lane
+ * holding a pair of consecutive schedule words.  The expanded words are
+ * pre-added to the round constants, so the compression rounds only need one
+ * load per round.  The rounds themselves stay scalar, since each round depends
+ * on the one before it.
+ *
+ * The multi-buffer variant instead runs the rounds for four independent
+ * states at once, one state per 64-bit lane.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+#include "sha512_internal.h"
+
+#ifdef SHA512_HAVE_AVX2
+
+#include <immintrin.h>
+
+#include "../../cpu/cpu_features.h"
+
+#define SHA512_AVX2_TARGET __attribute__((target("avx2,bmi2")))
+
+/* the number of blocks expanded together. */
+#define SHA512_AVX2_LANES 2
+
+#define ROTR(x, s) (((x) >> (s)) | ((x) << (64 - (s))))
+#define Sigma0(x) (ROTR((x), 28) ^ ROTR((x), 34) ^ ROTR((x), 39))
+#define Sigma1(x) (ROTR((x), 14) ^ ROTR((x), 18) ^ ROTR((x), 41))
+#define Ch(x, y, z) (((x) & (y)) ^ ((~(x)) & (z)))
+#define Maj(x, y, z) (((x) & (y)) ^ ((x) & (z)) ^ ((y) & (z)))
+
+#define ROUND(i, a, b, c, d, e, f, g, h) \
+    do \
+    { \
+        uint64_t T1 = h + Sigma1(e) + Ch(e, f, g) + wk[i]; \
+        h = Sigma0(a) + Maj(a, b, c); \
+        d += T1; \
+        h += T1; \
+    } while (0)
+
+#define VROTR(x, s) \
+    _mm256_or_si256( \
+        _mm256_srli_epi64((x), (s)), _mm256_slli_epi64((x), 64 - (s)))
+#define vsigma0(x) \
+    _mm256_xor_si256( \
+        _mm256_xor_si256(VROTR((x), 1), VROTR((x), 8)), \
+        _mm256_srli_epi64((x), 7))
+#define vsigma1(x) \
+    _mm256_xor_si256( \
+        _mm256_xor_si256(VROTR((x), 19), VROTR((x), 61)), \
+        _mm256_srli_epi64((x), 6))
+#define vSigma0(x) \
+    _mm256_xor_si256( \
+        _mm256_xor_si256(VROTR((x), 28), VROTR((x), 34)), VROTR((x), 39))
+#define vSigma1(x) \
+    _mm256_xor_si256( \
+        _mm256_xor_si256(VROTR((x), 14), VROTR((x), 18)), VROTR((x), 41))
+#define vCh(x, y, z) \
+    _mm256_xor_si256(_mm256_and_si256((x), (y)), _mm256_andnot_si256((x), (z)))
+#define vMaj(x, y, z) \
+    _mm256_xor_si256( \
+        _mm256_and_si256((x), (y)), \
+        _mm256_and_si256((z), _mm256_xor_si256((x), (y))))
+
+#define VROUND(i, a, b, c, d, e, f, g, h) \
+    do \
+    { \
+        __m256i T1 = \
+            _mm256_add_epi64( \
+                _mm256_add_epi64(h, vSigma1(e)), \
+                _mm256_add_epi64( \
+                    vCh(e, f, g), \
+                    _mm256_add_epi64( \
+                        W[(i) & 0x0f], \
+                        _mm256_set1_epi64x((long long)sha512_K512[i])))); \
+        h = _mm256_add_epi64(vSigma0(a), vMaj(a, b, c)); \
+        d = _mm256_add_epi64(d, T1); \
+        h = _mm256_add_epi64(h, T1); \
+    } while (0)
+
+/* forward decls */
+static SHA512_AVX2_TARGET void sha512_avx2_schedule(
+    uint64_t wk[SHA512_AVX2_LANES][80], const uint8_t* b0, const uint8_t* b1);
+static SHA512_AVX2_TARGET void sha512_avx2_rounds(
+    SHA512_CTX* ctx, const uint64_t* wk);
+static SHA512_AVX2_TARGET void sha512_mb_transpose(__m256i r[4]);
+
+/**
+ * Returns non-zero if this CPU and OS support the AVX2 block function.
+ */
+int sha512_avx2_capable(void)
+{
+    return vccrypt_cpu_supports(
+        VCCRYPT_CPU_FEATURE_AVX2 | VCCRYPT_CPU_FEATURE_BMI2);
+}
+
+/**
+ * Digest whole blocks using the AVX2 message schedule.
+ *
+ * \param ctx   The SHA-512 context to update.
+ * \param in    The blocks to digest.
+ * \param num   The number of 128 byte blocks to digest.
+ */
+void sha512_block_data_order_avx2(
+    SHA512_CTX* ctx, const void* in, size_t num)
+{
+    const uint8_t* p = (const uint8_t*)in;
+    uint64_t wk[SHA512_AVX2_LANES][80];
+
+    while (num >= SHA512_AVX2_LANES)
+    {
+        sha512_avx2_schedule(wk, p, p + SHA512_CBLOCK);
+        sha512_avx2_rounds(ctx, wk[0]);
+        sha512_avx2_rounds(ctx, wk[1]);
+
+        p += SHA512_AVX2_LANES * SHA512_CBLOCK;
+        num -= SHA512_AVX2_LANES;
+    }
+
+    /* a trailing odd block is expanded in both lanes. */
+    if (num > 0)
+    {
+        sha512_avx2_schedule(wk, p, p);
+        sha512_avx2_rounds(ctx, wk[0]);
+    }
+
+    /* the schedule is derived from the message, so don't leave it behind. */
+    memset(wk, 0, sizeof(wk));
+}
+
+/**
+ * Expand the message schedule for two blocks and add the round constants.
+ *
+ * \param wk    The expanded W + K words for each block.
+ * \param b0    The first block.
+ * \param b1    The second block.
+ */
+static SHA512_AVX2_TARGET void sha512_avx2_schedule(
+    uint64_t wk[SHA512_AVX2_LANES][80], const uint8_t* b0, const uint8_t* b1)
+{
+    /* byte swap each 64-bit word from big-endian. */
+    const __m256i bswap =
+        _mm256_set_epi8(
+            8, 9, 10, 11, 12, 13, 14, 15, 0, 1, 2, 3, 4, 5, 6, 7,
+            8, 9, 10, 11, 12, 13, 14, 15, 0, 1, 2, 3, 4, 5, 6, 7);
+    __m256i x[40];
+    __m256i t;
+    int j;
+
+    /* x[j] holds words 2j and 2j + 1 of b0 in the low lane and of b1 in the
+     * high lane. */
+    for (j = 0; j < 8; ++j)
+    {
+        x[j] =
+            _mm256_shuffle_epi8(
+                _mm256_loadu2_m128i(
+                    (const __m128i*)(b1 + 16 * j),
+                    (const __m128i*)(b0 + 16 * j)),
+                bswap);
+    }
+
+    /* W[t] = sigma1(W[t-2]) + W[t-7] + sigma0(W[t-15]) + W[t-16] */
+    for (j = 8; j < 40; ++j)
+    {
+        t = _mm256_add_epi64(
+                x[j - 8],
+                vsigma0(_mm256_alignr_epi8(x[j - 7], x[j - 8], 8)));
+        t = _mm256_add_epi64(t, _mm256_alignr_epi8(x[j - 3], x[j - 4], 8));
+        x[j] = _mm256_add_epi64(t, vsigma1(x[j - 1]));
+    }
+
+    for (j = 0; j < 40; ++j)
+    {
+        t = _mm256_add_epi64(
+                x[j],
+                _mm256_broadcastsi128_si256(
+                    _mm_loadu_si128((const __m128i*)(sha512_K512 + 2 * j))));
+
+        _mm_storeu_si128(
+            (__m128i*)(wk[0] + 2 * j), _mm256_castsi256_si128(t));
+        _mm_storeu_si128(
+            (__m128i*)(wk[1] + 2 * j), _mm256_extracti128_si256(t, 1));
+    }
+}
+
+/**
+ * Run the 80 compression rounds for one block.
+ *
+ * \param ctx   The SHA-512 context to update.
+ * \param wk    The expanded W + K words for this block.
+ */
+static SHA512_AVX2_TARGET void sha512_avx2_rounds(
+    SHA512_CTX* ctx, const uint64_t* wk)
+{
+    uint64_t a, b, c, d, e, f, g, h;
+    int i;
+
+    a = ctx->h[0];
+    b = ctx->h[1];
+    c = ctx->h[2];
+    d = ctx->h[3];
+    e = ctx->h[4];
+    f = ctx->h[5];
+    g = ctx->h[6];
+    h = ctx->h[7];
+
+    /* rotate the variable names instead of the values. */
+    for (i = 0; i < 80; i += 8)
+    {
+        ROUND(i + 0, a, b, c, d, e, f, g, h);
+        ROUND(i + 1, h, a, b, c, d, e, f, g);
+        ROUND(i + 2, g, h, a, b, c, d, e, f);
+        ROUND(i + 3, f, g, h, a, b, c, d, e);
+        ROUND(i + 4, e, f, g, h, a, b, c, d);
+        ROUND(i + 5, d, e, f, g, h, a, b, c);
+        ROUND(i + 6, c, d, e, f, g, h, a, b);
+        ROUND(i + 7, b, c, d, e, f, g, h, a);
+    }
+
+    ctx->h[0] += a;
+    ctx->h[1] += b;
+    ctx->h[2] += c;
+    ctx->h[3] += d;
+    ctx->h[4] += e;
+    ctx->h[5] += f;
+    ctx->h[6] += g;
+    ctx->h[7] += h;
+}
+
+/**
+ * Digest one block into each of \ref SHA512_MB_LANES independent contexts,
+ * one context per AVX2 lane.
+ *
+ * \param ctx   The SHA-512 contexts to update.
+ * \param in    The block to digest for each context.
+ */
+SHA512_AVX2_TARGET void sha512_mb_block_avx2(
+    SHA512_CTX* ctx[SHA512_MB_LANES], const uint8_t* in[SHA512_MB_LANES])
+{
+    const __m256i bswap =
+        _mm256_set_epi8(
+            8, 9, 10, 11, 12, 13, 14, 15, 0, 1, 2, 3, 4, 5, 6, 7,
+            8, 9, 10, 11, 12, 13, 14, 15, 0, 1, 2, 3, 4, 5, 6, 7);
+    __m256i a, b, c, d, e, f, g, h, s0, s1;
+    __m256i S[8];
+    __m256i W[16];
+    int i, j;
+
+    /* transpose the chaining values so each lane holds one context. */
+    for (j = 0; j < 8; j += 4)
+    {
+        for (i = 0; i < SHA512_MB_LANES; ++i)
+        {
+            S[j + i] = _mm256_loadu_si256((const __m256i*)(ctx[i]->h + j));
+        }
+        sha512_mb_transpose(S + j);
+    }
+
+    /* likewise transpose the big-endian message words. */
+    for (j = 0; j < 16; j += 4)
+    {
+        for (i = 0; i < SHA512_MB_LANES; ++i)
+        {
+            W[j + i] =
+                _mm256_shuffle_epi8(
+                    _mm256_loadu_si256((const __m256i*)(in[i] + 8 * j)),
+                    bswap);
+        }
+        sha512_mb_transpose(W + j);
+    }
+
+    a = S[0];
+    b = S[1];
+    c = S[2];
+    d = S[3];
+    e = S[4];
+    f = S[5];
+    g = S[6];
+    h = S[7];
+
+    for (i = 0; i < 80; i += 8)
+    {
+        /* expand the next eight schedule words in place. */
+        if (i >= 16)
+        {
+            for (j = i; j < i + 8; ++j)
+            {
+                s0 = W[(j + 1) & 0x0f];
+                s1 = W[(j + 14) & 0x0f];
+                W[j & 0x0f] =
+                    _mm256_add_epi64(
+                        _mm256_add_epi64(W[j & 0x0f], vsigma0(s0)),
+                        _mm256_add_epi64(W[(j + 9) & 0x0f], vsigma1(s1)));
+            }
+        }
+
+        VROUND(i + 0, a, b, c, d, e, f, g, h);
+        VROUND(i + 1, h, a, b, c, d, e, f, g);
+        VROUND(i + 2, g, h, a, b, c, d, e, f);
+        VROUND(i + 3, f, g, h, a, b, c, d, e);
+        VROUND(i + 4, e, f, g, h, a, b, c, d);
+        VROUND(i + 5, d, e, f, g, h, a, b, c);
+        VROUND(i + 6, c, d, e, f, g, h, a, b);
+        VROUND(i + 7, b, c, d, e, f, g, h, a);
+    }
+
+    S[0] = _mm256_add_epi64(S[0], a);
+    S[1] = _mm256_add_epi64(S[1], b);
+    S[2] = _mm256_add_epi64(S[2], c);
+    S[3] = _mm256_add_epi64(S[3], d);
+    S[4] = _mm256_add_epi64(S[4], e);
+    S[5] = _mm256_add_epi64(S[5], f);
+    S[6] = _mm256_add_epi64(S[6], g);
+    S[7] = _mm256_add_epi64(S[7], h);
+
+    /* the transpose is its own inverse. */
+    for (j = 0; j < 8; j += 4)
+    {
+        sha512_mb_transpose(S + j);
+        for (i = 0; i < SHA512_MB_LANES; ++i)
+        {
+            _mm256_storeu_si256((__m256i*)(ctx[i]->h + j), S[j + i]);
+        }
+    }
+}
+
+/**
+ * Transpose a 4x4 matrix of 64-bit words in place.
+ *
+ * \param r     The four rows of the matrix.
+ */
+static SHA512_AVX2_TARGET void sha512_mb_transpose(__m256i r[4])
+{
+    __m256i t0 = _mm256_unpacklo_epi64(r[0], r[1]);
+    __m256i t1 = _mm256_unpackhi_epi64(r[0], r[1]);
+    __m256i t2 = _mm256_unpacklo_epi64(r[2], r[3]);
+    __m256i t3 = _mm256_unpackhi_epi64(r[2], r[3]);
+
+    r[0] = _mm256_permute2x128_si256(t0, t2, 0x20);
+    r[1] = _mm256_permute2x128_si256(t1, t3, 0x20);
+    r[2] = _mm256_permute2x128_si256(t0, t2, 0x31);
+    r[3] = _mm256_permute2x128_si256(t1, t3, 0x31);
+}
+
+#endif /*SHA512_HAVE_AVX2*/
@@ -0,0 +1,104 @@
+/**
+ * \file hash/ref/sha512_internal.h
+ *
+ * Internal interface shared by the SHA-512 block function variants.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#ifndef HASH_REF_SHA512_INTERNAL_HEADER_GUARD
+#define HASH_REF_SHA512_INTERNAL_HEADER_GUARD
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "sha512.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif /*__cplusplus*/
+
+/**
+ * The size of a SHA-512 block, in bytes.
+ */
+#define SHA512_CBLOCK 128
+
+/**
+ * Constants for the SHA-512 block operation.
+ */
+extern const uint64_t sha512_K512[80];
+
+/**
+ * The number of independent SHA-512 states advanced together by
+ * sha512_mb_block().
+ */
+#define SHA512_MB_LANES 4
+
+/**
+ * Digest whole blocks, using the fastest block function this CPU supports.
+ *
+ * \param ctx   The SHA-512 context to update.
+ * \param in    The blocks to digest.
+ * \param num   The number of 128 byte blocks to digest.
+ */
+void sha512_block(SHA512_CTX* ctx, const void* in, size_t num);
+
+/**
+ * Digest one block into each of \ref SHA512_MB_LANES independent contexts.
+ *
+ * The contexts must be distinct.  Only the chaining values are updated; the
+ * length and buffer fields of each context are left alone.
+ *
+ * \param ctx   The SHA-512 contexts to update.
+ * \param in    The block to digest for each context.
+ */
+void sha512_mb_block(
+    SHA512_CTX* ctx[SHA512_MB_LANES], const uint8_t* in[SHA512_MB_LANES]);
+
+/**
+ * Digest whole blocks using the portable block function.
+ *
+ * \param ctx   The SHA-512 context to update.
+ * \param in    The blocks to digest.
+ * \param num   The number of 128 byte blocks to digest.
+ */
+void sha512_block_data_order(SHA512_CTX* ctx, const void* in, size_t num);
+
+/*
+ * The AVX2 block function is available on x86-64 builds, and is selected at
+ * runtime when the CPU supports it.
+ */
+#if defined(__GNUC__) && (defined(__x86_64) || defined(__x86_64__))
+#define SHA512_HAVE_AVX2 1
+
+/**
+ * Returns non-zero if this CPU and OS support the AVX2 block function.
+ */
+int sha512_avx2_capable(void);
+
+/**
+ * Digest whole blocks using the AVX2 message schedule.
+ *
+ * \param ctx   The SHA-512 context to update.
+ * \param in    The blocks to digest.
+ * \param num   The number of 128 byte blocks to digest.
+ */
+void sha512_block_data_order_avx2(
+    SHA512_CTX* ctx, const void* in, size_t num);
+
+/**
+ * Digest one block into each of \ref SHA512_MB_LANES independent contexts,
+ * one context per AVX2 lane.
+ *
+ * \param ctx   The SHA-512 contexts to update.
+ * \param in    The block to digest for each context.
+ */
+void sha512_mb_block_avx2(
+    SHA512_CTX* ctx[SHA512_MB_LANES], const uint8_t* in[SHA512_MB_LANES]);
+#endif
+
+#ifdef __cplusplus
+}
+#endif /*__cplusplus*/
+
+#endif  //HASH_REF_SHA512_INTERNAL_HEADER_GUARD
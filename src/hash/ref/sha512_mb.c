@@ -0,0 +1,40 @@
+/**
+ * \file hash/ref/sha512_mb.c
+ *
+ * Multi-buffer SHA-512 block function.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <stdint.h>
+
+#include "sha512_internal.h"
+
+/**
+ * Digest one block into each of \ref SHA512_MB_LANES independent contexts.
+ *
+ * The contexts must be distinct.  Only the chaining values are updated; the
+ * length and buffer fields of each context are left alone.
+ *
+ * \param ctx   The SHA-512 contexts to update.
+ * \param in    The block to digest for each context.
+ */
+void sha512_mb_block(
+    SHA512_CTX* ctx[SHA512_MB_LANES], const uint8_t* in[SHA512_MB_LANES])
+{
+    int i;
+
+#ifdef SHA512_HAVE_AVX2
+    if (sha512_avx2_capable())
+    {
+        sha512_mb_block_avx2(ctx, in);
+        return;
+    }
+#endif
+
+    /* without a vector unit, run the lanes one after another. */
+    for (i = 0; i < SHA512_MB_LANES; ++i)
+    {
+        sha512_block(ctx[i], in[i], 1);
+    }
+}
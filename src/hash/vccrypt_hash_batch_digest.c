@@ -0,0 +1,128 @@
+/**
+ * \file vccrypt_hash_batch_digest.c
+ *
+ * Hash a batch of independent messages.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <cbmc/model_assert.h>
+#include <string.h>
+#include <vccrypt/hash.h>
+#include <vpr/parameters.h>
+
+/* forward decls */
+static int vccrypt_hash_batch_digest_each(
+    vccrypt_hash_options_t* options, const uint8_t* const* data,
+    const size_t* sizes, vccrypt_buffer_t* hash_buffers, size_t count);
+
+/**
+ * \brief Hash a batch of independent messages.
+ *
+ * Each message is hashed on its own, exactly as if by vccrypt_hash_init(),
+ * vccrypt_hash_digest(), and vccrypt_hash_finalize().  Algorithms that support
+ * it hash several messages in lockstep, which is much faster than hashing
+ * many short messages one at a time.
+ *
+ * \param options       The options for the hash algorithm to use.
+ * \param data          Array of \p count pointers to the messages to hash.  A
+ *                      pointer may only be NULL if its size is 0.
+ * \param sizes         Array of \p count message sizes, in bytes.
+ * \param hash_buffers  Array of \p count buffers to receive each hash.  Each
+ *                      must be large enough for the given hash algorithm.
+ * \param count         The number of messages to hash.
+ *
+ * \returns a status code indicating success or failure.
+ *      - \ref VCCRYPT_STATUS_SUCCESS on success.
+ *      - \ref VCCRYPT_ERROR_HASH_BATCH_DIGEST_INVALID_ARG if an invalid
+ *             argument is provided.
+ *      - a non-zero error code on failure.
+ */
+int vccrypt_hash_batch_digest(
+    vccrypt_hash_options_t* options, const uint8_t* const* data,
+    const size_t* sizes, vccrypt_buffer_t* hash_buffers, size_t count)
+{
+    MODEL_ASSERT(options != NULL);
+    MODEL_ASSERT(options->hash_size > 0);
+    MODEL_ASSERT(count == 0 || data != NULL);
+    MODEL_ASSERT(count == 0 || sizes != NULL);
+    MODEL_ASSERT(count == 0 || hash_buffers != NULL);
+
+    /* sanity check on parameters */
+    if (options == NULL || (count > 0 &&
+        (data == NULL || sizes == NULL || hash_buffers == NULL)))
+    {
+        return VCCRYPT_ERROR_HASH_BATCH_DIGEST_INVALID_ARG;
+    }
+
+    /* check each message and output buffer before hashing any of them. */
+    for (size_t i = 0; i < count; ++i)
+    {
+        if ((data[i] == NULL && sizes[i] > 0) ||
+            hash_buffers[i].data == NULL ||
+            hash_buffers[i].size < options->hash_size)
+        {
+            return VCCRYPT_ERROR_HASH_BATCH_DIGEST_INVALID_ARG;
+        }
+    }
+
+    /* use the lockstep implementation if this algorithm has one. */
+    if (options->vccrypt_hash_alg_batch_digest != NULL)
+    {
+        return
+            options->vccrypt_hash_alg_batch_digest(
+                options, data, sizes, hash_buffers, count);
+    }
+
+    return
+        vccrypt_hash_batch_digest_each(
+            options, data, sizes, hash_buffers, count);
+}
+
+/**
+ * Hash each message of a batch in turn.
+ *
+ * \param options       The options for the hash algorithm to use.
+ * \param data          Array of pointers to the messages to hash.
+ * \param sizes         Array of message sizes, in bytes.
+ * \param hash_buffers  Array of buffers to receive each hash.
+ * \param count         The number of messages to hash.
+ *
+ * \returns \ref VCCRYPT_STATUS_SUCCESS on success and non-zero on failure.
+ */
+static int vccrypt_hash_batch_digest_each(
+    vccrypt_hash_options_t* options, const uint8_t* const* data,
+    const size_t* sizes, vccrypt_buffer_t* hash_buffers, size_t count)
+{
+    vccrypt_hash_context_t context;
+    int retval;
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        retval = vccrypt_hash_init(options, &context);
+        if (VCCRYPT_STATUS_SUCCESS != retval)
+        {
+            return retval;
+        }
+
+        if (sizes[i] > 0)
+        {
+            retval = vccrypt_hash_digest(&context, data[i], sizes[i]);
+            if (VCCRYPT_STATUS_SUCCESS != retval)
+            {
+                dispose((disposable_t*)&context);
+                return retval;
+            }
+        }
+
+        retval = vccrypt_hash_finalize(&context, hash_buffers + i);
+        dispose((disposable_t*)&context);
+        if (VCCRYPT_STATUS_SUCCESS != retval)
+        {
+            return retval;
+        }
+    }
+
+    /* success */
+    return VCCRYPT_STATUS_SUCCESS;
+}
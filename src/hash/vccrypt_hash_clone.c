@@ -0,0 +1,67 @@
+/**
+ * \file vccrypt_hash_clone.c
+ *
+ * Clone a hash context structure.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <cbmc/model_assert.h>
+#include <string.h>
+#include <vccrypt/hash.h>
+#include <vpr/parameters.h>
+
+/**
+ * \brief Clone a hash instance, including any data digested so far.
+ *
+ * This allows data shared by several messages, such as a common header, to be
+ * digested once.  The clone and the original can then be continued and
+ * finalized independently.
+ *
+ * If cloning is successful, then the clone is owned by the caller and must be
+ * disposed by calling dispose() when no longer needed.
+ *
+ * \param dest          The hash instance to initialize as a clone.
+ * \param src           The hash instance to clone.
+ *
+ * \returns a status code indicating success or failure.
+ *      - \ref VCCRYPT_STATUS_SUCCESS on success.
+ *      - \ref VCCRYPT_ERROR_HASH_CLONE_INVALID_ARG if an invalid argument is
+ *             provided.
+ *      - a non-zero error code on failure.
+ */
+int vccrypt_hash_clone(
+    vccrypt_hash_context_t* dest, const vccrypt_hash_context_t* src)
+{
+    MODEL_ASSERT(dest != NULL);
+    MODEL_ASSERT(src != NULL);
+    MODEL_ASSERT(src->options != NULL);
+    MODEL_ASSERT(src->options->vccrypt_hash_alg_clone != NULL);
+    MODEL_ASSERT(dest != src);
+
+    /* sanity check on parameters */
+    if (dest == NULL || src == NULL || dest == src || src->options == NULL ||
+        src->options->vccrypt_hash_alg_clone == NULL)
+    {
+        return VCCRYPT_ERROR_HASH_CLONE_INVALID_ARG;
+    }
+
+    /* set up the context structure. */
+    memset(dest, 0, sizeof(vccrypt_hash_context_t));
+    dest->options = src->options;
+
+    /* call the algorithm specific clone method */
+    int ret = src->options->vccrypt_hash_alg_clone(src->options, dest, src);
+    if (ret != 0)
+    {
+        /* failure.  Clean up and return error code to caller. */
+        memset(dest, 0, sizeof(vccrypt_hash_context_t));
+        return ret;
+    }
+
+    /* the clone is disposed the same way as the original. */
+    dest->hdr.dispose = src->hdr.dispose;
+
+    /* success */
+    return VCCRYPT_STATUS_SUCCESS;
+}
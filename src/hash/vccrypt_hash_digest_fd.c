@@ -0,0 +1,413 @@
+/**
+ * \file vccrypt_hash_digest_fd.c
+ *
+ * Digest the contents of a file descriptor.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+/* expose the POSIX interfaces when building with a strict C standard. */
+#if !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include <cbmc/model_assert.h>
+#include <string.h>
+#include <vccrypt/hash.h>
+#include <vccrypt/os.h>
+#include <vpr/allocator.h>
+#include <vpr/parameters.h>
+
+#if defined(VCCRYPT_OS_UNIX)
+
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+/* the size of each read.  This is a multiple of the page size and of every
+ * hash block size.  The first read is shortened to end on a multiple of this
+ * size, so that every later read starts on an aligned file offset. */
+#define VCCRYPT_HASH_FD_CHUNK_SIZE (1024 * 1024)
+
+/* the number of chunks the reader thread may run ahead of the hash. */
+#define VCCRYPT_HASH_FD_CHUNKS 4
+
+/* state shared between the hashing thread and the reader thread. */
+typedef struct vccrypt_hash_fd_pipeline
+{
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    int fd;
+    size_t first_size;
+    uint8_t* chunk[VCCRYPT_HASH_FD_CHUNKS];
+    size_t chunk_size[VCCRYPT_HASH_FD_CHUNKS];
+    size_t produced;
+    size_t consumed;
+    bool eof;
+    bool read_error;
+    bool stop;
+} vccrypt_hash_fd_pipeline_t;
+
+/* forward decls */
+static size_t vccrypt_hash_fd_first_size(int fd);
+static ssize_t vccrypt_hash_fd_read_chunk(int fd, uint8_t* buf, size_t size);
+static int vccrypt_hash_fd_digest_serial(
+    vccrypt_hash_context_t* context, int fd, uint8_t* buf,
+    size_t first_size);
+static int vccrypt_hash_fd_digest_pipelined(
+    vccrypt_hash_context_t* context, int fd, uint8_t* buf,
+    size_t first_size);
+static void* vccrypt_hash_fd_reader(void* arg);
+
+/**
+ * \brief Digest the remaining contents of a file descriptor.
+ *
+ * Data is read from the current file offset until end of file.  Large files
+ * are read ahead on a helper thread, so that reading overlaps with hashing and
+ * the hash runs at the speed of the hash algorithm.
+ *
+ * \param context       The hash instance.
+ * \param fd            The file descriptor to read.
+ *
+ * \returns a status code indicating success or failure.
+ *      - \ref VCCRYPT_STATUS_SUCCESS on success.
+ *      - \ref VCCRYPT_ERROR_HASH_DIGEST_FD_INVALID_ARG if an invalid argument
+ *             is provided.
+ *      - \ref VCCRYPT_ERROR_HASH_DIGEST_FD_OUT_OF_MEMORY if the read buffers
+ *             could not be allocated.
+ *      - \ref VCCRYPT_ERROR_HASH_DIGEST_FD_READ_FAILURE if reading from the
+ *             file descriptor failed.
+ *      - a non-zero error code on failure.
+ */
+int vccrypt_hash_digest_fd(vccrypt_hash_context_t* context, int fd)
+{
+    struct stat st;
+    uint8_t* buf;
+    size_t first_size;
+    int retval;
+
+    MODEL_ASSERT(context != NULL);
+    MODEL_ASSERT(context->options != NULL);
+    MODEL_ASSERT(context->options->alloc_opts != NULL);
+    MODEL_ASSERT(fd >= 0);
+
+    /* sanity check on parameters */
+    if (context == NULL || context->options == NULL ||
+        context->options->alloc_opts == NULL || fd < 0)
+    {
+        return VCCRYPT_ERROR_HASH_DIGEST_FD_INVALID_ARG;
+    }
+
+    /* the reader thread isn't worth starting for a single chunk. */
+    bool pipelined = true;
+    if (0 == fstat(fd, &st) && S_ISREG(st.st_mode) &&
+        st.st_size <= VCCRYPT_HASH_FD_CHUNK_SIZE)
+    {
+        pipelined = false;
+    }
+
+    size_t buf_size =
+        pipelined
+            ? VCCRYPT_HASH_FD_CHUNKS * VCCRYPT_HASH_FD_CHUNK_SIZE
+            : VCCRYPT_HASH_FD_CHUNK_SIZE;
+
+    buf = (uint8_t*)allocate(context->options->alloc_opts, buf_size);
+    if (NULL == buf)
+    {
+        return VCCRYPT_ERROR_HASH_DIGEST_FD_OUT_OF_MEMORY;
+    }
+
+    first_size = vccrypt_hash_fd_first_size(fd);
+
+#if defined(POSIX_FADV_SEQUENTIAL)
+    /* ask for aggressive read-ahead.  This is only a hint, so failure is
+     * ignored. */
+    (void)posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+
+    if (pipelined)
+    {
+        retval =
+            vccrypt_hash_fd_digest_pipelined(context, fd, buf, first_size);
+    }
+    else
+    {
+        retval =
+            vccrypt_hash_fd_digest_serial(context, fd, buf, first_size);
+    }
+
+    /* the buffer held message data. */
+    memset(buf, 0, buf_size);
+    release(context->options->alloc_opts, buf);
+
+    return retval;
+}
+
+/**
+ * Find the size of the first read, so that it ends on a chunk boundary.
+ *
+ * \param fd            The file descriptor to read.
+ *
+ * \returns the size of the first read, or a full chunk if the descriptor
+ * can't seek.
+ */
+static size_t vccrypt_hash_fd_first_size(int fd)
+{
+    off_t offset = lseek(fd, 0, SEEK_CUR);
+    if (offset <= 0)
+    {
+        return VCCRYPT_HASH_FD_CHUNK_SIZE;
+    }
+
+    return
+        VCCRYPT_HASH_FD_CHUNK_SIZE -
+            (size_t)(offset % VCCRYPT_HASH_FD_CHUNK_SIZE);
+}
+
+/**
+ * Read until the buffer is full or end of file is reached.
+ *
+ * \param fd            The file descriptor to read.
+ * \param buf           The buffer to fill.
+ * \param size          The size of the buffer.
+ *
+ * \returns the number of bytes read, which is less than size only at end of
+ * file, or -1 on error.
+ */
+static ssize_t vccrypt_hash_fd_read_chunk(int fd, uint8_t* buf, size_t size)
+{
+    size_t total = 0;
+
+    while (total < size)
+    {
+        ssize_t n = read(fd, buf + total, size - total);
+        if (n < 0)
+        {
+            if (EINTR == errno)
+            {
+                continue;
+            }
+
+            return -1;
+        }
+        else if (0 == n)
+        {
+            break;
+        }
+
+        total += (size_t)n;
+    }
+
+    return (ssize_t)total;
+}
+
+/**
+ * Read and hash the file on the calling thread.
+ *
+ * \param context       The hash instance.
+ * \param fd            The file descriptor to read.
+ * \param buf           A buffer of VCCRYPT_HASH_FD_CHUNK_SIZE bytes.
+ * \param first_size    The size of the first read.
+ *
+ * \returns \ref VCCRYPT_STATUS_SUCCESS on success and non-zero on failure.
+ */
+static int vccrypt_hash_fd_digest_serial(
+    vccrypt_hash_context_t* context, int fd, uint8_t* buf,
+    size_t first_size)
+{
+    size_t size = first_size;
+
+    for (;;)
+    {
+        ssize_t n = vccrypt_hash_fd_read_chunk(fd, buf, size);
+        if (n < 0)
+        {
+            return VCCRYPT_ERROR_HASH_DIGEST_FD_READ_FAILURE;
+        }
+        else if (0 == n)
+        {
+            return VCCRYPT_STATUS_SUCCESS;
+        }
+
+        int retval = vccrypt_hash_digest(context, buf, (size_t)n);
+        if (VCCRYPT_STATUS_SUCCESS != retval)
+        {
+            return retval;
+        }
+
+        if ((size_t)n < size)
+        {
+            return VCCRYPT_STATUS_SUCCESS;
+        }
+
+        size = VCCRYPT_HASH_FD_CHUNK_SIZE;
+    }
+}
+
+/**
+ * Hash the file on the calling thread while a reader thread fills the next
+ * chunks.
+ *
+ * \param context       The hash instance.
+ * \param fd            The file descriptor to read.
+ * \param buf           A buffer of VCCRYPT_HASH_FD_CHUNKS chunks.
+ * \param first_size    The size of the first read.
+ *
+ * \returns \ref VCCRYPT_STATUS_SUCCESS on success and non-zero on failure.
+ */
+static int vccrypt_hash_fd_digest_pipelined(
+    vccrypt_hash_context_t* context, int fd, uint8_t* buf,
+    size_t first_size)
+{
+    vccrypt_hash_fd_pipeline_t p;
+    pthread_t reader;
+    int retval = VCCRYPT_STATUS_SUCCESS;
+
+    memset(&p, 0, sizeof(p));
+    p.fd = fd;
+    p.first_size = first_size;
+    for (int i = 0; i < VCCRYPT_HASH_FD_CHUNKS; ++i)
+    {
+        p.chunk[i] = buf + i * VCCRYPT_HASH_FD_CHUNK_SIZE;
+    }
+
+    if (0 != pthread_mutex_init(&p.lock, NULL))
+    {
+        return
+            vccrypt_hash_fd_digest_serial(context, fd, buf, first_size);
+    }
+
+    if (0 != pthread_cond_init(&p.cond, NULL))
+    {
+        pthread_mutex_destroy(&p.lock);
+        return
+            vccrypt_hash_fd_digest_serial(context, fd, buf, first_size);
+    }
+
+    /* without a reader thread, just read and hash in turn. */
+    if (0 != pthread_create(&reader, NULL, &vccrypt_hash_fd_reader, &p))
+    {
+        retval =
+            vccrypt_hash_fd_digest_serial(context, fd, buf, first_size);
+        goto cleanup_sync;
+    }
+
+    pthread_mutex_lock(&p.lock);
+    for (;;)
+    {
+        while (p.produced == p.consumed && !p.eof && !p.read_error)
+        {
+            pthread_cond_wait(&p.cond, &p.lock);
+        }
+
+        /* hash every chunk read before end of file or an error. */
+        if (p.produced == p.consumed)
+        {
+            if (p.read_error)
+            {
+                retval = VCCRYPT_ERROR_HASH_DIGEST_FD_READ_FAILURE;
+            }
+
+            break;
+        }
+
+        size_t slot = p.consumed % VCCRYPT_HASH_FD_CHUNKS;
+        pthread_mutex_unlock(&p.lock);
+
+        retval =
+            vccrypt_hash_digest(context, p.chunk[slot], p.chunk_size[slot]);
+
+        pthread_mutex_lock(&p.lock);
+        ++p.consumed;
+        pthread_cond_signal(&p.cond);
+
+        if (VCCRYPT_STATUS_SUCCESS != retval)
+        {
+            break;
+        }
+    }
+
+    /* let the reader thread exit if we stopped early. */
+    p.stop = true;
+    pthread_cond_signal(&p.cond);
+    pthread_mutex_unlock(&p.lock);
+
+    pthread_join(reader, NULL);
+
+cleanup_sync:
+    pthread_cond_destroy(&p.cond);
+    pthread_mutex_destroy(&p.lock);
+
+    return retval;
+}
+
+/**
+ * Reader thread for the pipelined hash.
+ *
+ * \param arg           The shared pipeline state.
+ *
+ * \returns NULL.
+ */
+static void* vccrypt_hash_fd_reader(void* arg)
+{
+    vccrypt_hash_fd_pipeline_t* p = (vccrypt_hash_fd_pipeline_t*)arg;
+    size_t size = p->first_size;
+
+    pthread_mutex_lock(&p->lock);
+    for (;;)
+    {
+        /* wait for a free chunk. */
+        while (p->produced - p->consumed == VCCRYPT_HASH_FD_CHUNKS &&
+               !p->stop)
+        {
+            pthread_cond_wait(&p->cond, &p->lock);
+        }
+
+        if (p->stop)
+        {
+            break;
+        }
+
+        size_t slot = p->produced % VCCRYPT_HASH_FD_CHUNKS;
+        pthread_mutex_unlock(&p->lock);
+
+        ssize_t n = vccrypt_hash_fd_read_chunk(p->fd, p->chunk[slot], size);
+
+        pthread_mutex_lock(&p->lock);
+        if (n < 0)
+        {
+            p->read_error = true;
+        }
+        else
+        {
+            if (n > 0)
+            {
+                p->chunk_size[slot] = (size_t)n;
+                ++p->produced;
+            }
+
+            /* a short chunk is only returned at end of file. */
+            if ((size_t)n < size)
+            {
+                p->eof = true;
+            }
+        }
+
+        size = VCCRYPT_HASH_FD_CHUNK_SIZE;
+
+        pthread_cond_signal(&p->cond);
+
+        if (p->eof || p->read_error)
+        {
+            break;
+        }
+    }
+    pthread_mutex_unlock(&p->lock);
+
+    return NULL;
+}
+
+#endif /*defined(VCCRYPT_OS_UNIX)*/
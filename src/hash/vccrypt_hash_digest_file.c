@@ -0,0 +1,74 @@
+/**
+ * \file vccrypt_hash_digest_file.c
+ *
+ * Digest the contents of a file.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+/* expose the POSIX interfaces when building with a strict C standard. */
+#if !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include <cbmc/model_assert.h>
+#include <vccrypt/hash.h>
+#include <vccrypt/os.h>
+#include <vpr/parameters.h>
+
+#if defined(VCCRYPT_OS_UNIX)
+
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+/**
+ * \brief Digest the contents of the file at the given path.
+ *
+ * The file is opened read-only, digested with vccrypt_hash_digest_fd(), and
+ * closed again.
+ *
+ * \param context       The hash instance.
+ * \param path          The path of the file to digest.
+ *
+ * \returns a status code indicating success or failure.
+ *      - \ref VCCRYPT_STATUS_SUCCESS on success.
+ *      - \ref VCCRYPT_ERROR_HASH_DIGEST_FILE_INVALID_ARG if an invalid
+ *             argument is provided.
+ *      - \ref VCCRYPT_ERROR_HASH_DIGEST_FILE_OPEN_FAILURE if the file could
+ *             not be opened.
+ *      - a non-zero error code on failure.
+ */
+int vccrypt_hash_digest_file(vccrypt_hash_context_t* context, const char* path)
+{
+    int fd;
+
+    MODEL_ASSERT(context != NULL);
+    MODEL_ASSERT(path != NULL);
+
+    /* sanity check on parameters */
+    if (context == NULL || path == NULL)
+    {
+        return VCCRYPT_ERROR_HASH_DIGEST_FILE_INVALID_ARG;
+    }
+
+    do
+    {
+        fd = open(path, O_RDONLY);
+    } while (fd < 0 && EINTR == errno);
+
+    if (fd < 0)
+    {
+        return VCCRYPT_ERROR_HASH_DIGEST_FILE_OPEN_FAILURE;
+    }
+
+    int retval = vccrypt_hash_digest_fd(context, fd);
+
+    close(fd);
+
+    return retval;
+}
+
+#endif /*defined(VCCRYPT_OS_UNIX)*/
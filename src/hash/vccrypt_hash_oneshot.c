@@ -0,0 +1,112 @@
+/**
+ * \file vccrypt_hash_oneshot.c
+ *
+ * Hash a single message in one call.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <cbmc/model_assert.h>
+#include <string.h>
+#include <vccrypt/hash.h>
+#include <vpr/parameters.h>
+
+/* forward decls */
+static int vccrypt_hash_oneshot_context(
+    vccrypt_hash_options_t* options, const uint8_t* data, size_t size,
+    uint8_t* md);
+
+/**
+ * \brief Hash a single message, writing the hash to caller-owned memory.
+ *
+ * This is equivalent to vccrypt_hash_init(), vccrypt_hash_digest(), and
+ * vccrypt_hash_finalize() followed by dispose(), but it needs neither a hash
+ * instance nor an output buffer.  This matters for short messages, where that
+ * setup and teardown costs more than hashing the message itself.
+ *
+ * \param options       The options for the hash algorithm to use.
+ * \param data          The message to hash.  May only be NULL if \p size is
+ *                      0.
+ * \param size          The size of the message, in bytes.
+ * \param md            The memory to receive the hash.
+ * \param md_size       The size of \p md, in bytes.  Must be at least the
+ *                      hash size of the given hash algorithm.
+ *
+ * \returns a status code indicating success or failure.
+ *      - \ref VCCRYPT_STATUS_SUCCESS on success.
+ *      - \ref VCCRYPT_ERROR_HASH_ONESHOT_INVALID_ARG if an invalid argument is
+ *             provided.
+ *      - a non-zero error code on failure.
+ */
+int vccrypt_hash_oneshot(
+    vccrypt_hash_options_t* options, const uint8_t* data, size_t size,
+    uint8_t* md, size_t md_size)
+{
+    MODEL_ASSERT(options != NULL);
+    MODEL_ASSERT(options->hash_size > 0);
+    MODEL_ASSERT(data != NULL || size == 0);
+    MODEL_ASSERT(md != NULL);
+    MODEL_ASSERT(md_size >= options->hash_size);
+
+    /* sanity check on parameters */
+    if (options == NULL || (data == NULL && size > 0) || md == NULL ||
+        md_size < options->hash_size)
+    {
+        return VCCRYPT_ERROR_HASH_ONESHOT_INVALID_ARG;
+    }
+
+    /* use the algorithm's own one-shot hash if it has one. */
+    if (options->vccrypt_hash_alg_oneshot != NULL)
+    {
+        return options->vccrypt_hash_alg_oneshot(options, data, size, md);
+    }
+
+    return vccrypt_hash_oneshot_context(options, data, size, md);
+}
+
+/**
+ * Hash a single message using a hash instance.
+ *
+ * \param options       The options for the hash algorithm to use.
+ * \param data          The message to hash.
+ * \param size          The size of the message, in bytes.
+ * \param md            The memory to receive the hash.
+ *
+ * \returns \ref VCCRYPT_STATUS_SUCCESS on success and non-zero on failure.
+ */
+static int vccrypt_hash_oneshot_context(
+    vccrypt_hash_options_t* options, const uint8_t* data, size_t size,
+    uint8_t* md)
+{
+    vccrypt_hash_context_t context;
+    vccrypt_buffer_t md_buffer;
+    int retval;
+
+    retval = vccrypt_hash_init(options, &context);
+    if (VCCRYPT_STATUS_SUCCESS != retval)
+    {
+        return retval;
+    }
+
+    if (size > 0)
+    {
+        retval = vccrypt_hash_digest(&context, data, size);
+        if (VCCRYPT_STATUS_SUCCESS != retval)
+        {
+            goto dispose_context;
+        }
+    }
+
+    /* finalize through a buffer that borrows the caller's memory.  It is
+     * never initialized, so it must not be disposed. */
+    memset(&md_buffer, 0, sizeof(md_buffer));
+    md_buffer.data = md;
+    md_buffer.size = options->hash_size;
+
+    retval = vccrypt_hash_finalize(&context, &md_buffer);
+
+dispose_context:
+    dispose((disposable_t*)&context);
+
+    return retval;
+}
@@ -0,0 +1,202 @@
+/**
+ * \file vccrypt_hash_register_SHA_2_256.c
+ *
+ * Register SHA-256 and force a link dependency so that this algorithm can be
+ * used at runtime.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <cbmc/model_assert.h>
+#include <stdbool.h>
+#include <string.h>
+#include <vccrypt/hash.h>
+#include <vpr/abstract_factory.h>
+#include <vpr/allocator.h>
+#include <vpr/parameters.h>
+
+#include "hash_private.h"
+#include "ref/sha256.h"
+
+/* forward decls */
+static int vccrypt_sha_256_init(void* options, void* context);
+static void vccrypt_sha_256_dispose(void* options, void* context);
+static int vccrypt_sha_256_digest(
+    void* context, const uint8_t* data, size_t size);
+static int vccrypt_sha_256_finalize(
+    void* context, vccrypt_buffer_t* hash_buffer);
+static int vccrypt_sha_256_clone(
+    void* options, void* dest, const void* src);
+static int vccrypt_sha_256_oneshot(
+    void* options, const uint8_t* data, size_t size, uint8_t* md);
+
+/* static data for this instance */
+static abstract_factory_registration_t sha256_impl;
+static vccrypt_hash_options_t sha256_options;
+static bool sha256_impl_registered = false;
+
+/**
+ * Register SHA-256 for use by the crypto library.
+ */
+void vccrypt_hash_register_SHA_2_256()
+{
+    /* only register once */
+    if (sha256_impl_registered)
+    {
+        return;
+    }
+
+    /* set up the options for SHA-256 */
+    sha256_options.hdr.dispose = 0; /* disposal handled by init */
+    sha256_options.alloc_opts = 0; /* allocator handled by init */
+    sha256_options.hash_size = VCCRYPT_HASH_SHA_256_DIGEST_SIZE;
+    sha256_options.hash_block_size = VCCRYPT_HASH_SHA_256_BLOCK_SIZE;
+    sha256_options.vccrypt_hash_alg_init = &vccrypt_sha_256_init;
+    sha256_options.vccrypt_hash_alg_dispose = &vccrypt_sha_256_dispose;
+    sha256_options.vccrypt_hash_alg_digest = &vccrypt_sha_256_digest;
+    sha256_options.vccrypt_hash_alg_finalize = &vccrypt_sha_256_finalize;
+    sha256_options.vccrypt_hash_alg_clone = &vccrypt_sha_256_clone;
+    sha256_options.vccrypt_hash_alg_oneshot = &vccrypt_sha_256_oneshot;
+
+    /* set up this registration for the abstract factory. */
+    sha256_impl.interface = VCCRYPT_INTERFACE_HASH;
+    sha256_impl.implementation = VCCRYPT_HASH_ALGORITHM_SHA_2_256;
+    sha256_impl.implementation_features = VCCRYPT_HASH_ALGORITHM_SHA_2_256;
+    sha256_impl.factory = 0;
+    sha256_impl.context = &sha256_options;
+
+    /* register this instance. */
+    abstract_factory_register(&sha256_impl);
+
+    /* only register once */
+    sha256_impl_registered = true;
+}
+
+/**
+ * Algorithm-specific initialization for hash.
+ *
+ * \param options   Opaque pointer to this options structure.
+ * \param context   Opaque pointer to vccrypt_hash_context_t structure.
+ *
+ * \returns 0 on success and non-zero on error.
+ */
+static int vccrypt_sha_256_init(void* UNUSED(options), void* context)
+{
+    vccrypt_hash_context_t* ctx = (vccrypt_hash_context_t*)context;
+
+    /* the SHA-256 state lives in the context, so no allocation is needed. */
+    ctx->hash_state = ctx->hash_state_inline;
+
+    /* initialize this context. */
+    SHA256_Init((SHA256_CTX*)ctx->hash_state);
+
+    /* success */
+    return VCCRYPT_STATUS_SUCCESS;
+}
+
+/**
+ * Algorithm-specific disposal for hash.
+ *
+ * \param options   Opaque pointer to this options structure.
+ * \param context   Opaque pointer to vccrypt_hash_context_t structure.
+ */
+static void vccrypt_sha_256_dispose(void* UNUSED(options), void* context)
+{
+    vccrypt_hash_context_t* ctx = (vccrypt_hash_context_t*)context;
+
+    /* clear the hash state structure if initialized. */
+    if (ctx->hash_state != NULL)
+    {
+        memset(ctx->hash_state, 0, sizeof(SHA256_CTX));
+        ctx->hash_state = NULL;
+    }
+}
+
+/**
+ * Digest data for the given hash instance.
+ *
+ * \param context       An opaque pointer to the vccrypt_hash_context_t
+ *                      structure.
+ * \param data          A pointer to raw data to digest.
+ * \param size          The size of the data to digest, in bytes.
+ *
+ * \returns 0 on success and 1 on failure.
+ */
+static int vccrypt_sha_256_digest(
+    void* context, const uint8_t* data, size_t size)
+{
+    vccrypt_hash_context_t* ctx = (vccrypt_hash_context_t*)context;
+
+    SHA256_Update((SHA256_CTX*)ctx->hash_state, data, size);
+
+    /* success */
+    return VCCRYPT_STATUS_SUCCESS;
+}
+
+/**
+ * Finalize the hash, copying the output data to the given buffer.
+ *
+ * \param context       An opaque pointer to the vccrypt_hash_context_t
+ *                      structure.
+ * \param hash_buffer   The buffer to receive the hash.  Must be large
+ *                      enough for the given hash algorithm.
+ *
+ * \returns 0 on success and 1 on failure.
+ */
+static int vccrypt_sha_256_finalize(
+    void* context, vccrypt_buffer_t* hash_buffer)
+{
+    vccrypt_hash_context_t* ctx = (vccrypt_hash_context_t*)context;
+
+    return SHA256_Final((SHA256_CTX*)ctx->hash_state, hash_buffer->data);
+}
+
+/**
+ * Copy the SHA-256 state of one hash instance into another.
+ *
+ * \param options       Opaque pointer to this options structure.
+ * \param dest          Opaque pointer to the vccrypt_hash_context_t
+ *                      structure receiving the copy.
+ * \param src           Opaque pointer to the vccrypt_hash_context_t
+ *                      structure to copy.
+ *
+ * \returns 0 on success and non-zero on failure.
+ */
+static int vccrypt_sha_256_clone(
+    void* UNUSED(options), void* dest, const void* src)
+{
+    vccrypt_hash_context_t* dctx = (vccrypt_hash_context_t*)dest;
+    const vccrypt_hash_context_t* sctx = (const vccrypt_hash_context_t*)src;
+
+    /* the copy gets its own inline state. */
+    dctx->hash_state = dctx->hash_state_inline;
+    memcpy(dctx->hash_state, sctx->hash_state, sizeof(SHA256_CTX));
+
+    /* success */
+    return VCCRYPT_STATUS_SUCCESS;
+}
+
+/**
+ * Hash a single message with SHA-256, without a hash instance.
+ *
+ * \param options       Opaque pointer to this options structure.
+ * \param data          The message to hash.
+ * \param size          The size of the message, in bytes.
+ * \param md            The memory to receive the hash.
+ *
+ * \returns 0 on success and non-zero on failure.
+ */
+static int vccrypt_sha_256_oneshot(
+    void* UNUSED(options), const uint8_t* data, size_t size, uint8_t* md)
+{
+    SHA256_CTX ctx;
+
+    SHA256_Init(&ctx);
+    SHA256_Update(&ctx, data, size);
+    int retval = SHA256_Final(&ctx, md);
+
+    /* don't leave the message state on the stack. */
+    memset(&ctx, 0, sizeof(ctx));
+
+    return retval;
+}
@@ -0,0 +1,233 @@
+/**
+ * \file vccrypt_hash_register_SHA_2_512_224.c
+ *
+ * Register SHA-512/224 and force a link dependency so that this algorithm can
+ * be used at runtime.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <cbmc/model_assert.h>
+#include <stdbool.h>
+#include <string.h>
+#include <vccrypt/hash.h>
+#include <vpr/abstract_factory.h>
+#include <vpr/allocator.h>
+#include <vpr/parameters.h>
+
+#include "hash_private.h"
+#include "ref/sha512.h"
+
+/* forward decls */
+static int vccrypt_sha_512_224_init(void* options, void* context);
+static void vccrypt_sha_512_224_dispose(void* options, void* context);
+static int vccrypt_sha_512_224_digest(
+    void* context, const uint8_t* data, size_t size);
+static int vccrypt_sha_512_224_finalize(
+    void* context, vccrypt_buffer_t* hash_buffer);
+static int vccrypt_sha_512_224_batch_digest(
+    void* options, const uint8_t* const* data, const size_t* sizes,
+    vccrypt_buffer_t* hash_buffers, size_t count);
+static int vccrypt_sha_512_224_clone(
+    void* options, void* dest, const void* src);
+static int vccrypt_sha_512_224_oneshot(
+    void* options, const uint8_t* data, size_t size, uint8_t* md);
+
+/* static data for this instance */
+static abstract_factory_registration_t sha512_224_impl;
+static vccrypt_hash_options_t sha512_224_options;
+static bool sha512_224_impl_registered = false;
+
+/**
+ * Register SHA-512/224 for use by the crypto library.
+ */
+void vccrypt_hash_register_SHA_2_512_224()
+{
+    /* only register once */
+    if (sha512_224_impl_registered)
+    {
+        return;
+    }
+
+    /* set up the options for SHA-512/224 */
+    sha512_224_options.hdr.dispose = 0; /* disposal handled by init */
+    sha512_224_options.alloc_opts = 0; /* allocator handled by init */
+    sha512_224_options.hash_size =
+        VCCRYPT_HASH_SHA_512_224_DIGEST_SIZE;
+    sha512_224_options.hash_block_size =
+        VCCRYPT_HASH_SHA_512_224_BLOCK_SIZE;
+    sha512_224_options.vccrypt_hash_alg_init = &vccrypt_sha_512_224_init;
+    sha512_224_options.vccrypt_hash_alg_dispose = &vccrypt_sha_512_224_dispose;
+    sha512_224_options.vccrypt_hash_alg_digest = &vccrypt_sha_512_224_digest;
+    sha512_224_options.vccrypt_hash_alg_finalize =
+        &vccrypt_sha_512_224_finalize;
+    sha512_224_options.vccrypt_hash_alg_batch_digest =
+        &vccrypt_sha_512_224_batch_digest;
+    sha512_224_options.vccrypt_hash_alg_clone = &vccrypt_sha_512_224_clone;
+    sha512_224_options.vccrypt_hash_alg_oneshot = &vccrypt_sha_512_224_oneshot;
+
+    /* set up this registration for the abstract factory. */
+    sha512_224_impl.interface = VCCRYPT_INTERFACE_HASH;
+    sha512_224_impl.implementation =
+        VCCRYPT_HASH_ALGORITHM_SHA_2_512_224;
+    sha512_224_impl.implementation_features =
+        VCCRYPT_HASH_ALGORITHM_SHA_2_512_224;
+    sha512_224_impl.factory = 0;
+    sha512_224_impl.context = &sha512_224_options;
+
+    /* register this instance. */
+    abstract_factory_register(&sha512_224_impl);
+
+    /* only register once */
+    sha512_224_impl_registered = true;
+}
+
+/**
+ * Algorithm-specific initialization for hash.
+ *
+ * \param options   Opaque pointer to this options structure.
+ * \param context   Opaque pointer to vccrypt_hash_context_t structure.
+ *
+ * \returns 0 on success and non-zero on error.
+ */
+static int vccrypt_sha_512_224_init(void* UNUSED(options), void* context)
+{
+    vccrypt_hash_context_t* ctx = (vccrypt_hash_context_t*)context;
+
+    /* the SHA-512/224 state lives in the context, so no allocation is
+     * needed. */
+    ctx->hash_state = ctx->hash_state_inline;
+
+    /* initialize this context. */
+    SHA512_224_Init((SHA512_CTX*)ctx->hash_state);
+
+    /* success */
+    return VCCRYPT_STATUS_SUCCESS;
+}
+
+/**
+ * Algorithm-specific disposal for hash.
+ *
+ * \param options   Opaque pointer to this options structure.
+ * \param context   Opaque pointer to vccrypt_hash_context_t structure.
+ */
+static void vccrypt_sha_512_224_dispose(void* UNUSED(options), void* context)
+{
+    vccrypt_hash_context_t* ctx = (vccrypt_hash_context_t*)context;
+
+    /* clear the hash state structure if initialized. */
+    if (ctx->hash_state != NULL)
+    {
+        memset(ctx->hash_state, 0, sizeof(SHA512_CTX));
+        ctx->hash_state = NULL;
+    }
+}
+
+/**
+ * Digest data for the given hash instance.
+ *
+ * \param context       An opaque pointer to the vccrypt_hash_context_t
+ *                      structure.
+ * \param data          A pointer to raw data to digest.
+ * \param size          The size of the data to digest, in bytes.
+ *
+ * \returns 0 on success and 1 on failure.
+ */
+static int vccrypt_sha_512_224_digest(
+    void* context, const uint8_t* data, size_t size)
+{
+    vccrypt_hash_context_t* ctx = (vccrypt_hash_context_t*)context;
+
+    SHA512_224_Update((SHA512_CTX*)ctx->hash_state, data, size);
+
+    /* success */
+    return VCCRYPT_STATUS_SUCCESS;
+}
+
+/**
+ * Finalize the hash, copying the output data to the given buffer.
+ *
+ * \param context       An opaque pointer to the vccrypt_hash_context_t
+ *                      structure.
+ * \param hash_buffer   The buffer to receive the hash.  Must be large
+ *                      enough for the given hash algorithm.
+ *
+ * \returns 0 on success and 1 on failure.
+ */
+static int vccrypt_sha_512_224_finalize(
+    void* context, vccrypt_buffer_t* hash_buffer)
+{
+    vccrypt_hash_context_t* ctx = (vccrypt_hash_context_t*)context;
+
+    return SHA512_224_Final((SHA512_CTX*)ctx->hash_state, hash_buffer->data);
+}
+
+/**
+ * Hash a batch of independent messages in lockstep.
+ *
+ * \param options       Opaque pointer to this options structure.
+ * \param data          Array of pointers to the messages to hash.
+ * \param sizes         Array of message sizes, in bytes.
+ * \param hash_buffers  Array of buffers to receive each hash.
+ * \param count         The number of messages.
+ *
+ * \returns 0 on success and non-zero on failure.
+ */
+static int vccrypt_sha_512_224_batch_digest(
+    void* UNUSED(options), const uint8_t* const* data, const size_t* sizes,
+    vccrypt_buffer_t* hash_buffers, size_t count)
+{
+    return
+        vccrypt_sha512_batch_digest(
+            &SHA512_224_Init, data, sizes, hash_buffers, count);
+}
+
+/**
+ * Copy the SHA-512/224 state of one hash instance into another.
+ *
+ * \param options       Opaque pointer to this options structure.
+ * \param dest          Opaque pointer to the vccrypt_hash_context_t
+ *                      structure receiving the copy.
+ * \param src           Opaque pointer to the vccrypt_hash_context_t
+ *                      structure to copy.
+ *
+ * \returns 0 on success and non-zero on failure.
+ */
+static int vccrypt_sha_512_224_clone(
+    void* UNUSED(options), void* dest, const void* src)
+{
+    vccrypt_hash_context_t* dctx = (vccrypt_hash_context_t*)dest;
+    const vccrypt_hash_context_t* sctx = (const vccrypt_hash_context_t*)src;
+
+    /* the copy gets its own inline state. */
+    dctx->hash_state = dctx->hash_state_inline;
+    memcpy(dctx->hash_state, sctx->hash_state, sizeof(SHA512_CTX));
+
+    /* success */
+    return VCCRYPT_STATUS_SUCCESS;
+}
+
+/**
+ * Hash a single message with SHA-512/224, without a hash instance.
+ *
+ * \param options       Opaque pointer to this options structure.
+ * \param data          The message to hash.
+ * \param size          The size of the message, in bytes.
+ * \param md            The memory to receive the hash.
+ *
+ * \returns 0 on success and non-zero on failure.
+ */
+static int vccrypt_sha_512_224_oneshot(
+    void* UNUSED(options), const uint8_t* data, size_t size, uint8_t* md)
+{
+    SHA512_CTX ctx;
+
+    SHA512_224_Init(&ctx);
+    SHA512_224_Update(&ctx, data, size);
+    int retval = SHA512_224_Final(&ctx, md);
+
+    /* don't leave the message state on the stack. */
+    memset(&ctx, 0, sizeof(ctx));
+
+    return retval;
+}
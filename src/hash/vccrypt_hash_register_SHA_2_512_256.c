@@ -15,6 +15,7 @@
 #include <vpr/allocator.h>
 #include <vpr/parameters.h>
 
+#include "hash_private.h"
 #include "ref/sha512.h"
 
 /* forward decls */
@@ -24,6 +25,13 @@ static int vccrypt_sha_512_256_digest(
     void* context, const uint8_t* data, size_t size);
 static int vccrypt_sha_512_256_finalize(
     void* context, vccrypt_buffer_t* hash_buffer);
+static int vccrypt_sha_512_256_batch_digest(
+    void* options, const uint8_t* const* data, const size_t* sizes,
+    vccrypt_buffer_t* hash_buffers, size_t count);
+static int vccrypt_sha_512_256_clone(
+    void* options, void* dest, const void* src);
+static int vccrypt_sha_512_256_oneshot(
+    void* options, const uint8_t* data, size_t size, uint8_t* md);
 
 /* static data for this instance */
 static abstract_factory_registration_t sha512_256_impl;
@@ -53,6 +61,10 @@ void vccrypt_hash_register_SHA_2_512_256()
     sha512_256_options.vccrypt_hash_alg_digest = &vccrypt_sha_512_256_digest;
     sha512_256_options.vccrypt_hash_alg_finalize =
         &vccrypt_sha_512_256_finalize;
+    sha512_256_options.vccrypt_hash_alg_batch_digest =
+        &vccrypt_sha_512_256_batch_digest;
+    sha512_256_options.vccrypt_hash_alg_clone = &vccrypt_sha_512_256_clone;
+    sha512_256_options.vccrypt_hash_alg_oneshot = &vccrypt_sha_512_256_oneshot;
 
     /* set up this registration for the abstract factory. */
     sha512_256_impl.interface = VCCRYPT_INTERFACE_HASH;
@@ -78,17 +90,13 @@ void vccrypt_hash_register_SHA_2_512_256()
  *
  * \returns 0 on success and non-zero on error.
  */
-static int vccrypt_sha_512_256_init(void* options, void* context)
+static int vccrypt_sha_512_256_init(void* UNUSED(options), void* context)
 {
-    vccrypt_hash_options_t* opts = (vccrypt_hash_options_t*)options;
     vccrypt_hash_context_t* ctx = (vccrypt_hash_context_t*)context;
 
-    /* allocate space for the SHA-512/256 context. */
-    ctx->hash_state = allocate(opts->alloc_opts, sizeof(SHA512_CTX));
-    if (ctx->hash_state == NULL)
-    {
-        return VCCRYPT_ERROR_HASH_INIT_OUT_OF_MEMORY;
-    }
+    /* the SHA-512/256 state lives in the context, so no allocation is
+     * needed. */
+    ctx->hash_state = ctx->hash_state_inline;
 
     /* initialize this context. */
     SHA512_256_Init((SHA512_CTX*)ctx->hash_state);
@@ -103,16 +111,15 @@ static int vccrypt_sha_512_256_init(void* options, void* context)
  * \param options   Opaque pointer to this options structure.
  * \param context   Opaque pointer to vccrypt_hash_context_t structure.
  */
-static void vccrypt_sha_512_256_dispose(void* options, void* context)
+static void vccrypt_sha_512_256_dispose(void* UNUSED(options), void* context)
 {
-    vccrypt_hash_options_t* opts = (vccrypt_hash_options_t*)options;
     vccrypt_hash_context_t* ctx = (vccrypt_hash_context_t*)context;
 
-    /* clear the hash state structure if allocated. */
+    /* clear the hash state structure if initialized. */
     if (ctx->hash_state != NULL)
     {
         memset(ctx->hash_state, 0, sizeof(SHA512_CTX));
-        release(opts->alloc_opts, ctx->hash_state);
+        ctx->hash_state = NULL;
     }
 }
 
@@ -154,3 +161,73 @@ static int vccrypt_sha_512_256_finalize(
 
     return SHA512_256_Final((SHA512_CTX*)ctx->hash_state, hash_buffer->data);
 }
+
+/**
+ * Hash a batch of independent messages in lockstep.
+ *
+ * \param options       Opaque pointer to this options structure.
+ * \param data          Array of pointers to the messages to hash.
+ * \param sizes         Array of message sizes, in bytes.
+ * \param hash_buffers  Array of buffers to receive each hash.
+ * \param count         The number of messages.
+ *
+ * \returns 0 on success and non-zero on failure.
+ */
+static int vccrypt_sha_512_256_batch_digest(
+    void* UNUSED(options), const uint8_t* const* data, const size_t* sizes,
+    vccrypt_buffer_t* hash_buffers, size_t count)
+{
+    return
+        vccrypt_sha512_batch_digest(
+            &SHA512_256_Init, data, sizes, hash_buffers, count);
+}
+
+/**
+ * Copy the SHA-512/256 state of one hash instance into another.
+ *
+ * \param options       Opaque pointer to this options structure.
+ * \param dest          Opaque pointer to the vccrypt_hash_context_t
+ *                      structure receiving the copy.
+ * \param src           Opaque pointer to the vccrypt_hash_context_t
+ *                      structure to copy.
+ *
+ * \returns 0 on success and non-zero on failure.
+ */
+static int vccrypt_sha_512_256_clone(
+    void* UNUSED(options), void* dest, const void* src)
+{
+    vccrypt_hash_context_t* dctx = (vccrypt_hash_context_t*)dest;
+    const vccrypt_hash_context_t* sctx = (const vccrypt_hash_context_t*)src;
+
+    /* the copy gets its own inline state. */
+    dctx->hash_state = dctx->hash_state_inline;
+    memcpy(dctx->hash_state, sctx->hash_state, sizeof(SHA512_CTX));
+
+    /* success */
+    return VCCRYPT_STATUS_SUCCESS;
+}
+
+/**
+ * Hash a single message with SHA-512/256, without a hash instance.
+ *
+ * \param options       Opaque pointer to this options structure.
+ * \param data          The message to hash.
+ * \param size          The size of the message, in bytes.
+ * \param md            The memory to receive the hash.
+ *
+ * \returns 0 on success and non-zero on failure.
+ */
+static int vccrypt_sha_512_256_oneshot(
+    void* UNUSED(options), const uint8_t* data, size_t size, uint8_t* md)
+{
+    SHA512_CTX ctx;
+
+    SHA512_256_Init(&ctx);
+    SHA512_256_Update(&ctx, data, size);
+    int retval = SHA512_256_Final(&ctx, md);
+
+    /* don't leave the message state on the stack. */
+    memset(&ctx, 0, sizeof(ctx));
+
+    return retval;
+}
@@ -0,0 +1,289 @@
+/**
+ * \file vccrypt_sha512_batch_digest.c
+ *
+ * Multi-buffer batch hashing for the SHA-512 family.
+ *
+ * Each lane of the multi-buffer block function is assigned a message.  All
+ * lanes advance one block per step, and as soon as a lane finishes its
+ * message, it picks up the next message in the batch.  This keeps the lanes
+ * busy even when message lengths differ.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <cbmc/model_assert.h>
+#include <stdbool.h>
+#include <string.h>
+#include <vccrypt/hash.h>
+#include <vpr/parameters.h>
+
+#include "hash_private.h"
+#include "ref/sha512_internal.h"
+
+/**
+ * The state of a single lane.
+ */
+typedef struct sha512_batch_lane
+{
+    SHA512_CTX ctx;
+    const uint8_t* prefix;
+    const uint8_t* data;
+    size_t full_blocks;
+    uint8_t tail[2 * SHA512_CBLOCK];
+    size_t tail_blocks;
+    size_t tail_offset;
+    uint8_t* md;
+    bool active;
+} sha512_batch_lane_t;
+
+/**
+ * The arrays of a vccrypt_sha512_batch_digest() call.
+ */
+typedef struct sha512_batch_arrays
+{
+    const uint8_t* const* data;
+    const size_t* sizes;
+    vccrypt_buffer_t* hash_buffers;
+} sha512_batch_arrays_t;
+
+/* forward decls */
+static void sha512_batch_lane_load(
+    sha512_batch_lane_t* lane, void (*init)(SHA512_CTX*),
+    const vccrypt_sha512_batch_item_t* item);
+static void sha512_batch_lane_output(const sha512_batch_lane_t* lane);
+static void sha512_batch_arrays_item(
+    void* user, size_t index, vccrypt_sha512_batch_item_t* item);
+
+/**
+ * Hash a batch of messages with a member of the SHA-512 family, interleaving
+ * several messages across the lanes of the multi-buffer block function.
+ *
+ * \param init          The SHA-512 family init function, which selects the
+ *                      initial state and digest length.
+ * \param data          Array of pointers to the messages to hash.
+ * \param sizes         Array of message sizes, in bytes.
+ * \param hash_buffers  Array of buffers to receive each hash.
+ * \param count         The number of messages to hash.
+ *
+ * \returns \ref VCCRYPT_STATUS_SUCCESS on success and non-zero on failure.
+ */
+int vccrypt_sha512_batch_digest(
+    void (*init)(SHA512_CTX*), const uint8_t* const* data,
+    const size_t* sizes, vccrypt_buffer_t* hash_buffers, size_t count)
+{
+    sha512_batch_arrays_t arrays;
+
+    MODEL_ASSERT(init != NULL);
+    MODEL_ASSERT(count == 0 || data != NULL);
+    MODEL_ASSERT(count == 0 || sizes != NULL);
+    MODEL_ASSERT(count == 0 || hash_buffers != NULL);
+
+    arrays.data = data;
+    arrays.sizes = sizes;
+    arrays.hash_buffers = hash_buffers;
+
+    vccrypt_sha512_batch_run(init, &sha512_batch_arrays_item, &arrays, count);
+
+    /* success */
+    return VCCRYPT_STATUS_SUCCESS;
+}
+
+/**
+ * Hash a batch of messages with a member of the SHA-512 family, interleaving
+ * several messages across the lanes of the multi-buffer block function.
+ *
+ * \param init          The SHA-512 family init function, which selects the
+ *                      initial state and digest length.
+ * \param get_item      Callback that describes the message at the given
+ *                      index.
+ * \param user          Opaque pointer passed to get_item.
+ * \param count         The number of messages to hash.
+ */
+void vccrypt_sha512_batch_run(
+    void (*init)(SHA512_CTX*),
+    void (*get_item)(
+        void* user, size_t index, vccrypt_sha512_batch_item_t* item),
+    void* user, size_t count)
+{
+    /* idle lanes digest this block into a scratch context. */
+    static const uint8_t idle_block[SHA512_CBLOCK] = { 0 };
+    sha512_batch_lane_t lanes[SHA512_MB_LANES];
+    SHA512_CTX idle_ctx[SHA512_MB_LANES];
+    SHA512_CTX* ctx[SHA512_MB_LANES];
+    const uint8_t* in[SHA512_MB_LANES];
+    vccrypt_sha512_batch_item_t item;
+    size_t next = 0;
+    int active = 0;
+    int i;
+
+    MODEL_ASSERT(init != NULL);
+    MODEL_ASSERT(get_item != NULL);
+
+    memset(lanes, 0, sizeof(lanes));
+    memset(idle_ctx, 0, sizeof(idle_ctx));
+
+    /* give each lane its first message. */
+    for (i = 0; i < SHA512_MB_LANES && next < count; ++i, ++next)
+    {
+        get_item(user, next, &item);
+        sha512_batch_lane_load(lanes + i, init, &item);
+        ++active;
+    }
+
+    while (active > 0)
+    {
+        for (i = 0; i < SHA512_MB_LANES; ++i)
+        {
+            if (!lanes[i].active)
+            {
+                ctx[i] = idle_ctx + i;
+                in[i] = idle_block;
+            }
+            else
+            {
+                ctx[i] = &lanes[i].ctx;
+                if (NULL != lanes[i].prefix)
+                {
+                    in[i] = lanes[i].prefix;
+                }
+                else if (lanes[i].full_blocks > 0)
+                {
+                    in[i] = lanes[i].data;
+                }
+                else
+                {
+                    in[i] = lanes[i].tail + lanes[i].tail_offset;
+                }
+            }
+        }
+
+        sha512_mb_block(ctx, in);
+
+        for (i = 0; i < SHA512_MB_LANES; ++i)
+        {
+            sha512_batch_lane_t* lane = lanes + i;
+
+            if (!lane->active)
+            {
+                continue;
+            }
+
+            if (NULL != lane->prefix)
+            {
+                lane->prefix = NULL;
+                continue;
+            }
+
+            if (lane->full_blocks > 0)
+            {
+                --lane->full_blocks;
+                lane->data += SHA512_CBLOCK;
+                continue;
+            }
+
+            lane->tail_offset += SHA512_CBLOCK;
+            if (lane->tail_offset < lane->tail_blocks * SHA512_CBLOCK)
+            {
+                continue;
+            }
+
+            /* this message is done; start the next one in this lane. */
+            sha512_batch_lane_output(lane);
+            if (next < count)
+            {
+                get_item(user, next, &item);
+                sha512_batch_lane_load(lane, init, &item);
+                ++next;
+            }
+            else
+            {
+                lane->active = false;
+                --active;
+            }
+        }
+    }
+
+    /* clear the lane state, which holds message data. */
+    memset(lanes, 0, sizeof(lanes));
+}
+
+/**
+ * Start hashing a message in the given lane.
+ *
+ * The whole blocks of the message are read in place, and the remaining bytes
+ * are padded into the lane's tail buffer.
+ *
+ * \param lane          The lane to load.
+ * \param init          The SHA-512 family init function.
+ * \param item          The message.
+ */
+static void sha512_batch_lane_load(
+    sha512_batch_lane_t* lane, void (*init)(SHA512_CTX*),
+    const vccrypt_sha512_batch_item_t* item)
+{
+    size_t size = item->size;
+    size_t rem = size % SHA512_CBLOCK;
+    size_t tail_size;
+    int i;
+
+    /* the prefix block counts towards the message length. */
+    uint64_t total = (uint64_t)size + (item->prefix ? SHA512_CBLOCK : 0);
+    uint64_t bits_hi = total >> 61;
+    uint64_t bits_lo = total << 3;
+
+    init(&lane->ctx);
+    lane->prefix = item->prefix;
+    lane->data = item->data;
+    lane->full_blocks = size / SHA512_CBLOCK;
+    lane->md = item->md;
+    lane->active = true;
+
+    /* the tail needs room for the 0x80 marker and the 128-bit length. */
+    lane->tail_blocks = (rem + 1 + 16 <= SHA512_CBLOCK) ? 1 : 2;
+    lane->tail_offset = 0;
+    tail_size = lane->tail_blocks * SHA512_CBLOCK;
+
+    memset(lane->tail, 0, sizeof(lane->tail));
+    if (rem > 0)
+    {
+        memcpy(lane->tail, item->data + (size - rem), rem);
+    }
+    lane->tail[rem] = 0x80;
+
+    for (i = 0; i < 8; ++i)
+    {
+        lane->tail[tail_size - 16 + i] = (uint8_t)(bits_hi >> (56 - 8 * i));
+        lane->tail[tail_size - 8 + i] = (uint8_t)(bits_lo >> (56 - 8 * i));
+    }
+}
+
+/**
+ * Write the digest for a finished lane.
+ *
+ * \param lane          The finished lane.
+ */
+static void sha512_batch_lane_output(const sha512_batch_lane_t* lane)
+{
+    for (unsigned int i = 0; i < lane->ctx.md_len; ++i)
+    {
+        lane->md[i] = (uint8_t)(lane->ctx.h[i / 8] >> (56 - 8 * (i % 8)));
+    }
+}
+
+/**
+ * Describe a message of a vccrypt_sha512_batch_digest() call.
+ *
+ * \param user          The sha512_batch_arrays_t of the call.
+ * \param index         The index of the message.
+ * \param item          The item to fill in.
+ */
+static void sha512_batch_arrays_item(
+    void* user, size_t index, vccrypt_sha512_batch_item_t* item)
+{
+    const sha512_batch_arrays_t* arrays = (const sha512_batch_arrays_t*)user;
+
+    item->prefix = NULL;
+    item->data = arrays->data[index];
+    item->size = arrays->sizes[index];
+    item->md = (uint8_t*)arrays->hash_buffers[index].data;
+}
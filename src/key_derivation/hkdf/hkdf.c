@@ -0,0 +1,229 @@
+/**
+ * \file hkdf.c
+ *
+ * HMAC-based Extract-and-Expand Key Derivation Function (RFC 5869).
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <cbmc/model_assert.h>
+#include <stdint.h>
+#include <string.h>
+#include <vccrypt/error_codes.h>
+#include <vccrypt/mac.h>
+#include <vpr/allocator.h>
+#include <vpr/parameters.h>
+
+#include "hkdf.h"
+
+/**
+ * \brief Extract a pseudorandom key from input keying material.
+ *
+ * \param prk                 Receives hmac_digest_length bytes of
+ *                            pseudorandom key.
+ * \param options             The options to use
+ * \param salt                The salt, or NULL for the default salt of
+ *                            hmac_digest_length zero bytes.
+ * \param salt_len            The length of the salt
+ * \param ikm                 The input keying material
+ * \param ikm_len             The length of the input keying material
+ *
+ * \returns a status code indicating success or failure.
+ *      - \ref VCCRYPT_STATUS_SUCCESS if successful.
+ *      - \ref VCCRYPT_ERROR_HKDF_INVALID_ARG if an argument is invalid.
+ *      - a non-zero error code indicating failure.
+ */
+int hkdf_extract(
+    uint8_t* prk, vccrypt_key_derivation_options_t* options,
+    const uint8_t* salt, size_t salt_len,
+    const uint8_t* ikm, size_t ikm_len)
+{
+    uint8_t zero_salt[HKDF_MAX_DIGEST_LENGTH];
+    vccrypt_mac_options_t mac_options;
+    vccrypt_mac_context_t mac_context;
+    vccrypt_buffer_t keybuf;
+    vccrypt_buffer_t prkbuf;
+    int retval;
+
+    MODEL_ASSERT(NULL != prk);
+    MODEL_ASSERT(NULL != options);
+    MODEL_ASSERT(NULL != ikm || 0 == ikm_len);
+
+    if (options->hmac_digest_length == 0 ||
+        options->hmac_digest_length > HKDF_MAX_DIGEST_LENGTH)
+    {
+        return VCCRYPT_ERROR_HKDF_INVALID_ARG;
+    }
+
+    /* an absent salt is a string of hmac_digest_length zeros. */
+    if (NULL == salt || 0 == salt_len)
+    {
+        memset(zero_salt, 0, sizeof(zero_salt));
+        salt = zero_salt;
+        salt_len = options->hmac_digest_length;
+    }
+
+    retval = vccrypt_mac_options_init(
+        &mac_options, options->alloc_opts, options->hmac_algorithm);
+    if (0 != retval)
+    {
+        return retval;
+    }
+
+    /* the salt is the HMAC key; borrow it instead of copying it. */
+    memset(&keybuf, 0, sizeof(keybuf));
+    keybuf.data = (void*)salt;
+    keybuf.size = salt_len;
+
+    retval = vccrypt_mac_init(&mac_options, &mac_context, &keybuf);
+    if (0 != retval)
+    {
+        goto cleanup_mac_options;
+    }
+
+    if (ikm_len > 0)
+    {
+        retval = vccrypt_mac_digest(&mac_context, ikm, ikm_len);
+        if (0 != retval)
+        {
+            goto cleanup_mac_context;
+        }
+    }
+
+    /* finalize directly into the caller's memory. */
+    memset(&prkbuf, 0, sizeof(prkbuf));
+    prkbuf.data = prk;
+    prkbuf.size = options->hmac_digest_length;
+
+    retval = vccrypt_mac_finalize(&mac_context, &prkbuf);
+
+cleanup_mac_context:
+    dispose((disposable_t*)&mac_context);
+
+cleanup_mac_options:
+    dispose((disposable_t*)&mac_options);
+
+    return retval;
+}
+
+/**
+ * \brief Expand a pseudorandom key into output keying material.
+ *
+ * The HMAC is keyed with the pseudorandom key once.  Each finalize returns it
+ * to the keyed state, so every output block starts from the precomputed inner
+ * and outer midstates instead of rehashing the key.
+ *
+ * \param okm                 The output keying material
+ * \param okm_len             The length of the output keying material, at
+ *                            most 255 * hmac_digest_length bytes.
+ * \param options             The options to use
+ * \param prk                 The pseudorandom key
+ * \param prk_len             The length of the pseudorandom key
+ * \param info                Optional context information, or NULL.
+ * \param info_len            The length of the context information
+ *
+ * \returns a status code indicating success or failure.
+ *      - \ref VCCRYPT_STATUS_SUCCESS if successful.
+ *      - \ref VCCRYPT_ERROR_HKDF_INVALID_ARG if an argument is invalid.
+ *      - a non-zero error code indicating failure.
+ */
+int hkdf_expand(
+    uint8_t* okm, size_t okm_len, vccrypt_key_derivation_options_t* options,
+    const uint8_t* prk, size_t prk_len,
+    const uint8_t* info, size_t info_len)
+{
+    uint8_t t[HKDF_MAX_DIGEST_LENGTH];
+    vccrypt_mac_options_t mac_options;
+    vccrypt_mac_context_t mac_context;
+    vccrypt_buffer_t keybuf;
+    vccrypt_buffer_t tbuf;
+    size_t hash_len;
+    int retval;
+
+    MODEL_ASSERT(NULL != okm);
+    MODEL_ASSERT(NULL != options);
+    MODEL_ASSERT(NULL != prk);
+    MODEL_ASSERT(prk_len > 0);
+    MODEL_ASSERT(NULL != info || 0 == info_len);
+
+    hash_len = options->hmac_digest_length;
+    if (0 == hash_len || hash_len > HKDF_MAX_DIGEST_LENGTH ||
+        0 == okm_len || okm_len > 255 * hash_len || 0 == prk_len)
+    {
+        return VCCRYPT_ERROR_HKDF_INVALID_ARG;
+    }
+
+    retval = vccrypt_mac_options_init(
+        &mac_options, options->alloc_opts, options->hmac_algorithm);
+    if (0 != retval)
+    {
+        return retval;
+    }
+
+    /* the PRK is the HMAC key; borrow it instead of copying it. */
+    memset(&keybuf, 0, sizeof(keybuf));
+    keybuf.data = (void*)prk;
+    keybuf.size = prk_len;
+
+    retval = vccrypt_mac_init(&mac_options, &mac_context, &keybuf);
+    if (0 != retval)
+    {
+        goto cleanup_mac_options;
+    }
+
+    memset(&tbuf, 0, sizeof(tbuf));
+    tbuf.data = t;
+    tbuf.size = hash_len;
+
+    for (unsigned int i = 1; okm_len > 0; ++i)
+    {
+        uint8_t counter = (uint8_t)i;
+
+        /* T(i) = HMAC-Hash(PRK, T(i-1) | info | i) */
+        if (i > 1)
+        {
+            retval = vccrypt_mac_digest(&mac_context, t, hash_len);
+            if (0 != retval)
+            {
+                goto cleanup_mac_context;
+            }
+        }
+
+        if (info_len > 0)
+        {
+            retval = vccrypt_mac_digest(&mac_context, info, info_len);
+            if (0 != retval)
+            {
+                goto cleanup_mac_context;
+            }
+        }
+
+        retval = vccrypt_mac_digest(&mac_context, &counter, 1);
+        if (0 != retval)
+        {
+            goto cleanup_mac_context;
+        }
+
+        retval = vccrypt_mac_finalize(&mac_context, &tbuf);
+        if (0 != retval)
+        {
+            goto cleanup_mac_context;
+        }
+
+        size_t r = okm_len < hash_len ? okm_len : hash_len;
+        memcpy(okm, t, r);
+        okm += r;
+        okm_len -= r;
+    }
+
+cleanup_mac_context:
+    dispose((disposable_t*)&mac_context);
+
+cleanup_mac_options:
+    dispose((disposable_t*)&mac_options);
+
+    /* erase the last output block */
+    memset(t, 0, sizeof(t));
+
+    return retval;
+}
@@ -0,0 +1,77 @@
+/**
+ * \file hkdf.h
+ *
+ * HMAC-based Extract-and-Expand Key Derivation Function (RFC 5869).
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#ifndef HKDF_PRIVATE_HEADER_GUARD
+#define HKDF_PRIVATE_HEADER_GUARD
+
+#include <vpr/allocator.h>
+#include <vccrypt/key_derivation.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif /*__cplusplus*/
+
+/**
+ * \brief The largest HMAC digest supported by HKDF, in bytes.
+ */
+#define HKDF_MAX_DIGEST_LENGTH 64
+
+/**
+ * \brief Extract a pseudorandom key from input keying material.
+ *
+ * PRK = HMAC-Hash(salt, IKM)
+ *
+ * \param prk                 Receives hmac_digest_length bytes of
+ *                            pseudorandom key.
+ * \param options             The options to use
+ * \param salt                The salt, or NULL for the default salt of
+ *                            hmac_digest_length zero bytes.
+ * \param salt_len            The length of the salt
+ * \param ikm                 The input keying material
+ * \param ikm_len             The length of the input keying material
+ *
+ * \returns a status code indicating success or failure.
+ *      - \ref VCCRYPT_STATUS_SUCCESS if successful.
+ *      - \ref VCCRYPT_ERROR_HKDF_INVALID_ARG if an argument is invalid.
+ *      - a non-zero error code indicating failure.
+ */
+int hkdf_extract(
+    uint8_t* prk, vccrypt_key_derivation_options_t* options,
+    const uint8_t* salt, size_t salt_len,
+    const uint8_t* ikm, size_t ikm_len);
+
+/**
+ * \brief Expand a pseudorandom key into output keying material.
+ *
+ * T(0) = empty, T(i) = HMAC-Hash(PRK, T(i-1) | info | i), and the output is
+ * the first okm_len bytes of T(1) | T(2) | ...
+ *
+ * \param okm                 The output keying material
+ * \param okm_len             The length of the output keying material, at
+ *                            most 255 * hmac_digest_length bytes.
+ * \param options             The options to use
+ * \param prk                 The pseudorandom key
+ * \param prk_len             The length of the pseudorandom key
+ * \param info                Optional context information, or NULL.
+ * \param info_len            The length of the context information
+ *
+ * \returns a status code indicating success or failure.
+ *      - \ref VCCRYPT_STATUS_SUCCESS if successful.
+ *      - \ref VCCRYPT_ERROR_HKDF_INVALID_ARG if an argument is invalid.
+ *      - a non-zero error code indicating failure.
+ */
+int hkdf_expand(
+    uint8_t* okm, size_t okm_len, vccrypt_key_derivation_options_t* options,
+    const uint8_t* prk, size_t prk_len,
+    const uint8_t* info, size_t info_len);
+
+#ifdef __cplusplus
+}
+#endif /*__cplusplus*/
+
+#endif /*HKDF_PRIVATE_HEADER_GUARD*/
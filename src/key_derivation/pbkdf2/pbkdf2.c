@@ -41,8 +41,8 @@
  * \param derived_key_len     The desired length of the derived key
  * \param options             The options to use
  * \param prf                 A pseudo random function, e.g. keyed HMAC
- * \param pass                The password or passphrase
- * \param pass_len            The length of the password or passphrase
+ * \param prf_context         The PRF state, keyed with the password or
+ *                            passphrase
  * \param salt                A salt value, typically random data
  * \param salt_len            The length of the salt
  * \param rounds              The number of rounds to process.  More rounds
@@ -54,8 +54,8 @@
 int pkcs5_pbkdf2(
     uint8_t* derived_key, size_t derived_key_len,
     vccrypt_key_derivation_options_t* options, pbkdf2_prf_t prf,
-    const char* pass, size_t pass_len,
-    const uint8_t* salt, size_t salt_len, unsigned int rounds)
+    void* prf_context, const uint8_t* salt, size_t salt_len,
+    unsigned int rounds)
 {
     int retval = VCCRYPT_STATUS_SUCCESS;
 
@@ -95,8 +95,8 @@ int pkcs5_pbkdf2(
 
         // the first round uses the user supplied salt
         memset(digest1, 0, sizeof(digest1));
-        retval = prf(digest1, sizeof(digest1), options, asalt, salt_len + 4,
-            (uint8_t*)pass, pass_len);
+        retval = prf(digest1, sizeof(digest1), prf_context,
+            asalt, salt_len + 4);
         if (0 != retval)
         {
             goto cleanup;
@@ -108,9 +108,8 @@ int pkcs5_pbkdf2(
         // subsequent rounds use the output of the previous round as the input
         for (unsigned int i = 1; i < rounds; i++)
         {
-            memset(digest2, 0, sizeof(digest2));
-            retval = prf(digest2, sizeof(digest2), options,
-                digest1, sizeof(digest1), (uint8_t*)pass, pass_len);
+            retval = prf(digest2, sizeof(digest2), prf_context,
+                digest1, sizeof(digest1));
             if (0 != retval)
             {
                 goto cleanup;
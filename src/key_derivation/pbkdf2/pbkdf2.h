@@ -4,6 +4,9 @@
 #include <vpr/allocator.h>
 #include <vccrypt/key_derivation.h>
 
+#include "../../hash/ref/sha512.h"
+#include "../../hash/ref/sha512_internal.h"
+
 #ifdef __cplusplus
 extern "C" {
 #endif /*__cplusplus*/
@@ -11,26 +14,117 @@ extern "C" {
 /**
  * \brief A pseudorandom function
  *
- * The pseudorandom function (PRF) accepts as input a text value and a key,
- * which are used to produce a fixed length digest value.
+ * The pseudorandom function (PRF) accepts as input a text value, which is
+ * used to produce a fixed length digest value.  The PRF is keyed with the
+ * password once, before the derivation starts, and its keyed state is passed
+ * to every call as prf_context.
  *
  * \param digest        An array to hold the output data
  * \param digest_len    The length of the digest produced by the PRF
- * \param options       Pointer to the options to use
- * \param text          The input data, e.g. a password
+ * \param prf_context   The keyed state of the PRF
+ * \param text          The input data, e.g. a salt
  * \param text_len      The length of the input data
- * \param key           The key
- * \param key_len       The length of the key
  *
  * \returns a status indicating success or failure.
  *      - \ref VCCRYPT_STATUS_SUCCESS on success.
  *      - a non-zero error code indicating failure.
 */
 typedef int (*pbkdf2_prf_t)(uint8_t* digest, size_t digest_len,
-    vccrypt_key_derivation_options_t* options,
-    const uint8_t* text, size_t text_len,
+    void* prf_context, const uint8_t* text, size_t text_len);
+
+/**
+ * \brief The most PRF calls that a lockstep PRF runs together.
+ */
+#define PBKDF2_PRF_LANES SHA512_MB_LANES
+
+/**
+ * \brief A pseudorandom function that runs several PRF calls in lockstep.
+ *
+ * For each lane i below lanes, digest[i] receives the PRF of text[i] under
+ * prf_context[i].  Every text is one digest long, which is the case for all
+ * PBKDF2 iterations after the first.
+ *
+ * \param digest        The arrays to hold the output data
+ * \param digest_len    The length of the digest produced by the PRF
+ * \param prf_context   The keyed state of the PRF for each lane
+ * \param text          The input data for each lane
+ * \param lanes         The number of lanes in use, from 1 to
+ *                      \ref PBKDF2_PRF_LANES
+ *
+ * \returns a status indicating success or failure.
+ *      - \ref VCCRYPT_STATUS_SUCCESS on success.
+ *      - a non-zero error code indicating failure.
+ */
+typedef int (*pbkdf2_prf_lanes_t)(
+    uint8_t* digest[PBKDF2_PRF_LANES], size_t digest_len,
+    void* prf_context[PBKDF2_PRF_LANES],
+    const uint8_t* text[PBKDF2_PRF_LANES], size_t lanes);
+
+/**
+ * \brief The keyed state of an HMAC PRF built on the SHA-512 family.
+ *
+ * The inner and outer states hold the midstates after the key XOR ipad and
+ * key XOR opad blocks.  Each PBKDF2 iteration hashes a single digest, so the
+ * inner and outer blocks are kept fully padded, and only the digest bytes
+ * change from one iteration to the next.
+ */
+typedef struct pbkdf2_sha512_prf_context
+{
+    SHA512_CTX inner;
+    SHA512_CTX outer;
+    uint8_t inner_block[SHA512_CBLOCK];
+    uint8_t outer_block[SHA512_CBLOCK];
+    size_t md_len;
+} pbkdf2_sha512_prf_context_t;
+
+/**
+ * \brief Key an HMAC PRF built on the SHA-512 family.
+ *
+ * \param prf_context   The PRF state to initialize.
+ * \param init          The SHA-512 family init function, which selects the
+ *                      initial state and digest length.
+ * \param key           The key, e.g. a password
+ * \param key_len       The length of the key
+ */
+void pbkdf2_sha512_prf_init(
+    pbkdf2_sha512_prf_context_t* prf_context, void (*init)(SHA512_CTX*),
     const uint8_t* key, size_t key_len);
 
+/**
+ * \brief An HMAC PRF built on the SHA-512 family.
+ *
+ * A text the length of one digest takes exactly two block operations.
+ *
+ * \param digest        An array to hold the output data
+ * \param digest_len    The length of the digest produced by the PRF
+ * \param prf_context   The pbkdf2_sha512_prf_context_t keyed state
+ * \param text          The input data, e.g. a salt
+ * \param text_len      The length of the input data
+ *
+ * \returns a status indicating success or failure.
+ *      - \ref VCCRYPT_STATUS_SUCCESS on success.
+ */
+int pbkdf2_sha512_prf(uint8_t* digest, size_t digest_len,
+    void* prf_context, const uint8_t* text, size_t text_len);
+
+/**
+ * \brief An HMAC PRF built on the SHA-512 family, run across the lanes of the
+ * multi-buffer block function.
+ *
+ * \param digest        The arrays to hold the output data
+ * \param digest_len    The length of the digest produced by the PRF
+ * \param prf_context   The pbkdf2_sha512_prf_context_t keyed state for each
+ *                      lane
+ * \param text          The input data for each lane, one digest long
+ * \param lanes         The number of lanes in use
+ *
+ * \returns a status indicating success or failure.
+ *      - \ref VCCRYPT_STATUS_SUCCESS on success.
+ */
+int pbkdf2_sha512_prf_lanes(
+    uint8_t* digest[PBKDF2_PRF_LANES], size_t digest_len,
+    void* prf_context[PBKDF2_PRF_LANES],
+    const uint8_t* text[PBKDF2_PRF_LANES], size_t lanes);
 
 /**
  * \brief Applies a pseudorandom function to an input password or passphrase,
@@ -40,8 +134,8 @@ typedef int (*pbkdf2_prf_t)(uint8_t* digest, size_t digest_len,
  * \param derived_key_len     The desired length of the derived key
  * \param options             The options to use
  * \param prf                 A pseudo random function, e.g. keyed HMAC
- * \param pass                The password or passphrase
- * \param pass_len            The length of the password or passphrase
+ * \param prf_context         The PRF state, keyed with the password or
+ *                            passphrase
  * \param salt                A salt value, typically random data
  * \param salt_len            The length of the salt
  * \param rounds              The number of rounds to process.  More rounds
@@ -53,8 +147,74 @@ typedef int (*pbkdf2_prf_t)(uint8_t* digest, size_t digest_len,
 int pkcs5_pbkdf2(
     uint8_t* derived_key, size_t derived_key_len,
     vccrypt_key_derivation_options_t* options, pbkdf2_prf_t prf,
-    const char* pass, size_t pass_len,
-    const uint8_t* salt, size_t salt_len, unsigned int rounds);
+    void* prf_context, const uint8_t* salt, size_t salt_len,
+    unsigned int rounds);
+
+/**
+ * \brief One derivation of a PBKDF2 batch.
+ */
+typedef struct pbkdf2_batch_item
+{
+    uint8_t* derived_key;
+    size_t derived_key_len;
+    void* prf_context;
+    const uint8_t* salt;
+    size_t salt_len;
+} pbkdf2_batch_item_t;
+
+/**
+ * \brief Applies PBKDF2 to each of a batch of independent derivations.
+ *
+ * The output blocks of all of the derivations are run in lockstep through
+ * prf_lanes, \ref PBKDF2_PRF_LANES at a time.  Each derived key is the same as
+ * the one pkcs5_pbkdf2() produces for its prf_context and salt.
+ *
+ * \param items               The derivations, each with its own output,
+ *                            keyed PRF state, and salt
+ * \param count               The number of derivations
+ * \param options             The options to use
+ * \param prf                 A pseudo random function, e.g. keyed HMAC
+ * \param prf_lanes           The lockstep version of prf
+ * \param rounds              The number of rounds to process for each
+ *                            derivation.
+ *
+ * \returns a status code indicating success or failure.
+ *      - \ref VCCRYPT_STATUS_SUCCESS if successful.
+ */
+int pkcs5_pbkdf2_batch(
+    const pbkdf2_batch_item_t* items, size_t count,
+    vccrypt_key_derivation_options_t* options, pbkdf2_prf_t prf,
+    pbkdf2_prf_lanes_t prf_lanes, unsigned int rounds);
+
+/**
+ * \brief Applies a pseudorandom function to an input password or passphrase,
+ * along with a salt value, to produce a derived key, computing up to
+ * \ref PBKDF2_PRF_LANES output blocks at once.
+ *
+ * The output blocks of PBKDF2 are independent, so the iterations of
+ * neighbouring blocks are run in lockstep through prf_lanes.  The result is
+ * the same as pkcs5_pbkdf2().
+ *
+ * \param derived_key         The output derived key
+ * \param derived_key_len     The desired length of the derived key
+ * \param options             The options to use
+ * \param prf                 A pseudo random function, e.g. keyed HMAC
+ * \param prf_lanes           The lockstep version of prf
+ * \param prf_context         The PRF state, keyed with the password or
+ *                            passphrase
+ * \param salt                A salt value, typically random data
+ * \param salt_len            The length of the salt
+ * \param rounds              The number of rounds to process.  More rounds
+ *                            increases randomness and computational cost.
+ *
+ * \returns a status code indicating success or failure.
+ *      - \ref VCCRYPT_STATUS_SUCCESS if successful.
+ */
+int pkcs5_pbkdf2_lanes(
+    uint8_t* derived_key, size_t derived_key_len,
+    vccrypt_key_derivation_options_t* options, pbkdf2_prf_t prf,
+    pbkdf2_prf_lanes_t prf_lanes, void* prf_context, const uint8_t* salt,
+    size_t salt_len, unsigned int rounds);
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,190 @@
+/**
+ * \file pbkdf2_batch.c
+ *
+ * PBKDF2 for a batch of independent derivations, with the output blocks of
+ * all derivations computed in lockstep.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <cbmc/model_assert.h>
+#include <stdint.h>
+#include <string.h>
+#include <vpr/allocator.h>
+#include <vpr/parameters.h>
+#include <vccrypt/error_codes.h>
+
+#include "pbkdf2.h"
+
+#define MINIMUM(a, b) (((a) < (b)) ? (a) : (b))
+
+/**
+ * \brief Applies PBKDF2 to each of a batch of independent derivations.
+ *
+ * \param items               The derivations, each with its own output,
+ *                            keyed PRF state, and salt
+ * \param count               The number of derivations
+ * \param options             The options to use
+ * \param prf                 A pseudo random function, e.g. keyed HMAC
+ * \param prf_lanes           The lockstep version of prf
+ * \param rounds              The number of rounds to process for each
+ *                            derivation.
+ *
+ * \returns a status code indicating success or failure.
+ *      - \ref VCCRYPT_STATUS_SUCCESS if successful.
+ */
+int pkcs5_pbkdf2_batch(
+    const pbkdf2_batch_item_t* items, size_t count,
+    vccrypt_key_derivation_options_t* options, pbkdf2_prf_t prf,
+    pbkdf2_prf_lanes_t prf_lanes, unsigned int rounds)
+{
+    int retval = VCCRYPT_STATUS_SUCCESS;
+    const size_t hlen = options->hmac_digest_length;
+    size_t max_salt_len = 0;
+
+    uint8_t* asalt;
+    uint8_t output_buffer[PBKDF2_PRF_LANES][hlen];
+    uint8_t digest1[PBKDF2_PRF_LANES][hlen],
+        digest2[PBKDF2_PRF_LANES][hlen];
+    uint8_t* out[PBKDF2_PRF_LANES];
+    const uint8_t* in[PBKDF2_PRF_LANES];
+    void* contexts[PBKDF2_PRF_LANES];
+    uint8_t* dest[PBKDF2_PRF_LANES];
+    size_t dest_len[PBKDF2_PRF_LANES];
+
+    MODEL_ASSERT(count == 0 || NULL != items);
+    MODEL_ASSERT(NULL != prf);
+    MODEL_ASSERT(NULL != prf_lanes);
+
+    // sanity checks
+    if (rounds < 1)
+    {
+        return VCCRYPT_ERROR_PBKDF2_INVALID_ARG;
+    }
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        if (items[i].derived_key_len == 0 || items[i].salt_len == 0 ||
+            items[i].salt_len > SIZE_MAX - 4)
+        {
+            return VCCRYPT_ERROR_PBKDF2_INVALID_ARG;
+        }
+
+        if (items[i].salt_len > max_salt_len)
+        {
+            max_salt_len = items[i].salt_len;
+        }
+    }
+
+    if (0 == count)
+    {
+        return VCCRYPT_STATUS_SUCCESS;
+    }
+
+    for (size_t l = 0; l < PBKDF2_PRF_LANES; ++l)
+    {
+        out[l] = digest2[l];
+        in[l] = digest1[l];
+    }
+
+    // create a buffer to hold the longest salt and an additional 4 bytes
+    // the additional bytes are to append the chunk number
+    asalt = allocate(options->alloc_opts, max_salt_len + 4);
+    if (NULL == asalt)
+    {
+        return VCCRYPT_ERROR_PBKDF2_INIT_OUT_OF_MEMORY;
+    }
+
+    // the next chunk to start is at offset in the key of item
+    size_t item = 0, offset = 0;
+    while (item < count)
+    {
+        // start the next chunks, across derivations if need be
+        size_t lanes = 0;
+        while (lanes < PBKDF2_PRF_LANES && item < count)
+        {
+            const pbkdf2_batch_item_t* it = items + item;
+            unsigned int chunk = (unsigned int)(offset / hlen) + 1;
+            size_t salt_len = it->salt_len;
+
+            // append the chunk number in big endian format to the salt
+            memcpy(asalt, it->salt, salt_len);
+            asalt[salt_len + 0] = (chunk >> 24) & 0xff;
+            asalt[salt_len + 1] = (chunk >> 16) & 0xff;
+            asalt[salt_len + 2] = (chunk >> 8) & 0xff;
+            asalt[salt_len + 3] = chunk & 0xff;
+
+            // the first round uses the user supplied salt
+            retval =
+                prf(digest1[lanes], hlen, it->prf_context,
+                    asalt, salt_len + 4);
+            if (0 != retval)
+            {
+                goto cleanup;
+            }
+
+            memcpy(output_buffer[lanes], digest1[lanes], hlen);
+
+            contexts[lanes] = it->prf_context;
+            dest[lanes] = it->derived_key + offset;
+            dest_len[lanes] = MINIMUM(it->derived_key_len - offset, hlen);
+
+            offset += dest_len[lanes];
+            if (offset == it->derived_key_len)
+            {
+                ++item;
+                offset = 0;
+            }
+
+            ++lanes;
+        }
+
+        // subsequent rounds run the chunks together
+        for (unsigned int i = 1; i < rounds; i++)
+        {
+            if (1 == lanes)
+            {
+                retval = prf(digest2[0], hlen, contexts[0], digest1[0], hlen);
+            }
+            else
+            {
+                retval = prf_lanes(out, hlen, contexts, in, lanes);
+            }
+
+            if (0 != retval)
+            {
+                goto cleanup;
+            }
+
+            // feed each output forward and xor it into its chunk
+            for (size_t l = 0; l < lanes; ++l)
+            {
+                memcpy(digest1[l], digest2[l], hlen);
+
+                for (size_t j = 0; j < hlen; j++)
+                {
+                    output_buffer[l][j] ^= digest1[l][j];
+                }
+            }
+        }
+
+        // copy the bytes from the output buffers into the keys
+        for (size_t l = 0; l < lanes; ++l)
+        {
+            memcpy(dest[l], output_buffer[l], dest_len[l]);
+        }
+    }
+
+cleanup:
+
+    // erase contents of salt and free memory
+    memset(asalt, 0, max_salt_len + 4);
+    release(options->alloc_opts, asalt);
+
+    // erase contents of working arrays
+    memset(output_buffer, 0, sizeof(output_buffer));
+    memset(digest1, 0, sizeof(digest1));
+    memset(digest2, 0, sizeof(digest2));
+
+    return retval;
+}
@@ -0,0 +1,53 @@
+/**
+ * \file pbkdf2_lanes.c
+ *
+ * PBKDF2 with neighbouring output blocks computed in lockstep.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <cbmc/model_assert.h>
+#include <vpr/parameters.h>
+
+#include "pbkdf2.h"
+
+/**
+ * \brief Applies a pseudorandom function to an input password or passphrase,
+ * along with a salt value, to produce a derived key, computing up to
+ * \ref PBKDF2_PRF_LANES output blocks at once.
+ *
+ * \param derived_key         The output derived key
+ * \param derived_key_len     The desired length of the derived key
+ * \param options             The options to use
+ * \param prf                 A pseudo random function, e.g. keyed HMAC
+ * \param prf_lanes           The lockstep version of prf
+ * \param prf_context         The PRF state, keyed with the password or
+ *                            passphrase
+ * \param salt                A salt value, typically random data
+ * \param salt_len            The length of the salt
+ * \param rounds              The number of rounds to process.  More rounds
+ *                            increases randomness and computational cost.
+ *
+ * \returns a status code indicating success or failure.
+ *      - \ref VCCRYPT_STATUS_SUCCESS if successful.
+ */
+int pkcs5_pbkdf2_lanes(
+    uint8_t* derived_key, size_t derived_key_len,
+    vccrypt_key_derivation_options_t* options, pbkdf2_prf_t prf,
+    pbkdf2_prf_lanes_t prf_lanes, void* prf_context, const uint8_t* salt,
+    size_t salt_len, unsigned int rounds)
+{
+    pbkdf2_batch_item_t item;
+
+    MODEL_ASSERT(NULL != prf);
+    MODEL_ASSERT(NULL != prf_lanes);
+
+    /* a batch of one runs its own output blocks side by side. */
+    item.derived_key = derived_key;
+    item.derived_key_len = derived_key_len;
+    item.prf_context = prf_context;
+    item.salt = salt;
+    item.salt_len = salt_len;
+
+    return pkcs5_pbkdf2_batch(&item, 1, options, prf, prf_lanes, rounds);
+}
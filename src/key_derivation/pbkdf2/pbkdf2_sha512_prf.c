@@ -0,0 +1,250 @@
+/**
+ * \file pbkdf2_sha512_prf.c
+ *
+ * An HMAC pseudorandom function for PBKDF2, built directly on the SHA-512
+ * family block function.
+ *
+ * PBKDF2 spends nearly all of its time computing HMACs of one digest under
+ * the same key.  Here the key is digested once, and each iteration runs the
+ * block function on the inner and outer midstates with blocks that are
+ * already padded, so an iteration is exactly two block operations.  The
+ * lanes version runs the iterations of several output blocks, or several
+ * derivations, together through the multi-buffer block function.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <cbmc/model_assert.h>
+#include <string.h>
+#include <vccrypt/error_codes.h>
+#include <vpr/parameters.h>
+
+#include "pbkdf2.h"
+
+/* forward decls */
+static void pbkdf2_sha512_pad_block(
+    uint8_t* block, size_t size, uint64_t total);
+static void pbkdf2_sha512_store(
+    uint8_t* out, const SHA512_CTX* ctx, size_t size);
+
+/**
+ * \brief Key an HMAC PRF built on the SHA-512 family.
+ *
+ * \param prf_context   The PRF state to initialize.
+ * \param init          The SHA-512 family init function, which selects the
+ *                      initial state and digest length.
+ * \param key           The key, e.g. a password
+ * \param key_len       The length of the key
+ */
+void pbkdf2_sha512_prf_init(
+    pbkdf2_sha512_prf_context_t* prf_context, void (*init)(SHA512_CTX*),
+    const uint8_t* key, size_t key_len)
+{
+    uint8_t k0[SHA512_CBLOCK];
+    uint8_t pad[SHA512_CBLOCK];
+
+    MODEL_ASSERT(NULL != prf_context);
+    MODEL_ASSERT(NULL != init);
+    MODEL_ASSERT(NULL != key || 0 == key_len);
+
+    memset(prf_context, 0, sizeof(pbkdf2_sha512_prf_context_t));
+    memset(k0, 0, sizeof(k0));
+
+    /* keys longer than a block are replaced by their hash. */
+    if (key_len > SHA512_CBLOCK)
+    {
+        init(&prf_context->inner);
+        SHA512_Update(&prf_context->inner, key, key_len);
+        SHA512_Final(&prf_context->inner, k0);
+    }
+    else if (key_len > 0)
+    {
+        memcpy(k0, key, key_len);
+    }
+
+    /* digest the key XOR ipad and key XOR opad blocks. */
+    for (size_t i = 0; i < SHA512_CBLOCK; ++i)
+    {
+        pad[i] = k0[i] ^ 0x36;
+    }
+    init(&prf_context->inner);
+    SHA512_Update(&prf_context->inner, pad, SHA512_CBLOCK);
+
+    for (size_t i = 0; i < SHA512_CBLOCK; ++i)
+    {
+        pad[i] = k0[i] ^ 0x5c;
+    }
+    init(&prf_context->outer);
+    SHA512_Update(&prf_context->outer, pad, SHA512_CBLOCK);
+
+    prf_context->md_len = prf_context->inner.md_len;
+
+    /* both blocks hold a digest after the pad block. */
+    pbkdf2_sha512_pad_block(
+        prf_context->inner_block, prf_context->md_len,
+        SHA512_CBLOCK + prf_context->md_len);
+    pbkdf2_sha512_pad_block(
+        prf_context->outer_block, prf_context->md_len,
+        SHA512_CBLOCK + prf_context->md_len);
+
+    memset(k0, 0, sizeof(k0));
+    memset(pad, 0, sizeof(pad));
+}
+
+/**
+ * \brief An HMAC PRF built on the SHA-512 family.
+ *
+ * \param digest        An array to hold the output data
+ * \param digest_len    The length of the digest produced by the PRF
+ * \param prf_context   The pbkdf2_sha512_prf_context_t keyed state
+ * \param text          The input data, e.g. a salt
+ * \param text_len      The length of the input data
+ *
+ * \returns a status indicating success or failure.
+ *      - \ref VCCRYPT_STATUS_SUCCESS on success.
+ */
+int pbkdf2_sha512_prf(uint8_t* digest, size_t digest_len,
+    void* prf_context, const uint8_t* text, size_t text_len)
+{
+    pbkdf2_sha512_prf_context_t* ctx =
+        (pbkdf2_sha512_prf_context_t*)prf_context;
+    SHA512_CTX c;
+
+    MODEL_ASSERT(NULL != ctx);
+    MODEL_ASSERT(NULL != digest);
+    MODEL_ASSERT(digest_len <= ctx->md_len);
+
+    if (text_len == ctx->md_len)
+    {
+        /* the common case: a single padded block from the inner midstate. */
+        memcpy(c.h, ctx->inner.h, sizeof(c.h));
+        memcpy(ctx->inner_block, text, text_len);
+        sha512_block(&c, ctx->inner_block, 1);
+        pbkdf2_sha512_store(ctx->outer_block, &c, ctx->md_len);
+    }
+    else
+    {
+        /* any other text, such as the salt, goes through the full hash.
+         * Final only writes the digest, so the padding is kept. */
+        memcpy(&c, &ctx->inner, sizeof(c));
+        SHA512_Update(&c, text, text_len);
+        SHA512_Final(&c, ctx->outer_block);
+    }
+
+    /* the outer hash digests the inner hash from the outer midstate. */
+    memcpy(c.h, ctx->outer.h, sizeof(c.h));
+    sha512_block(&c, ctx->outer_block, 1);
+    pbkdf2_sha512_store(digest, &c, digest_len);
+
+    memset(&c, 0, sizeof(c));
+
+    return VCCRYPT_STATUS_SUCCESS;
+}
+
+/**
+ * \brief An HMAC PRF built on the SHA-512 family, run across the lanes of the
+ * multi-buffer block function.
+ *
+ * \param digest        The arrays to hold the output data
+ * \param digest_len    The length of the digest produced by the PRF
+ * \param prf_context   The pbkdf2_sha512_prf_context_t keyed state for each
+ *                      lane
+ * \param text          The input data for each lane, one digest long
+ * \param lanes         The number of lanes in use
+ *
+ * \returns a status indicating success or failure.
+ *      - \ref VCCRYPT_STATUS_SUCCESS on success.
+ */
+int pbkdf2_sha512_prf_lanes(
+    uint8_t* digest[PBKDF2_PRF_LANES], size_t digest_len,
+    void* prf_context[PBKDF2_PRF_LANES],
+    const uint8_t* text[PBKDF2_PRF_LANES], size_t lanes)
+{
+    pbkdf2_sha512_prf_context_t* ctx[SHA512_MB_LANES];
+    SHA512_CTX c[SHA512_MB_LANES];
+    SHA512_CTX* cp[SHA512_MB_LANES];
+    uint8_t block[SHA512_MB_LANES][SHA512_CBLOCK];
+    const uint8_t* in[SHA512_MB_LANES];
+
+    MODEL_ASSERT(NULL != digest);
+    MODEL_ASSERT(NULL != prf_context);
+    MODEL_ASSERT(NULL != text);
+    MODEL_ASSERT(lanes > 0 && lanes <= PBKDF2_PRF_LANES);
+
+    /* lanes that aren't in use repeat the first lane, and are dropped. */
+    for (size_t i = 0; i < SHA512_MB_LANES; ++i)
+    {
+        size_t lane = (i < lanes) ? i : 0;
+
+        ctx[i] = (pbkdf2_sha512_prf_context_t*)prf_context[lane];
+        MODEL_ASSERT(digest_len <= ctx[i]->md_len);
+
+        memcpy(c[i].h, ctx[i]->inner.h, sizeof(c[i].h));
+        memcpy(block[i], ctx[i]->inner_block, SHA512_CBLOCK);
+        memcpy(block[i], text[lane], ctx[i]->md_len);
+
+        cp[i] = c + i;
+        in[i] = block[i];
+    }
+
+    sha512_mb_block(cp, in);
+
+    /* the inner and outer blocks share their padding. */
+    for (size_t i = 0; i < SHA512_MB_LANES; ++i)
+    {
+        pbkdf2_sha512_store(block[i], &c[i], ctx[i]->md_len);
+        memcpy(c[i].h, ctx[i]->outer.h, sizeof(c[i].h));
+    }
+
+    sha512_mb_block(cp, in);
+
+    for (size_t i = 0; i < lanes; ++i)
+    {
+        pbkdf2_sha512_store(digest[i], &c[i], digest_len);
+    }
+
+    memset(c, 0, sizeof(c));
+    memset(block, 0, sizeof(block));
+
+    return VCCRYPT_STATUS_SUCCESS;
+}
+
+/**
+ * Pad a block holding size bytes of message.
+ *
+ * \param block         The block to pad.
+ * \param size          The number of message bytes at the start of the block.
+ * \param total         The total message length, in bytes, including the
+ *                      blocks already digested.
+ */
+static void pbkdf2_sha512_pad_block(
+    uint8_t* block, size_t size, uint64_t total)
+{
+    uint64_t bits = total << 3;
+
+    MODEL_ASSERT(size + 1 + 16 <= SHA512_CBLOCK);
+
+    memset(block + size, 0, SHA512_CBLOCK - size);
+    block[size] = 0x80;
+
+    for (int i = 0; i < 8; ++i)
+    {
+        block[SHA512_CBLOCK - 1 - i] = (uint8_t)(bits >> (8 * i));
+    }
+}
+
+/**
+ * Write the first bytes of the chaining value in big-endian order.
+ *
+ * \param out           The output.
+ * \param ctx           The context holding the chaining value.
+ * \param size          The number of bytes to write.
+ */
+static void pbkdf2_sha512_store(
+    uint8_t* out, const SHA512_CTX* ctx, size_t size)
+{
+    for (size_t i = 0; i < size; ++i)
+    {
+        out[i] = (uint8_t)(ctx->h[i / 8] >> (56 - 8 * (i % 8)));
+    }
+}
@@ -0,0 +1,87 @@
+/**
+ * \file vccrypt_key_derivation_derive_key_batch.c
+ *
+ * Derive cryptographic keys for a batch of independent passwords.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <cbmc/model_assert.h>
+#include <string.h>
+#include <vccrypt/key_derivation.h>
+#include <vpr/parameters.h>
+
+/**
+ * \brief Derive a cryptographic key for each of a batch of independent
+ * passwords.
+ *
+ * \param derived_keys      Array of \p count crypto buffers to receive the
+ *                          derived keys.  Each buffer should be the size of
+ *                          the desired key length.
+ * \param context           Opaque pointer to the
+ *                          vccrypt_key_derivation_context_t structure.
+ * \param passes            Array of \p count passwords or passphrases.
+ * \param salts             Array of \p count salt values.
+ * \param count             The number of keys to derive.
+ * \param rounds            The number of rounds to process for each key.
+ *
+ * \returns a status indicating success or failure.
+ *      - \ref VCCRYPT_STATUS_SUCCESS on success.
+ *      - \ref VCCRYPT_ERROR_KEY_DERIVATION_DERIVE_KEY_BATCH_INVALID_ARG if one
+ *             of the provided arguments is invalid.
+ *      - a non-zero error code indicating failure.
+ */
+int vccrypt_key_derivation_derive_key_batch(
+    vccrypt_buffer_t* derived_keys, vccrypt_key_derivation_context_t* context,
+    const vccrypt_buffer_t* passes, const vccrypt_buffer_t* salts,
+    size_t count, unsigned int rounds)
+{
+    MODEL_ASSERT(NULL != context);
+    MODEL_ASSERT(NULL != context->options);
+    MODEL_ASSERT(count == 0 || NULL != derived_keys);
+    MODEL_ASSERT(count == 0 || NULL != passes);
+    MODEL_ASSERT(count == 0 || NULL != salts);
+    MODEL_ASSERT(rounds > 0);
+
+    /* parameter sanity check */
+    if (NULL == context || NULL == context->options ||
+        NULL == context->options->vccrypt_key_derivation_alg_derive_key ||
+        0 == rounds || (count > 0 &&
+        (NULL == derived_keys || NULL == passes || NULL == salts)))
+    {
+        return VCCRYPT_ERROR_KEY_DERIVATION_DERIVE_KEY_BATCH_INVALID_ARG;
+    }
+
+    /* check each item before deriving any keys. */
+    for (size_t i = 0; i < count; ++i)
+    {
+        if (NULL == passes[i].data || 0 == passes[i].size ||
+            NULL == salts[i].data || 0 == salts[i].size ||
+            NULL == derived_keys[i].data || 0 == derived_keys[i].size)
+        {
+            return VCCRYPT_ERROR_KEY_DERIVATION_DERIVE_KEY_BATCH_INVALID_ARG;
+        }
+    }
+
+    /* use the lockstep implementation if this algorithm has one. */
+    if (NULL != context->options->vccrypt_key_derivation_alg_derive_key_batch)
+    {
+        return
+            context->options->vccrypt_key_derivation_alg_derive_key_batch(
+                derived_keys, context, passes, salts, count, rounds);
+    }
+
+    /* otherwise, derive each key in turn. */
+    for (size_t i = 0; i < count; ++i)
+    {
+        int retval =
+            context->options->vccrypt_key_derivation_alg_derive_key(
+                derived_keys + i, context, passes + i, salts + i, rounds);
+        if (VCCRYPT_STATUS_SUCCESS != retval)
+        {
+            return retval;
+        }
+    }
+
+    return VCCRYPT_STATUS_SUCCESS;
+}
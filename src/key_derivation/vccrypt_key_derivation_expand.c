@@ -0,0 +1,61 @@
+/**
+ * \file vccrypt_key_derivation_expand.c
+ *
+ * Expand a pseudorandom key into a derived key.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <cbmc/model_assert.h>
+#include <string.h>
+#include <vccrypt/key_derivation.h>
+#include <vpr/parameters.h>
+
+/**
+ * \brief Expand a pseudorandom key into a derived key.
+ *
+ * \param derived_key       A crypto buffer to receive the derived key.
+ *                          The buffer should be the size of the desired
+ *                          key length.
+ * \param context           Opaque pointer to the
+ *                          vccrypt_key_derivation_context_t structure.
+ * \param prk               The pseudorandom key, typically from
+ *                          vccrypt_key_derivation_extract().
+ * \param info              Optional context and application specific
+ *                          information, or NULL.
+ *
+ * \returns a status indicating success or failure.
+ *      - \ref VCCRYPT_STATUS_SUCCESS on success.
+ *      - \ref VCCRYPT_ERROR_KEY_DERIVATION_EXPAND_INVALID_ARG if one of the
+ *             provided arguments is invalid, or if the algorithm does not
+ *             support extract-and-expand.
+ *      - a non-zero error code indicating failure.
+ */
+int vccrypt_key_derivation_expand(
+    vccrypt_buffer_t* derived_key, vccrypt_key_derivation_context_t* context,
+    const vccrypt_buffer_t* prk, const vccrypt_buffer_t* info)
+{
+    MODEL_ASSERT(NULL != context);
+    MODEL_ASSERT(NULL != context->options);
+    MODEL_ASSERT(NULL != derived_key);
+    MODEL_ASSERT(NULL != derived_key->data);
+    MODEL_ASSERT(derived_key->size > 0);
+    MODEL_ASSERT(NULL != prk);
+    MODEL_ASSERT(NULL != prk->data);
+    MODEL_ASSERT(prk->size > 0);
+    MODEL_ASSERT(NULL == info || NULL != info->data || 0 == info->size);
+
+    /* parameter sanity check */
+    if (NULL == context || NULL == context->options ||
+        NULL == context->options->vccrypt_key_derivation_alg_expand ||
+        NULL == derived_key || NULL == derived_key->data ||
+        0 == derived_key->size ||
+        NULL == prk || NULL == prk->data || 0 == prk->size ||
+        (NULL != info && NULL == info->data && 0 != info->size))
+    {
+        return VCCRYPT_ERROR_KEY_DERIVATION_EXPAND_INVALID_ARG;
+    }
+
+    return context->options->vccrypt_key_derivation_alg_expand(
+        derived_key, context, prk, info);
+}
@@ -0,0 +1,58 @@
+/**
+ * \file vccrypt_key_derivation_extract.c
+ *
+ * Extract a pseudorandom key from input keying material.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <cbmc/model_assert.h>
+#include <string.h>
+#include <vccrypt/key_derivation.h>
+#include <vpr/parameters.h>
+
+/**
+ * \brief Extract a pseudorandom key from input keying material.
+ *
+ * \param prk               A crypto buffer to receive the pseudorandom key.
+ *                          Its size must be the hmac_digest_length of the
+ *                          options.
+ * \param context           Opaque pointer to the
+ *                          vccrypt_key_derivation_context_t structure.
+ * \param ikm               The input keying material, such as a shared
+ *                          secret.
+ * \param salt              An optional salt value, or NULL.
+ *
+ * \returns a status indicating success or failure.
+ *      - \ref VCCRYPT_STATUS_SUCCESS on success.
+ *      - \ref VCCRYPT_ERROR_KEY_DERIVATION_EXTRACT_INVALID_ARG if one of the
+ *             provided arguments is invalid, or if the algorithm does not
+ *             support extract-and-expand.
+ *      - a non-zero error code indicating failure.
+ */
+int vccrypt_key_derivation_extract(
+    vccrypt_buffer_t* prk, vccrypt_key_derivation_context_t* context,
+    const vccrypt_buffer_t* ikm, const vccrypt_buffer_t* salt)
+{
+    MODEL_ASSERT(NULL != context);
+    MODEL_ASSERT(NULL != context->options);
+    MODEL_ASSERT(NULL != prk);
+    MODEL_ASSERT(NULL != prk->data);
+    MODEL_ASSERT(NULL != ikm);
+    MODEL_ASSERT(NULL != ikm->data || 0 == ikm->size);
+    MODEL_ASSERT(NULL == salt || NULL != salt->data || 0 == salt->size);
+
+    /* parameter sanity check */
+    if (NULL == context || NULL == context->options ||
+        NULL == context->options->vccrypt_key_derivation_alg_extract ||
+        NULL == prk || NULL == prk->data ||
+        prk->size != context->options->hmac_digest_length ||
+        NULL == ikm || (NULL == ikm->data && 0 != ikm->size) ||
+        (NULL != salt && NULL == salt->data && 0 != salt->size))
+    {
+        return VCCRYPT_ERROR_KEY_DERIVATION_EXTRACT_INVALID_ARG;
+    }
+
+    return context->options->vccrypt_key_derivation_alg_extract(
+        prk, context, ikm, salt);
+}
@@ -0,0 +1,212 @@
+/**
+ * \file vccrypt_key_derivation_register_hkdf.c
+ *
+ * Register HKDF and force a link dependency so that this algorithm can be
+ * used at runtime.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <cbmc/model_assert.h>
+#include <stdbool.h>
+#include <string.h>
+#include <vccrypt/key_derivation.h>
+#include <vccrypt/interfaces.h>
+#include <vccrypt/mac.h>
+#include <vpr/abstract_factory.h>
+#include <vpr/allocator.h>
+#include <vpr/parameters.h>
+
+#include "hkdf/hkdf.h"
+
+/* forward decls */
+static int vccrypt_hkdf_init(
+    vccrypt_key_derivation_context_t* context,
+    vccrypt_key_derivation_options_t* options);
+static void vccrypt_hkdf_dispose(
+    vccrypt_key_derivation_context_t* context,
+    vccrypt_key_derivation_options_t* options);
+static int vccrypt_hkdf_derive_key(
+    vccrypt_buffer_t* derived_key,
+    vccrypt_key_derivation_context_t* context,
+    const vccrypt_buffer_t* pass, const vccrypt_buffer_t* salt,
+    unsigned int rounds);
+static int vccrypt_hkdf_extract(
+    vccrypt_buffer_t* prk, vccrypt_key_derivation_context_t* context,
+    const vccrypt_buffer_t* ikm, const vccrypt_buffer_t* salt);
+static int vccrypt_hkdf_expand(
+    vccrypt_buffer_t* derived_key,
+    vccrypt_key_derivation_context_t* context,
+    const vccrypt_buffer_t* prk, const vccrypt_buffer_t* info);
+
+/* static data for this instance */
+static abstract_factory_registration_t hkdf_impl;
+static vccrypt_key_derivation_options_t hkdf_options;
+static bool hkdf_impl_registered = false;
+
+/**
+ * Register HKDF for use by the crypto library.
+ */
+void vccrypt_key_derivation_register_hkdf()
+{
+    /* only register once */
+    if (hkdf_impl_registered)
+    {
+        return;
+    }
+
+    /* register the HMACs for extract and expand */
+    vccrypt_mac_register_SHA_2_256_HMAC();
+    vccrypt_mac_register_SHA_2_512_HMAC();
+    vccrypt_mac_register_SHA_2_512_256_HMAC();
+
+    /* set up the options for hkdf */
+    hkdf_options.hdr.dispose = 0; /* disposal handled by init */
+    hkdf_options.alloc_opts = 0; /* allocator handled by init */
+    hkdf_options.hmac_algorithm = 0; /* HMAC algorithm handled by init */
+    hkdf_options.hmac_digest_length = 0; /* HMAC algorithm handled by init */
+
+    hkdf_options.vccrypt_key_derivation_alg_init = &vccrypt_hkdf_init;
+    hkdf_options.vccrypt_key_derivation_alg_dispose = &vccrypt_hkdf_dispose;
+    hkdf_options.vccrypt_key_derivation_alg_derive_key =
+        &vccrypt_hkdf_derive_key;
+    hkdf_options.vccrypt_key_derivation_alg_extract = &vccrypt_hkdf_extract;
+    hkdf_options.vccrypt_key_derivation_alg_expand = &vccrypt_hkdf_expand;
+
+    /* set up this registration for the abstract factory */
+    hkdf_impl.interface = VCCRYPT_INTERFACE_KD;
+    hkdf_impl.implementation = VCCRYPT_KEY_DERIVATION_ALGORITHM_HKDF;
+    hkdf_impl.implementation_features = VCCRYPT_KEY_DERIVATION_ALGORITHM_HKDF;
+    hkdf_impl.factory = 0;
+    hkdf_impl.context = &hkdf_options;
+
+    /* register this instance */
+    abstract_factory_register(&hkdf_impl);
+
+    hkdf_impl_registered = true;
+}
+
+/**
+ * Algorithm-specific initialization for key derivation.
+ *
+ * \param context   Pointer to the vccrypt_key_derivation_context_t
+ *                  structure.
+ * \param options   Pointer to this options structure.
+ *
+ * \returns 0 on success and non-zero on error.
+ */
+static int vccrypt_hkdf_init(
+    vccrypt_key_derivation_context_t* UNUSED(context),
+    vccrypt_key_derivation_options_t* UNUSED(options))
+{
+    /* no special initialization needed */
+
+    /* success */
+    return VCCRYPT_STATUS_SUCCESS;
+}
+
+/**
+ * Algorithm-specific disposal for key derivation.
+ *
+ * \param context   Pointer to the vccrypt_key_derivation_context_t
+ *                  structure.
+ * \param options   Pointer to this options structure.
+ */
+static void vccrypt_hkdf_dispose(
+    vccrypt_key_derivation_context_t* UNUSED(context),
+    vccrypt_key_derivation_options_t* UNUSED(options))
+{
+    /* no special cleanup needed */
+}
+
+/**
+ * \brief Derive a cryptographic key
+ *
+ * The password is used as the input keying material, and the key is expanded
+ * with empty info.  HKDF has no work factor, so the round count is ignored.
+ * Use vccrypt_key_derivation_extract() and vccrypt_key_derivation_expand() to
+ * derive several keys from one secret.
+ *
+ * \param derived_key       A crypto buffer to receive the derived key.
+ *                          The buffer should be the size of the desired
+ *                          key length.
+ * \param context           Pointer to the vccrypt_key_derivation_context_t
+ *                          structure.
+ * \param pass              A buffer containing the input keying material
+ * \param salt              A buffer containing a salt value
+ * \param rounds            Ignored.
+ *
+ * \returns \ref VCCRYPT_STATUS_SUCCESS on success and non-zero on error.
+ */
+static int vccrypt_hkdf_derive_key(
+    vccrypt_buffer_t* derived_key,
+    vccrypt_key_derivation_context_t* context,
+    const vccrypt_buffer_t* pass, const vccrypt_buffer_t* salt,
+    unsigned int UNUSED(rounds))
+{
+    uint8_t prk[HKDF_MAX_DIGEST_LENGTH];
+
+    int retval =
+        hkdf_extract(
+            prk, context->options, salt->data, salt->size,
+            pass->data, pass->size);
+    if (0 != retval)
+    {
+        goto done;
+    }
+
+    retval =
+        hkdf_expand(
+            derived_key->data, derived_key->size, context->options,
+            prk, context->options->hmac_digest_length, NULL, 0);
+
+done:
+    memset(prk, 0, sizeof(prk));
+
+    return retval;
+}
+
+/**
+ * \brief Extract a pseudorandom key from input keying material.
+ *
+ * \param prk               A crypto buffer to receive the pseudorandom key.
+ * \param context           Pointer to the vccrypt_key_derivation_context_t
+ *                          structure.
+ * \param ikm               The input keying material.
+ * \param salt              An optional salt value, or NULL.
+ *
+ * \returns \ref VCCRYPT_STATUS_SUCCESS on success and non-zero on error.
+ */
+static int vccrypt_hkdf_extract(
+    vccrypt_buffer_t* prk, vccrypt_key_derivation_context_t* context,
+    const vccrypt_buffer_t* ikm, const vccrypt_buffer_t* salt)
+{
+    return
+        hkdf_extract(
+            prk->data, context->options,
+            NULL != salt ? salt->data : NULL, NULL != salt ? salt->size : 0,
+            ikm->data, ikm->size);
+}
+
+/**
+ * \brief Expand a pseudorandom key into a derived key.
+ *
+ * \param derived_key       A crypto buffer to receive the derived key.
+ * \param context           Pointer to the vccrypt_key_derivation_context_t
+ *                          structure.
+ * \param prk               The pseudorandom key.
+ * \param info              Optional context information, or NULL.
+ *
+ * \returns \ref VCCRYPT_STATUS_SUCCESS on success and non-zero on error.
+ */
+static int vccrypt_hkdf_expand(
+    vccrypt_buffer_t* derived_key,
+    vccrypt_key_derivation_context_t* context,
+    const vccrypt_buffer_t* prk, const vccrypt_buffer_t* info)
+{
+    return
+        hkdf_expand(
+            derived_key->data, derived_key->size, context->options,
+            prk->data, prk->size,
+            NULL != info ? info->data : NULL, NULL != info ? info->size : 0);
+}
@@ -32,13 +32,25 @@ static int vccrypt_pbkdf2_derive_key(
     vccrypt_key_derivation_context_t* context,
     const vccrypt_buffer_t* pass, const vccrypt_buffer_t* salt,
     unsigned int rounds);
+static int vccrypt_pbkdf2_derive_key_batch(
+    vccrypt_buffer_t* derived_keys,
+    vccrypt_key_derivation_context_t* context,
+    const vccrypt_buffer_t* passes, const vccrypt_buffer_t* salts,
+    size_t count, unsigned int rounds);
+static void (*vccrypt_pbkdf2_sha512_init(uint32_t hmac_algorithm))(
+    SHA512_CTX*);
+static int vccrypt_pbkdf2_derive_key_mac(
+    vccrypt_buffer_t* derived_key, vccrypt_key_derivation_options_t* options,
+    const vccrypt_buffer_t* pass, const vccrypt_buffer_t* salt,
+    unsigned int rounds);
 static int hmac_prf(
-    uint8_t* digest, size_t digest_len,
-    vccrypt_key_derivation_options_t* options,
-    const uint8_t* text, size_t text_len,
-    const uint8_t* key, size_t key_len);
+    uint8_t* digest, size_t digest_len, void* prf_context,
+    const uint8_t* text, size_t text_len);
 
 
+/* the number of derivations whose PRF states are kept on the stack at once. */
+#define PBKDF2_BATCH_GROUP_SIZE 16
+
 /* static data for this instance */
 static abstract_factory_registration_t pbkdf2_impl;
 static vccrypt_key_derivation_options_t pbkdf2_options;
@@ -71,6 +83,8 @@ void vccrypt_key_derivation_register_pbkdf2()
     pbkdf2_options.vccrypt_key_derivation_alg_dispose = &vccrypt_pbkdf2_dispose;
     pbkdf2_options.vccrypt_key_derivation_alg_derive_key =
         &vccrypt_pbkdf2_derive_key;
+    pbkdf2_options.vccrypt_key_derivation_alg_derive_key_batch =
+        &vccrypt_pbkdf2_derive_key_batch;
 
     /* set up this registration for the abstract factory */
     pbkdf2_impl.interface = VCCRYPT_INTERFACE_KD;
@@ -141,102 +155,191 @@ static int vccrypt_pbkdf2_derive_key(
     const vccrypt_buffer_t* pass, const vccrypt_buffer_t* salt,
     unsigned int rounds)
 {
-    pbkdf2_prf_t prf = &hmac_prf;
-
     vccrypt_key_derivation_context_t* ctx =
         (vccrypt_key_derivation_context_t*)context;
+    pbkdf2_sha512_prf_context_t prf_context;
+
+    /* HMACs built on the SHA-512 family run directly on the midstates. */
+    void (*init)(SHA512_CTX*) =
+        vccrypt_pbkdf2_sha512_init(ctx->options->hmac_algorithm);
+    if (NULL == init)
+    {
+        return
+            vccrypt_pbkdf2_derive_key_mac(
+                derived_key, ctx->options, pass, salt, rounds);
+    }
+
+    pbkdf2_sha512_prf_init(&prf_context, init, pass->data, pass->size);
 
-    return pkcs5_pbkdf2(
-        derived_key->data, derived_key->size, ctx->options, prf,
-        pass->data, pass->size, salt->data, salt->size, rounds);
+    /* longer keys run their output blocks across the SIMD lanes. */
+    int retval =
+        pkcs5_pbkdf2_lanes(
+            derived_key->data, derived_key->size, ctx->options,
+            &pbkdf2_sha512_prf, &pbkdf2_sha512_prf_lanes, &prf_context,
+            salt->data, salt->size, rounds);
+
+    /* the PRF state is derived from the password. */
+    memset(&prf_context, 0, sizeof(prf_context));
+
+    return retval;
 }
 
 /**
- * \brief Use the configured HMAC function to produce a digest value from
- * a password/passphrase and a key.
+ * \brief Derive a cryptographic key for each of a batch of passwords.
  *
- * \param digest        An array to hold the output data
- * \param digest_len    The length of the digest produced by the PRF
- * \param options       Pointer to the options to use
- * \param text          The input data, e.g. a password
- * \param text_len      The length of the input data
- * \param key           The key
- * \param key_len       The length of the key
+ * The derivations are keyed a group at a time, and the output blocks of the
+ * whole group run in lockstep across the SIMD lanes.
  *
- * \returns a status indicating success or failure.
- *      - \ref VCCRYPT_STATUS_SUCCESS on success.
- *      - a non-zero error code indicating failure.
+ * \param derived_keys      Array of count crypto buffers to receive the
+ *                          derived keys.
+ * \param context           Pointer to the vccrypt_key_derivation_context_t
+ *                          structure.
+ * \param passes            Array of count passwords or passphrases.
+ * \param salts             Array of count salt values.
+ * \param count             The number of keys to derive.
+ * \param rounds            The number of rounds to process for each key.
+ *
+ * \returns \ref VCCRYPT_STATUS_SUCCESS on success and non-zero on error.
  */
-static int hmac_prf(uint8_t* digest, size_t digest_len,
-    vccrypt_key_derivation_options_t* options,
-    const uint8_t* text, size_t text_len,
-    const uint8_t* key, size_t key_len)
+static int vccrypt_pbkdf2_derive_key_batch(
+    vccrypt_buffer_t* derived_keys,
+    vccrypt_key_derivation_context_t* context,
+    const vccrypt_buffer_t* passes, const vccrypt_buffer_t* salts,
+    size_t count, unsigned int rounds)
 {
-    vccrypt_key_derivation_options_t* opts =
-        (vccrypt_key_derivation_options_t*)options;
+    pbkdf2_sha512_prf_context_t prf_context[PBKDF2_BATCH_GROUP_SIZE];
+    pbkdf2_batch_item_t item[PBKDF2_BATCH_GROUP_SIZE];
+    int retval = VCCRYPT_STATUS_SUCCESS;
 
-    // create mac options
-    vccrypt_mac_options_t mac_options;
-    int retval = vccrypt_mac_options_init(
-        &mac_options, opts->alloc_opts, opts->hmac_algorithm);
-    if (0 != retval)
-    {
-        goto done;
-    }
+    void (*init)(SHA512_CTX*) =
+        vccrypt_pbkdf2_sha512_init(context->options->hmac_algorithm);
 
-    // create a key buffer
-    vccrypt_buffer_t keybuf;
-    retval = vccrypt_buffer_init(&keybuf, opts->alloc_opts, key_len);
-    if (0 != retval)
+    /* other HMACs have no lockstep PRF, so derive each key in turn. */
+    if (NULL == init)
     {
-        goto cleanup_mac_options;
+        for (size_t i = 0; i < count; ++i)
+        {
+            retval =
+                vccrypt_pbkdf2_derive_key_mac(
+                    derived_keys + i, context->options, passes + i,
+                    salts + i, rounds);
+            if (VCCRYPT_STATUS_SUCCESS != retval)
+            {
+                return retval;
+            }
+        }
+
+        return VCCRYPT_STATUS_SUCCESS;
     }
-    memcpy(keybuf.data, key, key_len);
 
-    // initialize MAC
-    vccrypt_mac_context_t mac_context;
-    retval = vccrypt_mac_init(&mac_options, &mac_context, &keybuf);
-    if (0 != retval)
+    for (size_t base = 0; base < count; base += PBKDF2_BATCH_GROUP_SIZE)
     {
-        goto cleanup_keybuf;
+        size_t n = count - base;
+        if (n > PBKDF2_BATCH_GROUP_SIZE)
+        {
+            n = PBKDF2_BATCH_GROUP_SIZE;
+        }
+
+        for (size_t i = 0; i < n; ++i)
+        {
+            pbkdf2_sha512_prf_init(
+                prf_context + i, init, passes[base + i].data,
+                passes[base + i].size);
+
+            item[i].derived_key = derived_keys[base + i].data;
+            item[i].derived_key_len = derived_keys[base + i].size;
+            item[i].prf_context = prf_context + i;
+            item[i].salt = salts[base + i].data;
+            item[i].salt_len = salts[base + i].size;
+        }
+
+        retval =
+            pkcs5_pbkdf2_batch(
+                item, n, context->options, &pbkdf2_sha512_prf,
+                &pbkdf2_sha512_prf_lanes, rounds);
+        if (VCCRYPT_STATUS_SUCCESS != retval)
+        {
+            break;
+        }
     }
 
-    // digest
-    retval = vccrypt_mac_digest(&mac_context, text, text_len);
-    if (0 != retval)
+    /* the PRF states are derived from the passwords. */
+    memset(prf_context, 0, sizeof(prf_context));
+
+    return retval;
+}
+
+/**
+ * \brief Select the SHA-512 family init function for an HMAC algorithm.
+ *
+ * \param hmac_algorithm    The HMAC algorithm.
+ *
+ * \returns the init function, or NULL if the HMAC is not built on the SHA-512
+ * family.
+ */
+static void (*vccrypt_pbkdf2_sha512_init(uint32_t hmac_algorithm))(
+    SHA512_CTX*)
+{
+    switch (hmac_algorithm)
     {
-        goto cleanup_mac_context;
+        case VCCRYPT_MAC_ALGORITHM_SHA_2_512_HMAC:
+            return &SHA512_Init;
+
+        case VCCRYPT_MAC_ALGORITHM_SHA_2_512_256_HMAC:
+            return &SHA512_256_Init;
+
+        default:
+            return NULL;
     }
+}
 
-    // create an output buffer
-    vccrypt_buffer_t outbuf;
-    retval = vccrypt_buffer_init(&outbuf, opts->alloc_opts, digest_len);
+/**
+ * \brief Derive a cryptographic key using the configured HMAC through the mac
+ * interface.
+ *
+ * The HMAC instance is keyed with the password once.  Each finalize returns it
+ * to its keyed state, so the iterations don't rehash the password or allocate.
+ *
+ * \param derived_key       A crypto buffer to receive the derived key.
+ * \param options           Pointer to the options to use
+ * \param pass              A buffer containing a password or passphrase
+ * \param salt              A buffer containing a salt value
+ * \param rounds            The number of rounds to process.
+ *
+ * \returns \ref VCCRYPT_STATUS_SUCCESS on success and non-zero on error.
+ */
+static int vccrypt_pbkdf2_derive_key_mac(
+    vccrypt_buffer_t* derived_key, vccrypt_key_derivation_options_t* options,
+    const vccrypt_buffer_t* pass, const vccrypt_buffer_t* salt,
+    unsigned int rounds)
+{
+    // create mac options
+    vccrypt_mac_options_t mac_options;
+    int retval = vccrypt_mac_options_init(
+        &mac_options, options->alloc_opts, options->hmac_algorithm);
     if (0 != retval)
     {
-        goto cleanup_mac_context;
+        goto done;
     }
 
-
-    // finalize
-    retval = vccrypt_mac_finalize(&mac_context, &outbuf);
+    // initialize MAC, keyed with the password
+    vccrypt_mac_context_t mac_context;
+    retval =
+        vccrypt_mac_init(
+            &mac_options, &mac_context, (vccrypt_buffer_t*)pass);
     if (0 != retval)
     {
-        goto cleanup_outbuf;
+        goto cleanup_mac_options;
     }
-    memcpy(digest, outbuf.data, digest_len);
 
-    retval = VCCRYPT_STATUS_SUCCESS;
+    retval =
+        pkcs5_pbkdf2(
+            derived_key->data, derived_key->size, options, &hmac_prf,
+            &mac_context, salt->data, salt->size, rounds);
 
     // cleanup
-cleanup_outbuf:
-    dispose((disposable_t*)&outbuf);
-
-cleanup_mac_context:
     dispose((disposable_t*)&mac_context);
 
-cleanup_keybuf:
-    dispose((disposable_t*)&keybuf);
-
 cleanup_mac_options:
     dispose((disposable_t*)&mac_options);
 
@@ -244,3 +347,38 @@ done:
 
     return retval;
 }
+
+/**
+ * \brief Use a keyed HMAC instance to produce a digest value from a text.
+ *
+ * \param digest        An array to hold the output data
+ * \param digest_len    The length of the digest produced by the PRF
+ * \param prf_context   The keyed vccrypt_mac_context_t instance
+ * \param text          The input data, e.g. a salt
+ * \param text_len      The length of the input data
+ *
+ * \returns a status indicating success or failure.
+ *      - \ref VCCRYPT_STATUS_SUCCESS on success.
+ *      - a non-zero error code indicating failure.
+ */
+static int hmac_prf(
+    uint8_t* digest, size_t digest_len, void* prf_context,
+    const uint8_t* text, size_t text_len)
+{
+    vccrypt_mac_context_t* mac_context = (vccrypt_mac_context_t*)prf_context;
+
+    // digest
+    int retval = vccrypt_mac_digest(mac_context, text, text_len);
+    if (0 != retval)
+    {
+        return retval;
+    }
+
+    // finalize directly into the digest, which leaves the MAC keyed
+    vccrypt_buffer_t outbuf;
+    memset(&outbuf, 0, sizeof(outbuf));
+    outbuf.data = digest;
+    outbuf.size = digest_len;
+
+    return vccrypt_mac_finalize(mac_context, &outbuf);
+}
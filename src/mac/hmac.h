@@ -14,20 +14,35 @@
 #include <vccrypt/mac.h>
 #include <vpr/disposable.h>
 
+#include "../hash/ref/sha512.h"
+
 /* make this header C++ friendly. */
 #ifdef __cplusplus
 extern "C" {
 #endif  //__cplusplus
 
+/**
+ * The largest hash size supported by hmac, in bytes.
+ */
+#define VCCRYPT_HMAC_MAX_HASH_SIZE 64
+
 /**
  * The vccrypt_hmac_state_t data structure holds the current hmac state.
+ *
+ * The inner and outer hash instances hold the midstates after digesting the
+ * key XOR ipad and the key XOR opad blocks.  They are computed once, when the
+ * key is set, and each message starts from copies of them.  The inner hash of
+ * each message is finalized into inner_md, so that finalize doesn't need the
+ * allocator.
  */
 typedef struct vccrypt_hmac_state
 {
     disposable_t hdr;
     vccrypt_hash_options_t* hash_options;
     vccrypt_hash_context_t hash;
-    vccrypt_buffer_t key;
+    vccrypt_hash_context_t inner;
+    vccrypt_hash_context_t outer;
+    uint8_t inner_md[VCCRYPT_HMAC_MAX_HASH_SIZE];
 } vccrypt_hmac_state_t;
 
 /**
@@ -59,6 +74,8 @@ int vccrypt_hmac_digest(
 /**
  * Finalize the hmac, copying the output data to the given buffer.
  *
+ * The hmac instance is then ready to digest a new message with the same key.
+ *
  * \param state         The hmac state to finalize.
  * \param hmac_buffer   The buffer to receive the hmac.  Must be large enough
  *                      for the given hmac algorithm.
@@ -68,6 +85,55 @@ int vccrypt_hmac_digest(
 int vccrypt_hmac_finalize(
     vccrypt_hmac_state_t* state, vccrypt_buffer_t* hmac_buffer);
 
+/**
+ * Discard any data digested so far, returning the hmac to its keyed state.
+ *
+ * \param state         The hmac state to reset.
+ *
+ * \returns 0 on success and non-zero on failure.
+ */
+int vccrypt_hmac_reset(vccrypt_hmac_state_t* state);
+
+/**
+ * Finalize an hmac built on a member of the SHA-512 family, writing the first
+ * bytes of the hmac to caller memory.
+ *
+ * The outer hash runs as a single block from the outer midstate, without
+ * cloning hash instances, and the hmac instance is then ready to digest a new
+ * message with the same key.
+ *
+ * \param state         The hmac state to finalize.
+ * \param mac           Memory to receive the first size bytes of the hmac.
+ * \param size          The number of bytes to write, at most the hash size.
+ *
+ * \returns 0 on success and non-zero on failure.
+ */
+int vccrypt_hmac_sha512_finalize_truncated(
+    vccrypt_hmac_state_t* state, uint8_t* mac, size_t size);
+
+/**
+ * Verify a batch of HMACs built on a member of the SHA-512 family.
+ *
+ * The inner and outer hashes of independent items are interleaved across the
+ * lanes of the SHA-512 multi-buffer block function.  The arguments must have
+ * been checked by vccrypt_mac_batch_verify(), which also clears the results.
+ *
+ * \param init          The SHA-512 family init function.
+ * \param mac_size      The number of MAC bytes to compare.
+ * \param keys          Array of keys.
+ * \param data          Array of pointers to the messages.
+ * \param sizes         Array of message sizes, in bytes.
+ * \param tags          Array of pointers to the expected MACs.
+ * \param count         The number of messages.
+ * \param results       Bitmap receiving a set bit for each valid MAC.
+ *
+ * \returns 0 on success and non-zero on failure.
+ */
+int vccrypt_hmac_sha512_batch_verify(
+    void (*init)(SHA512_CTX*), size_t mac_size, const vccrypt_buffer_t* keys,
+    const uint8_t* const* data, const size_t* sizes,
+    const uint8_t* const* tags, size_t count, uint8_t* results);
+
 /* make this header C++ friendly. */
 #ifdef __cplusplus
 }
@@ -15,6 +15,8 @@
 /**
  * Finalize the hmac, copying the output data to the given buffer.
  *
+ * The hmac instance is then ready to digest a new message with the same key.
+ *
  * \param state         The hmac state to finalize.
  * \param hmac_buffer   The buffer to receive the hmac.  Must be large enough
  *                      for the given hmac algorithm.
@@ -38,73 +40,57 @@ int vccrypt_hmac_finalize(
         return VCCRYPT_ERROR_MAC_FINALIZE_INVALID_ARG;
     }
 
-    /* create a buffer to hold the inner hash */
+    /* the inner hash goes into the scratch space in the state, through a
+     * buffer that borrows it.  This buffer is never initialized, so it must
+     * not be disposed. */
     vccrypt_buffer_t inner;
-    int ret = vccrypt_buffer_init(
-        &inner, state->hash_options->alloc_opts,
-        state->hash_options->hash_size);
-    if (ret != 0)
-    {
-        return ret;
-    }
+    memset(&inner, 0, sizeof(inner));
+    inner.data = state->inner_md;
+    inner.size = state->hash_options->hash_size;
 
     /* finalize the inner hash */
-    ret = vccrypt_hash_finalize(&state->hash, &inner);
-    if (ret != 0)
-    {
-        goto cleanup_inner;
-    }
-
-    /* dispose of the hash and re-initialize */
-    dispose((disposable_t*)&state->hash);
-    ret = vccrypt_hash_init(state->hash_options, &state->hash);
+    int ret = vccrypt_hash_finalize(&state->hash, &inner);
     if (ret != 0)
     {
         goto cleanup_inner;
     }
 
-    /* create the outer key */
-    vccrypt_buffer_t okey;
-    ret = vccrypt_buffer_init(
-        &okey, state->hash_options->alloc_opts,
-        state->hash_options->hash_block_size);
+    /* the outer hash runs in a temporary clone of the outer midstate, so
+     * that a failed clone leaves the state untouched. */
+    vccrypt_hash_context_t outer;
+    ret = vccrypt_hash_clone(&outer, &state->outer);
     if (ret != 0)
     {
         goto cleanup_inner;
     }
 
-    /* enrich the outer key with our key data */
-    uint8_t* okeybuf = (uint8_t*)okey.data;
-    const uint8_t* keybuf = (const uint8_t*)state->key.data;
-    for (size_t i = 0; i < state->key.size; ++i)
-    {
-        okeybuf[i] = keybuf[i] ^ 0x5c;
-    }
-
-    /* digest the outer key */
-    ret = vccrypt_hash_digest(&state->hash, okey.data, okey.size);
+    /* digest the inner hash */
+    ret = vccrypt_hash_digest(&outer, inner.data, inner.size);
     if (ret != 0)
     {
-        goto cleanup_outer_key;
+        goto cleanup_outer;
     }
 
-    /* digest the inner hash */
-    ret = vccrypt_hash_digest(&state->hash, inner.data, inner.size);
+    /* finalize the hash */
+    ret = vccrypt_hash_finalize(&outer, hmac_buffer);
     if (ret != 0)
     {
-        goto cleanup_outer_key;
+        goto cleanup_outer;
     }
 
-    /* finalize the hash */
-    ret = vccrypt_hash_finalize(&state->hash, hmac_buffer);
+    /* the next message starts from the inner midstate.  If this clone
+     * fails, the hash is left empty, and vccrypt_hmac_reset() or dispose
+     * can still be called. */
+    dispose((disposable_t*)&state->hash);
+    ret = vccrypt_hash_clone(&state->hash, &state->inner);
 
     /* fall-through */
 
-cleanup_outer_key:
-    dispose((disposable_t*)&okey);
+cleanup_outer:
+    dispose((disposable_t*)&outer);
 
 cleanup_inner:
-    dispose((disposable_t*)&inner);
+    memset(state->inner_md, 0, sizeof(state->inner_md));
 
     return ret;
 }
@@ -15,7 +15,11 @@
 /* forward decls */
 static void vccrypt_hmac_dispose(void* context);
 static int vccrypt_hmac_key_init(
-    vccrypt_hmac_state_t* state, const vccrypt_buffer_t* key);
+    vccrypt_hmac_state_t* state, vccrypt_buffer_t* keybuf,
+    const vccrypt_buffer_t* key);
+static int vccrypt_hmac_pad_init(
+    vccrypt_hmac_state_t* state, vccrypt_hash_context_t* hash,
+    const vccrypt_buffer_t* keybuf, vccrypt_buffer_t* pad, uint8_t padval);
 
 /**
  * Initialize an hmac_state_t using the given hash options and key.
@@ -34,14 +38,16 @@ int vccrypt_hmac_init(
     MODEL_ASSERT(hash_options != NULL);
     MODEL_ASSERT(hash_options->alloc_opts != NULL);
     MODEL_ASSERT(hash_options->hash_size > 0);
+    MODEL_ASSERT(hash_options->hash_size <= VCCRYPT_HMAC_MAX_HASH_SIZE);
     MODEL_ASSERT(state != NULL);
     MODEL_ASSERT(key != NULL);
     MODEL_ASSERT(key->size > 0);
 
     /* sanity check on parameters */
     if (hash_options == NULL || hash_options->alloc_opts == NULL ||
-        hash_options->hash_size == 0 || state == NULL || key == NULL ||
-        key->size == 0)
+        hash_options->hash_size == 0 ||
+        hash_options->hash_size > VCCRYPT_HMAC_MAX_HASH_SIZE ||
+        state == NULL || key == NULL || key->size == 0)
     {
         return VCCRYPT_ERROR_MAC_INIT_INVALID_ARG;
     }
@@ -52,78 +58,127 @@ int vccrypt_hmac_init(
     /* save the hash options */
     state->hash_options = hash_options;
 
-    /* create the hash context for this hmac instance. */
-    int ret = vccrypt_hash_init(state->hash_options, &state->hash);
+    /* create the padded key buffer */
+    vccrypt_buffer_t keybuf;
+    int ret = vccrypt_buffer_init(
+        &keybuf, state->hash_options->alloc_opts,
+        state->hash_options->hash_block_size);
     if (ret != 0)
     {
         return ret;
     }
 
-    /* create the key buffer for our state buffer */
-    ret = vccrypt_buffer_init(
-        &state->key, state->hash_options->alloc_opts,
-        state->hash_options->hash_block_size);
+    /* initialize the padded key */
+    ret = vccrypt_hmac_key_init(state, &keybuf, key);
     if (ret != 0)
     {
-        goto cleanup_hash;
+        goto cleanup_keybuf;
     }
 
-    /* initialize the key for our state buffer */
-    ret = vccrypt_hmac_key_init(state, key);
+    /* create the buffer for the key XOR pad blocks */
+    vccrypt_buffer_t pad;
+    ret = vccrypt_buffer_init(
+        &pad, state->hash_options->alloc_opts,
+        state->hash_options->hash_block_size);
     if (ret != 0)
     {
-        goto cleanup_key;
+        goto cleanup_keybuf;
     }
 
-    /* create the inner key */
-    vccrypt_buffer_t ikey;
-    ret = vccrypt_buffer_init(
-        &ikey, state->hash_options->alloc_opts,
-        hash_options->hash_block_size);
+    /* compute the inner midstate */
+    ret = vccrypt_hmac_pad_init(state, &state->inner, &keybuf, &pad, 0x36);
     if (ret != 0)
     {
-        goto cleanup_key;
+        goto cleanup_pad;
     }
 
-    /* enrich the inner key with our key data */
-    uint8_t* ikeybuf = (uint8_t*)ikey.data;
-    const uint8_t* keybuf = (const uint8_t*)state->key.data;
-    for (size_t i = 0; i < state->key.size; ++i)
+    /* compute the outer midstate */
+    ret = vccrypt_hmac_pad_init(state, &state->outer, &keybuf, &pad, 0x5c);
+    if (ret != 0)
     {
-        ikeybuf[i] = keybuf[i] ^ 0x36;
+        goto cleanup_inner;
     }
 
-    /* digest the inner key with the inner hash */
-    ret = vccrypt_hash_digest(&state->hash, ikey.data, ikey.size);
-    dispose((disposable_t*)&ikey);
+    /* the first message starts from the inner midstate */
+    ret = vccrypt_hash_clone(&state->hash, &state->inner);
     if (ret != 0)
     {
-        goto cleanup_key;
+        goto cleanup_outer;
     }
 
-    return ret;
+    /* success */
+    goto cleanup_pad;
 
     /* error cleanup */
 
-cleanup_key:
-    dispose((disposable_t*)&state->key);
+cleanup_outer:
+    dispose((disposable_t*)&state->outer);
+
+cleanup_inner:
+    dispose((disposable_t*)&state->inner);
 
-cleanup_hash:
-    dispose((disposable_t*)&state->hash);
+cleanup_pad:
+    dispose((disposable_t*)&pad);
+
+cleanup_keybuf:
+    dispose((disposable_t*)&keybuf);
 
     return ret;
 }
 
+/**
+ * Create a hash instance that has digested the key XOR a pad block.
+ *
+ * \param state             The state structure to use for init.
+ * \param hash              The hash instance to initialize.
+ * \param keybuf            The padded key.
+ * \param pad               Scratch space for the key XOR pad block.
+ * \param padval            The pad byte.
+ *
+ * \returns 0 on success and non-zero on failure.
+ */
+static int vccrypt_hmac_pad_init(
+    vccrypt_hmac_state_t* state, vccrypt_hash_context_t* hash,
+    const vccrypt_buffer_t* keybuf, vccrypt_buffer_t* pad, uint8_t padval)
+{
+    /* enrich the pad block with our key data */
+    uint8_t* padbuf = (uint8_t*)pad->data;
+    const uint8_t* kbuf = (const uint8_t*)keybuf->data;
+    for (size_t i = 0; i < keybuf->size; ++i)
+    {
+        padbuf[i] = kbuf[i] ^ padval;
+    }
+
+    int ret = vccrypt_hash_init(state->hash_options, hash);
+    if (ret != 0)
+    {
+        return ret;
+    }
+
+    /* digest the pad block */
+    ret = vccrypt_hash_digest(hash, pad->data, pad->size);
+    if (ret != 0)
+    {
+        dispose((disposable_t*)hash);
+        return ret;
+    }
+
+    /* success */
+    return VCCRYPT_STATUS_SUCCESS;
+}
+
 /**
  * Initialize the key for the HMAC, performing any pre-digest needed.
  *
  * \param state             The state structure to use for init.
+ * \param keybuf            The buffer to receive the padded key.
  * \param key               The key to use for this HMAC.
  *
  * \returns 0 on success and non-zero on failure.
  */
 static int vccrypt_hmac_key_init(
-    vccrypt_hmac_state_t* state, const vccrypt_buffer_t* key)
+    vccrypt_hmac_state_t* state, vccrypt_buffer_t* keybuf,
+    const vccrypt_buffer_t* key)
 {
     const vccrypt_buffer_t* kv = key;
     size_t kv_size = key->size;
@@ -149,7 +204,7 @@ static int vccrypt_hmac_key_init(
         }
 
         /* finalize the key hash */
-        ret = vccrypt_hash_finalize(&keyhash, &state->key);
+        ret = vccrypt_hash_finalize(&keyhash, keybuf);
         if (ret != 0)
         {
             dispose((disposable_t*)&keyhash);
@@ -157,7 +212,7 @@ static int vccrypt_hmac_key_init(
         }
 
         /* set kv to the state key for the next part */
-        kv = &state->key;
+        kv = keybuf;
         kv_size = state->hash_options->hash_size;
 
         /* clean up */
@@ -167,19 +222,19 @@ static int vccrypt_hmac_key_init(
     /* handle the case where the key is smaller than the hash block size */
     if (kv_size < state->hash_options->hash_block_size)
     {
-        uint8_t* keybuf = (uint8_t*)state->key.data;
+        uint8_t* kbuf = (uint8_t*)keybuf->data;
 
         /* copy the key to the beginning of the buffer */
-        memmove(keybuf, kv->data, kv_size);
+        memmove(kbuf, kv->data, kv_size);
         /* clear the buffer after the key */
-        memset(keybuf + kv_size, 0, state->key.size - kv_size);
+        memset(kbuf + kv_size, 0, keybuf->size - kv_size);
     }
     /* handle the case where the key is exactly the hash size */
     else
     {
-        MODEL_ASSERT(kv_size == state->key.size);
+        MODEL_ASSERT(kv_size == keybuf->size);
 
-        memmove(state->key.data, kv->data, state->key.size);
+        memmove(keybuf->data, kv->data, keybuf->size);
     }
 
     /* success */
@@ -196,9 +251,14 @@ static void vccrypt_hmac_dispose(void* state)
     vccrypt_hmac_state_t* st = (vccrypt_hmac_state_t*)state;
     MODEL_ASSERT(st != NULL);
 
-    /* dispose of algorithm-specific resources */
-    dispose((disposable_t*)&st->hash);
-    dispose((disposable_t*)&st->key);
+    /* dispose of algorithm-specific resources.  A failed restart in
+     * vccrypt_hmac_finalize() leaves no hash to dispose. */
+    if (NULL != st->hash.hdr.dispose)
+    {
+        dispose((disposable_t*)&st->hash);
+    }
+    dispose((disposable_t*)&st->inner);
+    dispose((disposable_t*)&st->outer);
 
     /* clear out this structure */
     memset(st, 0, sizeof(vccrypt_hmac_state_t));
@@ -0,0 +1,34 @@
+/**
+ * \file vccrypt_hmac_reset.c
+ *
+ * Reset an hmac to its keyed state.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <cbmc/model_assert.h>
+#include <string.h>
+#include <vpr/parameters.h>
+
+#include "hmac.h"
+
+/**
+ * Discard any data digested so far, returning the hmac to its keyed state.
+ *
+ * \param state         The hmac state to reset.
+ *
+ * \returns 0 on success and non-zero on failure.
+ */
+int vccrypt_hmac_reset(vccrypt_hmac_state_t* state)
+{
+    MODEL_ASSERT(state != NULL);
+
+    /* the hash state is inline, so this doesn't touch the allocator.  A
+     * failed restart in vccrypt_hmac_finalize() leaves no hash to dispose. */
+    if (NULL != state->hash.hdr.dispose)
+    {
+        dispose((disposable_t*)&state->hash);
+    }
+
+    return vccrypt_hash_clone(&state->hash, &state->inner);
+}
@@ -0,0 +1,208 @@
+/**
+ * \file vccrypt_hmac_sha512_batch_verify.c
+ *
+ * Verify a batch of HMACs built on a member of the SHA-512 family.
+ *
+ * The batch is processed in groups.  For each group, the key XOR ipad blocks
+ * and messages of all items are hashed together across the lanes of the
+ * multi-buffer block function, then the key XOR opad blocks and inner hashes
+ * are hashed the same way.  Each pad block is hashed as the first block of its
+ * lane, so no hash context is built or copied per item.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <cbmc/model_assert.h>
+#include <string.h>
+#include <vccrypt/compare.h>
+#include <vpr/parameters.h>
+
+#include "../hash/hash_private.h"
+#include "../hash/ref/sha512_internal.h"
+#include "hmac.h"
+
+/* the number of items whose scratch space is kept on the stack at once. */
+#define HMAC_SHA512_BATCH_GROUP_SIZE 16
+
+/**
+ * Scratch space for one item.
+ */
+typedef struct hmac_sha512_batch_item
+{
+    uint8_t ipad[SHA512_CBLOCK];
+    uint8_t opad[SHA512_CBLOCK];
+    uint8_t inner_md[SHA512_DIGEST_LENGTH];
+    uint8_t mac[SHA512_DIGEST_LENGTH];
+} hmac_sha512_batch_item_t;
+
+/**
+ * Scratch space for one group of items.
+ */
+typedef struct hmac_sha512_batch_group
+{
+    const uint8_t* const* data;
+    const size_t* sizes;
+    size_t md_len;
+    hmac_sha512_batch_item_t item[HMAC_SHA512_BATCH_GROUP_SIZE];
+} hmac_sha512_batch_group_t;
+
+/* forward decls */
+static void hmac_sha512_batch_pads(
+    void (*init)(SHA512_CTX*), const vccrypt_buffer_t* key,
+    hmac_sha512_batch_item_t* item);
+static void hmac_sha512_batch_inner_item(
+    void* user, size_t index, vccrypt_sha512_batch_item_t* item);
+static void hmac_sha512_batch_outer_item(
+    void* user, size_t index, vccrypt_sha512_batch_item_t* item);
+
+/**
+ * Verify a batch of HMACs built on a member of the SHA-512 family.
+ *
+ * \param init          The SHA-512 family init function.
+ * \param mac_size      The number of MAC bytes to compare.
+ * \param keys          Array of keys.
+ * \param data          Array of pointers to the messages.
+ * \param sizes         Array of message sizes, in bytes.
+ * \param tags          Array of pointers to the expected MACs.
+ * \param count         The number of messages.
+ * \param results       Bitmap receiving a set bit for each valid MAC.
+ *
+ * \returns 0 on success and non-zero on failure.
+ */
+int vccrypt_hmac_sha512_batch_verify(
+    void (*init)(SHA512_CTX*), size_t mac_size, const vccrypt_buffer_t* keys,
+    const uint8_t* const* data, const size_t* sizes,
+    const uint8_t* const* tags, size_t count, uint8_t* results)
+{
+    hmac_sha512_batch_group_t group;
+    SHA512_CTX probe;
+
+    MODEL_ASSERT(init != NULL);
+    MODEL_ASSERT(count == 0 || keys != NULL);
+    MODEL_ASSERT(count == 0 || data != NULL);
+    MODEL_ASSERT(count == 0 || sizes != NULL);
+    MODEL_ASSERT(count == 0 || tags != NULL);
+    MODEL_ASSERT(count == 0 || results != NULL);
+
+    /* the init function selects the digest length. */
+    init(&probe);
+    group.md_len = probe.md_len;
+
+    MODEL_ASSERT(mac_size <= group.md_len);
+
+    for (size_t base = 0; base < count; base += HMAC_SHA512_BATCH_GROUP_SIZE)
+    {
+        size_t n = count - base;
+        if (n > HMAC_SHA512_BATCH_GROUP_SIZE)
+        {
+            n = HMAC_SHA512_BATCH_GROUP_SIZE;
+        }
+
+        group.data = data + base;
+        group.sizes = sizes + base;
+
+        for (size_t i = 0; i < n; ++i)
+        {
+            hmac_sha512_batch_pads(init, keys + base + i, group.item + i);
+        }
+
+        /* H((K0 ^ ipad) || text) */
+        vccrypt_sha512_batch_run(
+            init, &hmac_sha512_batch_inner_item, &group, n);
+
+        /* H((K0 ^ opad) || H((K0 ^ ipad) || text)) */
+        vccrypt_sha512_batch_run(
+            init, &hmac_sha512_batch_outer_item, &group, n);
+
+        for (size_t i = 0; i < n; ++i)
+        {
+            size_t j = base + i;
+
+            if (0 == crypto_memcmp(group.item[i].mac, tags[j], mac_size))
+            {
+                results[j / 8] |= (uint8_t)(1U << (j % 8));
+            }
+        }
+    }
+
+    /* the scratch space holds key material. */
+    memset(&group, 0, sizeof(group));
+
+    /* success */
+    return VCCRYPT_STATUS_SUCCESS;
+}
+
+/**
+ * Compute the key XOR ipad and key XOR opad blocks for an item.
+ *
+ * \param init          The SHA-512 family init function.
+ * \param key           The key for this item.
+ * \param item          The item scratch space to receive the pad blocks.
+ */
+static void hmac_sha512_batch_pads(
+    void (*init)(SHA512_CTX*), const vccrypt_buffer_t* key,
+    hmac_sha512_batch_item_t* item)
+{
+    uint8_t k0[SHA512_CBLOCK];
+
+    memset(k0, 0, sizeof(k0));
+
+    /* keys longer than a block are replaced by their hash. */
+    if (key->size > SHA512_CBLOCK)
+    {
+        SHA512_CTX keyhash;
+
+        init(&keyhash);
+        SHA512_Update(&keyhash, key->data, key->size);
+        SHA512_Final(&keyhash, k0);
+        memset(&keyhash, 0, sizeof(keyhash));
+    }
+    else
+    {
+        memcpy(k0, key->data, key->size);
+    }
+
+    for (size_t i = 0; i < SHA512_CBLOCK; ++i)
+    {
+        item->ipad[i] = k0[i] ^ 0x36;
+        item->opad[i] = k0[i] ^ 0x5c;
+    }
+
+    memset(k0, 0, sizeof(k0));
+}
+
+/**
+ * Describe the inner hash of an item in the current group.
+ *
+ * \param user          The hmac_sha512_batch_group_t for this group.
+ * \param index         The index of the item in the group.
+ * \param item          The batch item to fill in.
+ */
+static void hmac_sha512_batch_inner_item(
+    void* user, size_t index, vccrypt_sha512_batch_item_t* item)
+{
+    hmac_sha512_batch_group_t* group = (hmac_sha512_batch_group_t*)user;
+
+    item->prefix = group->item[index].ipad;
+    item->data = group->data[index];
+    item->size = group->sizes[index];
+    item->md = group->item[index].inner_md;
+}
+
+/**
+ * Describe the outer hash of an item in the current group.
+ *
+ * \param user          The hmac_sha512_batch_group_t for this group.
+ * \param index         The index of the item in the group.
+ * \param item          The batch item to fill in.
+ */
+static void hmac_sha512_batch_outer_item(
+    void* user, size_t index, vccrypt_sha512_batch_item_t* item)
+{
+    hmac_sha512_batch_group_t* group = (hmac_sha512_batch_group_t*)user;
+
+    item->prefix = group->item[index].opad;
+    item->data = group->item[index].inner_md;
+    item->size = group->md_len;
+    item->md = group->item[index].mac;
+}
@@ -0,0 +1,88 @@
+/**
+ * \file vccrypt_hmac_sha512_finalize_truncated.c
+ *
+ * Finalize an hmac built on the SHA-512 family, writing the first bytes of the
+ * hmac to caller memory.
+ *
+ * The inner hash of a message is always shorter than a block, so the outer
+ * hash is exactly one block operation from the outer midstate.  Running it
+ * directly on the SHA-512 state skips cloning and disposing the hash
+ * instances, which is most of the cost of finalizing a short message.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <cbmc/model_assert.h>
+#include <string.h>
+#include <vpr/parameters.h>
+
+#include "../hash/ref/sha512_internal.h"
+#include "hmac.h"
+
+/**
+ * Finalize an hmac built on a member of the SHA-512 family, writing the first
+ * bytes of the hmac to caller memory.
+ *
+ * \param state         The hmac state to finalize.
+ * \param mac           Memory to receive the first size bytes of the hmac.
+ * \param size          The number of bytes to write, at most the hash size.
+ *
+ * \returns 0 on success and non-zero on failure.
+ */
+int vccrypt_hmac_sha512_finalize_truncated(
+    vccrypt_hmac_state_t* state, uint8_t* mac, size_t size)
+{
+    uint8_t block[SHA512_CBLOCK];
+    SHA512_CTX c;
+
+    MODEL_ASSERT(state != NULL);
+    MODEL_ASSERT(state->hash.hash_state != NULL);
+    MODEL_ASSERT(mac != NULL);
+
+    /* a failed restart in vccrypt_hmac_finalize() leaves no hash. */
+    if (NULL == state->hash.hash_state)
+    {
+        return VCCRYPT_ERROR_MAC_FINALIZE_INVALID_ARG;
+    }
+
+    SHA512_CTX* hash = (SHA512_CTX*)state->hash.hash_state;
+    const SHA512_CTX* inner = (const SHA512_CTX*)state->inner.hash_state;
+    const SHA512_CTX* outer = (const SHA512_CTX*)state->outer.hash_state;
+    size_t md_len = hash->md_len;
+    uint64_t bits = (uint64_t)(SHA512_CBLOCK + md_len) << 3;
+
+    MODEL_ASSERT(size <= md_len);
+
+    /* H((K0 ^ ipad) || text) goes at the start of the outer block. */
+    int ret = SHA512_Final(hash, block);
+    if (0 != ret)
+    {
+        goto cleanup;
+    }
+
+    /* pad the block, which follows the K0 ^ opad block. */
+    memset(block + md_len, 0, SHA512_CBLOCK - md_len);
+    block[md_len] = 0x80;
+    for (int i = 0; i < 8; ++i)
+    {
+        block[SHA512_CBLOCK - 1 - i] = (uint8_t)(bits >> (8 * i));
+    }
+
+    /* H((K0 ^ opad) || H((K0 ^ ipad) || text)) */
+    memcpy(c.h, outer->h, sizeof(c.h));
+    sha512_block(&c, block, 1);
+
+    for (size_t i = 0; i < size; ++i)
+    {
+        mac[i] = (uint8_t)(c.h[i / 8] >> (56 - 8 * (i % 8)));
+    }
+
+cleanup:
+    /* the next message starts from the inner midstate */
+    memcpy(hash, inner, sizeof(SHA512_CTX));
+
+    memset(block, 0, sizeof(block));
+    memset(&c, 0, sizeof(c));
+
+    return ret;
+}
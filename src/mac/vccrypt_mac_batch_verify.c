@@ -0,0 +1,172 @@
+/**
+ * \file vccrypt_mac_batch_verify.c
+ *
+ * Verify the MACs of a batch of independent messages.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <cbmc/model_assert.h>
+#include <string.h>
+#include <vccrypt/compare.h>
+#include <vccrypt/mac.h>
+#include <vpr/parameters.h>
+
+/* forward decls */
+static int vccrypt_mac_batch_verify_each(
+    vccrypt_mac_options_t* options, const vccrypt_buffer_t* keys,
+    const uint8_t* const* data, const size_t* sizes,
+    const uint8_t* const* tags, size_t count, uint8_t* results);
+
+/**
+ * \brief Verify the MACs of a batch of independent messages.
+ *
+ * Item \p i is valid if the MAC of \p data[i] under \p keys[i] matches the
+ * first mac_size bytes of \p tags[i], exactly as if it were checked with
+ * vccrypt_mac_init(), vccrypt_mac_digest(), vccrypt_mac_finalize(), and
+ * crypto_memcmp().  Algorithms that support it authenticate several messages
+ * in lockstep, which is much faster than checking many short messages one at
+ * a time.
+ *
+ * The result for item \p i is bit (i % 8) of \p results[i / 8], which is set
+ * if the MAC is valid and clear otherwise.  A success status only means that
+ * the batch was processed; the caller must check the bitmap.
+ *
+ * \param options       The options for the MAC algorithm to use.
+ * \param keys          Array of \p count keys.
+ * \param data          Array of \p count pointers to the messages.  A pointer
+ *                      may only be NULL if its size is 0.
+ * \param sizes         Array of \p count message sizes, in bytes.
+ * \param tags          Array of \p count pointers to the expected MACs, each
+ *                      at least mac_size bytes.
+ * \param count         The number of messages to verify.
+ * \param results       Bitmap of (count + 7) / 8 bytes to receive the result
+ *                      for each message.
+ *
+ * \returns a status indicating success or failure.
+ *      - \ref VCCRYPT_STATUS_SUCCESS if the batch was processed.
+ *      - \ref VCCRYPT_ERROR_MAC_BATCH_VERIFY_INVALID_ARG if an invalid
+ *             argument is provided.
+ *      - a non-zero return code on error.
+ */
+int vccrypt_mac_batch_verify(
+    vccrypt_mac_options_t* options, const vccrypt_buffer_t* keys,
+    const uint8_t* const* data, const size_t* sizes,
+    const uint8_t* const* tags, size_t count, uint8_t* results)
+{
+    MODEL_ASSERT(options != NULL);
+    MODEL_ASSERT(options->mac_size > 0);
+    MODEL_ASSERT(count == 0 || keys != NULL);
+    MODEL_ASSERT(count == 0 || data != NULL);
+    MODEL_ASSERT(count == 0 || sizes != NULL);
+    MODEL_ASSERT(count == 0 || tags != NULL);
+    MODEL_ASSERT(count == 0 || results != NULL);
+
+    /* sanity check on parameters */
+    if (options == NULL || options->mac_size == 0 || (count > 0 &&
+        (keys == NULL || data == NULL || sizes == NULL || tags == NULL ||
+         results == NULL)))
+    {
+        return VCCRYPT_ERROR_MAC_BATCH_VERIFY_INVALID_ARG;
+    }
+
+    /* check each item before verifying any of them. */
+    for (size_t i = 0; i < count; ++i)
+    {
+        if (keys[i].data == NULL || keys[i].size == 0 ||
+            (data[i] == NULL && sizes[i] > 0) || tags[i] == NULL)
+        {
+            return VCCRYPT_ERROR_MAC_BATCH_VERIFY_INVALID_ARG;
+        }
+    }
+
+    /* every item starts out as invalid. */
+    memset(results, 0, (count + 7) / 8);
+
+    /* use the lockstep implementation if this algorithm has one. */
+    if (options->vccrypt_mac_alg_batch_verify != NULL)
+    {
+        return
+            options->vccrypt_mac_alg_batch_verify(
+                options, keys, data, sizes, tags, count, results);
+    }
+
+    return
+        vccrypt_mac_batch_verify_each(
+            options, keys, data, sizes, tags, count, results);
+}
+
+/**
+ * Verify each MAC of a batch in turn.
+ *
+ * \param options       The options for the MAC algorithm to use.
+ * \param keys          Array of keys.
+ * \param data          Array of pointers to the messages.
+ * \param sizes         Array of message sizes, in bytes.
+ * \param tags          Array of pointers to the expected MACs.
+ * \param count         The number of messages.
+ * \param results       Bitmap receiving a set bit for each valid MAC.
+ *
+ * \returns \ref VCCRYPT_STATUS_SUCCESS on success and non-zero on failure.
+ */
+static int vccrypt_mac_batch_verify_each(
+    vccrypt_mac_options_t* options, const vccrypt_buffer_t* keys,
+    const uint8_t* const* data, const size_t* sizes,
+    const uint8_t* const* tags, size_t count, uint8_t* results)
+{
+    vccrypt_mac_context_t context;
+    vccrypt_buffer_t mac;
+    int retval;
+
+    /* one MAC buffer is shared by the whole batch. */
+    retval = vccrypt_buffer_init(&mac, options->alloc_opts, options->mac_size);
+    if (VCCRYPT_STATUS_SUCCESS != retval)
+    {
+        return retval;
+    }
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        retval =
+            vccrypt_mac_init(
+                options, &context, (vccrypt_buffer_t*)(keys + i));
+        if (VCCRYPT_STATUS_SUCCESS != retval)
+        {
+            goto cleanup_mac;
+        }
+
+        if (sizes[i] > 0)
+        {
+            retval = vccrypt_mac_digest(&context, data[i], sizes[i]);
+            if (VCCRYPT_STATUS_SUCCESS != retval)
+            {
+                goto cleanup_context;
+            }
+        }
+
+        retval = vccrypt_mac_finalize(&context, &mac);
+        if (VCCRYPT_STATUS_SUCCESS != retval)
+        {
+            goto cleanup_context;
+        }
+
+        if (0 == crypto_memcmp(mac.data, tags[i], options->mac_size))
+        {
+            results[i / 8] |= (uint8_t)(1U << (i % 8));
+        }
+
+        dispose((disposable_t*)&context);
+    }
+
+    /* success */
+    retval = VCCRYPT_STATUS_SUCCESS;
+    goto cleanup_mac;
+
+cleanup_context:
+    dispose((disposable_t*)&context);
+
+cleanup_mac:
+    dispose((disposable_t*)&mac);
+
+    return retval;
+}
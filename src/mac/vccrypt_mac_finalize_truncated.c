@@ -0,0 +1,74 @@
+/**
+ * \file vccrypt_mac_finalize_truncated.c
+ *
+ * Finalize the mac and write the first bytes of the authentication code to
+ * caller memory.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <cbmc/model_assert.h>
+#include <string.h>
+#include <vccrypt/mac.h>
+#include <vpr/parameters.h>
+
+/**
+ * \brief Finalize the message authentication code, writing only its first
+ * bytes to caller memory.
+ *
+ * \param context       The MAC instance.
+ * \param mac           Memory to receive the first \p size bytes of the MAC.
+ * \param size          The number of bytes to write, from 1 to mac_size.
+ *
+ * \returns a status indicating success or failure.
+ *      - \ref VCCRYPT_STATUS_SUCCESS on success.
+ *      - \ref VCCRYPT_ERROR_MAC_FINALIZE_INVALID_ARG if an invalid argument is
+ *             provided.
+ *      - a non-zero return code on error.
+ */
+int vccrypt_mac_finalize_truncated(
+    vccrypt_mac_context_t* context, uint8_t* mac, size_t size)
+{
+    uint8_t md[VCCRYPT_MAC_MAX_MAC_SIZE];
+
+    MODEL_ASSERT(context != NULL);
+    MODEL_ASSERT(context->options != NULL);
+    MODEL_ASSERT(context->options->vccrypt_mac_alg_finalize != NULL);
+    MODEL_ASSERT(context->options->mac_size <= sizeof(md));
+    MODEL_ASSERT(mac != NULL);
+    MODEL_ASSERT(size > 0 && size <= context->options->mac_size);
+
+    /* sanity check on parameters */
+    if (context == NULL || context->options == NULL ||
+        context->options->vccrypt_mac_alg_finalize == NULL ||
+        context->options->mac_size > sizeof(md) ||
+        mac == NULL || size == 0 || size > context->options->mac_size)
+    {
+        return VCCRYPT_ERROR_MAC_FINALIZE_INVALID_ARG;
+    }
+
+    /* algorithms that can write the truncated MAC directly do so. */
+    if (NULL != context->options->vccrypt_mac_alg_finalize_truncated)
+    {
+        return
+            context->options->vccrypt_mac_alg_finalize_truncated(
+                context, mac, size);
+    }
+
+    /* the full MAC goes to the stack through a buffer that borrows it.  This
+     * buffer is never initialized, so it must not be disposed. */
+    vccrypt_buffer_t full;
+    memset(&full, 0, sizeof(full));
+    full.data = md;
+    full.size = context->options->mac_size;
+
+    int retval = context->options->vccrypt_mac_alg_finalize(context, &full);
+    if (VCCRYPT_STATUS_SUCCESS == retval)
+    {
+        memcpy(mac, md, size);
+    }
+
+    memset(md, 0, sizeof(md));
+
+    return retval;
+}
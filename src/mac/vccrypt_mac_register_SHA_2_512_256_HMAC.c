@@ -21,6 +21,13 @@ static void hmac512_256_alg_dispose(void* options, void* context);
 static int hmac512_256_alg_digest(
     void* context, const uint8_t* data, size_t size);
 static int hmac512_256_alg_finalize(void* context, vccrypt_buffer_t* mac_buffer);
+static int hmac512_256_alg_reset(void* context);
+static int hmac512_256_alg_finalize_truncated(
+    void* context, uint8_t* mac, size_t size);
+static int hmac512_256_alg_batch_verify(
+    void* options, const vccrypt_buffer_t* keys, const uint8_t* const* data,
+    const size_t* sizes, const uint8_t* const* tags, size_t count,
+    uint8_t* results);
 
 /* static data for this instance */
 static abstract_factory_registration_t hmac512_256_impl;
@@ -59,6 +66,11 @@ void vccrypt_mac_register_SHA_2_512_256_HMAC()
     hmac512_256_options.vccrypt_mac_alg_dispose = &hmac512_256_alg_dispose;
     hmac512_256_options.vccrypt_mac_alg_digest = &hmac512_256_alg_digest;
     hmac512_256_options.vccrypt_mac_alg_finalize = &hmac512_256_alg_finalize;
+    hmac512_256_options.vccrypt_mac_alg_reset = &hmac512_256_alg_reset;
+    hmac512_256_options.vccrypt_mac_alg_batch_verify =
+        &hmac512_256_alg_batch_verify;
+    hmac512_256_options.vccrypt_mac_alg_finalize_truncated =
+        &hmac512_256_alg_finalize_truncated;
 
     /* set up this registration for the abstract factory. */
     hmac512_256_impl.interface = VCCRYPT_INTERFACE_MAC;
@@ -197,3 +209,71 @@ static int hmac512_256_alg_finalize(
 
     return vccrypt_hmac_finalize(&state->hmac_state, mac_buffer);
 }
+
+/**
+ * Reset this HMAC-SHA-512/256 instance to its keyed state.
+ *
+ * \param context       An opaque pointer to the vccrypt_mac_context_t
+ *                      structure.
+ *
+ * \returns 0 on success and non-zero on failure.
+ */
+static int hmac512_256_alg_reset(void* context)
+{
+    vccrypt_mac_context_t* ctx = (vccrypt_mac_context_t*)context;
+    MODEL_ASSERT(ctx != NULL);
+    hmac512_256_state_t* state = (hmac512_256_state_t*)ctx->mac_state;
+    MODEL_ASSERT(state != NULL);
+
+    return vccrypt_hmac_reset(&state->hmac_state);
+}
+
+/**
+ * Finalize the HMAC-SHA-512/256 instance, writing the first bytes of the MAC
+ * directly to caller memory.
+ *
+ * \param context       An opaque pointer to the vccrypt_mac_context_t
+ *                      structure.
+ * \param mac           Memory to receive the first size bytes of the MAC.
+ * \param size          The number of bytes to write.
+ *
+ * \returns 0 on success and non-zero on failure.
+ */
+static int hmac512_256_alg_finalize_truncated(
+    void* context, uint8_t* mac, size_t size)
+{
+    vccrypt_mac_context_t* ctx = (vccrypt_mac_context_t*)context;
+    MODEL_ASSERT(ctx != NULL);
+    hmac512_256_state_t* state = (hmac512_256_state_t*)ctx->mac_state;
+    MODEL_ASSERT(state != NULL);
+
+    return vccrypt_hmac_sha512_finalize_truncated(
+        &state->hmac_state, mac, size);
+}
+
+/**
+ * Verify a batch of HMAC-SHA-512/256 MACs in lockstep.
+ *
+ * \param options       Opaque pointer to this options structure.
+ * \param keys          Array of keys.
+ * \param data          Array of pointers to the messages.
+ * \param sizes         Array of message sizes, in bytes.
+ * \param tags          Array of pointers to the expected MACs.
+ * \param count         The number of messages.
+ * \param results       Bitmap receiving a set bit for each valid MAC.
+ *
+ * \returns 0 on success and non-zero on failure.
+ */
+static int hmac512_256_alg_batch_verify(
+    void* options, const vccrypt_buffer_t* keys, const uint8_t* const* data,
+    const size_t* sizes, const uint8_t* const* tags, size_t count,
+    uint8_t* results)
+{
+    vccrypt_mac_options_t* opts = (vccrypt_mac_options_t*)options;
+    MODEL_ASSERT(opts != NULL);
+
+    return
+        vccrypt_hmac_sha512_batch_verify(
+            &SHA512_256_Init, opts->mac_size, keys, data, sizes, tags, count,
+            results);
+}
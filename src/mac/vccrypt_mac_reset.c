@@ -0,0 +1,40 @@
+/**
+ * \file vccrypt_mac_reset.c
+ *
+ * Reset a mac context structure to its keyed state.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <cbmc/model_assert.h>
+#include <string.h>
+#include <vccrypt/mac.h>
+#include <vpr/parameters.h>
+
+/**
+ * \brief Discard any data digested so far, returning the MAC instance to the
+ * state it had just after vccrypt_mac_init().
+ *
+ * \param context       The MAC instance.
+ *
+ * \returns a status indicating success or failure.
+ *      - \ref VCCRYPT_STATUS_SUCCESS on success.
+ *      - \ref VCCRYPT_ERROR_MAC_RESET_INVALID_ARG if an invalid argument is
+ *             provided.
+ *      - a non-zero return code on error.
+ */
+int vccrypt_mac_reset(vccrypt_mac_context_t* context)
+{
+    MODEL_ASSERT(context != NULL);
+    MODEL_ASSERT(context->options != NULL);
+    MODEL_ASSERT(context->options->vccrypt_mac_alg_reset != NULL);
+
+    /* sanity check of parameters */
+    if (context == NULL || context->options == NULL ||
+        context->options->vccrypt_mac_alg_reset == NULL)
+    {
+        return VCCRYPT_ERROR_MAC_RESET_INVALID_ARG;
+    }
+
+    return context->options->vccrypt_mac_alg_reset(context);
+}
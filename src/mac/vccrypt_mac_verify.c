@@ -0,0 +1,79 @@
+/**
+ * \file vccrypt_mac_verify.c
+ *
+ * Finalize the mac and compare it with an expected authentication code.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <cbmc/model_assert.h>
+#include <string.h>
+#include <vccrypt/compare.h>
+#include <vccrypt/mac.h>
+#include <vpr/parameters.h>
+
+/**
+ * \brief Finalize the message authentication code, and compare its first
+ * bytes with an expected MAC in constant time.
+ *
+ * \param context       The MAC instance.
+ * \param mac           The expected MAC, or its first \p size bytes.
+ * \param size          The number of bytes to compare, from 1 to mac_size.
+ *
+ * \returns a status indicating success or failure.
+ *      - \ref VCCRYPT_STATUS_SUCCESS if the MAC matches.
+ *      - \ref VCCRYPT_ERROR_MAC_VERIFY_MISMATCH if the MAC does not match.
+ *      - \ref VCCRYPT_ERROR_MAC_VERIFY_INVALID_ARG if an invalid argument is
+ *             provided.
+ *      - a non-zero return code on error.
+ */
+int vccrypt_mac_verify(
+    vccrypt_mac_context_t* context, const uint8_t* mac, size_t size)
+{
+    uint8_t md[VCCRYPT_MAC_MAX_MAC_SIZE];
+
+    MODEL_ASSERT(context != NULL);
+    MODEL_ASSERT(context->options != NULL);
+    MODEL_ASSERT(context->options->vccrypt_mac_alg_finalize != NULL);
+    MODEL_ASSERT(context->options->mac_size <= sizeof(md));
+    MODEL_ASSERT(mac != NULL);
+    MODEL_ASSERT(size > 0 && size <= context->options->mac_size);
+
+    /* sanity check on parameters */
+    if (context == NULL || context->options == NULL ||
+        context->options->vccrypt_mac_alg_finalize == NULL ||
+        context->options->mac_size > sizeof(md) ||
+        mac == NULL || size == 0 || size > context->options->mac_size)
+    {
+        return VCCRYPT_ERROR_MAC_VERIFY_INVALID_ARG;
+    }
+
+    int retval;
+    if (NULL != context->options->vccrypt_mac_alg_finalize_truncated)
+    {
+        /* only the bytes being compared are computed. */
+        retval =
+            context->options->vccrypt_mac_alg_finalize_truncated(
+                context, md, size);
+    }
+    else
+    {
+        /* the full MAC goes to the stack through a buffer that borrows it.
+         * This buffer is never initialized, so it must not be disposed. */
+        vccrypt_buffer_t full;
+        memset(&full, 0, sizeof(full));
+        full.data = md;
+        full.size = context->options->mac_size;
+
+        retval = context->options->vccrypt_mac_alg_finalize(context, &full);
+    }
+
+    if (VCCRYPT_STATUS_SUCCESS == retval && 0 != crypto_memcmp(md, mac, size))
+    {
+        retval = VCCRYPT_ERROR_MAC_VERIFY_MISMATCH;
+    }
+
+    memset(md, 0, sizeof(md));
+
+    return retval;
+}
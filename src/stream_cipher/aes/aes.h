@@ -1,6 +1,7 @@
 #ifndef AES_PRIVATE_HEADER_GUARD
 #define AES_PRIVATE_HEADER_GUARD
 
+#include <stddef.h>
 #include <stdint.h>
 
 #define AES_MAXNR 56
@@ -20,10 +21,49 @@
 extern "C" {
 #endif /*__cplusplus*/
 
+/*
+ * The bitsliced core holds its state in eight words, each one bit plane of
+ * several blocks.  With GCC, the words are vectors, so that each pass runs
+ * more blocks: pairs of 64-bit words holding eight blocks on 64-bit targets,
+ * and pairs of 32-bit words holding four blocks on 32-bit targets.  Each
+ * element keeps the plain 64-bit or 32-bit layout, so that the row rotations
+ * stay within one element.  Other compilers use 64-bit words holding four
+ * blocks.
+ */
+#if defined(__GNUC__) && UINTPTR_MAX == 0xffffffff
+typedef uint32_t bsaes_word_t __attribute__((vector_size(8)));
+#define BSAES_VECTOR 1
+#define BSAES_CT32 1
+#define BSAES_LANES 4
+#elif defined(__GNUC__)
+typedef uint64_t bsaes_word_t __attribute__((vector_size(16)));
+#define BSAES_VECTOR 1
+#define BSAES_LANES 8
+#else
+typedef uint64_t bsaes_word_t;
+#define BSAES_LANES 4
+#endif
+
+/*
+ * The AES-NI backend is available on x86-64 builds.  It works from the AES_KEY
+ * schedules built below, including the extended round schedules, and is
+ * selected at runtime by AES_encrypt, AES_encrypt_blocks, AES_decrypt, and
+ * AES_decrypt_blocks when the CPU supports it.
+ */
+#if defined(__GNUC__) && (defined(__x86_64) || defined(__x86_64__))
+#define AES_HAVE_AESNI 1
+#endif
+
 typedef struct aes_key
 {
     uint32_t rd_key[4 * (AES_MAXNR + 1)];
     int rounds;
+    /* the same round keys in the bitsliced layout, eight words per round. */
+    bsaes_word_t bs_key[8 * (AES_MAXNR + 1)];
+#ifdef AES_HAVE_AESNI
+    /* the same round keys in byte order, as AES-NI loads them. */
+    unsigned char ni_key[16 * (AES_MAXNR + 1)];
+#endif
 } AES_KEY;
 
 /**
@@ -46,12 +86,86 @@ int AES_set_decrypt_key(
  */
 void AES_encrypt(const unsigned char* in, unsigned char* out, const AES_KEY* key);
 
+/*
+ * Encrypt a run of consecutive blocks
+ * in and out can overlap, as long as they are identical
+ */
+void AES_encrypt_blocks(
+    const unsigned char* in, unsigned char* out, size_t blocks,
+    const AES_KEY* key);
+
 /*
  * Decrypt a single block
  * in and out can overlap
  */
 void AES_decrypt(const unsigned char* in, unsigned char* out, const AES_KEY* key);
 
+/*
+ * Decrypt a run of consecutive blocks
+ * in and out can overlap, as long as they are identical
+ */
+void AES_decrypt_blocks(
+    const unsigned char* in, unsigned char* out, size_t blocks,
+    const AES_KEY* key);
+
+/*
+ * Convert the round keys of an AES_KEY schedule to the bitsliced layout
+ * AES_set_encrypt_key and AES_set_decrypt_key call this
+ */
+void bsaes_set_key(AES_KEY* key);
+
+/*
+ * Apply the AES S-box to each byte of a word using the bitsliced core
+ * AES_set_encrypt_key and AES_set_decrypt_key use this for SubWord
+ */
+uint32_t bsaes_sub_word(uint32_t x);
+
+/*
+ * Encrypt a run of consecutive blocks using the constant-time bitsliced core
+ * in and out can overlap, as long as they are identical
+ */
+void bsaes_encrypt_blocks(
+    const unsigned char* in, unsigned char* out, size_t blocks,
+    const AES_KEY* key);
+
+/*
+ * Decrypt a run of consecutive blocks using the constant-time bitsliced core
+ * in and out can overlap, as long as they are identical
+ */
+void bsaes_decrypt_blocks(
+    const unsigned char* in, unsigned char* out, size_t blocks,
+    const AES_KEY* key);
+
+#ifdef AES_HAVE_AESNI
+
+/*
+ * Convert the round keys of an AES_KEY schedule to the AES-NI layout
+ * AES_set_encrypt_key and AES_set_decrypt_key call this
+ */
+void aesni_set_key(AES_KEY* key);
+
+/*
+ * Returns non-zero if this CPU supports the AES-NI instructions
+ */
+int aesni_capable(void);
+
+/*
+ * Encrypt a run of consecutive blocks using AES-NI
+ * in and out can overlap, as long as they are identical
+ */
+void aesni_encrypt_blocks(
+    const unsigned char* in, unsigned char* out, size_t blocks,
+    const AES_KEY* key);
+
+/*
+ * Decrypt a run of consecutive blocks using AES-NI
+ * in and out can overlap, as long as they are identical
+ */
+void aesni_decrypt_blocks(
+    const unsigned char* in, unsigned char* out, size_t blocks,
+    const AES_KEY* key);
+#endif
+
 #ifdef __cplusplus
 }
 #endif /*__cplusplus*/
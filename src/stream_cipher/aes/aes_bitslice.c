@@ -0,0 +1,811 @@
+/**
+ * \file aes_bitslice.c
+ *
+ * Constant-time bitsliced AES backend.
+ *
+ * Several blocks are processed in parallel, with the state held as eight bit
+ * planes, so that no table lookup depends on key or data.  Each plane is made
+ * of 64-bit elements holding four blocks, or on 32-bit targets, 32-bit
+ * elements holding two blocks.  This follows the bitsliced designs of Thomas
+ * Pornin's BearSSL (MIT license), ct64 and ct respectively, and uses the
+ * Boyar-Peralta S-box circuit.
+ *
+ * The round keys are taken from the AES_KEY schedules built by
+ * AES_set_encrypt_key and AES_set_decrypt_key, so the extended 2X, 3X, and 4X
+ * round schedules work unchanged.  They are converted to the bitsliced layout
+ * once, by bsaes_set_key, when the schedule is built.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "aes.h"
+
+/* an element of a state word, and the number of bits and blocks in it. */
+#ifdef BSAES_CT32
+typedef uint32_t bsaes_elem_t;
+#else
+typedef uint64_t bsaes_elem_t;
+#endif
+#define BSAES_WORD_BITS (8 * sizeof(bsaes_elem_t))
+#define BSAES_ROW_BITS (BSAES_WORD_BITS / 4)
+#define BSAES_ELEM_LANES (BSAES_WORD_BITS / 16)
+
+/* a constant in every element of a state word, and one element of a word. */
+#ifdef BSAES_VECTOR
+#define BSAES_CONST(c) ((bsaes_word_t){ 0 } + (bsaes_elem_t)(c))
+#define BSAES_ELEM(x, i) ((x)[i])
+#else
+#define BSAES_CONST(c) ((bsaes_word_t)(c))
+#define BSAES_ELEM(x, i) ((&(x))[i])
+#endif
+
+/* forward decls */
+static void bsaes_sbox(bsaes_word_t* q);
+static void bsaes_inv_affine(bsaes_word_t* q);
+static void bsaes_inv_sbox(bsaes_word_t* q);
+static void bsaes_ortho(bsaes_word_t* q);
+static void bsaes_interleave_in(
+    bsaes_word_t* q, size_t lane, const uint32_t* w);
+static void bsaes_interleave_out(
+    uint32_t* w, const bsaes_word_t* q, size_t lane);
+static void bsaes_add_round_key(bsaes_word_t* q, const bsaes_word_t* skey);
+static void bsaes_shift_rows(bsaes_word_t* q);
+static void bsaes_inv_shift_rows(bsaes_word_t* q);
+static void bsaes_mix_columns(bsaes_word_t* q);
+static void bsaes_inv_mix_columns(bsaes_word_t* q);
+static void bsaes_load_blocks(
+    bsaes_word_t* q, const unsigned char* in, size_t blocks);
+static void bsaes_store_blocks(
+    unsigned char* out, const bsaes_word_t* q, size_t blocks);
+
+/*
+ * Convert the round keys of an AES_KEY schedule to the bitsliced layout
+ */
+void bsaes_set_key(AES_KEY* key)
+{
+    bsaes_word_t* skey = key->bs_key;
+    uint32_t w[4];
+    unsigned char b[16];
+
+    for (int r = 0; r <= key->rounds; ++r)
+    {
+        /* the schedule holds big-endian words; the core wants the bytes. */
+        for (int i = 0; i < 4; ++i)
+        {
+            PUTU32(b + 4 * i, key->rd_key[4 * r + i]);
+            w[i] = (uint32_t)b[4 * i] | ((uint32_t)b[4 * i + 1] << 8)
+                | ((uint32_t)b[4 * i + 2] << 16)
+                | ((uint32_t)b[4 * i + 3] << 24);
+        }
+
+        /* the same round key applies to every lane. */
+        for (size_t lane = 0; lane < BSAES_LANES; ++lane)
+        {
+            bsaes_interleave_in(skey, lane, w);
+        }
+        bsaes_ortho(skey);
+
+        skey += 8;
+    }
+
+    memset(b, 0, sizeof(b));
+    memset(w, 0, sizeof(w));
+}
+
+/*
+ * Apply the AES S-box to each byte of a word using the bitsliced core
+ */
+uint32_t bsaes_sub_word(uint32_t x)
+{
+    bsaes_word_t q[8];
+
+    /* the ortho transform spreads each byte of the word across the eight
+     * bit planes, and gathers it back. */
+    memset(q, 0, sizeof(q));
+    q[0] = BSAES_CONST(x);
+    bsaes_ortho(q);
+    bsaes_sbox(q);
+    bsaes_ortho(q);
+    x = (uint32_t)BSAES_ELEM(q[0], 0);
+
+    memset(q, 0, sizeof(q));
+
+    return x;
+}
+
+/*
+ * Encrypt a run of consecutive blocks using the bitsliced core
+ * in and out can overlap, as long as they are identical
+ */
+void bsaes_encrypt_blocks(
+    const unsigned char* in, unsigned char* out, size_t blocks,
+    const AES_KEY* key)
+{
+    const bsaes_word_t* skey = key->bs_key;
+    bsaes_word_t q[8];
+    int nr = key->rounds;
+
+    while (blocks > 0)
+    {
+        size_t n = blocks < BSAES_LANES ? blocks : BSAES_LANES;
+
+        bsaes_load_blocks(q, in, n);
+
+        bsaes_add_round_key(q, skey);
+        for (int r = 1; r < nr; ++r)
+        {
+            bsaes_sbox(q);
+            bsaes_shift_rows(q);
+            bsaes_mix_columns(q);
+            bsaes_add_round_key(q, skey + 8 * r);
+        }
+        bsaes_sbox(q);
+        bsaes_shift_rows(q);
+        bsaes_add_round_key(q, skey + 8 * nr);
+
+        bsaes_store_blocks(out, q, n);
+
+        in += 16 * n;
+        out += 16 * n;
+        blocks -= n;
+    }
+
+    memset(q, 0, sizeof(q));
+}
+
+/*
+ * Decrypt a run of consecutive blocks using the bitsliced core
+ * in and out can overlap, as long as they are identical
+ */
+void bsaes_decrypt_blocks(
+    const unsigned char* in, unsigned char* out, size_t blocks,
+    const AES_KEY* key)
+{
+    const bsaes_word_t* skey = key->bs_key;
+    bsaes_word_t q[8];
+    int nr = key->rounds;
+
+    /* AES_set_decrypt_key builds the equivalent inverse cipher schedule, so
+     * the inverse mix columns step precedes each middle round key. */
+    while (blocks > 0)
+    {
+        size_t n = blocks < BSAES_LANES ? blocks : BSAES_LANES;
+
+        bsaes_load_blocks(q, in, n);
+
+        bsaes_add_round_key(q, skey);
+        for (int r = 1; r < nr; ++r)
+        {
+            bsaes_inv_shift_rows(q);
+            bsaes_inv_sbox(q);
+            bsaes_inv_mix_columns(q);
+            bsaes_add_round_key(q, skey + 8 * r);
+        }
+        bsaes_inv_shift_rows(q);
+        bsaes_inv_sbox(q);
+        bsaes_add_round_key(q, skey + 8 * nr);
+
+        bsaes_store_blocks(out, q, n);
+
+        in += 16 * n;
+        out += 16 * n;
+        blocks -= n;
+    }
+
+    memset(q, 0, sizeof(q));
+}
+
+/**
+ * Apply the AES S-box to each byte of the bitsliced state.
+ *
+ * \param q         The bitsliced state.
+ */
+static void bsaes_sbox(bsaes_word_t* q)
+{
+    bsaes_word_t x0, x1, x2, x3, x4, x5, x6, x7;
+    bsaes_word_t y1, y2, y3, y4, y5, y6, y7, y8, y9;
+    bsaes_word_t y10, y11, y12, y13, y14, y15, y16, y17, y18, y19;
+    bsaes_word_t y20, y21;
+    bsaes_word_t z0, z1, z2, z3, z4, z5, z6, z7, z8, z9;
+    bsaes_word_t z10, z11, z12, z13, z14, z15, z16, z17;
+    bsaes_word_t t0, t1, t2, t3, t4, t5, t6, t7, t8, t9;
+    bsaes_word_t t10, t11, t12, t13, t14, t15, t16, t17, t18, t19;
+    bsaes_word_t t20, t21, t22, t23, t24, t25, t26, t27, t28, t29;
+    bsaes_word_t t30, t31, t32, t33, t34, t35, t36, t37, t38, t39;
+    bsaes_word_t t40, t41, t42, t43, t44, t45, t46, t47, t48, t49;
+    bsaes_word_t t50, t51, t52, t53, t54, t55, t56, t57, t58, t59;
+    bsaes_word_t t60, t61, t62, t63, t64, t65, t66, t67;
+    bsaes_word_t s0, s1, s2, s3, s4, s5, s6, s7;
+
+    x0 = q[7];
+    x1 = q[6];
+    x2 = q[5];
+    x3 = q[4];
+    x4 = q[3];
+    x5 = q[2];
+    x6 = q[1];
+    x7 = q[0];
+
+    /* top linear transformation. */
+    y14 = x3 ^ x5;
+    y13 = x0 ^ x6;
+    y9 = x0 ^ x3;
+    y8 = x0 ^ x5;
+    t0 = x1 ^ x2;
+    y1 = t0 ^ x7;
+    y4 = y1 ^ x3;
+    y12 = y13 ^ y14;
+    y2 = y1 ^ x0;
+    y5 = y1 ^ x6;
+    y3 = y5 ^ y8;
+    t1 = x4 ^ y12;
+    y15 = t1 ^ x5;
+    y20 = t1 ^ x1;
+    y6 = y15 ^ x7;
+    y10 = y15 ^ t0;
+    y11 = y20 ^ y9;
+    y7 = x7 ^ y11;
+    y17 = y10 ^ y11;
+    y19 = y10 ^ y8;
+    y16 = t0 ^ y11;
+    y21 = y13 ^ y16;
+    y18 = x0 ^ y16;
+
+    /* non-linear section. */
+    t2 = y12 & y15;
+    t3 = y3 & y6;
+    t4 = t3 ^ t2;
+    t5 = y4 & x7;
+    t6 = t5 ^ t2;
+    t7 = y13 & y16;
+    t8 = y5 & y1;
+    t9 = t8 ^ t7;
+    t10 = y2 & y7;
+    t11 = t10 ^ t7;
+    t12 = y9 & y11;
+    t13 = y14 & y17;
+    t14 = t13 ^ t12;
+    t15 = y8 & y10;
+    t16 = t15 ^ t12;
+    t17 = t4 ^ t14;
+    t18 = t6 ^ t16;
+    t19 = t9 ^ t14;
+    t20 = t11 ^ t16;
+    t21 = t17 ^ y20;
+    t22 = t18 ^ y19;
+    t23 = t19 ^ y21;
+    t24 = t20 ^ y18;
+
+    t25 = t21 ^ t22;
+    t26 = t21 & t23;
+    t27 = t24 ^ t26;
+    t28 = t25 & t27;
+    t29 = t28 ^ t22;
+    t30 = t23 ^ t24;
+    t31 = t22 ^ t26;
+    t32 = t31 & t30;
+    t33 = t32 ^ t24;
+    t34 = t23 ^ t33;
+    t35 = t27 ^ t33;
+    t36 = t24 & t35;
+    t37 = t36 ^ t34;
+    t38 = t27 ^ t36;
+    t39 = t29 & t38;
+    t40 = t25 ^ t39;
+
+    t41 = t40 ^ t37;
+    t42 = t29 ^ t33;
+    t43 = t29 ^ t40;
+    t44 = t33 ^ t37;
+    t45 = t42 ^ t41;
+    z0 = t44 & y15;
+    z1 = t37 & y6;
+    z2 = t33 & x7;
+    z3 = t43 & y16;
+    z4 = t40 & y1;
+    z5 = t29 & y7;
+    z6 = t42 & y11;
+    z7 = t45 & y17;
+    z8 = t41 & y10;
+    z9 = t44 & y12;
+    z10 = t37 & y3;
+    z11 = t33 & y4;
+    z12 = t43 & y13;
+    z13 = t40 & y5;
+    z14 = t29 & y2;
+    z15 = t42 & y9;
+    z16 = t45 & y14;
+    z17 = t41 & y8;
+
+    /* bottom linear transformation. */
+    t46 = z15 ^ z16;
+    t47 = z10 ^ z11;
+    t48 = z5 ^ z13;
+    t49 = z9 ^ z10;
+    t50 = z2 ^ z12;
+    t51 = z2 ^ z5;
+    t52 = z7 ^ z8;
+    t53 = z0 ^ z3;
+    t54 = z6 ^ z7;
+    t55 = z16 ^ z17;
+    t56 = z12 ^ t48;
+    t57 = t50 ^ t53;
+    t58 = z4 ^ t46;
+    t59 = z3 ^ t54;
+    t60 = t46 ^ t57;
+    t61 = z14 ^ t57;
+    t62 = t52 ^ t58;
+    t63 = t49 ^ t58;
+    t64 = z4 ^ t59;
+    t65 = t61 ^ t62;
+    t66 = z1 ^ t63;
+    s0 = t59 ^ t63;
+    s6 = t56 ^ ~t62;
+    s7 = t48 ^ ~t60;
+    t67 = t64 ^ t65;
+    s3 = t53 ^ t66;
+    s4 = t51 ^ t66;
+    s5 = t47 ^ t65;
+    s1 = t64 ^ ~s3;
+    s2 = t55 ^ ~t67;
+
+    q[7] = s0;
+    q[6] = s1;
+    q[5] = s2;
+    q[4] = s3;
+    q[3] = s4;
+    q[2] = s5;
+    q[1] = s6;
+    q[0] = s7;
+}
+
+/**
+ * Apply the inverse affine transform of the S-box to each byte of the
+ * bitsliced state.
+ *
+ * \param q         The bitsliced state.
+ */
+static void bsaes_inv_affine(bsaes_word_t* q)
+{
+    bsaes_word_t q0, q1, q2, q3, q4, q5, q6, q7;
+
+    q0 = ~q[0];
+    q1 = ~q[1];
+    q2 = q[2];
+    q3 = q[3];
+    q4 = q[4];
+    q5 = ~q[5];
+    q6 = ~q[6];
+    q7 = q[7];
+
+    q[7] = q1 ^ q4 ^ q6;
+    q[6] = q0 ^ q3 ^ q5;
+    q[5] = q7 ^ q2 ^ q4;
+    q[4] = q6 ^ q1 ^ q3;
+    q[3] = q5 ^ q0 ^ q2;
+    q[2] = q4 ^ q7 ^ q1;
+    q[1] = q3 ^ q6 ^ q0;
+    q[0] = q2 ^ q5 ^ q7;
+}
+
+/**
+ * Apply the inverse AES S-box to each byte of the bitsliced state.
+ *
+ * The S-box is the field inversion followed by an affine transform, so the
+ * inverse is the forward S-box wrapped in the inverse affine transform.
+ *
+ * \param q         The bitsliced state.
+ */
+static void bsaes_inv_sbox(bsaes_word_t* q)
+{
+    bsaes_inv_affine(q);
+    bsaes_sbox(q);
+    bsaes_inv_affine(q);
+}
+
+/**
+ * Convert between interleaved blocks and the bitsliced representation.
+ * This transform is its own inverse.
+ *
+ * \param q         The state to transform.
+ */
+static void bsaes_ortho(bsaes_word_t* q)
+{
+#define SWAPN(cl, ch, s, x, y) \
+    do \
+    { \
+        bsaes_word_t a, b; \
+        a = (x); \
+        b = (y); \
+        (x) = (a & BSAES_CONST(cl)) | ((b & BSAES_CONST(cl)) << (s)); \
+        (y) = ((a & BSAES_CONST(ch)) >> (s)) | (b & BSAES_CONST(ch)); \
+    } while (0)
+
+#define SWAP2(x, y) \
+    SWAPN(0x5555555555555555, 0xAAAAAAAAAAAAAAAA, 1, x, y)
+#define SWAP4(x, y) \
+    SWAPN(0x3333333333333333, 0xCCCCCCCCCCCCCCCC, 2, x, y)
+#define SWAP8(x, y) \
+    SWAPN(0x0F0F0F0F0F0F0F0F, 0xF0F0F0F0F0F0F0F0, 4, x, y)
+
+    SWAP2(q[0], q[1]);
+    SWAP2(q[2], q[3]);
+    SWAP2(q[4], q[5]);
+    SWAP2(q[6], q[7]);
+
+    SWAP4(q[0], q[2]);
+    SWAP4(q[1], q[3]);
+    SWAP4(q[4], q[6]);
+    SWAP4(q[5], q[7]);
+
+    SWAP8(q[0], q[4]);
+    SWAP8(q[1], q[5]);
+    SWAP8(q[2], q[6]);
+    SWAP8(q[3], q[7]);
+
+#undef SWAP8
+#undef SWAP4
+#undef SWAP2
+#undef SWAPN
+}
+
+#ifndef BSAES_CT32
+
+/**
+ * Spread one block, as four little-endian words, across the two state words
+ * of its lane.
+ *
+ * \param q         The state, before the ortho transform.
+ * \param lane      The lane of the block.
+ * \param w         The four words of the block.
+ */
+static void bsaes_interleave_in(
+    bsaes_word_t* q, size_t lane, const uint32_t* w)
+{
+    size_t elem = lane / BSAES_ELEM_LANES;
+    uint64_t x0, x1, x2, x3;
+
+    lane %= BSAES_ELEM_LANES;
+    x0 = w[0];
+    x1 = w[1];
+    x2 = w[2];
+    x3 = w[3];
+    x0 |= (x0 << 16);
+    x1 |= (x1 << 16);
+    x2 |= (x2 << 16);
+    x3 |= (x3 << 16);
+    x0 &= 0x0000FFFF0000FFFF;
+    x1 &= 0x0000FFFF0000FFFF;
+    x2 &= 0x0000FFFF0000FFFF;
+    x3 &= 0x0000FFFF0000FFFF;
+    x0 |= (x0 << 8);
+    x1 |= (x1 << 8);
+    x2 |= (x2 << 8);
+    x3 |= (x3 << 8);
+    x0 &= 0x00FF00FF00FF00FF;
+    x1 &= 0x00FF00FF00FF00FF;
+    x2 &= 0x00FF00FF00FF00FF;
+    x3 &= 0x00FF00FF00FF00FF;
+    BSAES_ELEM(q[lane], elem) = x0 | (x2 << 8);
+    BSAES_ELEM(q[lane + 4], elem) = x1 | (x3 << 8);
+}
+
+/**
+ * Gather one block, as four little-endian words, from the two state words of
+ * its lane.
+ *
+ * \param w         The four words of the block.
+ * \param q         The state, after the ortho transform.
+ * \param lane      The lane of the block.
+ */
+static void bsaes_interleave_out(
+    uint32_t* w, const bsaes_word_t* q, size_t lane)
+{
+    size_t elem = lane / BSAES_ELEM_LANES;
+    uint64_t x0, x1, x2, x3;
+
+    lane %= BSAES_ELEM_LANES;
+    x0 = BSAES_ELEM(q[lane], elem) & 0x00FF00FF00FF00FF;
+    x1 = BSAES_ELEM(q[lane + 4], elem) & 0x00FF00FF00FF00FF;
+    x2 = (BSAES_ELEM(q[lane], elem) >> 8) & 0x00FF00FF00FF00FF;
+    x3 = (BSAES_ELEM(q[lane + 4], elem) >> 8) & 0x00FF00FF00FF00FF;
+    x0 |= (x0 >> 8);
+    x1 |= (x1 >> 8);
+    x2 |= (x2 >> 8);
+    x3 |= (x3 >> 8);
+    x0 &= 0x0000FFFF0000FFFF;
+    x1 &= 0x0000FFFF0000FFFF;
+    x2 &= 0x0000FFFF0000FFFF;
+    x3 &= 0x0000FFFF0000FFFF;
+    w[0] = (uint32_t)x0 | (uint32_t)(x0 >> 16);
+    w[1] = (uint32_t)x1 | (uint32_t)(x1 >> 16);
+    w[2] = (uint32_t)x2 | (uint32_t)(x2 >> 16);
+    w[3] = (uint32_t)x3 | (uint32_t)(x3 >> 16);
+}
+
+#else
+
+/**
+ * Place one block, as four little-endian words, in the state words of its
+ * lane.
+ *
+ * \param q         The state, before the ortho transform.
+ * \param lane      The lane of the block.
+ * \param w         The four words of the block.
+ */
+static void bsaes_interleave_in(
+    bsaes_word_t* q, size_t lane, const uint32_t* w)
+{
+    size_t elem = lane / BSAES_ELEM_LANES;
+
+    lane %= BSAES_ELEM_LANES;
+    BSAES_ELEM(q[lane], elem) = w[0];
+    BSAES_ELEM(q[lane + 2], elem) = w[1];
+    BSAES_ELEM(q[lane + 4], elem) = w[2];
+    BSAES_ELEM(q[lane + 6], elem) = w[3];
+}
+
+/**
+ * Gather one block, as four little-endian words, from the state words of its
+ * lane.
+ *
+ * \param w         The four words of the block.
+ * \param q         The state, after the ortho transform.
+ * \param lane      The lane of the block.
+ */
+static void bsaes_interleave_out(
+    uint32_t* w, const bsaes_word_t* q, size_t lane)
+{
+    size_t elem = lane / BSAES_ELEM_LANES;
+
+    lane %= BSAES_ELEM_LANES;
+    w[0] = BSAES_ELEM(q[lane], elem);
+    w[1] = BSAES_ELEM(q[lane + 2], elem);
+    w[2] = BSAES_ELEM(q[lane + 4], elem);
+    w[3] = BSAES_ELEM(q[lane + 6], elem);
+}
+
+#endif
+
+/**
+ * Add a round key to the state.
+ *
+ * \param q         The bitsliced state.
+ * \param skey      The eight bitsliced words of this round key.
+ */
+static void bsaes_add_round_key(bsaes_word_t* q, const bsaes_word_t* skey)
+{
+    for (int i = 0; i < 8; ++i)
+    {
+        q[i] ^= skey[i];
+    }
+}
+
+/**
+ * Apply ShiftRows to the bitsliced state.
+ *
+ * \param q         The bitsliced state.
+ */
+static void bsaes_shift_rows(bsaes_word_t* q)
+{
+    for (int i = 0; i < 8; ++i)
+    {
+        bsaes_word_t x = q[i];
+
+#ifndef BSAES_CT32
+        q[i] = (x & BSAES_CONST(0x000000000000FFFF))
+            | ((x & BSAES_CONST(0x00000000FFF00000)) >> 4)
+            | ((x & BSAES_CONST(0x00000000000F0000)) << 12)
+            | ((x & BSAES_CONST(0x0000FF0000000000)) >> 8)
+            | ((x & BSAES_CONST(0x000000FF00000000)) << 8)
+            | ((x & BSAES_CONST(0xF000000000000000)) >> 12)
+            | ((x & BSAES_CONST(0x0FFF000000000000)) << 4);
+#else
+        q[i] = (x & BSAES_CONST(0x000000FF))
+            | ((x & BSAES_CONST(0x0000FC00)) >> 2)
+            | ((x & BSAES_CONST(0x00000300)) << 6)
+            | ((x & BSAES_CONST(0x00F00000)) >> 4)
+            | ((x & BSAES_CONST(0x000F0000)) << 4)
+            | ((x & BSAES_CONST(0xC0000000)) >> 6)
+            | ((x & BSAES_CONST(0x3F000000)) << 2);
+#endif
+    }
+}
+
+/**
+ * Apply the inverse of ShiftRows to the bitsliced state.
+ *
+ * \param q         The bitsliced state.
+ */
+static void bsaes_inv_shift_rows(bsaes_word_t* q)
+{
+    for (int i = 0; i < 8; ++i)
+    {
+        bsaes_word_t x = q[i];
+
+#ifndef BSAES_CT32
+        q[i] = (x & BSAES_CONST(0x000000000000FFFF))
+            | ((x & BSAES_CONST(0x000000000FFF0000)) << 4)
+            | ((x & BSAES_CONST(0x00000000F0000000)) >> 12)
+            | ((x & BSAES_CONST(0x000000FF00000000)) << 8)
+            | ((x & BSAES_CONST(0x0000FF0000000000)) >> 8)
+            | ((x & BSAES_CONST(0x000F000000000000)) << 12)
+            | ((x & BSAES_CONST(0xFFF0000000000000)) >> 4);
+#else
+        q[i] = (x & BSAES_CONST(0x000000FF))
+            | ((x & BSAES_CONST(0x00003F00)) << 2)
+            | ((x & BSAES_CONST(0x0000C000)) >> 6)
+            | ((x & BSAES_CONST(0x000F0000)) << 4)
+            | ((x & BSAES_CONST(0x00F00000)) >> 4)
+            | ((x & BSAES_CONST(0x03000000)) << 6)
+            | ((x & BSAES_CONST(0xFC000000)) >> 2);
+#endif
+    }
+}
+
+/**
+ * Rotate a state word by one row.
+ */
+static inline bsaes_word_t bsaes_rotr_row(bsaes_word_t x)
+{
+    return (x >> BSAES_ROW_BITS) | (x << (BSAES_WORD_BITS - BSAES_ROW_BITS));
+}
+
+/**
+ * Rotate a state word by two rows.
+ */
+static inline bsaes_word_t bsaes_rotr_half(bsaes_word_t x)
+{
+    return (x << (BSAES_WORD_BITS / 2)) | (x >> (BSAES_WORD_BITS / 2));
+}
+
+/**
+ * Apply MixColumns to the bitsliced state.
+ *
+ * \param q         The bitsliced state.
+ */
+static void bsaes_mix_columns(bsaes_word_t* q)
+{
+    bsaes_word_t q0, q1, q2, q3, q4, q5, q6, q7;
+    bsaes_word_t r0, r1, r2, r3, r4, r5, r6, r7;
+
+    q0 = q[0];
+    q1 = q[1];
+    q2 = q[2];
+    q3 = q[3];
+    q4 = q[4];
+    q5 = q[5];
+    q6 = q[6];
+    q7 = q[7];
+    r0 = bsaes_rotr_row(q0);
+    r1 = bsaes_rotr_row(q1);
+    r2 = bsaes_rotr_row(q2);
+    r3 = bsaes_rotr_row(q3);
+    r4 = bsaes_rotr_row(q4);
+    r5 = bsaes_rotr_row(q5);
+    r6 = bsaes_rotr_row(q6);
+    r7 = bsaes_rotr_row(q7);
+
+    q[0] = q7 ^ r7 ^ r0 ^ bsaes_rotr_half(q0 ^ r0);
+    q[1] = q0 ^ r0 ^ q7 ^ r7 ^ r1 ^ bsaes_rotr_half(q1 ^ r1);
+    q[2] = q1 ^ r1 ^ r2 ^ bsaes_rotr_half(q2 ^ r2);
+    q[3] = q2 ^ r2 ^ q7 ^ r7 ^ r3 ^ bsaes_rotr_half(q3 ^ r3);
+    q[4] = q3 ^ r3 ^ q7 ^ r7 ^ r4 ^ bsaes_rotr_half(q4 ^ r4);
+    q[5] = q4 ^ r4 ^ r5 ^ bsaes_rotr_half(q5 ^ r5);
+    q[6] = q5 ^ r5 ^ r6 ^ bsaes_rotr_half(q6 ^ r6);
+    q[7] = q6 ^ r6 ^ r7 ^ bsaes_rotr_half(q7 ^ r7);
+}
+
+/**
+ * Apply the inverse of MixColumns to the bitsliced state.
+ *
+ * \param q         The bitsliced state.
+ */
+static void bsaes_inv_mix_columns(bsaes_word_t* q)
+{
+    bsaes_word_t q0, q1, q2, q3, q4, q5, q6, q7;
+    bsaes_word_t r0, r1, r2, r3, r4, r5, r6, r7;
+
+    q0 = q[0];
+    q1 = q[1];
+    q2 = q[2];
+    q3 = q[3];
+    q4 = q[4];
+    q5 = q[5];
+    q6 = q[6];
+    q7 = q[7];
+    r0 = bsaes_rotr_row(q0);
+    r1 = bsaes_rotr_row(q1);
+    r2 = bsaes_rotr_row(q2);
+    r3 = bsaes_rotr_row(q3);
+    r4 = bsaes_rotr_row(q4);
+    r5 = bsaes_rotr_row(q5);
+    r6 = bsaes_rotr_row(q6);
+    r7 = bsaes_rotr_row(q7);
+
+    q[0] = q5 ^ q6 ^ q7 ^ r0 ^ r5 ^ r7
+        ^ bsaes_rotr_half(q0 ^ q5 ^ q6 ^ r0 ^ r5);
+    q[1] = q0 ^ q5 ^ r0 ^ r1 ^ r5 ^ r6 ^ r7
+        ^ bsaes_rotr_half(q1 ^ q5 ^ q7 ^ r1 ^ r5 ^ r6);
+    q[2] = q0 ^ q1 ^ q6 ^ r1 ^ r2 ^ r6 ^ r7
+        ^ bsaes_rotr_half(q0 ^ q2 ^ q6 ^ r2 ^ r6 ^ r7);
+    q[3] = q0 ^ q1 ^ q2 ^ q5 ^ q6 ^ r0 ^ r2 ^ r3 ^ r5
+        ^ bsaes_rotr_half(q0 ^ q1 ^ q3 ^ q5 ^ q6 ^ q7 ^ r0 ^ r3 ^ r5 ^ r7);
+    q[4] = q1 ^ q2 ^ q3 ^ q5 ^ r1 ^ r3 ^ r4 ^ r5 ^ r6 ^ r7
+        ^ bsaes_rotr_half(q1 ^ q2 ^ q4 ^ q5 ^ q7 ^ r1 ^ r4 ^ r5 ^ r6);
+    q[5] = q2 ^ q3 ^ q4 ^ q6 ^ r2 ^ r4 ^ r5 ^ r6 ^ r7
+        ^ bsaes_rotr_half(q2 ^ q3 ^ q5 ^ q6 ^ r2 ^ r5 ^ r6 ^ r7);
+    q[6] = q3 ^ q4 ^ q5 ^ q7 ^ r3 ^ r5 ^ r6 ^ r7
+        ^ bsaes_rotr_half(q3 ^ q4 ^ q6 ^ q7 ^ r3 ^ r6 ^ r7);
+    q[7] = q4 ^ q5 ^ q6 ^ r4 ^ r6 ^ r7
+        ^ bsaes_rotr_half(q4 ^ q5 ^ q7 ^ r4 ^ r7);
+}
+
+/**
+ * Load up to BSAES_LANES blocks into the bitsliced state.  Only the lanes
+ * that hold a block are filled; the others are left at zero.
+ *
+ * \param q         The bitsliced state.
+ * \param in        The blocks to load.
+ * \param blocks    The number of blocks to load, at most BSAES_LANES.
+ */
+static void bsaes_load_blocks(
+    bsaes_word_t* q, const unsigned char* in, size_t blocks)
+{
+    uint32_t w[4];
+
+    memset(q, 0, 8 * sizeof(bsaes_word_t));
+
+    for (size_t i = 0; i < blocks; ++i)
+    {
+        for (size_t j = 0; j < 4; ++j)
+        {
+            const unsigned char* p = in + 16 * i + 4 * j;
+            w[j] = (uint32_t)p[0] | ((uint32_t)p[1] << 8)
+                | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+        }
+
+        bsaes_interleave_in(q, i, w);
+    }
+
+    bsaes_ortho(q);
+    memset(w, 0, sizeof(w));
+}
+
+/**
+ * Store up to BSAES_LANES blocks from the bitsliced state.
+ *
+ * \param out       The buffer to receive the blocks.
+ * \param q         The bitsliced state.
+ * \param blocks    The number of blocks to store, at most BSAES_LANES.
+ */
+static void bsaes_store_blocks(
+    unsigned char* out, const bsaes_word_t* q, size_t blocks)
+{
+    bsaes_word_t s[8];
+    uint32_t w[4];
+
+    memcpy(s, q, sizeof(s));
+    bsaes_ortho(s);
+
+    for (size_t i = 0; i < blocks; ++i)
+    {
+        bsaes_interleave_out(w, s, i);
+
+        for (size_t j = 0; j < 4; ++j)
+        {
+            unsigned char* p = out + 16 * i + 4 * j;
+            p[0] = (unsigned char)w[j];
+            p[1] = (unsigned char)(w[j] >> 8);
+            p[2] = (unsigned char)(w[j] >> 16);
+            p[3] = (unsigned char)(w[j] >> 24);
+        }
+    }
+
+    memset(s, 0, sizeof(s));
+    memset(w, 0, sizeof(w));
+}
@@ -0,0 +1,92 @@
+/**
+ * \file aes_dispatch.c
+ *
+ * Select between the AES backends available on this platform.
+ *
+ * AES-NI is used when the CPU supports it.  Otherwise, the constant-time
+ * bitsliced core is used.  There is no table-driven fallback, since its key
+ * and data dependent lookups leak through cache timing.
+ *
+ * The bitsliced core costs the same for a single block as for a full pass of
+ * BSAES_LANES blocks, so callers that can batch blocks should use the
+ * *_blocks functions.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "aes.h"
+
+/*
+ * Encrypt a single block
+ * in and out can overlap
+ */
+void AES_encrypt(const unsigned char* in, unsigned char* out, const AES_KEY* key)
+{
+#ifdef AES_HAVE_AESNI
+    if (aesni_capable())
+    {
+        aesni_encrypt_blocks(in, out, 1, key);
+        return;
+    }
+#endif
+
+    bsaes_encrypt_blocks(in, out, 1, key);
+}
+
+/*
+ * Encrypt a run of consecutive blocks
+ * in and out can overlap, as long as they are identical
+ */
+void AES_encrypt_blocks(
+    const unsigned char* in, unsigned char* out, size_t blocks,
+    const AES_KEY* key)
+{
+#ifdef AES_HAVE_AESNI
+    if (aesni_capable())
+    {
+        aesni_encrypt_blocks(in, out, blocks, key);
+        return;
+    }
+#endif
+
+    bsaes_encrypt_blocks(in, out, blocks, key);
+}
+
+/*
+ * Decrypt a single block
+ * in and out can overlap
+ */
+void AES_decrypt(const unsigned char* in, unsigned char* out, const AES_KEY* key)
+{
+#ifdef AES_HAVE_AESNI
+    if (aesni_capable())
+    {
+        aesni_decrypt_blocks(in, out, 1, key);
+        return;
+    }
+#endif
+
+    bsaes_decrypt_blocks(in, out, 1, key);
+}
+
+/*
+ * Decrypt a run of consecutive blocks
+ * in and out can overlap, as long as they are identical
+ */
+void AES_decrypt_blocks(
+    const unsigned char* in, unsigned char* out, size_t blocks,
+    const AES_KEY* key)
+{
+#ifdef AES_HAVE_AESNI
+    if (aesni_capable())
+    {
+        aesni_decrypt_blocks(in, out, blocks, key);
+        return;
+    }
+#endif
+
+    bsaes_decrypt_blocks(in, out, blocks, key);
+}
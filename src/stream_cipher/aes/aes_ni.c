@@ -0,0 +1,179 @@
+/**
+ * \file aes_ni.c
+ *
+ * AES backend using the x86-64 AES-NI round instructions.
+ *
+ * The round keys are taken from the AES_KEY schedules built by
+ * AES_set_encrypt_key and AES_set_decrypt_key, so the extended 2X, 3X, and 4X
+ * round schedules work unchanged.  The schedule stores each round key as four
+ * host-order words, so aesni_set_key keeps a byte order copy of it when the
+ * schedule is built, and the rounds load their keys straight from that copy.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "aes.h"
+
+#ifdef AES_HAVE_AESNI
+
+#include <immintrin.h>
+
+#include "../../cpu/cpu_features.h"
+
+#define AESNI_TARGET __attribute__((target("aes,ssse3")))
+
+/* the number of blocks run through the round pipeline together. */
+#define AESNI_LANES 8
+
+/*
+ * Convert the round keys of an AES_KEY schedule to the AES-NI layout
+ */
+void aesni_set_key(AES_KEY* key)
+{
+    for (int i = 0; i < 4 * (key->rounds + 1); ++i)
+    {
+        PUTU32(key->ni_key + 4 * i, key->rd_key[i]);
+    }
+}
+
+/*
+ * Returns non-zero if this CPU supports the AES-NI instructions
+ */
+int aesni_capable(void)
+{
+    return vccrypt_cpu_supports(
+        VCCRYPT_CPU_FEATURE_AESNI | VCCRYPT_CPU_FEATURE_SSSE3);
+}
+
+/*
+ * Encrypt a run of consecutive blocks using AES-NI
+ * in and out can overlap, as long as they are identical
+ */
+AESNI_TARGET void aesni_encrypt_blocks(
+    const unsigned char* in, unsigned char* out, size_t blocks,
+    const AES_KEY* key)
+{
+    const __m128i* rk = (const __m128i*)key->ni_key;
+    int nr = key->rounds;
+    __m128i first = _mm_loadu_si128(rk);
+    __m128i last = _mm_loadu_si128(rk + nr);
+    __m128i b[AESNI_LANES];
+    int r, j;
+
+    /* keep several independent blocks in flight to hide round latency. */
+    while (blocks >= AESNI_LANES)
+    {
+        for (j = 0; j < AESNI_LANES; ++j)
+        {
+            b[j] = _mm_xor_si128(
+                _mm_loadu_si128((const __m128i*)in + j), first);
+        }
+
+        for (r = 1; r < nr; ++r)
+        {
+            __m128i k = _mm_loadu_si128(rk + r);
+
+            for (j = 0; j < AESNI_LANES; ++j)
+            {
+                b[j] = _mm_aesenc_si128(b[j], k);
+            }
+        }
+
+        for (j = 0; j < AESNI_LANES; ++j)
+        {
+            _mm_storeu_si128(
+                (__m128i*)out + j, _mm_aesenclast_si128(b[j], last));
+        }
+
+        in += 16 * AESNI_LANES;
+        out += 16 * AESNI_LANES;
+        blocks -= AESNI_LANES;
+    }
+
+    while (blocks--)
+    {
+        b[0] = _mm_xor_si128(_mm_loadu_si128((const __m128i*)in), first);
+
+        for (r = 1; r < nr; ++r)
+        {
+            b[0] = _mm_aesenc_si128(b[0], _mm_loadu_si128(rk + r));
+        }
+
+        _mm_storeu_si128((__m128i*)out, _mm_aesenclast_si128(b[0], last));
+
+        in += 16;
+        out += 16;
+    }
+
+    memset(b, 0, sizeof(b));
+}
+
+/*
+ * Decrypt a run of consecutive blocks using AES-NI
+ * in and out can overlap, as long as they are identical
+ */
+AESNI_TARGET void aesni_decrypt_blocks(
+    const unsigned char* in, unsigned char* out, size_t blocks,
+    const AES_KEY* key)
+{
+    const __m128i* rk = (const __m128i*)key->ni_key;
+    int nr = key->rounds;
+    __m128i first = _mm_loadu_si128(rk);
+    __m128i last = _mm_loadu_si128(rk + nr);
+    __m128i b[AESNI_LANES];
+    int r, j;
+
+    /* AES_set_decrypt_key already builds the equivalent inverse cipher
+     * schedule that aesdec expects. */
+    while (blocks >= AESNI_LANES)
+    {
+        for (j = 0; j < AESNI_LANES; ++j)
+        {
+            b[j] = _mm_xor_si128(
+                _mm_loadu_si128((const __m128i*)in + j), first);
+        }
+
+        for (r = 1; r < nr; ++r)
+        {
+            __m128i k = _mm_loadu_si128(rk + r);
+
+            for (j = 0; j < AESNI_LANES; ++j)
+            {
+                b[j] = _mm_aesdec_si128(b[j], k);
+            }
+        }
+
+        for (j = 0; j < AESNI_LANES; ++j)
+        {
+            _mm_storeu_si128(
+                (__m128i*)out + j, _mm_aesdeclast_si128(b[j], last));
+        }
+
+        in += 16 * AESNI_LANES;
+        out += 16 * AESNI_LANES;
+        blocks -= AESNI_LANES;
+    }
+
+    while (blocks--)
+    {
+        b[0] = _mm_xor_si128(_mm_loadu_si128((const __m128i*)in), first);
+
+        for (r = 1; r < nr; ++r)
+        {
+            b[0] = _mm_aesdec_si128(b[0], _mm_loadu_si128(rk + r));
+        }
+
+        _mm_storeu_si128((__m128i*)out, _mm_aesdeclast_si128(b[0], last));
+
+        in += 16;
+        out += 16;
+    }
+
+    memset(b, 0, sizeof(b));
+}
+
+#endif /*AES_HAVE_AESNI*/
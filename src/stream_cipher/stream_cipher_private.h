@@ -27,6 +27,9 @@ extern "C" {
 
 #define VCCRYPT_AES_CTR_ALG_AES_256_KEY_SIZE 32
 
+/* the number of counter blocks expanded at once by the bulk encrypt path. */
+#define VCCRYPT_AES_CTR_ALG_BULK_BLOCKS 16
+
 /**
  * AES CTR Mode specific options data.
  */
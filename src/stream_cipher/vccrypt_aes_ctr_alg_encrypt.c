@@ -7,10 +7,17 @@
  */
 
 #include <cbmc/model_assert.h>
+#include <string.h>
 #include <vpr/parameters.h>
 
 #include "stream_cipher_private.h"
 
+/* forward decls */
+static void vccrypt_aes_ctr_alg_keystream(
+    aes_ctr_context_data_t* ctx_data, uint8_t* stream, size_t blocks);
+static void vccrypt_aes_ctr_alg_xor_blocks(
+    uint8_t* out, const uint8_t* in, const uint8_t* stream, size_t size);
+
 /**
  * Encrypt data using the stream cipher.
  *
@@ -34,25 +41,104 @@ int vccrypt_aes_ctr_alg_encrypt(
     vccrypt_stream_context_t* ctx = (vccrypt_stream_context_t*)context;
     aes_ctr_context_data_t* ctx_data =
         (aes_ctr_context_data_t*)ctx->stream_state;
+    uint8_t stream[16 * VCCRYPT_AES_CTR_ALG_BULK_BLOCKS];
 
     const uint8_t* in = (const uint8_t*)input;
     uint8_t* out = (uint8_t*)output;
     out += *offset;
+    *offset += size;
+
+    /* use up any stream bytes left over from a previous call. */
+    while (size > 0 && ctx_data->count < 16)
+    {
+        *(out++) = *(in++) ^ ctx_data->stream[ctx_data->count++];
+        --size;
+    }
 
-    while (size--)
+    /* encrypt whole blocks using bulk keystream generation. */
+    while (size >= 16)
     {
-        /* generate more stream bytes if needed */
-        if (ctx_data->count >= 16)
+        size_t blocks = size / 16;
+        if (blocks > VCCRYPT_AES_CTR_ALG_BULK_BLOCKS)
         {
-            ctx_data->count = 0;
-            vccrypt_aes_ctr_incr(ctx_data->ctr);
-            AES_encrypt(ctx_data->ctr, ctx_data->stream, &ctx_data->key);
+            blocks = VCCRYPT_AES_CTR_ALG_BULK_BLOCKS;
         }
 
-        /* encrypt a byte and update the output offset */
-        *(out++) = *(in++) ^ ctx_data->stream[ctx_data->count++];
-        ++(*offset);
+        vccrypt_aes_ctr_alg_keystream(ctx_data, stream, blocks);
+        vccrypt_aes_ctr_alg_xor_blocks(out, in, stream, 16 * blocks);
+
+        in += 16 * blocks;
+        out += 16 * blocks;
+        size -= 16 * blocks;
+    }
+
+    /* encrypt any trailing bytes from a fresh stream block. */
+    if (size > 0)
+    {
+        vccrypt_aes_ctr_alg_keystream(ctx_data, stream, 1);
+        ctx_data->count = 0;
+
+        while (size--)
+        {
+            *(out++) = *(in++) ^ ctx_data->stream[ctx_data->count++];
+        }
     }
 
+    memset(stream, 0, sizeof(stream));
+
     return VCCRYPT_STATUS_SUCCESS;
 }
+
+/**
+ * Generate the keystream for the next run of counter blocks.
+ *
+ * On return, the context counter is set to the last counter block used, and
+ * the context stream holds the keystream for this block, fully consumed.
+ *
+ * \param ctx_data      The AES CTR context data.
+ * \param stream        The buffer to receive the keystream; must be at least
+ *                      16 * blocks bytes in size.
+ * \param blocks        The number of keystream blocks to generate.
+ */
+static void vccrypt_aes_ctr_alg_keystream(
+    aes_ctr_context_data_t* ctx_data, uint8_t* stream, size_t blocks)
+{
+    MODEL_ASSERT(blocks > 0 && blocks <= VCCRYPT_AES_CTR_ALG_BULK_BLOCKS);
+
+    /* lay out the counter blocks. */
+    for (size_t i = 0; i < blocks; ++i)
+    {
+        vccrypt_aes_ctr_incr(ctx_data->ctr);
+        memcpy(stream + 16 * i, ctx_data->ctr, 16);
+    }
+
+    /* encrypt them in place to get the keystream. */
+    AES_encrypt_blocks(stream, stream, blocks, &ctx_data->key);
+
+    /* the last block becomes the current stream block. */
+    memcpy(ctx_data->stream, stream + 16 * (blocks - 1), 16);
+    ctx_data->count = 16;
+}
+
+/**
+ * XOR whole blocks of input against the keystream, a word at a time.
+ *
+ * \param out           The output to write.
+ * \param in            The input to read.
+ * \param stream        The keystream.
+ * \param size          The size of the data, which must be a multiple of 16.
+ */
+static void vccrypt_aes_ctr_alg_xor_blocks(
+    uint8_t* out, const uint8_t* in, const uint8_t* stream, size_t size)
+{
+    uint64_t x, k;
+
+    for (size_t i = 0; i < size; i += sizeof(x))
+    {
+        /* memcpy keeps this safe for unaligned input and output. */
+        memcpy(&x, in + i, sizeof(x));
+        memcpy(&k, stream + i, sizeof(k));
+        x ^= k;
+        memcpy(out + i, &x, sizeof(x));
+    }
+}
@@ -0,0 +1,49 @@
+/**
+ * \file vccrypt_suite_mac_short_compute.c
+ *
+ * Compute the short mac of a message for the given crypto suite.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <cbmc/model_assert.h>
+#include <string.h>
+#include <vccrypt/suite.h>
+#include <vpr/parameters.h>
+
+/**
+ * \brief Compute the short message authentication code of a message.
+ *
+ * \param options       The options structure for this crypto suite.
+ * \param context       The short MAC instance, with no data digested yet.
+ * \param data          The message.
+ * \param size          The size of the message, in bytes.
+ * \param mac           Memory to receive the MAC, which is
+ *                      mac_short_opts.mac_size bytes long.
+ *
+ * \returns a status indicating success or failure.
+ *      - \ref VCCRYPT_STATUS_SUCCESS on success.
+ *      - a non-zero return code on failure.
+ */
+int vccrypt_suite_mac_short_compute(
+    vccrypt_suite_options_t* options, vccrypt_mac_context_t* context,
+    const uint8_t* data, size_t size, uint8_t* mac)
+{
+    MODEL_ASSERT(options != NULL);
+    MODEL_ASSERT(context != NULL);
+    MODEL_ASSERT(data != NULL || size == 0);
+    MODEL_ASSERT(mac != NULL);
+
+    if (size > 0)
+    {
+        int retval = vccrypt_mac_digest(context, data, size);
+        if (VCCRYPT_STATUS_SUCCESS != retval)
+        {
+            return retval;
+        }
+    }
+
+    return
+        vccrypt_mac_finalize_truncated(
+            context, mac, options->mac_short_opts.mac_size);
+}
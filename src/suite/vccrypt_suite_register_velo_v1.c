@@ -67,6 +67,7 @@ void vccrypt_suite_register_velo_v1()
     vccrypt_key_agreement_register_curve25519_sha512();
     vccrypt_key_agreement_register_curve25519_sha512_256();
     vccrypt_key_derivation_register_pbkdf2();
+    vccrypt_key_derivation_register_hkdf();
     vccrypt_block_register_AES_256_2X_CBC();
     vccrypt_stream_register_AES_256_2X_CTR();
 
@@ -95,6 +95,7 @@ TEST_F(aes_cbc_test, register_options)
     EXPECT_NE(nullptr, fips_options.vccrypt_block_alg_init);
     EXPECT_NE(nullptr, fips_options.vccrypt_block_alg_encrypt);
     EXPECT_NE(nullptr, fips_options.vccrypt_block_alg_decrypt);
+    EXPECT_NE(nullptr, fips_options.vccrypt_block_alg_decrypt_blocks);
 
     /* Test AES-256-2X-CBC options init. */
     ASSERT_EQ(0, x2_options_init_result);
@@ -212,3 +213,138 @@ TEST_F(aes_cbc_test, aes_256_cbc_fips_f25)
     dispose((disposable_t*)&ctx);
     dispose((disposable_t*)&key);
 }
+
+/**
+ * Decrypting a run of blocks matches the FIPS-800-38a (F.2.6) vector, both
+ * into a separate buffer and in place.
+ */
+TEST_F(aes_cbc_test, aes_256_cbc_fips_f26_decrypt_blocks)
+{
+    vccrypt_block_context_t ctx;
+    vccrypt_buffer_t key;
+
+    const uint8_t KEY[32] = {
+        0x60, 0x3d, 0xeb, 0x10, 0x15, 0xca, 0x71, 0xbe,
+        0x2b, 0x73, 0xae, 0xf0, 0x85, 0x7d, 0x77, 0x81,
+        0x1f, 0x35, 0x2c, 0x07, 0x3b, 0x61, 0x08, 0xd7,
+        0x2d, 0x98, 0x10, 0xa3, 0x09, 0x14, 0xdf, 0xf4
+    };
+    const uint8_t IV[16] = {
+        0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07,
+        0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f
+    };
+    const uint8_t PLAINTEXT[64] = {
+        0x6b, 0xc1, 0xbe, 0xe2, 0x2e, 0x40, 0x9f, 0x96,
+        0xe9, 0x3d, 0x7e, 0x11, 0x73, 0x93, 0x17, 0x2a,
+        0xae, 0x2d, 0x8a, 0x57, 0x1e, 0x03, 0xac, 0x9c,
+        0x9e, 0xb7, 0x6f, 0xac, 0x45, 0xaf, 0x8e, 0x51,
+        0x30, 0xc8, 0x1c, 0x46, 0xa3, 0x5c, 0xe4, 0x11,
+        0xe5, 0xfb, 0xc1, 0x19, 0x1a, 0x0a, 0x52, 0xef,
+        0xf6, 0x9f, 0x24, 0x45, 0xdf, 0x4f, 0x9b, 0x17,
+        0xad, 0x2b, 0x41, 0x7b, 0xe6, 0x6c, 0x37, 0x10
+    };
+    const uint8_t CIPHERTEXT[64] = {
+        0xf5, 0x8c, 0x4c, 0x04, 0xd6, 0xe5, 0xf1, 0xba,
+        0x77, 0x9e, 0xab, 0xfb, 0x5f, 0x7b, 0xfb, 0xd6,
+        0x9c, 0xfc, 0x4e, 0x96, 0x7e, 0xdb, 0x80, 0x8d,
+        0x67, 0x9f, 0x77, 0x7b, 0xc6, 0x70, 0x2c, 0x7d,
+        0x39, 0xf2, 0x33, 0x69, 0xa9, 0xd9, 0xba, 0xcf,
+        0xa5, 0x30, 0xe2, 0x63, 0x04, 0x23, 0x14, 0x61,
+        0xb2, 0xeb, 0x05, 0xe2, 0xc3, 0x9b, 0xe9, 0xfc,
+        0xda, 0x6c, 0x19, 0x07, 0x8c, 0x6a, 0x9d, 0x1b
+    };
+    uint8_t poutput[64];
+
+    /* write junk to the output buffer */
+    memset(poutput, 0xFC, sizeof(poutput));
+
+    ASSERT_EQ(0, vccrypt_buffer_init(&key, &alloc_opts, sizeof(KEY)));
+    ASSERT_EQ(0, vccrypt_buffer_read_data(&key, KEY, sizeof(KEY)));
+    ASSERT_EQ(0, vccrypt_block_init(&fips_options, &ctx, &key, false));
+
+    /* decrypt all four blocks at once. */
+    ASSERT_EQ(0,
+        vccrypt_block_decrypt_blocks(&ctx, IV, CIPHERTEXT, poutput, 4));
+    EXPECT_EQ(0, memcmp(poutput, PLAINTEXT, sizeof(poutput)));
+
+    /* decrypt them again in place. */
+    memcpy(poutput, CIPHERTEXT, sizeof(poutput));
+    ASSERT_EQ(0,
+        vccrypt_block_decrypt_blocks(&ctx, IV, poutput, poutput, 4));
+    EXPECT_EQ(0, memcmp(poutput, PLAINTEXT, sizeof(poutput)));
+
+    dispose((disposable_t*)&ctx);
+    dispose((disposable_t*)&key);
+}
+
+/**
+ * Decrypting a run of blocks matches decrypting them one at a time, for every
+ * run length up to a few batches, with and without the algorithm's batch
+ * decryption.
+ */
+TEST_F(aes_cbc_test, decrypt_blocks_matches_decrypt)
+{
+    vccrypt_block_context_t ctx;
+    vccrypt_buffer_t key;
+    uint8_t iv[16];
+    uint8_t ciphertext[16 * 11];
+    uint8_t expected[16 * 11];
+    uint8_t output[16 * 11];
+
+    ASSERT_EQ(0, x4_options_init_result);
+    ASSERT_EQ(0, vccrypt_buffer_init(&key, &alloc_opts, x4_options.key_size));
+
+    uint8_t* key_data = (uint8_t*)key.data;
+    for (size_t i = 0; i < key.size; ++i)
+    {
+        key_data[i] = (uint8_t)(i * 19 + 3);
+    }
+
+    for (size_t i = 0; i < sizeof(iv); ++i)
+    {
+        iv[i] = (uint8_t)(i * 7 + 1);
+    }
+
+    for (size_t i = 0; i < sizeof(ciphertext); ++i)
+    {
+        ciphertext[i] = (uint8_t)(i * 31 + 17);
+    }
+
+    ASSERT_EQ(0, vccrypt_block_init(&x4_options, &ctx, &key, false));
+
+    /* decrypt one block at a time to get the expected plaintext. */
+    ASSERT_EQ(0, vccrypt_block_decrypt(&ctx, iv, ciphertext, expected));
+    for (size_t i = 16; i < sizeof(ciphertext); i += 16)
+    {
+        ASSERT_EQ(0,
+            vccrypt_block_decrypt(
+                &ctx, ciphertext + i - 16, ciphertext + i, expected + i));
+    }
+
+    for (int pass = 0; pass < 2; ++pass)
+    {
+        /* the second pass uses the generic one block at a time fallback. */
+        if (1 == pass)
+        {
+            x4_options.vccrypt_block_alg_decrypt_blocks = NULL;
+        }
+
+        for (size_t blocks = 1; blocks <= sizeof(ciphertext) / 16; ++blocks)
+        {
+            memset(output, 0xFC, sizeof(output));
+            ASSERT_EQ(0,
+                vccrypt_block_decrypt_blocks(
+                    &ctx, iv, ciphertext, output, blocks));
+            EXPECT_EQ(0, memcmp(expected, output, 16 * blocks));
+
+            memcpy(output, ciphertext, sizeof(output));
+            ASSERT_EQ(0,
+                vccrypt_block_decrypt_blocks(
+                    &ctx, iv, output, output, blocks));
+            EXPECT_EQ(0, memcmp(expected, output, 16 * blocks));
+        }
+    }
+
+    dispose((disposable_t*)&ctx);
+    dispose((disposable_t*)&key);
+}
@@ -0,0 +1,100 @@
+/**
+ * \file test_crypto_memcmp.cpp
+ *
+ * Unit tests for crypto_memcmp.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <gtest/gtest.h>
+#include <string.h>
+#include <vccrypt/compare.h>
+
+/* lengths around the byte, word, and vector boundaries. */
+static const size_t MAX_LENGTH = 300;
+
+/**
+ * Equal buffers compare equal at every length and alignment.
+ */
+TEST(crypto_memcmp_test, equal)
+{
+    uint8_t lhs[MAX_LENGTH + 8];
+    uint8_t rhs[MAX_LENGTH + 8];
+
+    for (size_t i = 0; i < sizeof(lhs); ++i)
+    {
+        lhs[i] = (uint8_t)(i * 37 + 11);
+    }
+
+    for (size_t offset = 0; offset < 8; ++offset)
+    {
+        memcpy(rhs + (7 - offset), lhs + offset, MAX_LENGTH);
+
+        for (size_t length = 0; length <= MAX_LENGTH; ++length)
+        {
+            EXPECT_EQ(0,
+                crypto_memcmp(lhs + offset, rhs + (7 - offset), length))
+                << "length = " << length << ", offset = " << offset;
+        }
+    }
+}
+
+/**
+ * A single differing bit is found at every position, and only within the
+ * compared length.
+ */
+TEST(crypto_memcmp_test, single_difference)
+{
+    uint8_t lhs[MAX_LENGTH + 1];
+    uint8_t rhs[MAX_LENGTH + 1];
+
+    for (size_t i = 0; i < sizeof(lhs); ++i)
+    {
+        lhs[i] = (uint8_t)(i * 37 + 11);
+    }
+
+    for (size_t length = 1; length <= MAX_LENGTH; ++length)
+    {
+        for (size_t pos = 0; pos <= length; ++pos)
+        {
+            memcpy(rhs, lhs, sizeof(rhs));
+            rhs[pos] ^= (uint8_t)(1U << (pos % 8));
+
+            if (pos < length)
+            {
+                EXPECT_NE(0, crypto_memcmp(lhs, rhs, length))
+                    << "length = " << length << ", pos = " << pos;
+            }
+            else
+            {
+                EXPECT_EQ(0, crypto_memcmp(lhs, rhs, length))
+                    << "length = " << length << ", pos = " << pos;
+            }
+        }
+    }
+}
+
+/**
+ * The first and last bytes of unaligned buffers are compared.
+ */
+TEST(crypto_memcmp_test, unaligned_ends)
+{
+    uint8_t lhs[MAX_LENGTH + 8];
+    uint8_t rhs[MAX_LENGTH + 8];
+
+    for (size_t offset = 1; offset < 8; ++offset)
+    {
+        for (size_t length = 1; length <= MAX_LENGTH; ++length)
+        {
+            memset(lhs, 0xA5, sizeof(lhs));
+            memset(rhs, 0xA5, sizeof(rhs));
+
+            rhs[offset] = 0x5A;
+            EXPECT_NE(0, crypto_memcmp(lhs + offset, rhs + offset, length));
+            rhs[offset] = 0xA5;
+
+            rhs[offset + length - 1] = 0x5A;
+            EXPECT_NE(0, crypto_memcmp(lhs + offset, rhs + offset, length));
+        }
+    }
+}
@@ -0,0 +1,67 @@
+/**
+ * \file test_cpu_features.cpp
+ *
+ * Unit tests for CPU feature detection.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <gtest/gtest.h>
+
+#include "../../src/cpu/cpu_features.h"
+
+/**
+ * No features at all are always supported.
+ */
+TEST(cpu_features_test, no_features)
+{
+    EXPECT_NE(0, vccrypt_cpu_supports(0));
+}
+
+/**
+ * The cached answer matches the first probe, and a set of features is only
+ * supported if each of them is.
+ */
+TEST(cpu_features_test, consistent)
+{
+    const uint32_t all[] = {
+        VCCRYPT_CPU_FEATURE_SSSE3, VCCRYPT_CPU_FEATURE_SSE4_1,
+        VCCRYPT_CPU_FEATURE_AESNI, VCCRYPT_CPU_FEATURE_AVX2,
+        VCCRYPT_CPU_FEATURE_BMI2, VCCRYPT_CPU_FEATURE_SHA
+    };
+
+    for (uint32_t a : all)
+    {
+        EXPECT_EQ(vccrypt_cpu_supports(a), vccrypt_cpu_supports(a));
+
+        for (uint32_t b : all)
+        {
+            EXPECT_EQ(
+                vccrypt_cpu_supports(a) && vccrypt_cpu_supports(b),
+                0 != vccrypt_cpu_supports(a | b));
+        }
+    }
+}
+
+#if defined(__GNUC__) && (defined(__x86_64) || defined(__x86_64__))
+/**
+ * On x86-64, the instruction set features agree with the compiler's view.
+ */
+TEST(cpu_features_test, matches_compiler)
+{
+    __builtin_cpu_init();
+
+    EXPECT_EQ(
+        0 != __builtin_cpu_supports("ssse3"),
+        0 != vccrypt_cpu_supports(VCCRYPT_CPU_FEATURE_SSSE3));
+    EXPECT_EQ(
+        0 != __builtin_cpu_supports("sse4.1"),
+        0 != vccrypt_cpu_supports(VCCRYPT_CPU_FEATURE_SSE4_1));
+    EXPECT_EQ(
+        0 != __builtin_cpu_supports("aes"),
+        0 != vccrypt_cpu_supports(VCCRYPT_CPU_FEATURE_AESNI));
+    EXPECT_EQ(
+        0 != __builtin_cpu_supports("bmi2"),
+        0 != vccrypt_cpu_supports(VCCRYPT_CPU_FEATURE_BMI2));
+}
+#endif
@@ -0,0 +1,33 @@
+/**
+ * \file sign_input_path.h
+ *
+ * Locate the ED25519 sign.input test vectors.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#ifndef TEST_DIGITAL_SIGNATURE_SIGN_INPUT_PATH_HEADER_GUARD
+#define TEST_DIGITAL_SIGNATURE_SIGN_INPUT_PATH_HEADER_GUARD
+
+#include <cstdlib>
+#include <string>
+
+/**
+ * Returns the path to the sign.input test vectors.
+ *
+ * By default the file is relative to the project root.  Set
+ * TEST_SIGNATURE_PATH to an absolute path to the file to test from anywhere.
+ */
+static inline std::string sign_input_path()
+{
+    const char* test_signature_path = std::getenv("TEST_SIGNATURE_PATH");
+
+    if (test_signature_path != nullptr)
+    {
+        return std::string(test_signature_path);
+    }
+
+    return "test/digital_signature/sign.input";
+}
+
+#endif //TEST_DIGITAL_SIGNATURE_SIGN_INPUT_PATH_HEADER_GUARD
@@ -0,0 +1,162 @@
+/**
+ * \file test_curve25519_avx2.cpp
+ *
+ * Unit tests for the curve25519 point arithmetic variants.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <fstream>
+#include <gtest/gtest.h>
+#include <string.h>
+#include <string>
+#include "../../src/digital_signature/ref/curve25519_internal.h"
+#include "sign_input_path.h"
+
+using namespace std;
+
+/**
+ * Decode the hex string in into out.
+ */
+static void from_hex(uint8_t* out, const string& in)
+{
+    for (size_t i = 0; i + 1 < in.size(); i += 2)
+    {
+        out[i / 2] = (uint8_t)stoi(in.substr(i, 2), nullptr, 16);
+    }
+}
+
+/**
+ * Both X25519 paths match the RFC 7748 test vectors.
+ */
+TEST(curve25519_avx2_test, x25519_rfc7748)
+{
+    const uint8_t ALICE_PRIVATE[] = {
+        0x77, 0x07, 0x6d, 0x0a, 0x73, 0x18, 0xa5, 0x7d,
+        0x3c, 0x16, 0xc1, 0x72, 0x51, 0xb2, 0x66, 0x45,
+        0xdf, 0x4c, 0x2f, 0x87, 0xeb, 0xc0, 0x99, 0x2a,
+        0xb1, 0x77, 0xfb, 0xa5, 0x1d, 0xb9, 0x2c, 0x2a
+    };
+    const uint8_t BOB_PUBLIC[] = {
+        0xde, 0x9e, 0xdb, 0x7d, 0x7b, 0x7d, 0xc1, 0xb4,
+        0xd3, 0x5b, 0x61, 0xc2, 0xec, 0xe4, 0x35, 0x37,
+        0x3f, 0x83, 0x43, 0xc8, 0x5b, 0x78, 0x67, 0x4d,
+        0xad, 0xfc, 0x7e, 0x14, 0x6f, 0x88, 0x2b, 0x4f
+    };
+    const uint8_t SHARED_SECRET[] = {
+        0x4a, 0x5d, 0x9d, 0x5b, 0xa4, 0xce, 0x2d, 0xe1,
+        0x72, 0x8e, 0x3b, 0xf4, 0x80, 0x35, 0x0f, 0x25,
+        0xe0, 0x7e, 0x21, 0xc9, 0x47, 0xd1, 0x9e, 0x33,
+        0x76, 0xf0, 0x9b, 0x3c, 0x1e, 0x16, 0x17, 0x42
+    };
+    /* k = u = 9, then k = u = X25519(k, u) 1000 times. */
+    const uint8_t ITERATED[] = {
+        0x68, 0x4c, 0xf5, 0x9b, 0xa8, 0x33, 0x09, 0x55,
+        0x28, 0x00, 0xef, 0x56, 0x6f, 0x2f, 0x4d, 0x3c,
+        0x1c, 0x38, 0x87, 0xc4, 0x93, 0x60, 0xe3, 0x87,
+        0x5f, 0x2e, 0xb9, 0x4d, 0x99, 0x53, 0x2c, 0x51
+    };
+    uint8_t out[32], k[32], u[32], k_generic[32], u_generic[32];
+
+    x25519_scalar_mult(out, ALICE_PRIVATE, BOB_PUBLIC);
+    EXPECT_EQ(0, memcmp(SHARED_SECRET, out, sizeof(out)));
+
+    x25519_scalar_mult_generic(out, ALICE_PRIVATE, BOB_PUBLIC);
+    EXPECT_EQ(0, memcmp(SHARED_SECRET, out, sizeof(out)));
+
+    memset(k, 0, sizeof(k));
+    k[0] = 9;
+    memcpy(u, k, sizeof(u));
+    memcpy(k_generic, k, sizeof(k));
+    memcpy(u_generic, k, sizeof(u));
+
+    for (int i = 0; i < 1000; ++i)
+    {
+        x25519_scalar_mult(out, k, u);
+        memcpy(u, k, sizeof(u));
+        memcpy(k, out, sizeof(k));
+
+        x25519_scalar_mult_generic(out, k_generic, u_generic);
+        memcpy(u_generic, k_generic, sizeof(u));
+        memcpy(k_generic, out, sizeof(k));
+
+        ASSERT_EQ(0, memcmp(k, k_generic, sizeof(k))) << "i = " << i;
+    }
+
+    EXPECT_EQ(0, memcmp(ITERATED, k, sizeof(k)));
+}
+
+/**
+ * The dispatched double scalar multiplications used by verification match the
+ * portable one, for the public keys of the ED25519 test vectors.
+ */
+TEST(curve25519_avx2_test, double_scalarmult_matches_generic)
+{
+    string sign_path = sign_input_path();
+    ifstream in(sign_path);
+    string line;
+    int count = 0;
+
+    ASSERT_TRUE(in.good()) << "Using path: " << sign_path;
+
+    while (count < 128 && getline(in, line))
+    {
+        uint8_t pub[32], wide[64], a[32], b[32], r[32], r_generic[32];
+        ge_p3 A;
+        ge_cached Ai[8];
+        ge_p2 R;
+
+        /* the public key is the second field. */
+        from_hex(pub, line.substr(129, 64));
+        ASSERT_EQ(0, x25519_ge_frombytes_vartime(&A, pub)) << line;
+
+        /* reduced scalars, with the zero scalar and small scalars mixed in. */
+        for (size_t i = 0; i < sizeof(wide); ++i)
+        {
+            wide[i] = (uint8_t)(count * 97 + i * 13 + pub[i % 32]);
+        }
+        x25519_sc_reduce(wide);
+        memcpy(a, wide, 32);
+        for (size_t i = 0; i < sizeof(wide); ++i)
+        {
+            wide[i] = (uint8_t)(count * 59 + i * 7 + pub[31 - i % 32]);
+        }
+        x25519_sc_reduce(wide);
+        memcpy(b, wide, 32);
+
+        switch (count % 8)
+        {
+            case 1:
+                memset(a, 0, 32);
+                break;
+
+            case 2:
+                memset(b, 0, 32);
+                break;
+
+            case 3:
+                memset(a, 0, 32);
+                a[0] = (uint8_t)count;
+                break;
+        }
+
+        x25519_ge_double_scalarmult_vartime(&R, a, &A, b);
+        x25519_ge_tobytes(r, &R);
+        x25519_ge_double_scalarmult_vartime_generic(&R, a, &A, b);
+        x25519_ge_tobytes(r_generic, &R);
+
+        EXPECT_EQ(0, memcmp(r_generic, r, sizeof(r))) << "line " << count;
+
+        /* the same, from a table of odd multiples built by the portable
+         * code, whose limbs aren't fully reduced. */
+        x25519_ge_odd_multiples(Ai, &A);
+        x25519_ge_double_scalarmult_vartime_table(&R, a, Ai, b);
+        x25519_ge_tobytes(r, &R);
+
+        EXPECT_EQ(0, memcmp(r_generic, r, sizeof(r))) << "line " << count;
+
+        ++count;
+    }
+
+    EXPECT_EQ(128, count);
+}
@@ -0,0 +1,425 @@
+/**
+ * \file test_vccrypt_digital_signature_batch_verify.cpp
+ *
+ * Unit tests for batch signature verification.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <gtest/gtest.h>
+#include <string.h>
+#include <vccrypt/digital_signature.h>
+#include <vpr/allocator/malloc_allocator.h>
+#include <vector>
+
+class vccrypt_digital_signature_batch_verify_test : public ::testing::Test {
+protected:
+    void SetUp() override
+    {
+        vccrypt_digital_signature_register_ed25519();
+        vccrypt_prng_register_source_operating_system();
+
+        malloc_allocator_options_init(&alloc_opts);
+
+        ASSERT_EQ(0,
+            vccrypt_prng_options_init(
+                &prng_opts, &alloc_opts, VCCRYPT_PRNG_SOURCE_OPERATING_SYSTEM));
+        ASSERT_EQ(0,
+            vccrypt_digital_signature_options_init(
+                &options, &alloc_opts, &prng_opts,
+                VCCRYPT_DIGITAL_SIGNATURE_ALGORITHM_ED25519));
+        ASSERT_EQ(0, vccrypt_digital_signature_init(&options, &context));
+    }
+
+    void TearDown() override
+    {
+        for (size_t i = 0; i < signatures.size(); ++i)
+        {
+            dispose((disposable_t*)&signatures[i]);
+            dispose((disposable_t*)&pubs[i]);
+            delete[] messages[i];
+        }
+
+        dispose((disposable_t*)&context);
+        dispose((disposable_t*)&options);
+        dispose((disposable_t*)&prng_opts);
+        dispose((disposable_t*)&alloc_opts);
+    }
+
+    /**
+     * Sign count messages of varying sizes, each with a new key.
+     */
+    void make_batch(size_t count)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            vccrypt_buffer_t priv, pub, signature;
+            size_t size = (i * 37) % 300;
+            uint8_t* message = new uint8_t[size + 1];
+
+            for (size_t j = 0; j < size; ++j)
+            {
+                message[j] = (uint8_t)(i * 31 + j * 17);
+            }
+
+            ASSERT_EQ(0,
+                vccrypt_buffer_init(
+                    &priv, &alloc_opts, options.private_key_size));
+            ASSERT_EQ(0,
+                vccrypt_buffer_init(
+                    &pub, &alloc_opts, options.public_key_size));
+            ASSERT_EQ(0,
+                vccrypt_buffer_init(
+                    &signature, &alloc_opts, options.signature_size));
+            ASSERT_EQ(0,
+                vccrypt_digital_signature_keypair_create(
+                    &context, &priv, &pub));
+            ASSERT_EQ(0,
+                vccrypt_digital_signature_sign(
+                    &context, &signature, &priv, message, size));
+
+            dispose((disposable_t*)&priv);
+
+            signatures.push_back(signature);
+            pubs.push_back(pub);
+            messages.push_back(message);
+            sizes.push_back(size);
+        }
+    }
+
+    /**
+     * Add a signature made outside of the library.
+     */
+    void add_signature(
+        const uint8_t* pub_data, const uint8_t* sig_data, const char* text)
+    {
+        vccrypt_buffer_t pub, signature;
+        size_t size = strlen(text);
+        uint8_t* message = new uint8_t[size + 1];
+
+        memcpy(message, text, size);
+
+        ASSERT_EQ(0,
+            vccrypt_buffer_init(&pub, &alloc_opts, options.public_key_size));
+        ASSERT_EQ(0,
+            vccrypt_buffer_init(
+                &signature, &alloc_opts, options.signature_size));
+        memcpy(pub.data, pub_data, pub.size);
+        memcpy(signature.data, sig_data, signature.size);
+
+        signatures.push_back(signature);
+        pubs.push_back(pub);
+        messages.push_back(message);
+        sizes.push_back(size);
+    }
+
+    /**
+     * Break some of the signatures in different ways.
+     */
+    void corrupt(size_t stride)
+    {
+        for (size_t i = 1; i < signatures.size(); i += stride)
+        {
+            uint8_t* sig = (uint8_t*)signatures[i].data;
+
+            switch ((i / stride) % 6)
+            {
+                /* a different R. */
+                case 0:
+                    sig[i % 32] ^= 0x04;
+                    break;
+
+                /* a different S. */
+                case 1:
+                    sig[32 + i % 31] ^= 0x01;
+                    break;
+
+                /* S with its top bits set. */
+                case 2:
+                    sig[63] |= 0xe0;
+                    break;
+
+                /* a different message. */
+                case 3:
+                    if (sizes[i] > 0)
+                    {
+                        messages[i][sizes[i] / 2] ^= 0x80;
+                    }
+                    else
+                    {
+                        sig[0] ^= 0x01;
+                    }
+                    break;
+
+                /* another signer's key. */
+                case 4:
+                    memcpy(
+                        pubs[i].data, pubs[i - 1].data,
+                        options.public_key_size);
+                    break;
+
+                /* R = y of 1 with the sign bit, a non-canonical identity. */
+                case 5:
+                    memset(sig, 0, 32);
+                    sig[0] = 1;
+                    sig[31] = 0x80;
+                    break;
+            }
+        }
+    }
+
+    /**
+     * Check that the batch bitmap matches verifying each signature alone.
+     */
+    void check_batch()
+    {
+        size_t count = signatures.size();
+
+        /* start from garbage to check that every bit is written. */
+        std::vector<uint8_t> results((count + 7) / 8, 0xA5);
+
+        ASSERT_EQ(0,
+            vccrypt_digital_signature_batch_verify(
+                &context, signatures.data(), pubs.data(), messages.data(),
+                sizes.data(), count, results.data()));
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            bool valid = (results[i / 8] >> (i % 8)) & 1;
+            bool expected =
+                0 == vccrypt_digital_signature_verify(
+                        &context, &signatures[i], &pubs[i], messages[i],
+                        sizes[i]);
+
+            EXPECT_EQ(expected, valid) << "i = " << i;
+        }
+
+        /* bits past the end of the batch are cleared. */
+        for (size_t i = count; i < results.size() * 8; ++i)
+        {
+            EXPECT_EQ(0, (results[i / 8] >> (i % 8)) & 1);
+        }
+    }
+
+    /**
+     * Count the valid signatures in a batch.
+     */
+    size_t count_valid()
+    {
+        size_t count = signatures.size();
+        std::vector<uint8_t> results((count + 7) / 8);
+        size_t valid = 0;
+
+        EXPECT_EQ(0,
+            vccrypt_digital_signature_batch_verify(
+                &context, signatures.data(), pubs.data(), messages.data(),
+                sizes.data(), count, results.data()));
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            valid += (results[i / 8] >> (i % 8)) & 1;
+        }
+
+        return valid;
+    }
+
+    allocator_options_t alloc_opts;
+    vccrypt_prng_options_t prng_opts;
+    vccrypt_digital_signature_options_t options;
+    vccrypt_digital_signature_context_t context;
+    std::vector<vccrypt_buffer_t> signatures;
+    std::vector<vccrypt_buffer_t> pubs;
+    std::vector<uint8_t*> messages;
+    std::vector<size_t> sizes;
+};
+
+/**
+ * Batches of valid signatures pass, from a single signature up to batches
+ * large enough for the bucket method.
+ */
+TEST_F(vccrypt_digital_signature_batch_verify_test, valid)
+{
+    const size_t counts[] = { 1, 2, 3, 17, 64, 100, 200 };
+
+    for (size_t count : counts)
+    {
+        make_batch(count - signatures.size());
+        EXPECT_EQ(count, count_valid());
+    }
+}
+
+/**
+ * Every bad signature is found in a batch with a few bad signatures.
+ */
+TEST_F(vccrypt_digital_signature_batch_verify_test, few_invalid)
+{
+    make_batch(64);
+    corrupt(11);
+
+    check_batch();
+}
+
+/**
+ * Every bad signature is found in a batch with many bad signatures.
+ */
+TEST_F(vccrypt_digital_signature_batch_verify_test, many_invalid)
+{
+    make_batch(150);
+    corrupt(2);
+
+    check_batch();
+}
+
+/**
+ * A batch of one bad signature fails.
+ */
+TEST_F(vccrypt_digital_signature_batch_verify_test, single_invalid)
+{
+    make_batch(2);
+    corrupt(1);
+
+    /* keep only the corrupted second signature. */
+    dispose((disposable_t*)&signatures.front());
+    signatures.erase(signatures.begin());
+    dispose((disposable_t*)&pubs.front());
+    pubs.erase(pubs.begin());
+    delete[] messages.front();
+    messages.erase(messages.begin());
+    sizes.erase(sizes.begin());
+
+    EXPECT_EQ(0U, count_valid());
+
+    check_batch();
+}
+
+/**
+ * Signatures whose R or A has a small-order component get the same result
+ * from single and batch verification.
+ */
+TEST_F(vccrypt_digital_signature_batch_verify_test, small_order_components)
+{
+    /* R = rB + T, where T has order 8, and S = r + ha. */
+    const uint8_t small_r_pub[32] = {
+        0x03, 0xa1, 0x07, 0xbf, 0xf3, 0xce, 0x10, 0xbe, 0x1d, 0x70, 0xdd,
+        0x18, 0xe7, 0x4b, 0xc0, 0x99, 0x67, 0xe4, 0xd6, 0x30, 0x9b, 0xa5,
+        0x0d, 0x5f, 0x1d, 0xdc, 0x86, 0x64, 0x12, 0x55, 0x31, 0xb8 };
+    const uint8_t small_r_sig[64] = {
+        0x75, 0x5a, 0x5c, 0x3c, 0x1a, 0xfb, 0xdb, 0x94, 0xde, 0xa6, 0xe1,
+        0xd3, 0x11, 0xdf, 0x75, 0x61, 0x98, 0xdd, 0x8d, 0x41, 0x65, 0x95,
+        0xf4, 0x13, 0x47, 0x3a, 0xfc, 0x0f, 0x5f, 0x3f, 0x02, 0xf2, 0x5c,
+        0x29, 0xc7, 0x7e, 0x91, 0xcc, 0x9b, 0xb1, 0x85, 0x80, 0x3b, 0xab,
+        0xa2, 0x05, 0x00, 0x60, 0x20, 0xa6, 0xac, 0x90, 0xa9, 0xc5, 0x66,
+        0x0e, 0x5a, 0x67, 0x4f, 0x61, 0x9d, 0x66, 0xf5, 0x08 };
+
+    /* A = aB + T, where T has order 8, S = r + ha, and h is not a multiple
+     * of 8. */
+    const uint8_t small_a_pub[32] = {
+        0xb1, 0x54, 0xbd, 0x62, 0x18, 0x8a, 0xe2, 0x83, 0xdd, 0x18, 0x7f,
+        0xef, 0xe8, 0xc3, 0x1f, 0x5e, 0x27, 0x6e, 0xdf, 0x08, 0x3b, 0x4c,
+        0xff, 0x11, 0xc9, 0xd5, 0xcf, 0xf8, 0x56, 0xc7, 0x44, 0x40 };
+    const uint8_t small_a_sig[64] = {
+        0x19, 0x5c, 0x1f, 0x28, 0xad, 0xdb, 0x32, 0x7d, 0x04, 0x35, 0x60,
+        0x47, 0x89, 0x94, 0x80, 0xbf, 0x73, 0x47, 0xb3, 0x4b, 0x57, 0x67,
+        0x3d, 0xac, 0x22, 0x02, 0xd3, 0x42, 0x11, 0xc9, 0xe5, 0x15, 0x25,
+        0xc9, 0xb9, 0x82, 0xeb, 0xae, 0xc2, 0x3e, 0xd1, 0xb3, 0x4a, 0x99,
+        0xb6, 0x11, 0x87, 0x16, 0xcd, 0x97, 0xbb, 0x7a, 0x9b, 0x5c, 0x77,
+        0xde, 0x59, 0x54, 0x26, 0xec, 0xc0, 0x80, 0x52, 0x0e };
+
+    /* the cofactored equation accepts both, alone and in a batch. */
+    add_signature(small_r_pub, small_r_sig, "small-order R");
+    EXPECT_EQ(1U, count_valid());
+    add_signature(small_a_pub, small_a_sig, "small-order A");
+    make_batch(3);
+    EXPECT_EQ(5U, count_valid());
+
+    for (size_t i = 0; i < 2; ++i)
+    {
+        vccrypt_buffer_t prepared;
+
+        EXPECT_EQ(0,
+            vccrypt_digital_signature_verify(
+                &context, &signatures[i], &pubs[i], messages[i], sizes[i]));
+
+        ASSERT_EQ(0,
+            vccrypt_buffer_init(
+                &prepared, &alloc_opts, options.prepared_public_key_size));
+        ASSERT_EQ(0,
+            vccrypt_digital_signature_prepare_public_key(
+                &context, &prepared, &pubs[i]));
+        EXPECT_EQ(0,
+            vccrypt_digital_signature_verify_prepared(
+                &context, &signatures[i], &prepared, messages[i], sizes[i]));
+        dispose((disposable_t*)&prepared);
+    }
+
+    /* a changed S fails both ways. */
+    ((uint8_t*)signatures[0].data)[32] ^= 0x01;
+    ((uint8_t*)signatures[1].data)[32] ^= 0x01;
+    EXPECT_EQ(3U, count_valid());
+    check_batch();
+
+    options.vccrypt_digital_signature_alg_batch_verify = NULL;
+    check_batch();
+}
+
+/**
+ * Algorithms without a batch implementation verify each signature in turn.
+ */
+TEST_F(vccrypt_digital_signature_batch_verify_test, generic_fallback)
+{
+    options.vccrypt_digital_signature_alg_batch_verify = NULL;
+
+    make_batch(20);
+    corrupt(3);
+
+    check_batch();
+}
+
+/**
+ * An empty batch succeeds, and bad arguments are rejected.
+ */
+TEST_F(vccrypt_digital_signature_batch_verify_test, invalid_args)
+{
+    uint8_t results[1];
+
+    make_batch(2);
+
+    EXPECT_EQ(0,
+        vccrypt_digital_signature_batch_verify(
+            &context, NULL, NULL, NULL, NULL, 0, NULL));
+    EXPECT_EQ(VCCRYPT_ERROR_DIGITAL_SIGNATURE_BATCH_VERIFY_INVALID_ARG,
+        vccrypt_digital_signature_batch_verify(
+            NULL, signatures.data(), pubs.data(), messages.data(),
+            sizes.data(), 2, results));
+    EXPECT_EQ(VCCRYPT_ERROR_DIGITAL_SIGNATURE_BATCH_VERIFY_INVALID_ARG,
+        vccrypt_digital_signature_batch_verify(
+            &context, signatures.data(), pubs.data(), messages.data(),
+            sizes.data(), 2, NULL));
+    EXPECT_EQ(VCCRYPT_ERROR_DIGITAL_SIGNATURE_BATCH_VERIFY_INVALID_ARG,
+        vccrypt_digital_signature_batch_verify(
+            &context, NULL, pubs.data(), messages.data(), sizes.data(), 2,
+            results));
+
+    /* a short signature is rejected. */
+    signatures[1].size -= 1;
+    EXPECT_EQ(VCCRYPT_ERROR_DIGITAL_SIGNATURE_BATCH_VERIFY_INVALID_ARG,
+        vccrypt_digital_signature_batch_verify(
+            &context, signatures.data(), pubs.data(), messages.data(),
+            sizes.data(), 2, results));
+    signatures[1].size += 1;
+
+    /* a short public key is rejected. */
+    pubs[0].size -= 1;
+    EXPECT_EQ(VCCRYPT_ERROR_DIGITAL_SIGNATURE_BATCH_VERIFY_INVALID_ARG,
+        vccrypt_digital_signature_batch_verify(
+            &context, signatures.data(), pubs.data(), messages.data(),
+            sizes.data(), 2, results));
+    pubs[0].size += 1;
+
+    /* a NULL message is only allowed when its size is 0. */
+    const uint8_t* msgs[2] = { messages[0], NULL };
+    EXPECT_EQ(VCCRYPT_ERROR_DIGITAL_SIGNATURE_BATCH_VERIFY_INVALID_ARG,
+        vccrypt_digital_signature_batch_verify(
+            &context, signatures.data(), pubs.data(), msgs, sizes.data(), 2,
+            results));
+}
@@ -0,0 +1,263 @@
+/**
+ * \file test_vccrypt_digital_signature_sign_expanded.cpp
+ *
+ * Unit tests for signing with an expanded private key.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <fstream>
+#include <gtest/gtest.h>
+#include <string.h>
+#include <string>
+#include <vccrypt/digital_signature.h>
+#include <vpr/allocator/malloc_allocator.h>
+#include <vector>
+
+#include "sign_input_path.h"
+
+using namespace std;
+
+class vccrypt_digital_signature_sign_expanded_test : public ::testing::Test {
+protected:
+    void SetUp() override
+    {
+        vccrypt_digital_signature_register_ed25519();
+        vccrypt_prng_register_source_operating_system();
+
+        malloc_allocator_options_init(&alloc_opts);
+
+        ASSERT_EQ(0,
+            vccrypt_prng_options_init(
+                &prng_opts, &alloc_opts, VCCRYPT_PRNG_SOURCE_OPERATING_SYSTEM));
+        ASSERT_EQ(0,
+            vccrypt_digital_signature_options_init(
+                &options, &alloc_opts, &prng_opts,
+                VCCRYPT_DIGITAL_SIGNATURE_ALGORITHM_ED25519));
+        ASSERT_EQ(0, vccrypt_digital_signature_init(&options, &context));
+
+        ASSERT_EQ(0,
+            vccrypt_buffer_init(&priv, &alloc_opts, options.private_key_size));
+        ASSERT_EQ(0,
+            vccrypt_buffer_init(&pub, &alloc_opts, options.public_key_size));
+        ASSERT_EQ(0,
+            vccrypt_buffer_init(
+                &expanded, &alloc_opts, options.expanded_private_key_size));
+        ASSERT_EQ(0,
+            vccrypt_buffer_init(
+                &signature, &alloc_opts, options.signature_size));
+        ASSERT_EQ(0,
+            vccrypt_buffer_init(
+                &expected, &alloc_opts, options.signature_size));
+    }
+
+    void TearDown() override
+    {
+        dispose((disposable_t*)&expected);
+        dispose((disposable_t*)&signature);
+        dispose((disposable_t*)&expanded);
+        dispose((disposable_t*)&pub);
+        dispose((disposable_t*)&priv);
+        dispose((disposable_t*)&context);
+        dispose((disposable_t*)&options);
+        dispose((disposable_t*)&prng_opts);
+        dispose((disposable_t*)&alloc_opts);
+    }
+
+    /**
+     * Decode the hex string in into out.
+     */
+    static void from_hex(uint8_t* out, const string& in)
+    {
+        for (size_t i = 0; i + 1 < in.size(); i += 2)
+        {
+            out[i / 2] = (uint8_t)stoi(in.substr(i, 2), nullptr, 16);
+        }
+    }
+
+    /**
+     * Sign a few messages with both the private key and the expanded private
+     * key, and check that the signatures match and verify.
+     */
+    void check_matches_sign()
+    {
+        ASSERT_EQ(0,
+            vccrypt_digital_signature_keypair_create(&context, &priv, &pub));
+        ASSERT_EQ(0,
+            vccrypt_digital_signature_expand_private_key(
+                &context, &expanded, &priv));
+
+        for (size_t size = 0; size < 300; size += 37)
+        {
+            vector<uint8_t> message(size + 1);
+
+            for (size_t j = 0; j < size; ++j)
+            {
+                message[j] = (uint8_t)(size * 31 + j * 17);
+            }
+
+            ASSERT_EQ(0,
+                vccrypt_digital_signature_sign(
+                    &context, &expected, &priv, message.data(), size));
+            ASSERT_EQ(0,
+                vccrypt_digital_signature_sign_expanded(
+                    &context, &signature, &expanded, message.data(), size));
+
+            EXPECT_EQ(0,
+                memcmp(expected.data, signature.data, signature.size));
+            EXPECT_EQ(0,
+                vccrypt_digital_signature_verify(
+                    &context, &signature, &pub, message.data(), size));
+        }
+    }
+
+    allocator_options_t alloc_opts;
+    vccrypt_prng_options_t prng_opts;
+    vccrypt_digital_signature_options_t options;
+    vccrypt_digital_signature_context_t context;
+    vccrypt_buffer_t priv, pub, expanded, signature, expected;
+};
+
+/**
+ * The ED25519 expanded key carries the public key after the clamped scalar
+ * and nonce prefix.
+ */
+TEST_F(vccrypt_digital_signature_sign_expanded_test, expanded_key_layout)
+{
+    const uint8_t* exp = (const uint8_t*)expanded.data;
+
+    ASSERT_EQ(
+        (size_t)VCCRYPT_DIGITAL_SIGNATURE_ED25519_EXPANDED_PRIVATE_KEY_SIZE,
+        expanded.size);
+    ASSERT_EQ(0,
+        vccrypt_digital_signature_keypair_create(&context, &priv, &pub));
+    ASSERT_EQ(0,
+        vccrypt_digital_signature_expand_private_key(
+            &context, &expanded, &priv));
+
+    /* the scalar is clamped. */
+    EXPECT_EQ(0, exp[0] & 7);
+    EXPECT_EQ(0x40, exp[31] & 0xc0);
+
+    EXPECT_EQ(0, memcmp(exp + 64, pub.data, pub.size));
+}
+
+/**
+ * Signing with the expanded key produces the reference signatures.
+ */
+TEST_F(vccrypt_digital_signature_sign_expanded_test, sign_input_vectors)
+{
+    string sign_path = sign_input_path();
+    ifstream in(sign_path);
+    string line;
+    int count = 0;
+
+    ASSERT_TRUE(in.good()) << "Using path: " << sign_path;
+
+    while (getline(in, line))
+    {
+        /* sk:pk:msg:sig||msg, with sk being the seed and public key. */
+        size_t msg_start = 128 + 1 + 64 + 1;
+        size_t msg_end = line.find(':', msg_start);
+        ASSERT_NE(string::npos, msg_end);
+
+        size_t size = (msg_end - msg_start) / 2;
+        vector<uint8_t> message(size + 1);
+
+        from_hex((uint8_t*)priv.data, line.substr(0, 128));
+        from_hex(message.data(), line.substr(msg_start, 2 * size));
+        from_hex((uint8_t*)expected.data, line.substr(msg_end + 1, 128));
+
+        ASSERT_EQ(0,
+            vccrypt_digital_signature_expand_private_key(
+                &context, &expanded, &priv));
+        ASSERT_EQ(0,
+            vccrypt_digital_signature_sign_expanded(
+                &context, &signature, &expanded, message.data(), size));
+
+        EXPECT_EQ(0, memcmp(expected.data, signature.data, signature.size))
+            << "line " << count;
+
+        ++count;
+    }
+
+    EXPECT_EQ(1024, count);
+}
+
+/**
+ * Signing with the expanded key matches signing with the private key.
+ */
+TEST_F(vccrypt_digital_signature_sign_expanded_test, matches_sign)
+{
+    check_matches_sign();
+}
+
+/**
+ * Algorithms without expansion hooks fall back to copying the private key and
+ * signing with it.
+ */
+TEST_F(vccrypt_digital_signature_sign_expanded_test, generic_fallback)
+{
+    options.vccrypt_digital_signature_alg_expand_private_key = NULL;
+    options.vccrypt_digital_signature_alg_sign_expanded = NULL;
+    options.expanded_private_key_size = options.private_key_size;
+
+    dispose((disposable_t*)&expanded);
+    ASSERT_EQ(0,
+        vccrypt_buffer_init(
+            &expanded, &alloc_opts, options.expanded_private_key_size));
+
+    check_matches_sign();
+
+    EXPECT_EQ(0, memcmp(expanded.data, priv.data, priv.size));
+}
+
+/**
+ * Bad arguments are rejected.
+ */
+TEST_F(vccrypt_digital_signature_sign_expanded_test, invalid_args)
+{
+    const uint8_t message[] = { 0x01, 0x02, 0x03 };
+    vccrypt_buffer_t short_buffer;
+
+    ASSERT_EQ(0,
+        vccrypt_buffer_init(
+            &short_buffer, &alloc_opts, options.private_key_size - 1));
+
+    EXPECT_EQ(VCCRYPT_ERROR_DIGITAL_SIGNATURE_EXPAND_PRIVATE_KEY_INVALID_ARG,
+        vccrypt_digital_signature_expand_private_key(
+            nullptr, &expanded, &priv));
+    EXPECT_EQ(VCCRYPT_ERROR_DIGITAL_SIGNATURE_EXPAND_PRIVATE_KEY_INVALID_ARG,
+        vccrypt_digital_signature_expand_private_key(
+            &context, nullptr, &priv));
+    EXPECT_EQ(VCCRYPT_ERROR_DIGITAL_SIGNATURE_EXPAND_PRIVATE_KEY_INVALID_ARG,
+        vccrypt_digital_signature_expand_private_key(
+            &context, &expanded, nullptr));
+    EXPECT_EQ(VCCRYPT_ERROR_DIGITAL_SIGNATURE_EXPAND_PRIVATE_KEY_INVALID_ARG,
+        vccrypt_digital_signature_expand_private_key(
+            &context, &short_buffer, &priv));
+    EXPECT_EQ(VCCRYPT_ERROR_DIGITAL_SIGNATURE_EXPAND_PRIVATE_KEY_INVALID_ARG,
+        vccrypt_digital_signature_expand_private_key(
+            &context, &expanded, &short_buffer));
+
+    EXPECT_EQ(VCCRYPT_ERROR_DIGITAL_SIGNATURE_SIGN_EXPANDED_INVALID_ARG,
+        vccrypt_digital_signature_sign_expanded(
+            nullptr, &signature, &expanded, message, sizeof(message)));
+    EXPECT_EQ(VCCRYPT_ERROR_DIGITAL_SIGNATURE_SIGN_EXPANDED_INVALID_ARG,
+        vccrypt_digital_signature_sign_expanded(
+            &context, nullptr, &expanded, message, sizeof(message)));
+    EXPECT_EQ(VCCRYPT_ERROR_DIGITAL_SIGNATURE_SIGN_EXPANDED_INVALID_ARG,
+        vccrypt_digital_signature_sign_expanded(
+            &context, &short_buffer, &expanded, message, sizeof(message)));
+    EXPECT_EQ(VCCRYPT_ERROR_DIGITAL_SIGNATURE_SIGN_EXPANDED_INVALID_ARG,
+        vccrypt_digital_signature_sign_expanded(
+            &context, &signature, nullptr, message, sizeof(message)));
+    EXPECT_EQ(VCCRYPT_ERROR_DIGITAL_SIGNATURE_SIGN_EXPANDED_INVALID_ARG,
+        vccrypt_digital_signature_sign_expanded(
+            &context, &signature, &priv, message, sizeof(message)));
+    EXPECT_EQ(VCCRYPT_ERROR_DIGITAL_SIGNATURE_SIGN_EXPANDED_INVALID_ARG,
+        vccrypt_digital_signature_sign_expanded(
+            &context, &signature, &expanded, nullptr, sizeof(message)));
+
+    dispose((disposable_t*)&short_buffer);
+}
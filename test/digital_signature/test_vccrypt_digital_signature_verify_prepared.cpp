@@ -0,0 +1,486 @@
+/**
+ * \file test_vccrypt_digital_signature_verify_prepared.cpp
+ *
+ * Unit tests for verification with prepared public keys.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <fstream>
+#include <gtest/gtest.h>
+#include <string.h>
+#include <string>
+#include <vccrypt/digital_signature.h>
+#include <vpr/allocator/malloc_allocator.h>
+#include <vector>
+
+#include "../../src/digital_signature/digital_signature_private.h"
+#include "sign_input_path.h"
+
+using namespace std;
+
+/**
+ * The message signed by each key.
+ */
+static const uint8_t MESSAGE[] = "a message signed by each key";
+
+class vccrypt_digital_signature_verify_prepared_test : public ::testing::Test {
+protected:
+    void SetUp() override
+    {
+        vccrypt_digital_signature_register_ed25519();
+        vccrypt_prng_register_source_operating_system();
+
+        malloc_allocator_options_init(&alloc_opts);
+
+        ASSERT_EQ(0,
+            vccrypt_prng_options_init(
+                &prng_opts, &alloc_opts, VCCRYPT_PRNG_SOURCE_OPERATING_SYSTEM));
+        ASSERT_EQ(0,
+            vccrypt_digital_signature_options_init(
+                &options, &alloc_opts, &prng_opts,
+                VCCRYPT_DIGITAL_SIGNATURE_ALGORITHM_ED25519));
+        ASSERT_EQ(0, vccrypt_digital_signature_init(&options, &context));
+
+        ASSERT_EQ(0,
+            vccrypt_buffer_init(&pub, &alloc_opts, options.public_key_size));
+        ASSERT_EQ(0,
+            vccrypt_buffer_init(
+                &prepared, &alloc_opts, options.prepared_public_key_size));
+        ASSERT_EQ(0,
+            vccrypt_buffer_init(
+                &signature, &alloc_opts, options.signature_size));
+    }
+
+    void TearDown() override
+    {
+        for (size_t i = 0; i < keys.size(); ++i)
+        {
+            dispose((disposable_t*)&keys[i]);
+            dispose((disposable_t*)&signatures[i]);
+        }
+
+        dispose((disposable_t*)&signature);
+        dispose((disposable_t*)&prepared);
+        dispose((disposable_t*)&pub);
+        dispose((disposable_t*)&context);
+        dispose((disposable_t*)&options);
+        dispose((disposable_t*)&prng_opts);
+        dispose((disposable_t*)&alloc_opts);
+    }
+
+    /**
+     * Decode the hex string in into out.
+     */
+    static void from_hex(uint8_t* out, const string& in)
+    {
+        for (size_t i = 0; i + 1 < in.size(); i += 2)
+        {
+            out[i / 2] = (uint8_t)stoi(in.substr(i, 2), nullptr, 16);
+        }
+    }
+
+    /**
+     * Create count keys, each with a signature of MESSAGE.
+     */
+    void make_keys(size_t count)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            vccrypt_buffer_t priv, key, sig;
+
+            ASSERT_EQ(0,
+                vccrypt_buffer_init(
+                    &priv, &alloc_opts, options.private_key_size));
+            ASSERT_EQ(0,
+                vccrypt_buffer_init(
+                    &key, &alloc_opts, options.public_key_size));
+            ASSERT_EQ(0,
+                vccrypt_buffer_init(
+                    &sig, &alloc_opts, options.signature_size));
+            ASSERT_EQ(0,
+                vccrypt_digital_signature_keypair_create(
+                    &context, &priv, &key));
+            ASSERT_EQ(0,
+                vccrypt_digital_signature_sign(
+                    &context, &sig, &priv, MESSAGE, sizeof(MESSAGE)));
+
+            dispose((disposable_t*)&priv);
+
+            keys.push_back(key);
+            signatures.push_back(sig);
+        }
+    }
+
+    /**
+     * Returns true if the cache holds the given public key.
+     */
+    static bool cached(
+        const vccrypt_digital_signature_public_key_cache_t* cache,
+        const vccrypt_buffer_t* key)
+    {
+        const vccrypt_public_key_cache_state_t* state =
+            (const vccrypt_public_key_cache_state_t*)cache->cache_state;
+
+        for (size_t i = 0; i < state->count; ++i)
+        {
+            if (0 ==
+                    memcmp(
+                        state->keys + state->entries[i].slot * key->size,
+                        key->data, key->size))
+            {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    /**
+     * Check that verification with a prepared key agrees with verification
+     * with the public key, for good and bad signatures.
+     */
+    void check_matches_verify()
+    {
+        make_keys(8);
+
+        for (size_t i = 0; i < keys.size(); ++i)
+        {
+            ASSERT_EQ(0,
+                vccrypt_digital_signature_prepare_public_key(
+                    &context, &prepared, &keys[i]));
+
+            EXPECT_EQ(0,
+                vccrypt_digital_signature_verify_prepared(
+                    &context, &signatures[i], &prepared,
+                    MESSAGE, sizeof(MESSAGE)));
+
+            /* the signature of another key. */
+            EXPECT_NE(0,
+                vccrypt_digital_signature_verify_prepared(
+                    &context, &signatures[(i + 1) % keys.size()], &prepared,
+                    MESSAGE, sizeof(MESSAGE)));
+
+            /* a different message. */
+            EXPECT_NE(0,
+                vccrypt_digital_signature_verify_prepared(
+                    &context, &signatures[i], &prepared,
+                    MESSAGE, sizeof(MESSAGE) - 1));
+        }
+    }
+
+    allocator_options_t alloc_opts;
+    vccrypt_prng_options_t prng_opts;
+    vccrypt_digital_signature_options_t options;
+    vccrypt_digital_signature_context_t context;
+    vccrypt_buffer_t pub, prepared, signature;
+    vector<vccrypt_buffer_t> keys;
+    vector<vccrypt_buffer_t> signatures;
+};
+
+/**
+ * The ED25519 prepared key starts with the public key.
+ */
+TEST_F(vccrypt_digital_signature_verify_prepared_test, prepared_key_layout)
+{
+    ASSERT_EQ(
+        (size_t)VCCRYPT_DIGITAL_SIGNATURE_ED25519_PREPARED_PUBLIC_KEY_SIZE,
+        prepared.size);
+
+    make_keys(1);
+
+    ASSERT_EQ(0,
+        vccrypt_digital_signature_prepare_public_key(
+            &context, &prepared, &keys[0]));
+
+    EXPECT_EQ(0, memcmp(prepared.data, keys[0].data, keys[0].size));
+}
+
+/**
+ * Verification with prepared keys accepts the reference signatures, and
+ * rejects them for a changed message.
+ */
+TEST_F(vccrypt_digital_signature_verify_prepared_test, sign_input_vectors)
+{
+    string sign_path = sign_input_path();
+    ifstream in(sign_path);
+    string line;
+    int count = 0;
+
+    ASSERT_TRUE(in.good()) << "Using path: " << sign_path;
+
+    while (getline(in, line))
+    {
+        /* sk:pk:msg:sig||msg */
+        size_t msg_start = 128 + 1 + 64 + 1;
+        size_t msg_end = line.find(':', msg_start);
+        ASSERT_NE(string::npos, msg_end);
+
+        size_t size = (msg_end - msg_start) / 2;
+        vector<uint8_t> message(size + 1);
+
+        from_hex((uint8_t*)pub.data, line.substr(128 + 1, 64));
+        from_hex(message.data(), line.substr(msg_start, 2 * size));
+        from_hex((uint8_t*)signature.data, line.substr(msg_end + 1, 128));
+
+        ASSERT_EQ(0,
+            vccrypt_digital_signature_prepare_public_key(
+                &context, &prepared, &pub));
+        EXPECT_EQ(0,
+            vccrypt_digital_signature_verify_prepared(
+                &context, &signature, &prepared, message.data(), size))
+            << "line " << count;
+
+        /* an empty message becomes a one byte message. */
+        message[size / 2] ^= 0x01;
+        EXPECT_NE(0,
+            vccrypt_digital_signature_verify_prepared(
+                &context, &signature, &prepared, message.data(),
+                (size > 0) ? size : 1))
+            << "line " << count;
+
+        ++count;
+    }
+
+    EXPECT_EQ(1024, count);
+}
+
+/**
+ * Verification with prepared keys agrees with verification with public keys.
+ */
+TEST_F(vccrypt_digital_signature_verify_prepared_test, matches_verify)
+{
+    check_matches_verify();
+}
+
+/**
+ * Algorithms without preparation hooks fall back to copying the public key
+ * and verifying with it.
+ */
+TEST_F(vccrypt_digital_signature_verify_prepared_test, generic_fallback)
+{
+    options.vccrypt_digital_signature_alg_prepare_public_key = NULL;
+    options.vccrypt_digital_signature_alg_verify_prepared = NULL;
+    options.prepared_public_key_size = options.public_key_size;
+
+    dispose((disposable_t*)&prepared);
+    ASSERT_EQ(0,
+        vccrypt_buffer_init(
+            &prepared, &alloc_opts, options.prepared_public_key_size));
+
+    check_matches_verify();
+
+    EXPECT_EQ(0, memcmp(prepared.data, keys.back().data, pub.size));
+}
+
+/**
+ * A public key that is not a point can't be prepared.
+ */
+TEST_F(vccrypt_digital_signature_verify_prepared_test, invalid_public_key)
+{
+    int invalid = 0;
+
+    make_keys(1);
+
+    for (int i = 0; i < 32; ++i)
+    {
+        memset(pub.data, 0, pub.size);
+        ((uint8_t*)pub.data)[0] = (uint8_t)i;
+
+        if (0 != vccrypt_digital_signature_prepare_public_key(
+                    &context, &prepared, &pub))
+        {
+            ++invalid;
+
+            EXPECT_NE(0,
+                vccrypt_digital_signature_verify(
+                    &context, &signatures[0], &pub,
+                    MESSAGE, sizeof(MESSAGE)));
+        }
+    }
+
+    EXPECT_LT(0, invalid);
+}
+
+/**
+ * The cache verifies like vccrypt_digital_signature_verify(), and keeps the
+ * most recently used keys.
+ */
+TEST_F(vccrypt_digital_signature_verify_prepared_test, cache_lru)
+{
+    vccrypt_digital_signature_public_key_cache_t cache;
+
+    make_keys(6);
+
+    ASSERT_EQ(0,
+        vccrypt_digital_signature_public_key_cache_init(&cache, &context, 3));
+
+    /* fill the cache with keys 0, 1, 2, then use key 0 again. */
+    for (size_t i : { 0, 1, 2, 0 })
+    {
+        EXPECT_EQ(0,
+            vccrypt_digital_signature_verify_cached(
+                &cache, &signatures[i], &keys[i], MESSAGE, sizeof(MESSAGE)));
+    }
+
+    /* key 3 evicts key 1, the least recently used. */
+    EXPECT_EQ(0,
+        vccrypt_digital_signature_verify_cached(
+            &cache, &signatures[3], &keys[3], MESSAGE, sizeof(MESSAGE)));
+    EXPECT_TRUE(cached(&cache, &keys[0]));
+    EXPECT_FALSE(cached(&cache, &keys[1]));
+    EXPECT_TRUE(cached(&cache, &keys[2]));
+    EXPECT_TRUE(cached(&cache, &keys[3]));
+
+    /* a bad signature with a cached key is still rejected. */
+    EXPECT_NE(0,
+        vccrypt_digital_signature_verify_cached(
+            &cache, &signatures[2], &keys[0], MESSAGE, sizeof(MESSAGE)));
+
+    /* a public key that can't be prepared fails, and evicts nothing. */
+    for (int i = 0; i < 32; ++i)
+    {
+        memset(pub.data, 0, pub.size);
+        ((uint8_t*)pub.data)[0] = (uint8_t)i;
+
+        if (0 != vccrypt_digital_signature_prepare_public_key(
+                    &context, &prepared, &pub))
+        {
+            EXPECT_NE(0,
+                vccrypt_digital_signature_verify_cached(
+                    &cache, &signatures[0], &pub, MESSAGE, sizeof(MESSAGE)));
+        }
+    }
+    EXPECT_TRUE(cached(&cache, &keys[0]));
+    EXPECT_TRUE(cached(&cache, &keys[2]));
+    EXPECT_TRUE(cached(&cache, &keys[3]));
+
+    /* churn through all of the keys several times. */
+    for (size_t round = 0; round < 5; ++round)
+    {
+        for (size_t i = 0; i < keys.size(); ++i)
+        {
+            size_t k = (i * (round + 1)) % keys.size();
+
+            EXPECT_EQ(0,
+                vccrypt_digital_signature_verify_cached(
+                    &cache, &signatures[k], &keys[k],
+                    MESSAGE, sizeof(MESSAGE)));
+            EXPECT_NE(0,
+                vccrypt_digital_signature_verify_cached(
+                    &cache, &signatures[k], &keys[(k + 1) % keys.size()],
+                    MESSAGE, sizeof(MESSAGE)));
+            EXPECT_TRUE(cached(&cache, &keys[k]));
+        }
+    }
+
+    dispose((disposable_t*)&cache);
+}
+
+/**
+ * A cache with room for one key still works.
+ */
+TEST_F(vccrypt_digital_signature_verify_prepared_test, cache_capacity_one)
+{
+    vccrypt_digital_signature_public_key_cache_t cache;
+
+    make_keys(2);
+
+    ASSERT_EQ(0,
+        vccrypt_digital_signature_public_key_cache_init(&cache, &context, 1));
+
+    for (size_t i = 0; i < 6; ++i)
+    {
+        EXPECT_EQ(0,
+            vccrypt_digital_signature_verify_cached(
+                &cache, &signatures[i % 2], &keys[i % 2],
+                MESSAGE, sizeof(MESSAGE)));
+        EXPECT_TRUE(cached(&cache, &keys[i % 2]));
+        EXPECT_FALSE(cached(&cache, &keys[(i + 1) % 2]));
+    }
+
+    dispose((disposable_t*)&cache);
+}
+
+/**
+ * Bad arguments are rejected.
+ */
+TEST_F(vccrypt_digital_signature_verify_prepared_test, invalid_args)
+{
+    vccrypt_digital_signature_public_key_cache_t cache;
+    vccrypt_buffer_t short_buffer;
+
+    make_keys(1);
+
+    ASSERT_EQ(0,
+        vccrypt_buffer_init(
+            &short_buffer, &alloc_opts, options.public_key_size - 1));
+
+    EXPECT_EQ(VCCRYPT_ERROR_DIGITAL_SIGNATURE_PREPARE_PUBLIC_KEY_INVALID_ARG,
+        vccrypt_digital_signature_prepare_public_key(
+            nullptr, &prepared, &keys[0]));
+    EXPECT_EQ(VCCRYPT_ERROR_DIGITAL_SIGNATURE_PREPARE_PUBLIC_KEY_INVALID_ARG,
+        vccrypt_digital_signature_prepare_public_key(
+            &context, nullptr, &keys[0]));
+    EXPECT_EQ(VCCRYPT_ERROR_DIGITAL_SIGNATURE_PREPARE_PUBLIC_KEY_INVALID_ARG,
+        vccrypt_digital_signature_prepare_public_key(
+            &context, &prepared, nullptr));
+    EXPECT_EQ(VCCRYPT_ERROR_DIGITAL_SIGNATURE_PREPARE_PUBLIC_KEY_INVALID_ARG,
+        vccrypt_digital_signature_prepare_public_key(
+            &context, &short_buffer, &keys[0]));
+    EXPECT_EQ(VCCRYPT_ERROR_DIGITAL_SIGNATURE_PREPARE_PUBLIC_KEY_INVALID_ARG,
+        vccrypt_digital_signature_prepare_public_key(
+            &context, &prepared, &short_buffer));
+
+    EXPECT_EQ(VCCRYPT_ERROR_DIGITAL_SIGNATURE_VERIFY_PREPARED_INVALID_ARG,
+        vccrypt_digital_signature_verify_prepared(
+            nullptr, &signatures[0], &prepared, MESSAGE, sizeof(MESSAGE)));
+    EXPECT_EQ(VCCRYPT_ERROR_DIGITAL_SIGNATURE_VERIFY_PREPARED_INVALID_ARG,
+        vccrypt_digital_signature_verify_prepared(
+            &context, nullptr, &prepared, MESSAGE, sizeof(MESSAGE)));
+    EXPECT_EQ(VCCRYPT_ERROR_DIGITAL_SIGNATURE_VERIFY_PREPARED_INVALID_ARG,
+        vccrypt_digital_signature_verify_prepared(
+            &context, &short_buffer, &prepared, MESSAGE, sizeof(MESSAGE)));
+    EXPECT_EQ(VCCRYPT_ERROR_DIGITAL_SIGNATURE_VERIFY_PREPARED_INVALID_ARG,
+        vccrypt_digital_signature_verify_prepared(
+            &context, &signatures[0], nullptr, MESSAGE, sizeof(MESSAGE)));
+    EXPECT_EQ(VCCRYPT_ERROR_DIGITAL_SIGNATURE_VERIFY_PREPARED_INVALID_ARG,
+        vccrypt_digital_signature_verify_prepared(
+            &context, &signatures[0], &keys[0], MESSAGE, sizeof(MESSAGE)));
+    EXPECT_EQ(VCCRYPT_ERROR_DIGITAL_SIGNATURE_VERIFY_PREPARED_INVALID_ARG,
+        vccrypt_digital_signature_verify_prepared(
+            &context, &signatures[0], &prepared, nullptr, sizeof(MESSAGE)));
+
+    EXPECT_EQ(VCCRYPT_ERROR_DIGITAL_SIGNATURE_PUBLIC_KEY_CACHE_INIT_INVALID_ARG,
+        vccrypt_digital_signature_public_key_cache_init(
+            nullptr, &context, 1));
+    EXPECT_EQ(VCCRYPT_ERROR_DIGITAL_SIGNATURE_PUBLIC_KEY_CACHE_INIT_INVALID_ARG,
+        vccrypt_digital_signature_public_key_cache_init(&cache, nullptr, 1));
+    EXPECT_EQ(VCCRYPT_ERROR_DIGITAL_SIGNATURE_PUBLIC_KEY_CACHE_INIT_INVALID_ARG,
+        vccrypt_digital_signature_public_key_cache_init(&cache, &context, 0));
+    EXPECT_EQ(VCCRYPT_ERROR_DIGITAL_SIGNATURE_PUBLIC_KEY_CACHE_OUT_OF_MEMORY,
+        vccrypt_digital_signature_public_key_cache_init(
+            &cache, &context, SIZE_MAX / 2));
+
+    ASSERT_EQ(0,
+        vccrypt_digital_signature_public_key_cache_init(&cache, &context, 4));
+
+    EXPECT_EQ(VCCRYPT_ERROR_DIGITAL_SIGNATURE_VERIFY_CACHED_INVALID_ARG,
+        vccrypt_digital_signature_verify_cached(
+            nullptr, &signatures[0], &keys[0], MESSAGE, sizeof(MESSAGE)));
+    EXPECT_EQ(VCCRYPT_ERROR_DIGITAL_SIGNATURE_VERIFY_CACHED_INVALID_ARG,
+        vccrypt_digital_signature_verify_cached(
+            &cache, nullptr, &keys[0], MESSAGE, sizeof(MESSAGE)));
+    EXPECT_EQ(VCCRYPT_ERROR_DIGITAL_SIGNATURE_VERIFY_CACHED_INVALID_ARG,
+        vccrypt_digital_signature_verify_cached(
+            &cache, &signatures[0], nullptr, MESSAGE, sizeof(MESSAGE)));
+    EXPECT_EQ(VCCRYPT_ERROR_DIGITAL_SIGNATURE_VERIFY_CACHED_INVALID_ARG,
+        vccrypt_digital_signature_verify_cached(
+            &cache, &signatures[0], &short_buffer, MESSAGE, sizeof(MESSAGE)));
+    EXPECT_EQ(VCCRYPT_ERROR_DIGITAL_SIGNATURE_VERIFY_CACHED_INVALID_ARG,
+        vccrypt_digital_signature_verify_cached(
+            &cache, &signatures[0], &keys[0], nullptr, sizeof(MESSAGE)));
+
+    dispose((disposable_t*)&cache);
+    dispose((disposable_t*)&short_buffer);
+}
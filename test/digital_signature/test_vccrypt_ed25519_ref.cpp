@@ -13,6 +13,8 @@
 #include <vccrypt/digital_signature.h>
 #include <vpr/allocator/malloc_allocator.h>
 
+#include "sign_input_path.h"
+
 using namespace std;
 
 class vccrypt_ed25519_ref_test : public ::testing::Test {
@@ -104,15 +106,7 @@ TEST_F(vccrypt_ed25519_ref_test, simple_sign)
             &options, &alloc_opts, &prng_opts,
             VCCRYPT_DIGITAL_SIGNATURE_ALGORITHM_ED25519));
 
-    // By default the file is relative to the project root.
-    // You can set TEST_SIGNATURE_FILE to an absolute path to the file to test from anywhere.
-    std::string sign_path = "test/digital_signature/sign.input";
-    char* test_signature_path = std::getenv("TEST_SIGNATURE_PATH");
-
-    if (test_signature_path != nullptr)
-    {
-        sign_path = std::string(test_signature_path);
-    }
+    std::string sign_path = sign_input_path();
 
     //read the signature input file
     ifstream in(sign_path);
@@ -0,0 +1,109 @@
+/**
+ * \file test_sha256_block.cpp
+ *
+ * Unit tests for the SHA-256 block function variants.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <gtest/gtest.h>
+#include <string.h>
+#include "../../src/hash/ref/sha256_internal.h"
+
+/**
+ * The dispatched SHA-256 matches the NIST one million 'a' test vector.
+ */
+TEST(sha256_block_test, million_a)
+{
+    const uint8_t expected[SHA256_DIGEST_LENGTH] = {
+        0xcd, 0xc7, 0x6e, 0x5c, 0x99, 0x14, 0xfb, 0x92,
+        0x81, 0xa1, 0xc7, 0xe2, 0x84, 0xd7, 0x3e, 0x67,
+        0xf1, 0x80, 0x9a, 0x48, 0xa4, 0x97, 0x20, 0x0e,
+        0x04, 0x6d, 0x39, 0xcc, 0xc7, 0x11, 0x2c, 0xd0 };
+    uint8_t chunk[1000];
+    uint8_t md[SHA256_DIGEST_LENGTH];
+    SHA256_CTX ctx;
+
+    memset(chunk, 'a', sizeof(chunk));
+
+    SHA256_Init(&ctx);
+    for (int i = 0; i < 1000; ++i)
+    {
+        SHA256_Update(&ctx, chunk, sizeof(chunk));
+    }
+    ASSERT_EQ(0, SHA256_Final(&ctx, md));
+
+    EXPECT_EQ(0, memcmp(expected, md, sizeof(md)));
+}
+
+/**
+ * Fill a test message with a fixed pattern.
+ */
+static void sha256_block_test_message(uint8_t* msg, size_t size)
+{
+    for (size_t i = 0; i < size; ++i)
+    {
+        msg[i] = (uint8_t)(i * 131 + 7);
+    }
+}
+
+#ifdef SHA256_HAVE_AVX2
+/**
+ * The AVX2 block function matches the portable block function for even and
+ * odd block counts.
+ */
+TEST(sha256_block_test, avx2_matches_reference)
+{
+    uint8_t msg[9 * SHA256_CBLOCK];
+    SHA256_CTX ref, avx2;
+
+    if (!sha256_avx2_capable())
+    {
+        return;
+    }
+
+    sha256_block_test_message(msg, sizeof(msg));
+
+    for (size_t blocks = 1; blocks <= 9; ++blocks)
+    {
+        SHA256_Init(&ref);
+        SHA256_Init(&avx2);
+
+        sha256_block_data_order(&ref, msg, blocks);
+        sha256_block_data_order_avx2(&avx2, msg, blocks);
+
+        EXPECT_EQ(0, memcmp(ref.h, avx2.h, sizeof(ref.h)))
+            << "blocks = " << blocks;
+    }
+}
+#endif
+
+#ifdef SHA256_HAVE_SHANI
+/**
+ * The SHA extension block function matches the portable block function.
+ */
+TEST(sha256_block_test, shani_matches_reference)
+{
+    uint8_t msg[9 * SHA256_CBLOCK];
+    SHA256_CTX ref, shani;
+
+    if (!sha256_shani_capable())
+    {
+        return;
+    }
+
+    sha256_block_test_message(msg, sizeof(msg));
+
+    for (size_t blocks = 1; blocks <= 9; ++blocks)
+    {
+        SHA256_Init(&ref);
+        SHA256_Init(&shani);
+
+        sha256_block_data_order(&ref, msg, blocks);
+        sha256_block_data_order_shani(&shani, msg, blocks);
+
+        EXPECT_EQ(0, memcmp(ref.h, shani.h, sizeof(ref.h)))
+            << "blocks = " << blocks;
+    }
+}
+#endif
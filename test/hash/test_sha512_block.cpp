@@ -0,0 +1,75 @@
+/**
+ * \file test_sha512_block.cpp
+ *
+ * Unit tests for the SHA-512 block function variants.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <gtest/gtest.h>
+#include <string.h>
+#include "../../src/hash/ref/sha512_internal.h"
+
+/**
+ * The dispatched SHA-512 matches the NIST one million 'a' test vector.
+ */
+TEST(sha512_block_test, million_a)
+{
+    const uint8_t expected[SHA512_DIGEST_LENGTH] = {
+        0xe7, 0x18, 0x48, 0x3d, 0x0c, 0xe7, 0x69, 0x64,
+        0x4e, 0x2e, 0x42, 0xc7, 0xbc, 0x15, 0xb4, 0x63,
+        0x8e, 0x1f, 0x98, 0xb1, 0x3b, 0x20, 0x44, 0x28,
+        0x56, 0x32, 0xa8, 0x03, 0xaf, 0xa9, 0x73, 0xeb,
+        0xde, 0x0f, 0xf2, 0x44, 0x87, 0x7e, 0xa6, 0x0a,
+        0x4c, 0xb0, 0x43, 0x2c, 0xe5, 0x77, 0xc3, 0x1b,
+        0xeb, 0x00, 0x9c, 0x5c, 0x2c, 0x49, 0xaa, 0x2e,
+        0x4e, 0xad, 0xb2, 0x17, 0xad, 0x8c, 0xc0, 0x9b };
+    uint8_t chunk[1000];
+    uint8_t md[SHA512_DIGEST_LENGTH];
+    SHA512_CTX ctx;
+
+    memset(chunk, 'a', sizeof(chunk));
+
+    SHA512_Init(&ctx);
+    for (int i = 0; i < 1000; ++i)
+    {
+        SHA512_Update(&ctx, chunk, sizeof(chunk));
+    }
+    ASSERT_EQ(0, SHA512_Final(&ctx, md));
+
+    EXPECT_EQ(0, memcmp(expected, md, sizeof(md)));
+}
+
+#ifdef SHA512_HAVE_AVX2
+/**
+ * The AVX2 block function matches the portable block function for even and
+ * odd block counts.
+ */
+TEST(sha512_block_test, avx2_matches_reference)
+{
+    uint8_t msg[9 * SHA512_CBLOCK];
+    SHA512_CTX ref, avx2;
+
+    if (!sha512_avx2_capable())
+    {
+        return;
+    }
+
+    for (size_t i = 0; i < sizeof(msg); ++i)
+    {
+        msg[i] = (uint8_t)(i * 131 + 7);
+    }
+
+    for (size_t blocks = 1; blocks <= 9; ++blocks)
+    {
+        SHA512_Init(&ref);
+        SHA512_Init(&avx2);
+
+        sha512_block_data_order(&ref, msg, blocks);
+        sha512_block_data_order_avx2(&avx2, msg, blocks);
+
+        EXPECT_EQ(0, memcmp(ref.h, avx2.h, sizeof(ref.h)))
+            << "blocks = " << blocks;
+    }
+}
+#endif
@@ -0,0 +1,244 @@
+/**
+ * \file test_vccrypt_hash_batch_digest.cpp
+ *
+ * Unit tests for batch hashing.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <gtest/gtest.h>
+#include <string.h>
+#include <vccrypt/hash.h>
+#include <vpr/allocator/malloc_allocator.h>
+#include <vector>
+
+class vccrypt_hash_batch_digest_test : public ::testing::Test {
+protected:
+    void SetUp() override
+    {
+        vccrypt_hash_register_SHA_2_256();
+        vccrypt_hash_register_SHA_2_384();
+        vccrypt_hash_register_SHA_2_512();
+        vccrypt_hash_register_SHA_2_512_224();
+        vccrypt_hash_register_SHA_2_512_256();
+
+        malloc_allocator_options_init(&alloc_opts);
+
+        /* message sizes around the one and two block padding boundaries. */
+        for (size_t i = 0; i < 300; i += 7)
+        {
+            sizes.push_back(i);
+        }
+        sizes.push_back(111);
+        sizes.push_back(112);
+        sizes.push_back(127);
+        sizes.push_back(128);
+        sizes.push_back(239);
+        sizes.push_back(240);
+        sizes.push_back(1000);
+
+        for (size_t i = 0; i < sizes.size(); ++i)
+        {
+            uint8_t* msg = new uint8_t[sizes[i] + 1];
+            for (size_t j = 0; j < sizes[i]; ++j)
+            {
+                msg[j] = (uint8_t)(i * 31 + j * 17);
+            }
+            data.push_back(msg);
+        }
+    }
+
+    void TearDown() override
+    {
+        for (size_t i = 0; i < data.size(); ++i)
+        {
+            delete[] data[i];
+        }
+
+        dispose((disposable_t*)&alloc_opts);
+    }
+
+    /**
+     * Check that a batch hash matches hashing each message on its own.
+     */
+    void check_batch(vccrypt_hash_options_t* options)
+    {
+        std::vector<vccrypt_buffer_t> md(data.size());
+
+        for (size_t i = 0; i < md.size(); ++i)
+        {
+            ASSERT_EQ(0,
+                vccrypt_buffer_init(&md[i], &alloc_opts, options->hash_size));
+        }
+
+        ASSERT_EQ(0,
+            vccrypt_hash_batch_digest(
+                options, data.data(), sizes.data(), md.data(), md.size()));
+
+        for (size_t i = 0; i < md.size(); ++i)
+        {
+            vccrypt_hash_context_t context;
+            vccrypt_buffer_t expected;
+
+            ASSERT_EQ(0, vccrypt_hash_init(options, &context));
+            ASSERT_EQ(0,
+                vccrypt_buffer_init(&expected, &alloc_opts,
+                    options->hash_size));
+            if (sizes[i] > 0)
+            {
+                ASSERT_EQ(0,
+                    vccrypt_hash_digest(&context, data[i], sizes[i]));
+            }
+            ASSERT_EQ(0, vccrypt_hash_finalize(&context, &expected));
+
+            EXPECT_EQ(0,
+                memcmp(expected.data, md[i].data, options->hash_size))
+                << "size = " << sizes[i];
+
+            dispose((disposable_t*)&expected);
+            dispose((disposable_t*)&context);
+            dispose((disposable_t*)&md[i]);
+        }
+    }
+
+    allocator_options_t alloc_opts;
+    std::vector<size_t> sizes;
+    std::vector<const uint8_t*> data;
+};
+
+/**
+ * A SHA-512 batch matches hashing each message on its own.
+ */
+TEST_F(vccrypt_hash_batch_digest_test, sha_512)
+{
+    vccrypt_hash_options_t options;
+
+    ASSERT_EQ(0,
+        vccrypt_hash_options_init(&options, &alloc_opts,
+            VCCRYPT_HASH_ALGORITHM_SHA_2_512));
+
+    check_batch(&options);
+
+    dispose((disposable_t*)&options);
+}
+
+/**
+ * A SHA-384 batch matches hashing each message on its own.
+ */
+TEST_F(vccrypt_hash_batch_digest_test, sha_384)
+{
+    vccrypt_hash_options_t options;
+
+    ASSERT_EQ(0,
+        vccrypt_hash_options_init(&options, &alloc_opts,
+            VCCRYPT_HASH_ALGORITHM_SHA_2_384));
+
+    check_batch(&options);
+
+    dispose((disposable_t*)&options);
+}
+
+/**
+ * A SHA-512/256 batch matches hashing each message on its own.
+ */
+TEST_F(vccrypt_hash_batch_digest_test, sha_512_256)
+{
+    vccrypt_hash_options_t options;
+
+    ASSERT_EQ(0,
+        vccrypt_hash_options_init(&options, &alloc_opts,
+            VCCRYPT_HASH_ALGORITHM_SHA_2_512_256));
+
+    check_batch(&options);
+
+    dispose((disposable_t*)&options);
+}
+
+/**
+ * A SHA-512/224 batch matches hashing each message on its own.
+ */
+TEST_F(vccrypt_hash_batch_digest_test, sha_512_224)
+{
+    vccrypt_hash_options_t options;
+
+    ASSERT_EQ(0,
+        vccrypt_hash_options_init(&options, &alloc_opts,
+            VCCRYPT_HASH_ALGORITHM_SHA_2_512_224));
+
+    check_batch(&options);
+
+    dispose((disposable_t*)&options);
+}
+
+/**
+ * SHA-256 has no batch implementation and hashes each message in turn.
+ */
+TEST_F(vccrypt_hash_batch_digest_test, sha_256)
+{
+    vccrypt_hash_options_t options;
+
+    ASSERT_EQ(0,
+        vccrypt_hash_options_init(&options, &alloc_opts,
+            VCCRYPT_HASH_ALGORITHM_SHA_2_256));
+
+    check_batch(&options);
+
+    dispose((disposable_t*)&options);
+}
+
+/**
+ * Algorithms without a batch implementation hash each message in turn.
+ */
+TEST_F(vccrypt_hash_batch_digest_test, generic_fallback)
+{
+    vccrypt_hash_options_t options;
+
+    ASSERT_EQ(0,
+        vccrypt_hash_options_init(&options, &alloc_opts,
+            VCCRYPT_HASH_ALGORITHM_SHA_2_512));
+
+    options.vccrypt_hash_alg_batch_digest = NULL;
+
+    check_batch(&options);
+
+    dispose((disposable_t*)&options);
+}
+
+/**
+ * An empty batch succeeds, and bad arguments are rejected.
+ */
+TEST_F(vccrypt_hash_batch_digest_test, invalid_args)
+{
+    vccrypt_hash_options_t options;
+    vccrypt_buffer_t md[2];
+    const uint8_t* msgs[2] = { data[1], NULL };
+    size_t msg_sizes[2] = { sizes[1], 0 };
+
+    ASSERT_EQ(0,
+        vccrypt_hash_options_init(&options, &alloc_opts,
+            VCCRYPT_HASH_ALGORITHM_SHA_2_512));
+    ASSERT_EQ(0,
+        vccrypt_buffer_init(&md[0], &alloc_opts, options.hash_size));
+    ASSERT_EQ(0,
+        vccrypt_buffer_init(&md[1], &alloc_opts, options.hash_size - 1));
+
+    EXPECT_EQ(0,
+        vccrypt_hash_batch_digest(&options, NULL, NULL, NULL, 0));
+    EXPECT_EQ(VCCRYPT_ERROR_HASH_BATCH_DIGEST_INVALID_ARG,
+        vccrypt_hash_batch_digest(NULL, msgs, msg_sizes, md, 1));
+    EXPECT_EQ(VCCRYPT_ERROR_HASH_BATCH_DIGEST_INVALID_ARG,
+        vccrypt_hash_batch_digest(&options, NULL, msg_sizes, md, 1));
+
+    /* the second output buffer is too small. */
+    EXPECT_EQ(VCCRYPT_ERROR_HASH_BATCH_DIGEST_INVALID_ARG,
+        vccrypt_hash_batch_digest(&options, msgs, msg_sizes, md, 2));
+
+    /* a NULL message is only allowed when its size is 0. */
+    msgs[0] = NULL;
+    EXPECT_EQ(VCCRYPT_ERROR_HASH_BATCH_DIGEST_INVALID_ARG,
+        vccrypt_hash_batch_digest(&options, msgs, msg_sizes, md, 1));
+
+    dispose((disposable_t*)&md[0]);
+    dispose((disposable_t*)&md[1]);
+    dispose((disposable_t*)&options);
+}
@@ -0,0 +1,171 @@
+/**
+ * \file test_vccrypt_hash_clone.cpp
+ *
+ * Unit tests for cloning hash instances.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <gtest/gtest.h>
+#include <string.h>
+#include <vccrypt/hash.h>
+#include <vpr/allocator/malloc_allocator.h>
+
+class vccrypt_hash_clone_test : public ::testing::Test {
+protected:
+    void SetUp() override
+    {
+        vccrypt_hash_register_SHA_2_256();
+        vccrypt_hash_register_SHA_2_384();
+        vccrypt_hash_register_SHA_2_512();
+        vccrypt_hash_register_SHA_2_512_224();
+        vccrypt_hash_register_SHA_2_512_256();
+
+        malloc_allocator_options_init(&alloc_opts);
+
+        for (size_t i = 0; i < sizeof(prefix); ++i)
+        {
+            prefix[i] = (uint8_t)(i * 7 + 1);
+        }
+    }
+
+    void TearDown() override
+    {
+        dispose((disposable_t*)&alloc_opts);
+    }
+
+    /**
+     * Hash the prefix followed by the given suffix in one instance.
+     */
+    void hash_direct(
+        vccrypt_hash_options_t* options, const char* suffix,
+        vccrypt_buffer_t* md)
+    {
+        vccrypt_hash_context_t context;
+
+        ASSERT_EQ(0, vccrypt_hash_init(options, &context));
+        ASSERT_EQ(0,
+            vccrypt_hash_digest(&context, prefix, sizeof(prefix)));
+        ASSERT_EQ(0,
+            vccrypt_hash_digest(
+                &context, (const uint8_t*)suffix, strlen(suffix)));
+        ASSERT_EQ(0, vccrypt_hash_finalize(&context, md));
+
+        dispose((disposable_t*)&context);
+    }
+
+    /**
+     * Hash the prefix once, then finish two different messages from it.
+     */
+    void check_clone(uint32_t algorithm)
+    {
+        vccrypt_hash_options_t options;
+        vccrypt_hash_context_t context, clone;
+        vccrypt_buffer_t md, clone_md, expected;
+
+        ASSERT_EQ(0,
+            vccrypt_hash_options_init(&options, &alloc_opts, algorithm));
+        ASSERT_EQ(0,
+            vccrypt_buffer_init(&md, &alloc_opts, options.hash_size));
+        ASSERT_EQ(0,
+            vccrypt_buffer_init(&clone_md, &alloc_opts, options.hash_size));
+        ASSERT_EQ(0,
+            vccrypt_buffer_init(&expected, &alloc_opts, options.hash_size));
+
+        ASSERT_EQ(0, vccrypt_hash_init(&options, &context));
+        ASSERT_EQ(0,
+            vccrypt_hash_digest(&context, prefix, sizeof(prefix)));
+
+        ASSERT_EQ(0, vccrypt_hash_clone(&clone, &context));
+
+        /* finish the clone first, which must not disturb the original. */
+        ASSERT_EQ(0,
+            vccrypt_hash_digest(&clone, (const uint8_t*)"second", 6));
+        ASSERT_EQ(0, vccrypt_hash_finalize(&clone, &clone_md));
+        dispose((disposable_t*)&clone);
+
+        ASSERT_EQ(0,
+            vccrypt_hash_digest(&context, (const uint8_t*)"first", 5));
+        ASSERT_EQ(0, vccrypt_hash_finalize(&context, &md));
+
+        hash_direct(&options, "first", &expected);
+        EXPECT_EQ(0, memcmp(expected.data, md.data, options.hash_size));
+
+        hash_direct(&options, "second", &expected);
+        EXPECT_EQ(0,
+            memcmp(expected.data, clone_md.data, options.hash_size));
+
+        dispose((disposable_t*)&expected);
+        dispose((disposable_t*)&clone_md);
+        dispose((disposable_t*)&md);
+        dispose((disposable_t*)&context);
+        dispose((disposable_t*)&options);
+    }
+
+    allocator_options_t alloc_opts;
+    uint8_t prefix[300];
+};
+
+/**
+ * A SHA-512 clone continues from the digested prefix.
+ */
+TEST_F(vccrypt_hash_clone_test, sha_512)
+{
+    check_clone(VCCRYPT_HASH_ALGORITHM_SHA_2_512);
+}
+
+/**
+ * A SHA-384 clone continues from the digested prefix.
+ */
+TEST_F(vccrypt_hash_clone_test, sha_384)
+{
+    check_clone(VCCRYPT_HASH_ALGORITHM_SHA_2_384);
+}
+
+/**
+ * A SHA-512/256 clone continues from the digested prefix.
+ */
+TEST_F(vccrypt_hash_clone_test, sha_512_256)
+{
+    check_clone(VCCRYPT_HASH_ALGORITHM_SHA_2_512_256);
+}
+
+/**
+ * A SHA-512/224 clone continues from the digested prefix.
+ */
+TEST_F(vccrypt_hash_clone_test, sha_512_224)
+{
+    check_clone(VCCRYPT_HASH_ALGORITHM_SHA_2_512_224);
+}
+
+/**
+ * A SHA-256 clone continues from the digested prefix.
+ */
+TEST_F(vccrypt_hash_clone_test, sha_256)
+{
+    check_clone(VCCRYPT_HASH_ALGORITHM_SHA_2_256);
+}
+
+/**
+ * Invalid arguments are rejected.
+ */
+TEST_F(vccrypt_hash_clone_test, invalid_args)
+{
+    vccrypt_hash_options_t options;
+    vccrypt_hash_context_t context, clone;
+
+    ASSERT_EQ(0,
+        vccrypt_hash_options_init(&options, &alloc_opts,
+            VCCRYPT_HASH_ALGORITHM_SHA_2_512));
+    ASSERT_EQ(0, vccrypt_hash_init(&options, &context));
+
+    EXPECT_EQ(VCCRYPT_ERROR_HASH_CLONE_INVALID_ARG,
+        vccrypt_hash_clone(NULL, &context));
+    EXPECT_EQ(VCCRYPT_ERROR_HASH_CLONE_INVALID_ARG,
+        vccrypt_hash_clone(&clone, NULL));
+    EXPECT_EQ(VCCRYPT_ERROR_HASH_CLONE_INVALID_ARG,
+        vccrypt_hash_clone(&context, &context));
+
+    dispose((disposable_t*)&context);
+    dispose((disposable_t*)&options);
+}
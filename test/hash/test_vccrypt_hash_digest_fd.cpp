@@ -0,0 +1,300 @@
+/**
+ * \file test_vccrypt_hash_digest_fd.cpp
+ *
+ * Unit tests for hashing files and file descriptors.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <fcntl.h>
+#include <gtest/gtest.h>
+#include <stdlib.h>
+#include <string.h>
+#include <thread>
+#include <unistd.h>
+#include <vccrypt/hash.h>
+#include <vector>
+#include <vpr/allocator/malloc_allocator.h>
+
+#if defined(VCCRYPT_OS_UNIX)
+
+class vccrypt_hash_digest_fd_test : public ::testing::Test {
+protected:
+    void SetUp() override
+    {
+        vccrypt_hash_register_SHA_2_512();
+
+        malloc_allocator_options_init(&alloc_opts);
+
+        ASSERT_EQ(0,
+            vccrypt_hash_options_init(&options, &alloc_opts,
+                VCCRYPT_HASH_ALGORITHM_SHA_2_512));
+
+        strcpy(path, "/tmp/vccrypt_hash_digest_fd_XXXXXX");
+        fd = mkstemp(path);
+        ASSERT_LE(0, fd);
+    }
+
+    void TearDown() override
+    {
+        close(fd);
+        unlink(path);
+
+        dispose((disposable_t*)&options);
+        dispose((disposable_t*)&alloc_opts);
+    }
+
+    /**
+     * Fill the message with a fixed pattern.
+     */
+    void make_message(size_t size)
+    {
+        msg.resize(size);
+        for (size_t i = 0; i < size; ++i)
+        {
+            msg[i] = (uint8_t)(i * 7 + (i >> 12));
+        }
+    }
+
+    /**
+     * Write the message to the temporary file and rewind it.
+     */
+    void write_message()
+    {
+        ASSERT_EQ(0, ftruncate(fd, 0));
+        ASSERT_EQ((off_t)0, lseek(fd, 0, SEEK_SET));
+        ASSERT_EQ((ssize_t)msg.size(), write(fd, msg.data(), msg.size()));
+        ASSERT_EQ((off_t)0, lseek(fd, 0, SEEK_SET));
+    }
+
+    /**
+     * Hash the given part of the message in memory.
+     */
+    void hash_memory(size_t offset, vccrypt_buffer_t* md)
+    {
+        vccrypt_hash_context_t context;
+
+        ASSERT_EQ(0, vccrypt_hash_init(&options, &context));
+        if (msg.size() > offset)
+        {
+            ASSERT_EQ(0,
+                vccrypt_hash_digest(
+                    &context, msg.data() + offset, msg.size() - offset));
+        }
+        ASSERT_EQ(0, vccrypt_hash_finalize(&context, md));
+
+        dispose((disposable_t*)&context);
+    }
+
+    /**
+     * Check that hashing the file descriptor matches hashing in memory.
+     */
+    void check_fd(size_t size)
+    {
+        vccrypt_hash_context_t context;
+        vccrypt_buffer_t md, expected;
+
+        make_message(size);
+        write_message();
+
+        ASSERT_EQ(0, vccrypt_buffer_init(&md, &alloc_opts, options.hash_size));
+        ASSERT_EQ(0,
+            vccrypt_buffer_init(&expected, &alloc_opts, options.hash_size));
+
+        ASSERT_EQ(0, vccrypt_hash_init(&options, &context));
+        ASSERT_EQ(0, vccrypt_hash_digest_fd(&context, fd));
+        ASSERT_EQ(0, vccrypt_hash_finalize(&context, &md));
+
+        hash_memory(0, &expected);
+        EXPECT_EQ(0, memcmp(expected.data, md.data, options.hash_size))
+            << "size = " << size;
+
+        dispose((disposable_t*)&context);
+        dispose((disposable_t*)&expected);
+        dispose((disposable_t*)&md);
+    }
+
+    allocator_options_t alloc_opts;
+    vccrypt_hash_options_t options;
+    char path[64];
+    int fd;
+    std::vector<uint8_t> msg;
+};
+
+/**
+ * Files smaller than one read are hashed on the calling thread.
+ */
+TEST_F(vccrypt_hash_digest_fd_test, small_files)
+{
+    check_fd(0);
+    check_fd(1);
+    check_fd(1000);
+    check_fd(1024 * 1024);
+}
+
+/**
+ * Larger files are read ahead on a helper thread.
+ */
+TEST_F(vccrypt_hash_digest_fd_test, large_files)
+{
+    check_fd(1024 * 1024 + 1);
+    check_fd(4 * 1024 * 1024);
+    check_fd(11 * 1024 * 1024 + 333);
+}
+
+/**
+ * Hashing starts at the current file offset.
+ */
+TEST_F(vccrypt_hash_digest_fd_test, current_offset)
+{
+    const size_t OFFSET = 12345;
+    vccrypt_hash_context_t context;
+    vccrypt_buffer_t md, expected;
+
+    make_message(3 * 1024 * 1024);
+    write_message();
+    ASSERT_EQ((off_t)OFFSET, lseek(fd, OFFSET, SEEK_SET));
+
+    ASSERT_EQ(0, vccrypt_buffer_init(&md, &alloc_opts, options.hash_size));
+    ASSERT_EQ(0,
+        vccrypt_buffer_init(&expected, &alloc_opts, options.hash_size));
+
+    ASSERT_EQ(0, vccrypt_hash_init(&options, &context));
+    ASSERT_EQ(0, vccrypt_hash_digest_fd(&context, fd));
+    ASSERT_EQ(0, vccrypt_hash_finalize(&context, &md));
+
+    hash_memory(OFFSET, &expected);
+    EXPECT_EQ(0, memcmp(expected.data, md.data, options.hash_size));
+
+    dispose((disposable_t*)&context);
+    dispose((disposable_t*)&expected);
+    dispose((disposable_t*)&md);
+}
+
+/**
+ * An unaligned start offset shortens the first read only.
+ */
+TEST_F(vccrypt_hash_digest_fd_test, unaligned_offset)
+{
+    const size_t OFFSET = 1024 * 1024 - 1;
+    vccrypt_hash_context_t context;
+    vccrypt_buffer_t md, expected;
+
+    make_message(3 * 1024 * 1024 + 7);
+    write_message();
+    ASSERT_EQ((off_t)OFFSET, lseek(fd, OFFSET, SEEK_SET));
+
+    ASSERT_EQ(0, vccrypt_buffer_init(&md, &alloc_opts, options.hash_size));
+    ASSERT_EQ(0,
+        vccrypt_buffer_init(&expected, &alloc_opts, options.hash_size));
+
+    ASSERT_EQ(0, vccrypt_hash_init(&options, &context));
+    ASSERT_EQ(0, vccrypt_hash_digest_fd(&context, fd));
+    ASSERT_EQ(0, vccrypt_hash_finalize(&context, &md));
+
+    hash_memory(OFFSET, &expected);
+    EXPECT_EQ(0, memcmp(expected.data, md.data, options.hash_size));
+
+    dispose((disposable_t*)&context);
+    dispose((disposable_t*)&expected);
+    dispose((disposable_t*)&md);
+}
+
+/**
+ * Pipes are hashed until the writer closes them.
+ */
+TEST_F(vccrypt_hash_digest_fd_test, pipe)
+{
+    vccrypt_hash_context_t context;
+    vccrypt_buffer_t md, expected;
+    int fds[2];
+
+    make_message(3 * 1024 * 1024 + 17);
+    ASSERT_EQ(0, ::pipe(fds));
+
+    /* write in small pieces, so that reads come back short. */
+    std::thread writer([&]() {
+        for (size_t off = 0; off < msg.size(); off += 10000)
+        {
+            size_t n = std::min((size_t)10000, msg.size() - off);
+            if ((ssize_t)n != write(fds[1], msg.data() + off, n))
+            {
+                break;
+            }
+        }
+        close(fds[1]);
+    });
+
+    ASSERT_EQ(0, vccrypt_buffer_init(&md, &alloc_opts, options.hash_size));
+    ASSERT_EQ(0,
+        vccrypt_buffer_init(&expected, &alloc_opts, options.hash_size));
+
+    ASSERT_EQ(0, vccrypt_hash_init(&options, &context));
+    EXPECT_EQ(0, vccrypt_hash_digest_fd(&context, fds[0]));
+    writer.join();
+    close(fds[0]);
+    ASSERT_EQ(0, vccrypt_hash_finalize(&context, &md));
+
+    hash_memory(0, &expected);
+    EXPECT_EQ(0, memcmp(expected.data, md.data, options.hash_size));
+
+    dispose((disposable_t*)&context);
+    dispose((disposable_t*)&expected);
+    dispose((disposable_t*)&md);
+}
+
+/**
+ * A file can be hashed by path.
+ */
+TEST_F(vccrypt_hash_digest_fd_test, path)
+{
+    vccrypt_hash_context_t context;
+    vccrypt_buffer_t md, expected;
+
+    make_message(2 * 1024 * 1024 + 5);
+    write_message();
+
+    ASSERT_EQ(0, vccrypt_buffer_init(&md, &alloc_opts, options.hash_size));
+    ASSERT_EQ(0,
+        vccrypt_buffer_init(&expected, &alloc_opts, options.hash_size));
+
+    ASSERT_EQ(0, vccrypt_hash_init(&options, &context));
+    ASSERT_EQ(0, vccrypt_hash_digest_file(&context, path));
+    ASSERT_EQ(0, vccrypt_hash_finalize(&context, &md));
+
+    hash_memory(0, &expected);
+    EXPECT_EQ(0, memcmp(expected.data, md.data, options.hash_size));
+
+    dispose((disposable_t*)&context);
+    dispose((disposable_t*)&expected);
+    dispose((disposable_t*)&md);
+}
+
+/**
+ * Bad arguments, missing files, and read errors are reported.
+ */
+TEST_F(vccrypt_hash_digest_fd_test, errors)
+{
+    vccrypt_hash_context_t context;
+
+    ASSERT_EQ(0, vccrypt_hash_init(&options, &context));
+
+    EXPECT_EQ(VCCRYPT_ERROR_HASH_DIGEST_FD_INVALID_ARG,
+        vccrypt_hash_digest_fd(NULL, fd));
+    EXPECT_EQ(VCCRYPT_ERROR_HASH_DIGEST_FD_INVALID_ARG,
+        vccrypt_hash_digest_fd(&context, -1));
+    EXPECT_EQ(VCCRYPT_ERROR_HASH_DIGEST_FILE_INVALID_ARG,
+        vccrypt_hash_digest_file(NULL, path));
+    EXPECT_EQ(VCCRYPT_ERROR_HASH_DIGEST_FILE_INVALID_ARG,
+        vccrypt_hash_digest_file(&context, NULL));
+    EXPECT_EQ(VCCRYPT_ERROR_HASH_DIGEST_FILE_OPEN_FAILURE,
+        vccrypt_hash_digest_file(&context, "/nonexistent/vccrypt/file"));
+
+    /* a directory can be opened, but not read. */
+    EXPECT_EQ(VCCRYPT_ERROR_HASH_DIGEST_FD_READ_FAILURE,
+        vccrypt_hash_digest_file(&context, "/"));
+
+    dispose((disposable_t*)&context);
+}
+
+#endif /*defined(VCCRYPT_OS_UNIX)*/
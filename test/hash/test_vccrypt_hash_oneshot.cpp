@@ -0,0 +1,175 @@
+/**
+ * \file test_vccrypt_hash_oneshot.cpp
+ *
+ * Unit tests for one-shot hashing.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <gtest/gtest.h>
+#include <string.h>
+#include <vccrypt/hash.h>
+#include <vpr/allocator/malloc_allocator.h>
+
+class vccrypt_hash_oneshot_test : public ::testing::Test {
+protected:
+    void SetUp() override
+    {
+        vccrypt_hash_register_SHA_2_256();
+        vccrypt_hash_register_SHA_2_384();
+        vccrypt_hash_register_SHA_2_512();
+        vccrypt_hash_register_SHA_2_512_224();
+        vccrypt_hash_register_SHA_2_512_256();
+
+        malloc_allocator_options_init(&alloc_opts);
+
+        for (size_t i = 0; i < sizeof(msg); ++i)
+        {
+            msg[i] = (uint8_t)(i * 17 + 3);
+        }
+    }
+
+    void TearDown() override
+    {
+        dispose((disposable_t*)&alloc_opts);
+    }
+
+    /**
+     * Check that one-shot hashes match hashing with a hash instance.
+     */
+    void check_oneshot(vccrypt_hash_options_t* options)
+    {
+        uint8_t md[64];
+        vccrypt_buffer_t expected;
+
+        ASSERT_EQ(0,
+            vccrypt_buffer_init(&expected, &alloc_opts, options->hash_size));
+
+        for (size_t size = 0; size <= sizeof(msg); size += 13)
+        {
+            vccrypt_hash_context_t context;
+
+            ASSERT_EQ(0, vccrypt_hash_init(options, &context));
+            if (size > 0)
+            {
+                ASSERT_EQ(0, vccrypt_hash_digest(&context, msg, size));
+            }
+            ASSERT_EQ(0, vccrypt_hash_finalize(&context, &expected));
+            dispose((disposable_t*)&context);
+
+            memset(md, 0xFF, sizeof(md));
+            ASSERT_EQ(0,
+                vccrypt_hash_oneshot(
+                    options, size > 0 ? msg : NULL, size, md,
+                    options->hash_size));
+
+            EXPECT_EQ(0, memcmp(expected.data, md, options->hash_size))
+                << "size = " << size;
+
+            /* nothing past the hash size is written. */
+            for (size_t i = options->hash_size; i < sizeof(md); ++i)
+            {
+                EXPECT_EQ(0xFF, md[i]);
+            }
+        }
+
+        dispose((disposable_t*)&expected);
+    }
+
+    void check_algorithm(uint32_t algorithm)
+    {
+        vccrypt_hash_options_t options;
+
+        ASSERT_EQ(0,
+            vccrypt_hash_options_init(&options, &alloc_opts, algorithm));
+
+        check_oneshot(&options);
+
+        dispose((disposable_t*)&options);
+    }
+
+    allocator_options_t alloc_opts;
+    uint8_t msg[300];
+};
+
+/**
+ * One-shot SHA-256 matches hashing with a hash instance.
+ */
+TEST_F(vccrypt_hash_oneshot_test, sha_256)
+{
+    check_algorithm(VCCRYPT_HASH_ALGORITHM_SHA_2_256);
+}
+
+/**
+ * One-shot SHA-384 matches hashing with a hash instance.
+ */
+TEST_F(vccrypt_hash_oneshot_test, sha_384)
+{
+    check_algorithm(VCCRYPT_HASH_ALGORITHM_SHA_2_384);
+}
+
+/**
+ * One-shot SHA-512 matches hashing with a hash instance.
+ */
+TEST_F(vccrypt_hash_oneshot_test, sha_512)
+{
+    check_algorithm(VCCRYPT_HASH_ALGORITHM_SHA_2_512);
+}
+
+/**
+ * One-shot SHA-512/224 matches hashing with a hash instance.
+ */
+TEST_F(vccrypt_hash_oneshot_test, sha_512_224)
+{
+    check_algorithm(VCCRYPT_HASH_ALGORITHM_SHA_2_512_224);
+}
+
+/**
+ * One-shot SHA-512/256 matches hashing with a hash instance.
+ */
+TEST_F(vccrypt_hash_oneshot_test, sha_512_256)
+{
+    check_algorithm(VCCRYPT_HASH_ALGORITHM_SHA_2_512_256);
+}
+
+/**
+ * Algorithms without a one-shot implementation use a hash instance.
+ */
+TEST_F(vccrypt_hash_oneshot_test, generic_fallback)
+{
+    vccrypt_hash_options_t options;
+
+    ASSERT_EQ(0,
+        vccrypt_hash_options_init(&options, &alloc_opts,
+            VCCRYPT_HASH_ALGORITHM_SHA_2_512));
+
+    options.vccrypt_hash_alg_oneshot = NULL;
+
+    check_oneshot(&options);
+
+    dispose((disposable_t*)&options);
+}
+
+/**
+ * Bad arguments are rejected.
+ */
+TEST_F(vccrypt_hash_oneshot_test, invalid_args)
+{
+    vccrypt_hash_options_t options;
+    uint8_t md[64];
+
+    ASSERT_EQ(0,
+        vccrypt_hash_options_init(&options, &alloc_opts,
+            VCCRYPT_HASH_ALGORITHM_SHA_2_512));
+
+    EXPECT_EQ(VCCRYPT_ERROR_HASH_ONESHOT_INVALID_ARG,
+        vccrypt_hash_oneshot(NULL, msg, sizeof(msg), md, sizeof(md)));
+    EXPECT_EQ(VCCRYPT_ERROR_HASH_ONESHOT_INVALID_ARG,
+        vccrypt_hash_oneshot(&options, NULL, 1, md, sizeof(md)));
+    EXPECT_EQ(VCCRYPT_ERROR_HASH_ONESHOT_INVALID_ARG,
+        vccrypt_hash_oneshot(&options, msg, sizeof(msg), NULL, sizeof(md)));
+    EXPECT_EQ(VCCRYPT_ERROR_HASH_ONESHOT_INVALID_ARG,
+        vccrypt_hash_oneshot(&options, msg, sizeof(msg), md, sizeof(md) - 1));
+
+    dispose((disposable_t*)&options);
+}
@@ -0,0 +1,157 @@
+/**
+ * \file test_vccrypt_sha256_ref.cpp
+ *
+ * Unit tests for the reference SHA-256 implementation.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <gtest/gtest.h>
+#include <vccrypt/hash.h>
+#include <vpr/allocator/malloc_allocator.h>
+
+class vccrypt_sha256_ref_test : public ::testing::Test {
+protected:
+    void SetUp() override
+    {
+        //make sure SHA-256 has been registered
+        vccrypt_hash_register_SHA_2_256();
+
+        malloc_allocator_options_init(&alloc_opts);
+    }
+
+    void TearDown() override
+    {
+        dispose((disposable_t*)&alloc_opts);
+    }
+
+    allocator_options_t alloc_opts;
+};
+
+/**
+ * We should be able to get SHA-256 options if it has been registered.
+ */
+TEST_F(vccrypt_sha256_ref_test, init)
+{
+    vccrypt_hash_options_t options;
+
+    ASSERT_EQ(0,
+        vccrypt_hash_options_init(&options, &alloc_opts,
+            VCCRYPT_HASH_ALGORITHM_SHA_2_256));
+
+    dispose((disposable_t*)&options);
+}
+
+/**
+ * We should be able to create a hash context.
+ */
+TEST_F(vccrypt_sha256_ref_test, context_init)
+{
+    vccrypt_hash_options_t options;
+    vccrypt_hash_context_t context;
+
+    ASSERT_EQ(0,
+        vccrypt_hash_options_init(&options, &alloc_opts,
+            VCCRYPT_HASH_ALGORITHM_SHA_2_256));
+
+    ASSERT_EQ(0,
+        vccrypt_hash_init(&options, &context));
+
+    dispose((disposable_t*)&context);
+    dispose((disposable_t*)&options);
+}
+
+/**
+ * The SHA-256 state is kept inline in the hash context.
+ */
+TEST_F(vccrypt_sha256_ref_test, context_state_inline)
+{
+    vccrypt_hash_options_t options;
+    vccrypt_hash_context_t context;
+
+    ASSERT_EQ(0,
+        vccrypt_hash_options_init(&options, &alloc_opts,
+            VCCRYPT_HASH_ALGORITHM_SHA_2_256));
+
+    ASSERT_EQ(0,
+        vccrypt_hash_init(&options, &context));
+
+    EXPECT_EQ((void*)context.hash_state_inline, context.hash_state);
+
+    dispose((disposable_t*)&context);
+    dispose((disposable_t*)&options);
+}
+
+/**
+ * We should be able to hash test vector 1.
+ */
+TEST_F(vccrypt_sha256_ref_test, hash_1)
+{
+    const char INPUT[] =
+        "abc";
+    const char EXPECTED_HASH[] =
+        "\xba\x78\x16\xbf\x8f\x01\xcf\xea\x41\x41\x40\xde\x5d\xae\x22\x23"
+        "\xb0\x03\x61\xa3\x96\x17\x7a\x9c\xb4\x10\xff\x61\xf2\x00\x15\xad";
+    vccrypt_hash_options_t options;
+    vccrypt_hash_context_t context;
+    vccrypt_buffer_t md;
+
+    ASSERT_EQ(0,
+        vccrypt_hash_options_init(&options, &alloc_opts,
+            VCCRYPT_HASH_ALGORITHM_SHA_2_256));
+
+    ASSERT_EQ(0,
+        vccrypt_buffer_init(&md, &alloc_opts, options.hash_size));
+
+    ASSERT_EQ(0,
+        vccrypt_hash_init(&options, &context));
+
+    ASSERT_EQ(0,
+        vccrypt_hash_digest(&context, (const uint8_t*)INPUT, sizeof(INPUT) - 1));
+
+    ASSERT_EQ(0,
+        vccrypt_hash_finalize(&context, &md));
+
+    ASSERT_EQ(0, memcmp(md.data, EXPECTED_HASH, 32));
+
+    dispose((disposable_t*)&context);
+    dispose((disposable_t*)&md);
+    dispose((disposable_t*)&options);
+}
+
+/**
+ * We should be able to hash test vector 2.
+ */
+TEST_F(vccrypt_sha256_ref_test, hash_2)
+{
+    const char INPUT[] =
+        "abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq";
+    const char EXPECTED_HASH[] =
+        "\x24\x8d\x6a\x61\xd2\x06\x38\xb8\xe5\xc0\x26\x93\x0c\x3e\x60\x39"
+        "\xa3\x3c\xe4\x59\x64\xff\x21\x67\xf6\xec\xed\xd4\x19\xdb\x06\xc1";
+    vccrypt_hash_options_t options;
+    vccrypt_hash_context_t context;
+    vccrypt_buffer_t md;
+
+    ASSERT_EQ(0,
+        vccrypt_hash_options_init(&options, &alloc_opts,
+            VCCRYPT_HASH_ALGORITHM_SHA_2_256));
+
+    ASSERT_EQ(0,
+        vccrypt_buffer_init(&md, &alloc_opts, options.hash_size));
+
+    ASSERT_EQ(0,
+        vccrypt_hash_init(&options, &context));
+
+    ASSERT_EQ(0,
+        vccrypt_hash_digest(&context, (const uint8_t*)INPUT, sizeof(INPUT) - 1));
+
+    ASSERT_EQ(0,
+        vccrypt_hash_finalize(&context, &md));
+
+    ASSERT_EQ(0, memcmp(md.data, EXPECTED_HASH, 32));
+
+    dispose((disposable_t*)&context);
+    dispose((disposable_t*)&md);
+    dispose((disposable_t*)&options);
+}
@@ -0,0 +1,158 @@
+/**
+ * \file test_vccrypt_sha512_224_ref.cpp
+ *
+ * Unit tests for the reference SHA-512/224 implementation.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <gtest/gtest.h>
+#include <vccrypt/hash.h>
+#include <vpr/allocator/malloc_allocator.h>
+
+class vccrypt_sha512_224_ref_test : public ::testing::Test {
+protected:
+    void SetUp() override
+    {
+        //make sure SHA-512/224 has been registered
+        vccrypt_hash_register_SHA_2_512_224();
+
+        malloc_allocator_options_init(&alloc_opts);
+    }
+
+    void TearDown() override
+    {
+        dispose((disposable_t*)&alloc_opts);
+    }
+
+    allocator_options_t alloc_opts;
+};
+
+/**
+ * We should be able to get SHA-512/224 options if it has been registered.
+ */
+TEST_F(vccrypt_sha512_224_ref_test, init)
+{
+    vccrypt_hash_options_t options;
+
+    ASSERT_EQ(0,
+        vccrypt_hash_options_init(&options, &alloc_opts,
+            VCCRYPT_HASH_ALGORITHM_SHA_2_512_224));
+
+    dispose((disposable_t*)&options);
+}
+
+/**
+ * We should be able to create a hash context.
+ */
+TEST_F(vccrypt_sha512_224_ref_test, context_init)
+{
+    vccrypt_hash_options_t options;
+    vccrypt_hash_context_t context;
+
+    ASSERT_EQ(0,
+        vccrypt_hash_options_init(&options, &alloc_opts,
+            VCCRYPT_HASH_ALGORITHM_SHA_2_512_224));
+
+    ASSERT_EQ(0,
+        vccrypt_hash_init(&options, &context));
+
+    dispose((disposable_t*)&context);
+    dispose((disposable_t*)&options);
+}
+
+/**
+ * The SHA-512/224 state is kept inline in the hash context.
+ */
+TEST_F(vccrypt_sha512_224_ref_test, context_state_inline)
+{
+    vccrypt_hash_options_t options;
+    vccrypt_hash_context_t context;
+
+    ASSERT_EQ(0,
+        vccrypt_hash_options_init(&options, &alloc_opts,
+            VCCRYPT_HASH_ALGORITHM_SHA_2_512_224));
+
+    ASSERT_EQ(0,
+        vccrypt_hash_init(&options, &context));
+
+    EXPECT_EQ((void*)context.hash_state_inline, context.hash_state);
+
+    dispose((disposable_t*)&context);
+    dispose((disposable_t*)&options);
+}
+
+/**
+ * We should be able to hash test vector 1.
+ */
+TEST_F(vccrypt_sha512_224_ref_test, hash_1)
+{
+    const char INPUT[] =
+        "abc";
+    const char EXPECTED_HASH[] =
+        "\x46\x34\x27\x0f\x70\x7b\x6a\x54\xda\xae\x75\x30\x46\x08\x42\xe2"
+        "\x0e\x37\xed\x26\x5c\xee\xe9\xa4\x3e\x89\x24\xaa";
+    vccrypt_hash_options_t options;
+    vccrypt_hash_context_t context;
+    vccrypt_buffer_t md;
+
+    ASSERT_EQ(0,
+        vccrypt_hash_options_init(&options, &alloc_opts,
+            VCCRYPT_HASH_ALGORITHM_SHA_2_512_224));
+
+    ASSERT_EQ(0,
+        vccrypt_buffer_init(&md, &alloc_opts, options.hash_size));
+
+    ASSERT_EQ(0,
+        vccrypt_hash_init(&options, &context));
+
+    ASSERT_EQ(0,
+        vccrypt_hash_digest(&context, (const uint8_t*)INPUT, sizeof(INPUT) - 1));
+
+    ASSERT_EQ(0,
+        vccrypt_hash_finalize(&context, &md));
+
+    ASSERT_EQ(0, memcmp(md.data, EXPECTED_HASH, 28));
+
+    dispose((disposable_t*)&context);
+    dispose((disposable_t*)&md);
+    dispose((disposable_t*)&options);
+}
+
+/**
+ * We should be able to hash test vector 2.
+ */
+TEST_F(vccrypt_sha512_224_ref_test, hash_2)
+{
+    const char INPUT[] =
+        "abcdefghbcdefghicdefghijdefghijkefghijklfghijklmghijklmn"
+        "hijklmnoijklmnopjklmnopqklmnopqrlmnopqrsmnopqrstnopqrstu";
+    const char EXPECTED_HASH[] =
+        "\x23\xfe\xc5\xbb\x94\xd6\x0b\x23\x30\x81\x92\x64\x0b\x0c\x45\x33"
+        "\x35\xd6\x64\x73\x4f\xe4\x0e\x72\x68\x67\x4a\xf9";
+    vccrypt_hash_options_t options;
+    vccrypt_hash_context_t context;
+    vccrypt_buffer_t md;
+
+    ASSERT_EQ(0,
+        vccrypt_hash_options_init(&options, &alloc_opts,
+            VCCRYPT_HASH_ALGORITHM_SHA_2_512_224));
+
+    ASSERT_EQ(0,
+        vccrypt_buffer_init(&md, &alloc_opts, options.hash_size));
+
+    ASSERT_EQ(0,
+        vccrypt_hash_init(&options, &context));
+
+    ASSERT_EQ(0,
+        vccrypt_hash_digest(&context, (const uint8_t*)INPUT, sizeof(INPUT) - 1));
+
+    ASSERT_EQ(0,
+        vccrypt_hash_finalize(&context, &md));
+
+    ASSERT_EQ(0, memcmp(md.data, EXPECTED_HASH, 28));
+
+    dispose((disposable_t*)&context);
+    dispose((disposable_t*)&md);
+    dispose((disposable_t*)&options);
+}
@@ -61,6 +61,27 @@ TEST_F(vccrypt_sha512_ref_test, context_init)
     dispose((disposable_t*)&options);
 }
 
+/**
+ * The SHA-512 state is kept inline in the hash context.
+ */
+TEST_F(vccrypt_sha512_ref_test, context_state_inline)
+{
+    vccrypt_hash_options_t options;
+    vccrypt_hash_context_t context;
+
+    ASSERT_EQ(0,
+        vccrypt_hash_options_init(&options, &alloc_opts,
+            VCCRYPT_HASH_ALGORITHM_SHA_2_512));
+
+    ASSERT_EQ(0,
+        vccrypt_hash_init(&options, &context));
+
+    EXPECT_EQ((void*)context.hash_state_inline, context.hash_state);
+
+    dispose((disposable_t*)&context);
+    dispose((disposable_t*)&options);
+}
+
 /**
  * We should be able to hash an empty buffer.
  */
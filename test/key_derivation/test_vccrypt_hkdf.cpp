@@ -0,0 +1,340 @@
+/**
+ * \file test_vccrypt_hkdf.cpp
+ *
+ * Unit tests for hkdf
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <gtest/gtest.h>
+#include <string.h>
+#include <vpr/parameters.h>
+#include <vpr/allocator/malloc_allocator.h>
+#include <vccrypt/key_derivation.h>
+#include <vccrypt/mac.h>
+#include <vector>
+
+using namespace std;
+
+class vccrypt_hkdf_test : public ::testing::Test {
+protected:
+    void SetUp() override
+    {
+        //make sure our key derivation algorithms have been registered
+        vccrypt_key_derivation_register_hkdf();
+        vccrypt_key_derivation_register_pbkdf2();
+
+        malloc_allocator_options_init(&alloc_opts);
+    }
+
+    void TearDown() override
+    {
+        dispose((disposable_t*)&alloc_opts);
+    }
+
+    /**
+     * Decode a hex string.
+     */
+    static vector<uint8_t> from_hex(const char* hex)
+    {
+        vector<uint8_t> out;
+
+        for (size_t i = 0; hex[i] && hex[i + 1]; i += 2)
+        {
+            char byte[3] = { hex[i], hex[i + 1], 0 };
+            out.push_back((uint8_t)strtoul(byte, NULL, 16));
+        }
+
+        return out;
+    }
+
+    /**
+     * Return the bytes first, first + 1, ..., last - 1.
+     */
+    static vector<uint8_t> range(int first, int last)
+    {
+        vector<uint8_t> out;
+
+        for (int i = first; i < last; ++i)
+        {
+            out.push_back((uint8_t)i);
+        }
+
+        return out;
+    }
+
+    /**
+     * Initialize a buffer holding a copy of the given bytes.
+     */
+    void buffer_from(vccrypt_buffer_t* buffer, const vector<uint8_t>& bytes)
+    {
+        ASSERT_EQ(0,
+            vccrypt_buffer_init(buffer, &alloc_opts, bytes.size()));
+        memcpy(buffer->data, bytes.data(), bytes.size());
+    }
+
+    /**
+     * Check extract and expand against a known answer.
+     */
+    void hkdf_test(
+        uint32_t hmac_algorithm, const vector<uint8_t>& ikm,
+        const vector<uint8_t>& salt, const vector<uint8_t>& info,
+        const char* expected_prk, const char* expected_okm)
+    {
+        vccrypt_key_derivation_options_t options;
+        vccrypt_key_derivation_context_t context;
+        vccrypt_buffer_t ikm_buffer, salt_buffer, info_buffer;
+        vccrypt_buffer_t prk, okm;
+        vector<uint8_t> prk_bytes = from_hex(expected_prk);
+        vector<uint8_t> okm_bytes = from_hex(expected_okm);
+
+        ASSERT_EQ(0,
+            vccrypt_key_derivation_options_init(
+                &options, &alloc_opts,
+                VCCRYPT_KEY_DERIVATION_ALGORITHM_HKDF, hmac_algorithm));
+        ASSERT_EQ(0, vccrypt_key_derivation_init(&context, &options));
+
+        buffer_from(&ikm_buffer, ikm);
+        buffer_from(&salt_buffer, salt);
+        buffer_from(&info_buffer, info);
+        ASSERT_EQ(0,
+            vccrypt_buffer_init(
+                &prk, &alloc_opts, options.hmac_digest_length));
+        ASSERT_EQ(0,
+            vccrypt_buffer_init(&okm, &alloc_opts, okm_bytes.size()));
+
+        ASSERT_EQ(0,
+            vccrypt_key_derivation_extract(
+                &prk, &context, &ikm_buffer,
+                salt.empty() ? NULL : &salt_buffer));
+        ASSERT_EQ(prk_bytes.size(), prk.size);
+        EXPECT_EQ(0, memcmp(prk_bytes.data(), prk.data, prk.size));
+
+        ASSERT_EQ(0,
+            vccrypt_key_derivation_expand(
+                &okm, &context, &prk, info.empty() ? NULL : &info_buffer));
+        EXPECT_EQ(0, memcmp(okm_bytes.data(), okm.data, okm.size));
+
+        dispose((disposable_t*)&okm);
+        dispose((disposable_t*)&prk);
+        dispose((disposable_t*)&info_buffer);
+        dispose((disposable_t*)&salt_buffer);
+        dispose((disposable_t*)&ikm_buffer);
+        dispose((disposable_t*)&context);
+        dispose((disposable_t*)&options);
+    }
+
+    allocator_options_t alloc_opts;
+};
+
+/**
+ * We should be able to get hkdf options and create an instance.
+ */
+TEST_F(vccrypt_hkdf_test, init)
+{
+    vccrypt_key_derivation_options_t options;
+    vccrypt_key_derivation_context_t context;
+
+    ASSERT_EQ(0,
+        vccrypt_key_derivation_options_init(
+            &options, &alloc_opts,
+            VCCRYPT_KEY_DERIVATION_ALGORITHM_HKDF,
+            VCCRYPT_MAC_ALGORITHM_SHA_2_512_HMAC));
+
+    EXPECT_EQ(64u, options.hmac_digest_length);
+
+    ASSERT_EQ(0, vccrypt_key_derivation_init(&context, &options));
+
+    dispose((disposable_t*)&context);
+    dispose((disposable_t*)&options);
+}
+
+/**
+ * RFC 5869 test case 1: basic test case with SHA-256.
+ */
+TEST_F(vccrypt_hkdf_test, rfc5869_test_case_1)
+{
+    hkdf_test(
+        VCCRYPT_MAC_ALGORITHM_SHA_2_256_HMAC,
+        vector<uint8_t>(22, 0x0b), range(0x00, 0x0d), range(0xf0, 0xfa),
+        "077709362c2e32df0ddc3f0dc47bba63"
+        "90b6c73bb50f9c3122ec844ad7c2b3e5",
+        "3cb25f25faacd57a90434f64d0362f2a"
+        "2d2d0a90cf1a5a4c5db02d56ecc4c5bf"
+        "34007208d5b887185865");
+}
+
+/**
+ * RFC 5869 test case 2: longer inputs and outputs with SHA-256.
+ */
+TEST_F(vccrypt_hkdf_test, rfc5869_test_case_2)
+{
+    hkdf_test(
+        VCCRYPT_MAC_ALGORITHM_SHA_2_256_HMAC,
+        range(0x00, 0x50), range(0x60, 0xb0), range(0xb0, 0x100),
+        "06a6b88c5853361a06104c9ceb35b45c"
+        "ef760014904671014a193f40c15fc244",
+        "b11e398dc80327a1c8e7f78c596a4934"
+        "4f012eda2d4efad8a050cc4c19afa97c"
+        "59045a99cac7827271cb41c65e590e09"
+        "da3275600c2f09b8367793a9aca3db71"
+        "cc30c58179ec3e87c14c01d5c1f3434f"
+        "1d87");
+}
+
+/**
+ * RFC 5869 test case 3: zero-length salt and info with SHA-256.
+ */
+TEST_F(vccrypt_hkdf_test, rfc5869_test_case_3)
+{
+    hkdf_test(
+        VCCRYPT_MAC_ALGORITHM_SHA_2_256_HMAC,
+        vector<uint8_t>(22, 0x0b), vector<uint8_t>(), vector<uint8_t>(),
+        "19ef24a32c717b167f33a91d6f648bdf"
+        "96596776afdb6377ac434c1c293ccb04",
+        "8da4e775a563c18f715f802a063c5a31"
+        "b8a11f5c5ee1879ec3454e5f3c738d2d"
+        "9d201395faa4b61a96c8");
+}
+
+/**
+ * The RFC 5869 test case 1 inputs with HMAC-SHA-512.
+ */
+TEST_F(vccrypt_hkdf_test, sha512_basic)
+{
+    hkdf_test(
+        VCCRYPT_MAC_ALGORITHM_SHA_2_512_HMAC,
+        vector<uint8_t>(22, 0x0b), range(0x00, 0x0d), range(0xf0, 0xfa),
+        "665799823737ded04a88e47e54a5890b"
+        "b2c3d247c7a4254a8e61350723590a26"
+        "c36238127d8661b88cf80ef802d57e2f"
+        "7cebcf1e00e083848be19929c61b4237",
+        "832390086cda71fb47625bb5ceb168e4"
+        "c8e26a1a16ed34d9fc7fe92c14815793"
+        "38da362cb8d9f925d7cb");
+}
+
+/**
+ * The RFC 5869 test case 2 inputs with HMAC-SHA-512, over several blocks.
+ */
+TEST_F(vccrypt_hkdf_test, sha512_long)
+{
+    hkdf_test(
+        VCCRYPT_MAC_ALGORITHM_SHA_2_512_HMAC,
+        range(0x00, 0x50), range(0x60, 0xb0), range(0xb0, 0x100),
+        "35672542907d4e142c00e84499e74e1d"
+        "e08be86535f924e022804ad775dde27e"
+        "c86cd1e5b7d178c74489bdbeb30712be"
+        "b82d4f97416c5a94ea81ebdf3e629e4a",
+        "ce6c97192805b346e6161e821ed16567"
+        "3b84f400a2b514b2fe23d84cd189ddf1"
+        "b695b48cbd1c8388441137b3ce28f16a"
+        "a64ba33ba466b24df6cfcb021ecff235"
+        "f6a2056ce3af1de44d572097a8505d9e"
+        "7a9354e5796284151c2dd39c39b3cd3d"
+        "8e50fcc383ebdec37476e03b721ef5ef"
+        "ef873c281f018b8ca42e1245b2271f87"
+        "1ba6585ee6b7c47ddf0e1e64685e87ea"
+        "b3e2b4df55874cc74d058879d2f22332"
+        "72d5e3ee660dcad82cb9c7018fb08928"
+        "7c0538612abe485010009d505e5062c6"
+        "e60beef755288e89");
+}
+
+/**
+ * derive_key extracts with the salt and expands with empty info.
+ */
+TEST_F(vccrypt_hkdf_test, derive_key)
+{
+    vccrypt_key_derivation_options_t options;
+    vccrypt_key_derivation_context_t context;
+    vccrypt_buffer_t pass, salt, okm;
+    vector<uint8_t> expected =
+        from_hex(
+            "8da4e775a563c18f715f802a063c5a31"
+            "b8a11f5c5ee1879ec3454e5f3c738d2d"
+            "9d201395faa4b61a96c8");
+
+    ASSERT_EQ(0,
+        vccrypt_key_derivation_options_init(
+            &options, &alloc_opts,
+            VCCRYPT_KEY_DERIVATION_ALGORITHM_HKDF,
+            VCCRYPT_MAC_ALGORITHM_SHA_2_256_HMAC));
+    ASSERT_EQ(0, vccrypt_key_derivation_init(&context, &options));
+
+    /* an explicit salt of HashLen zeros is the same as no salt. */
+    buffer_from(&pass, vector<uint8_t>(22, 0x0b));
+    buffer_from(&salt, vector<uint8_t>(32, 0x00));
+    ASSERT_EQ(0, vccrypt_buffer_init(&okm, &alloc_opts, expected.size()));
+
+    ASSERT_EQ(0,
+        vccrypt_key_derivation_derive_key(&okm, &context, &pass, &salt, 1));
+    EXPECT_EQ(0, memcmp(expected.data(), okm.data, okm.size));
+
+    dispose((disposable_t*)&okm);
+    dispose((disposable_t*)&salt);
+    dispose((disposable_t*)&pass);
+    dispose((disposable_t*)&context);
+    dispose((disposable_t*)&options);
+}
+
+/**
+ * Bad arguments are rejected, and PBKDF2 doesn't support extract and expand.
+ */
+TEST_F(vccrypt_hkdf_test, invalid_args)
+{
+    vccrypt_key_derivation_options_t options;
+    vccrypt_key_derivation_context_t context;
+    vccrypt_buffer_t ikm, prk, short_prk, okm;
+
+    ASSERT_EQ(0,
+        vccrypt_key_derivation_options_init(
+            &options, &alloc_opts,
+            VCCRYPT_KEY_DERIVATION_ALGORITHM_HKDF,
+            VCCRYPT_MAC_ALGORITHM_SHA_2_512_256_HMAC));
+    ASSERT_EQ(0, vccrypt_key_derivation_init(&context, &options));
+
+    buffer_from(&ikm, vector<uint8_t>(32, 0x42));
+    ASSERT_EQ(0, vccrypt_buffer_init(&prk, &alloc_opts, 32));
+    ASSERT_EQ(0, vccrypt_buffer_init(&short_prk, &alloc_opts, 31));
+
+    /* the PRK buffer must be exactly one digest. */
+    EXPECT_EQ(VCCRYPT_ERROR_KEY_DERIVATION_EXTRACT_INVALID_ARG,
+        vccrypt_key_derivation_extract(&short_prk, &context, &ikm, NULL));
+    EXPECT_EQ(VCCRYPT_ERROR_KEY_DERIVATION_EXTRACT_INVALID_ARG,
+        vccrypt_key_derivation_extract(&prk, &context, NULL, NULL));
+    ASSERT_EQ(0, vccrypt_key_derivation_extract(&prk, &context, &ikm, NULL));
+
+    /* at most 255 blocks may be expanded. */
+    ASSERT_EQ(0, vccrypt_buffer_init(&okm, &alloc_opts, 255 * 32 + 1));
+    EXPECT_EQ(VCCRYPT_ERROR_HKDF_INVALID_ARG,
+        vccrypt_key_derivation_expand(&okm, &context, &prk, NULL));
+    okm.size = 255 * 32;
+    EXPECT_EQ(0, vccrypt_key_derivation_expand(&okm, &context, &prk, NULL));
+    okm.size = 255 * 32 + 1;
+    EXPECT_EQ(VCCRYPT_ERROR_KEY_DERIVATION_EXPAND_INVALID_ARG,
+        vccrypt_key_derivation_expand(&okm, &context, NULL, NULL));
+
+    dispose((disposable_t*)&context);
+    dispose((disposable_t*)&options);
+
+    /* PBKDF2 has no extract or expand step. */
+    ASSERT_EQ(0,
+        vccrypt_key_derivation_options_init(
+            &options, &alloc_opts,
+            VCCRYPT_KEY_DERIVATION_ALGORITHM_PBKDF2,
+            VCCRYPT_MAC_ALGORITHM_SHA_2_512_256_HMAC));
+    ASSERT_EQ(0, vccrypt_key_derivation_init(&context, &options));
+
+    EXPECT_EQ(VCCRYPT_ERROR_KEY_DERIVATION_EXTRACT_INVALID_ARG,
+        vccrypt_key_derivation_extract(&prk, &context, &ikm, NULL));
+    EXPECT_EQ(VCCRYPT_ERROR_KEY_DERIVATION_EXPAND_INVALID_ARG,
+        vccrypt_key_derivation_expand(&okm, &context, &prk, NULL));
+
+    dispose((disposable_t*)&context);
+    dispose((disposable_t*)&options);
+    dispose((disposable_t*)&okm);
+    dispose((disposable_t*)&short_prk);
+    dispose((disposable_t*)&prk);
+    dispose((disposable_t*)&ikm);
+}
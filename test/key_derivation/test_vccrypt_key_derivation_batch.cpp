@@ -0,0 +1,221 @@
+/**
+ * \file test_vccrypt_key_derivation_batch.cpp
+ *
+ * Unit tests for batch key derivation.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <gtest/gtest.h>
+#include <string.h>
+#include <vccrypt/key_derivation.h>
+#include <vccrypt/mac.h>
+#include <vpr/allocator/malloc_allocator.h>
+#include <vector>
+
+class vccrypt_key_derivation_batch_test : public ::testing::Test {
+protected:
+    void SetUp() override
+    {
+        vccrypt_key_derivation_register_pbkdf2();
+        vccrypt_key_derivation_register_hkdf();
+
+        malloc_allocator_options_init(&alloc_opts);
+
+        /* password sizes around the block size, where long keys are hashed,
+         * and key sizes that take from one to five output blocks. */
+        const size_t pass_sizes[] = { 1, 8, 64, 127, 128, 129, 200 };
+        const size_t key_sizes[] = { 16, 32, 64, 96, 100, 128, 160, 300 };
+        const size_t pass_count = sizeof(pass_sizes) / sizeof(pass_sizes[0]);
+        const size_t key_count = sizeof(key_sizes) / sizeof(key_sizes[0]);
+
+        /* enough items for several groups of derivations. */
+        for (size_t i = 0; i < 37; ++i)
+        {
+            vccrypt_buffer_t pass, salt;
+            size_t pass_size = pass_sizes[i % pass_count];
+            size_t salt_size = 1 + (i * 11) % 40;
+
+            EXPECT_EQ(0, vccrypt_buffer_init(&pass, &alloc_opts, pass_size));
+            for (size_t j = 0; j < pass_size; ++j)
+            {
+                ((uint8_t*)pass.data)[j] = (uint8_t)(i * 7 + j * 13 + 1);
+            }
+            passes.push_back(pass);
+
+            EXPECT_EQ(0, vccrypt_buffer_init(&salt, &alloc_opts, salt_size));
+            for (size_t j = 0; j < salt_size; ++j)
+            {
+                ((uint8_t*)salt.data)[j] = (uint8_t)(i * 31 + j * 17);
+            }
+            salts.push_back(salt);
+
+            key_lengths.push_back(key_sizes[i % key_count]);
+        }
+    }
+
+    void TearDown() override
+    {
+        for (size_t i = 0; i < passes.size(); ++i)
+        {
+            dispose((disposable_t*)&passes[i]);
+            dispose((disposable_t*)&salts[i]);
+        }
+
+        dispose((disposable_t*)&alloc_opts);
+    }
+
+    /**
+     * Check that a batch derives the same keys as deriving each on its own.
+     */
+    void check_batch(
+        vccrypt_key_derivation_options_t* options, unsigned int rounds)
+    {
+        vccrypt_key_derivation_context_t context;
+        std::vector<vccrypt_buffer_t> batch(passes.size());
+
+        ASSERT_EQ(0, vccrypt_key_derivation_init(&context, options));
+
+        for (size_t i = 0; i < passes.size(); ++i)
+        {
+            ASSERT_EQ(0,
+                vccrypt_buffer_init(&batch[i], &alloc_opts, key_lengths[i]));
+        }
+
+        ASSERT_EQ(0,
+            vccrypt_key_derivation_derive_key_batch(
+                batch.data(), &context, passes.data(), salts.data(),
+                passes.size(), rounds));
+
+        for (size_t i = 0; i < passes.size(); ++i)
+        {
+            vccrypt_buffer_t single;
+
+            ASSERT_EQ(0,
+                vccrypt_buffer_init(&single, &alloc_opts, key_lengths[i]));
+            ASSERT_EQ(0,
+                vccrypt_key_derivation_derive_key(
+                    &single, &context, &passes[i], &salts[i], rounds));
+
+            EXPECT_EQ(0, memcmp(single.data, batch[i].data, single.size))
+                << "pass size = " << passes[i].size
+                << ", key size = " << single.size;
+
+            dispose((disposable_t*)&single);
+            dispose((disposable_t*)&batch[i]);
+        }
+
+        dispose((disposable_t*)&context);
+    }
+
+    allocator_options_t alloc_opts;
+    std::vector<vccrypt_buffer_t> passes;
+    std::vector<vccrypt_buffer_t> salts;
+    std::vector<size_t> key_lengths;
+};
+
+/**
+ * A PBKDF2 HMAC-SHA-512 batch matches deriving each key on its own.
+ */
+TEST_F(vccrypt_key_derivation_batch_test, pbkdf2_sha_512)
+{
+    vccrypt_key_derivation_options_t options;
+
+    ASSERT_EQ(0,
+        vccrypt_key_derivation_options_init(
+            &options, &alloc_opts, VCCRYPT_KEY_DERIVATION_ALGORITHM_PBKDF2,
+            VCCRYPT_MAC_ALGORITHM_SHA_2_512_HMAC));
+
+    check_batch(&options, 1);
+    check_batch(&options, 100);
+
+    dispose((disposable_t*)&options);
+}
+
+/**
+ * A PBKDF2 HMAC-SHA-512/256 batch matches deriving each key on its own.
+ */
+TEST_F(vccrypt_key_derivation_batch_test, pbkdf2_sha_512_256)
+{
+    vccrypt_key_derivation_options_t options;
+
+    ASSERT_EQ(0,
+        vccrypt_key_derivation_options_init(
+            &options, &alloc_opts, VCCRYPT_KEY_DERIVATION_ALGORITHM_PBKDF2,
+            VCCRYPT_MAC_ALGORITHM_SHA_2_512_256_HMAC));
+
+    check_batch(&options, 1);
+    check_batch(&options, 100);
+
+    dispose((disposable_t*)&options);
+}
+
+/**
+ * Algorithms without a batch implementation derive each key in turn.
+ */
+TEST_F(vccrypt_key_derivation_batch_test, generic_fallback)
+{
+    vccrypt_key_derivation_options_t options;
+
+    ASSERT_EQ(0,
+        vccrypt_key_derivation_options_init(
+            &options, &alloc_opts, VCCRYPT_KEY_DERIVATION_ALGORITHM_HKDF,
+            VCCRYPT_MAC_ALGORITHM_SHA_2_512_HMAC));
+
+    EXPECT_EQ(NULL, options.vccrypt_key_derivation_alg_derive_key_batch);
+
+    check_batch(&options, 1);
+
+    dispose((disposable_t*)&options);
+}
+
+/**
+ * An empty batch succeeds, and bad arguments are rejected.
+ */
+TEST_F(vccrypt_key_derivation_batch_test, invalid_args)
+{
+    vccrypt_key_derivation_options_t options;
+    vccrypt_key_derivation_context_t context;
+    vccrypt_buffer_t keys[2];
+
+    ASSERT_EQ(0,
+        vccrypt_key_derivation_options_init(
+            &options, &alloc_opts, VCCRYPT_KEY_DERIVATION_ALGORITHM_PBKDF2,
+            VCCRYPT_MAC_ALGORITHM_SHA_2_512_HMAC));
+    ASSERT_EQ(0, vccrypt_key_derivation_init(&context, &options));
+    ASSERT_EQ(0, vccrypt_buffer_init(&keys[0], &alloc_opts, 64));
+    ASSERT_EQ(0, vccrypt_buffer_init(&keys[1], &alloc_opts, 64));
+
+    EXPECT_EQ(0,
+        vccrypt_key_derivation_derive_key_batch(
+            NULL, &context, NULL, NULL, 0, 1));
+    EXPECT_EQ(VCCRYPT_ERROR_KEY_DERIVATION_DERIVE_KEY_BATCH_INVALID_ARG,
+        vccrypt_key_derivation_derive_key_batch(
+            keys, NULL, passes.data(), salts.data(), 2, 1));
+    EXPECT_EQ(VCCRYPT_ERROR_KEY_DERIVATION_DERIVE_KEY_BATCH_INVALID_ARG,
+        vccrypt_key_derivation_derive_key_batch(
+            keys, &context, passes.data(), salts.data(), 2, 0));
+    EXPECT_EQ(VCCRYPT_ERROR_KEY_DERIVATION_DERIVE_KEY_BATCH_INVALID_ARG,
+        vccrypt_key_derivation_derive_key_batch(
+            keys, &context, NULL, salts.data(), 2, 1));
+
+    /* an empty salt is rejected. */
+    size_t salt_size = salts[1].size;
+    salts[1].size = 0;
+    EXPECT_EQ(VCCRYPT_ERROR_KEY_DERIVATION_DERIVE_KEY_BATCH_INVALID_ARG,
+        vccrypt_key_derivation_derive_key_batch(
+            keys, &context, passes.data(), salts.data(), 2, 1));
+    salts[1].size = salt_size;
+
+    /* an empty key is rejected. */
+    keys[1].size = 0;
+    EXPECT_EQ(VCCRYPT_ERROR_KEY_DERIVATION_DERIVE_KEY_BATCH_INVALID_ARG,
+        vccrypt_key_derivation_derive_key_batch(
+            keys, &context, passes.data(), salts.data(), 2, 1));
+    keys[1].size = 64;
+
+    dispose((disposable_t*)&keys[0]);
+    dispose((disposable_t*)&keys[1]);
+    dispose((disposable_t*)&context);
+    dispose((disposable_t*)&options);
+}
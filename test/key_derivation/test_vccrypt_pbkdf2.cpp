@@ -16,7 +16,7 @@
 
 static void key_derivation_test(allocator_options_t* alloc_opts,
     uint32_t hmac_algorithm, const char* password, const char* salt,
-    int iterations, const char* expected);
+    int iterations, const char* expected, size_t key_len = 0);
 
 static void to_hex(uint8_t vals[], size_t vals_len, char** hex);
 
@@ -351,15 +351,133 @@ TEST_F(vccrypt_pbkdf2_test, sha512_256_test_vector_1)
 }
 
 
+/**
+ * Keys longer than one digest compute their output blocks together.  The
+ * expected values were generated with Python's hashlib.pbkdf2_hmac.
+ */
+TEST_F(vccrypt_pbkdf2_test, sha512_long_key)
+{
+    const char* password = "password";
+
+    const char* salt = "salt";
+
+    /* four blocks, the last one partial. */
+    const char* expected = "0x"
+                           "AFE6C5530785B6CC"
+                           "6B1C6453384731BD"
+                           "5EE432EE549FD42F"
+                           "B6695779AD8A1C5B"
+                           "F59DE69C48F774EF"
+                           "C4007D5298F9033C"
+                           "0241D5AB69305E7B"
+                           "64ECEEB8D834CFEC"
+                           "6AFDEC3C1C23982A"
+                           "121F2D4BE0088893"
+                           "78A49A0DFB104F0D"
+                           "2856E38F44271CDA"
+                           "F6DE434196647BC5"
+                           "673CD6C148611CED"
+                           "6E9003B65879FECC"
+                           "C89226ECC5E22090"
+                           "795445CC7314FCF4"
+                           "14878A42FFD39CD3"
+                           "B90DCD41E065E35B"
+                           "1EF75FEEA606C439"
+                           "B64BE622F790E1C4"
+                           "9C3D9147D307928E"
+                           "D5B1AB2C84CB34D2"
+                           "066A8947A325BCBA"
+                           "42D3F411FDBE3D23";
+
+    key_derivation_test(
+        &alloc_opts, VCCRYPT_MAC_ALGORITHM_SHA_2_512_HMAC, password, salt,
+        1000, expected, 200);
+}
+
+TEST_F(vccrypt_pbkdf2_test, sha512_256_long_key_1)
+{
+    const char* password = "password";
+
+    const char* salt = "salt";
+
+    /* a group of four blocks, then a single block. */
+    const char* expected = "0x"
+                           "F7E4FB1D98C78B61"
+                           "5F585F974AF8CD97"
+                           "651A244F4C500418"
+                           "9D136FED65652FA0"
+                           "0E3E2060276CBCEA"
+                           "9287202CF250CC5D"
+                           "8EAC09B6C015643F"
+                           "FBE177B53738350A"
+                           "487A6E7029E98A54"
+                           "EB29602EAB69895C"
+                           "BC7534CEB243699D"
+                           "2D0DBF5F0FCD353C"
+                           "4549192D2230AAFF"
+                           "55E73C09043FDCC3"
+                           "39D0AC1DB514E6E4"
+                           "B8DE2CE220BC2F57"
+                           "D042495BD4C19221"
+                           "61E5F5C287F0D1E0"
+                           "17F78EA9C578F80D"
+                           "6A44DD98E0255AD6";
+
+    key_derivation_test(
+        &alloc_opts, VCCRYPT_MAC_ALGORITHM_SHA_2_512_256_HMAC,
+        password, salt, 1000, expected, 160);
+}
+
+TEST_F(vccrypt_pbkdf2_test, sha512_256_long_key_2)
+{
+    const char* password = "password";
+
+    const char* salt = "salt";
+
+    /* a group of four blocks, then three, the last one partial. */
+    const char* expected = "0x"
+                           "F7E4FB1D98C78B61"
+                           "5F585F974AF8CD97"
+                           "651A244F4C500418"
+                           "9D136FED65652FA0"
+                           "0E3E2060276CBCEA"
+                           "9287202CF250CC5D"
+                           "8EAC09B6C015643F"
+                           "FBE177B53738350A"
+                           "487A6E7029E98A54"
+                           "EB29602EAB69895C"
+                           "BC7534CEB243699D"
+                           "2D0DBF5F0FCD353C"
+                           "4549192D2230AAFF"
+                           "55E73C09043FDCC3"
+                           "39D0AC1DB514E6E4"
+                           "B8DE2CE220BC2F57"
+                           "D042495BD4C19221"
+                           "61E5F5C287F0D1E0"
+                           "17F78EA9C578F80D"
+                           "6A44DD98E0255AD6"
+                           "1EC0C50EA001E54F"
+                           "CB454D6F0C9D9333"
+                           "719842EA0DD97F1B"
+                           "8EAAC5BEAA48981A"
+                           "B6C3E68A5CD4CD44";
+
+    key_derivation_test(
+        &alloc_opts, VCCRYPT_MAC_ALGORITHM_SHA_2_512_256_HMAC,
+        password, salt, 1000, expected, 200);
+}
+
+
 /**
  * Test utility function to DRY up matching against test vectors
  *
  * expected is optional.  if unknown, pass NULL and the test will simply
- * assert the derived key is not all 0's.
+ * assert the derived key is not all 0's.  key_len defaults to the digest
+ * length.
  */
 static void key_derivation_test(allocator_options_t* alloc_opts,
     uint32_t hmac_algorithm, const char* password, const char* salt,
-    int iterations, const char* expected)
+    int iterations, const char* expected, size_t key_len)
 {
     vccrypt_key_derivation_options_t options;
     vccrypt_key_derivation_context_t context;
@@ -392,7 +510,8 @@ static void key_derivation_test(allocator_options_t* alloc_opts,
     vccrypt_buffer_t dk_buffer;
     ASSERT_EQ(0,
         vccrypt_buffer_init(
-            &dk_buffer, alloc_opts, options.hmac_digest_length));
+            &dk_buffer, alloc_opts,
+            key_len ? key_len : options.hmac_digest_length));
 
     ASSERT_EQ(0,
         vccrypt_key_derivation_derive_key(&dk_buffer,
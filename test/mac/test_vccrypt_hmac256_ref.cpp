@@ -0,0 +1,479 @@
+/**
+ * \file test_vccrypt_hmac256_ref.cpp
+ *
+ * Unit tests for the reference HMAC-SHA-256 implementation.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <gtest/gtest.h>
+#include <vccrypt/mac.h>
+#include <vpr/allocator/malloc_allocator.h>
+
+class vccrypt_hmac256_ref_test : public ::testing::Test {
+protected:
+    void SetUp() override
+    {
+        //make sure HMAC-256 has been registered
+        vccrypt_mac_register_SHA_2_256_HMAC();
+
+        hmac_init_result =
+            vccrypt_mac_options_init(
+                &options, &alloc_opts,
+                VCCRYPT_MAC_ALGORITHM_SHA_2_256_HMAC);
+
+        malloc_allocator_options_init(&alloc_opts);
+
+        //create a dummy key
+        buffer_init_result =
+            vccrypt_buffer_init(&dummyKey, &alloc_opts, 32);
+        if (buffer_init_result == 0)
+            memset(dummyKey.data, 0, dummyKey.size);
+    }
+
+    void TearDown() override
+    {
+        if (buffer_init_result == 0)
+            dispose((disposable_t*)&dummyKey);
+
+        if (hmac_init_result == 0)
+            dispose((disposable_t*)&options);
+
+        dispose((disposable_t*)&alloc_opts);
+    }
+
+    int buffer_init_result;
+    int hmac_init_result;
+    vccrypt_mac_options_t options;
+    allocator_options_t alloc_opts;
+    vccrypt_buffer_t dummyKey;
+};
+
+/**
+ * HMAC-SHA-256 should have been successfully initialized.
+ */
+TEST_F(vccrypt_hmac256_ref_test, options_init)
+{
+    ASSERT_EQ(0, hmac_init_result);
+}
+
+/**
+ * We should be able to create an HMAC context.
+ */
+TEST_F(vccrypt_hmac256_ref_test, init)
+{
+    vccrypt_mac_context_t context;
+
+    ASSERT_EQ(0, vccrypt_mac_init(&options, &context, &dummyKey));
+
+    dispose((disposable_t*)&context);
+}
+
+/**
+ * We should be able to HMAC RFC-4231 Test Case 1.
+ */
+TEST_F(vccrypt_hmac256_ref_test, test_case_1)
+{
+    const uint8_t KEY[] = {
+        0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b,
+        0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b,
+        0x0b, 0x0b, 0x0b, 0x0b
+    };
+    const uint8_t DATA[] = {
+        0x48, 0x69, 0x20, 0x54, 0x68, 0x65, 0x72, 0x65
+    };
+    const uint8_t EXPECTED_HMAC[] = {
+        0xb0, 0x34, 0x4c, 0x61, 0xd8, 0xdb, 0x38, 0x53,
+        0x5c, 0xa8, 0xaf, 0xce, 0xaf, 0x0b, 0xf1, 0x2b,
+        0x88, 0x1d, 0xc2, 0x00, 0xc9, 0x83, 0x3d, 0xa7,
+        0x26, 0xe9, 0x37, 0x6c, 0x2e, 0x32, 0xcf, 0xf7
+    };
+
+    vccrypt_buffer_t keybuf, outbuf;
+    vccrypt_mac_context_t context;
+
+    //create key buffer
+    ASSERT_EQ(0, vccrypt_buffer_init(&keybuf, &alloc_opts, sizeof(KEY)));
+    memcpy(keybuf.data, KEY, sizeof(KEY));
+
+    //initialize MAC
+    ASSERT_EQ(0, vccrypt_mac_init(&options, &context, &keybuf));
+
+    //digest input
+    ASSERT_EQ(0, vccrypt_mac_digest(&context, DATA, sizeof(DATA)));
+
+    //create output buffer
+    ASSERT_EQ(0, vccrypt_buffer_init(&outbuf, &alloc_opts, options.mac_size));
+
+    //finalize hmac
+    ASSERT_EQ(0, vccrypt_mac_finalize(&context, &outbuf));
+
+    //the HMAC output should match our expected HMAC
+    ASSERT_EQ(0, memcmp(outbuf.data, EXPECTED_HMAC, sizeof(EXPECTED_HMAC)));
+
+    //clean up
+    dispose((disposable_t*)&outbuf);
+    dispose((disposable_t*)&context);
+    dispose((disposable_t*)&keybuf);
+}
+
+/**
+ * We should be able to HMAC RFC-4231 Test Case 2.
+ */
+TEST_F(vccrypt_hmac256_ref_test, test_case_2)
+{
+    const uint8_t KEY[] = {
+        0x4a, 0x65, 0x66, 0x65
+    };
+    const uint8_t DATA[] = {
+        0x77, 0x68, 0x61, 0x74, 0x20, 0x64, 0x6f, 0x20,
+        0x79, 0x61, 0x20, 0x77, 0x61, 0x6e, 0x74, 0x20,
+        0x66, 0x6f, 0x72, 0x20, 0x6e, 0x6f, 0x74, 0x68,
+        0x69, 0x6e, 0x67, 0x3f
+    };
+    const uint8_t EXPECTED_HMAC[] = {
+        0x5b, 0xdc, 0xc1, 0x46, 0xbf, 0x60, 0x75, 0x4e,
+        0x6a, 0x04, 0x24, 0x26, 0x08, 0x95, 0x75, 0xc7,
+        0x5a, 0x00, 0x3f, 0x08, 0x9d, 0x27, 0x39, 0x83,
+        0x9d, 0xec, 0x58, 0xb9, 0x64, 0xec, 0x38, 0x43
+    };
+
+    vccrypt_buffer_t keybuf, outbuf;
+    vccrypt_mac_context_t context;
+
+    //create key buffer
+    ASSERT_EQ(0, vccrypt_buffer_init(&keybuf, &alloc_opts, sizeof(KEY)));
+    memcpy(keybuf.data, KEY, sizeof(KEY));
+
+    //initialize MAC
+    ASSERT_EQ(0, vccrypt_mac_init(&options, &context, &keybuf));
+
+    //digest input
+    ASSERT_EQ(0, vccrypt_mac_digest(&context, DATA, sizeof(DATA)));
+
+    //create output buffer
+    ASSERT_EQ(0, vccrypt_buffer_init(&outbuf, &alloc_opts, options.mac_size));
+
+    //finalize hmac
+    ASSERT_EQ(0, vccrypt_mac_finalize(&context, &outbuf));
+
+    //the HMAC output should match our expected HMAC
+    ASSERT_EQ(0, memcmp(outbuf.data, EXPECTED_HMAC, sizeof(EXPECTED_HMAC)));
+
+    //clean up
+    dispose((disposable_t*)&outbuf);
+    dispose((disposable_t*)&context);
+    dispose((disposable_t*)&keybuf);
+}
+
+/**
+ * We should be able to HMAC RFC-4231 Test Case 3.
+ */
+TEST_F(vccrypt_hmac256_ref_test, test_case_3)
+{
+    const uint8_t KEY[] = {
+        0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+        0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+        0xaa, 0xaa, 0xaa, 0xaa
+    };
+    const uint8_t DATA[] = {
+        0xdd, 0xdd, 0xdd, 0xdd, 0xdd, 0xdd, 0xdd, 0xdd,
+        0xdd, 0xdd, 0xdd, 0xdd, 0xdd, 0xdd, 0xdd, 0xdd,
+        0xdd, 0xdd, 0xdd, 0xdd, 0xdd, 0xdd, 0xdd, 0xdd,
+        0xdd, 0xdd, 0xdd, 0xdd, 0xdd, 0xdd, 0xdd, 0xdd,
+        0xdd, 0xdd, 0xdd, 0xdd, 0xdd, 0xdd, 0xdd, 0xdd,
+        0xdd, 0xdd, 0xdd, 0xdd, 0xdd, 0xdd, 0xdd, 0xdd,
+        0xdd, 0xdd
+    };
+    const uint8_t EXPECTED_HMAC[] = {
+        0x77, 0x3e, 0xa9, 0x1e, 0x36, 0x80, 0x0e, 0x46,
+        0x85, 0x4d, 0xb8, 0xeb, 0xd0, 0x91, 0x81, 0xa7,
+        0x29, 0x59, 0x09, 0x8b, 0x3e, 0xf8, 0xc1, 0x22,
+        0xd9, 0x63, 0x55, 0x14, 0xce, 0xd5, 0x65, 0xfe
+    };
+
+    vccrypt_buffer_t keybuf, outbuf;
+    vccrypt_mac_context_t context;
+
+    //create key buffer
+    ASSERT_EQ(0, vccrypt_buffer_init(&keybuf, &alloc_opts, sizeof(KEY)));
+    memcpy(keybuf.data, KEY, sizeof(KEY));
+
+    //initialize MAC
+    ASSERT_EQ(0, vccrypt_mac_init(&options, &context, &keybuf));
+
+    //digest input
+    ASSERT_EQ(0, vccrypt_mac_digest(&context, DATA, sizeof(DATA)));
+
+    //create output buffer
+    ASSERT_EQ(0, vccrypt_buffer_init(&outbuf, &alloc_opts, options.mac_size));
+
+    //finalize hmac
+    ASSERT_EQ(0, vccrypt_mac_finalize(&context, &outbuf));
+
+    //the HMAC output should match our expected HMAC
+    ASSERT_EQ(0, memcmp(outbuf.data, EXPECTED_HMAC, sizeof(EXPECTED_HMAC)));
+
+    //clean up
+    dispose((disposable_t*)&outbuf);
+    dispose((disposable_t*)&context);
+    dispose((disposable_t*)&keybuf);
+}
+
+/**
+ * We should be able to HMAC RFC-4231 Test Case 4.
+ */
+TEST_F(vccrypt_hmac256_ref_test, test_case_4)
+{
+    const uint8_t KEY[] = {
+        0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08,
+        0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f, 0x10,
+        0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18,
+        0x19
+    };
+    const uint8_t DATA[] = {
+        0xcd, 0xcd, 0xcd, 0xcd, 0xcd, 0xcd, 0xcd, 0xcd,
+        0xcd, 0xcd, 0xcd, 0xcd, 0xcd, 0xcd, 0xcd, 0xcd,
+        0xcd, 0xcd, 0xcd, 0xcd, 0xcd, 0xcd, 0xcd, 0xcd,
+        0xcd, 0xcd, 0xcd, 0xcd, 0xcd, 0xcd, 0xcd, 0xcd,
+        0xcd, 0xcd, 0xcd, 0xcd, 0xcd, 0xcd, 0xcd, 0xcd,
+        0xcd, 0xcd, 0xcd, 0xcd, 0xcd, 0xcd, 0xcd, 0xcd,
+        0xcd, 0xcd
+    };
+    const uint8_t EXPECTED_HMAC[] = {
+        0x82, 0x55, 0x8a, 0x38, 0x9a, 0x44, 0x3c, 0x0e,
+        0xa4, 0xcc, 0x81, 0x98, 0x99, 0xf2, 0x08, 0x3a,
+        0x85, 0xf0, 0xfa, 0xa3, 0xe5, 0x78, 0xf8, 0x07,
+        0x7a, 0x2e, 0x3f, 0xf4, 0x67, 0x29, 0x66, 0x5b
+    };
+
+    vccrypt_buffer_t keybuf, outbuf;
+    vccrypt_mac_context_t context;
+
+    //create key buffer
+    ASSERT_EQ(0, vccrypt_buffer_init(&keybuf, &alloc_opts, sizeof(KEY)));
+    memcpy(keybuf.data, KEY, sizeof(KEY));
+
+    //initialize MAC
+    ASSERT_EQ(0, vccrypt_mac_init(&options, &context, &keybuf));
+
+    //digest input
+    ASSERT_EQ(0, vccrypt_mac_digest(&context, DATA, sizeof(DATA)));
+
+    //create output buffer
+    ASSERT_EQ(0, vccrypt_buffer_init(&outbuf, &alloc_opts, options.mac_size));
+
+    //finalize hmac
+    ASSERT_EQ(0, vccrypt_mac_finalize(&context, &outbuf));
+
+    //the HMAC output should match our expected HMAC
+    ASSERT_EQ(0, memcmp(outbuf.data, EXPECTED_HMAC, sizeof(EXPECTED_HMAC)));
+
+    //clean up
+    dispose((disposable_t*)&outbuf);
+    dispose((disposable_t*)&context);
+    dispose((disposable_t*)&keybuf);
+}
+
+/* test case 5 intentionally skipped; it's meaningless to us. */
+
+/**
+ * We should be able to HMAC RFC-4231 Test Case 6.
+ */
+TEST_F(vccrypt_hmac256_ref_test, test_case_6)
+{
+    const uint8_t KEY[] = {
+        0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+        0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+        0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+        0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+        0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+        0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+        0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+        0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+        0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+        0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+        0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+        0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+        0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+        0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+        0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+        0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+        0xaa, 0xaa, 0xaa
+    };
+    const uint8_t DATA[] = {
+        0x54, 0x65, 0x73, 0x74, 0x20, 0x55, 0x73, 0x69,
+        0x6e, 0x67, 0x20, 0x4c, 0x61, 0x72, 0x67, 0x65,
+        0x72, 0x20, 0x54, 0x68, 0x61, 0x6e, 0x20, 0x42,
+        0x6c, 0x6f, 0x63, 0x6b, 0x2d, 0x53, 0x69, 0x7a,
+        0x65, 0x20, 0x4b, 0x65, 0x79, 0x20, 0x2d, 0x20,
+        0x48, 0x61, 0x73, 0x68, 0x20, 0x4b, 0x65, 0x79,
+        0x20, 0x46, 0x69, 0x72, 0x73, 0x74
+    };
+    const uint8_t EXPECTED_HMAC[] = {
+        0x60, 0xe4, 0x31, 0x59, 0x1e, 0xe0, 0xb6, 0x7f,
+        0x0d, 0x8a, 0x26, 0xaa, 0xcb, 0xf5, 0xb7, 0x7f,
+        0x8e, 0x0b, 0xc6, 0x21, 0x37, 0x28, 0xc5, 0x14,
+        0x05, 0x46, 0x04, 0x0f, 0x0e, 0xe3, 0x7f, 0x54
+    };
+
+    vccrypt_buffer_t keybuf, outbuf;
+    vccrypt_mac_context_t context;
+
+    //create key buffer
+    ASSERT_EQ(0, vccrypt_buffer_init(&keybuf, &alloc_opts, sizeof(KEY)));
+    memcpy(keybuf.data, KEY, sizeof(KEY));
+
+    //initialize MAC
+    ASSERT_EQ(0, vccrypt_mac_init(&options, &context, &keybuf));
+
+    //digest input
+    ASSERT_EQ(0, vccrypt_mac_digest(&context, DATA, sizeof(DATA)));
+
+    //create output buffer
+    ASSERT_EQ(0, vccrypt_buffer_init(&outbuf, &alloc_opts, options.mac_size));
+
+    //finalize hmac
+    ASSERT_EQ(0, vccrypt_mac_finalize(&context, &outbuf));
+
+    //the HMAC output should match our expected HMAC
+    ASSERT_EQ(0, memcmp(outbuf.data, EXPECTED_HMAC, sizeof(EXPECTED_HMAC)));
+
+    //clean up
+    dispose((disposable_t*)&outbuf);
+    dispose((disposable_t*)&context);
+    dispose((disposable_t*)&keybuf);
+}
+
+/**
+ * We should be able to HMAC RFC-4231 Test Case 7.
+ */
+TEST_F(vccrypt_hmac256_ref_test, test_case_7)
+{
+    const uint8_t KEY[] = {
+        0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+        0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+        0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+        0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+        0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+        0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+        0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+        0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+        0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+        0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+        0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+        0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+        0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+        0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+        0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+        0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+        0xaa, 0xaa, 0xaa
+    };
+    const uint8_t DATA[] = {
+        0x54, 0x68, 0x69, 0x73, 0x20, 0x69, 0x73, 0x20,
+        0x61, 0x20, 0x74, 0x65, 0x73, 0x74, 0x20, 0x75,
+        0x73, 0x69, 0x6e, 0x67, 0x20, 0x61, 0x20, 0x6c,
+        0x61, 0x72, 0x67, 0x65, 0x72, 0x20, 0x74, 0x68,
+        0x61, 0x6e, 0x20, 0x62, 0x6c, 0x6f, 0x63, 0x6b,
+        0x2d, 0x73, 0x69, 0x7a, 0x65, 0x20, 0x6b, 0x65,
+        0x79, 0x20, 0x61, 0x6e, 0x64, 0x20, 0x61, 0x20,
+        0x6c, 0x61, 0x72, 0x67, 0x65, 0x72, 0x20, 0x74,
+        0x68, 0x61, 0x6e, 0x20, 0x62, 0x6c, 0x6f, 0x63,
+        0x6b, 0x2d, 0x73, 0x69, 0x7a, 0x65, 0x20, 0x64,
+        0x61, 0x74, 0x61, 0x2e, 0x20, 0x54, 0x68, 0x65,
+        0x20, 0x6b, 0x65, 0x79, 0x20, 0x6e, 0x65, 0x65,
+        0x64, 0x73, 0x20, 0x74, 0x6f, 0x20, 0x62, 0x65,
+        0x20, 0x68, 0x61, 0x73, 0x68, 0x65, 0x64, 0x20,
+        0x62, 0x65, 0x66, 0x6f, 0x72, 0x65, 0x20, 0x62,
+        0x65, 0x69, 0x6e, 0x67, 0x20, 0x75, 0x73, 0x65,
+        0x64, 0x20, 0x62, 0x79, 0x20, 0x74, 0x68, 0x65,
+        0x20, 0x48, 0x4d, 0x41, 0x43, 0x20, 0x61, 0x6c,
+        0x67, 0x6f, 0x72, 0x69, 0x74, 0x68, 0x6d, 0x2e
+    };
+    const uint8_t EXPECTED_HMAC[] = {
+        0x9b, 0x09, 0xff, 0xa7, 0x1b, 0x94, 0x2f, 0xcb,
+        0x27, 0x63, 0x5f, 0xbc, 0xd5, 0xb0, 0xe9, 0x44,
+        0xbf, 0xdc, 0x63, 0x64, 0x4f, 0x07, 0x13, 0x93,
+        0x8a, 0x7f, 0x51, 0x53, 0x5c, 0x3a, 0x35, 0xe2
+    };
+
+    vccrypt_buffer_t keybuf, outbuf;
+    vccrypt_mac_context_t context;
+
+    //create key buffer
+    ASSERT_EQ(0, vccrypt_buffer_init(&keybuf, &alloc_opts, sizeof(KEY)));
+    memcpy(keybuf.data, KEY, sizeof(KEY));
+
+    //initialize MAC
+    ASSERT_EQ(0, vccrypt_mac_init(&options, &context, &keybuf));
+
+    //digest input
+    ASSERT_EQ(0, vccrypt_mac_digest(&context, DATA, sizeof(DATA)));
+
+    //create output buffer
+    ASSERT_EQ(0, vccrypt_buffer_init(&outbuf, &alloc_opts, options.mac_size));
+
+    //finalize hmac
+    ASSERT_EQ(0, vccrypt_mac_finalize(&context, &outbuf));
+
+    //the HMAC output should match our expected HMAC
+    ASSERT_EQ(0, memcmp(outbuf.data, EXPECTED_HMAC, sizeof(EXPECTED_HMAC)));
+
+    //clean up
+    dispose((disposable_t*)&outbuf);
+    dispose((disposable_t*)&context);
+    dispose((disposable_t*)&keybuf);
+}
+
+/**
+ * Key exactly equals block size.
+ */
+TEST_F(vccrypt_hmac256_ref_test, test_key_block_size)
+{
+    const uint8_t KEY[] = {
+        '0', '1', '2', '3', '4', '5', '6', '7',
+        '8', '9', 'a', 'b', 'c', 'd', 'e', 'f',
+        '0', '1', '2', '3', '4', '5', '6', '7',
+        '8', '9', 'a', 'b', 'c', 'd', 'e', 'f',
+        '0', '1', '2', '3', '4', '5', '6', '7',
+        '8', '9', 'a', 'b', 'c', 'd', 'e', 'f',
+        '0', '1', '2', '3', '4', '5', '6', '7',
+        '8', '9', 'a', 'b', 'c', 'd', 'e', 'f'
+    };
+    const uint8_t DATA[] = {
+        't', 'e', 's', 't'
+    };
+    const uint8_t EXPECTED_HMAC[] = {
+        0xae, 0x39, 0x1d, 0xa4, 0x89, 0x86, 0xdc, 0x1c,
+        0x2d, 0xf6, 0xb1, 0x19, 0x74, 0xda, 0xfa, 0x3f,
+        0xcd, 0x85, 0x7d, 0xcc, 0x91, 0x93, 0x10, 0xfd,
+        0x79, 0xe7, 0x86, 0xd8, 0xbd, 0x60, 0xaa, 0x0e
+    };
+
+    vccrypt_buffer_t keybuf, outbuf;
+    vccrypt_mac_context_t context;
+
+    //create key buffer
+    ASSERT_EQ(0, vccrypt_buffer_init(&keybuf, &alloc_opts, sizeof(KEY)));
+    memcpy(keybuf.data, KEY, sizeof(KEY));
+
+    //initialize MAC
+    ASSERT_EQ(0, vccrypt_mac_init(&options, &context, &keybuf));
+
+    //digest input
+    ASSERT_EQ(0, vccrypt_mac_digest(&context, DATA, sizeof(DATA)));
+
+    //create output buffer
+    ASSERT_EQ(0, vccrypt_buffer_init(&outbuf, &alloc_opts, options.mac_size));
+
+    //finalize hmac
+    ASSERT_EQ(0, vccrypt_mac_finalize(&context, &outbuf));
+
+    //the HMAC output should match our expected HMAC
+    ASSERT_EQ(0, memcmp(outbuf.data, EXPECTED_HMAC, sizeof(EXPECTED_HMAC)));
+
+    //clean up
+    dispose((disposable_t*)&outbuf);
+    dispose((disposable_t*)&context);
+    dispose((disposable_t*)&keybuf);
+}
@@ -485,3 +485,114 @@ TEST_F(vccrypt_hmac512_256_ref_test, test_key_block_size)
     dispose((disposable_t*)&context);
     dispose((disposable_t*)&keybuf);
 }
+
+/**
+ * After finalize, the same instance can MAC another message.
+ */
+TEST_F(vccrypt_hmac512_256_ref_test, reuse_after_finalize)
+{
+    const uint8_t KEY[] = {
+        0x4a, 0x65, 0x66, 0x65
+    };
+    const uint8_t DATA[] = {
+        0x77, 0x68, 0x61, 0x74, 0x20, 0x64, 0x6f, 0x20,
+        0x79, 0x61, 0x20, 0x77, 0x61, 0x6e, 0x74, 0x20,
+        0x66, 0x6f, 0x72, 0x20, 0x6e, 0x6f, 0x74, 0x68,
+        0x69, 0x6e, 0x67, 0x3f
+    };
+    const uint8_t EXPECTED_HMAC[] = {
+        0x6d, 0xf7, 0xb2, 0x46, 0x30, 0xd5, 0xcc, 0xb2,
+        0xee, 0x33, 0x54, 0x07, 0x08, 0x1a, 0x87, 0x18,
+        0x8c, 0x22, 0x14, 0x89, 0x76, 0x8f, 0xa2, 0x02,
+        0x05, 0x13, 0xb2, 0xd5, 0x93, 0x35, 0x94, 0x56
+    };
+
+    vccrypt_buffer_t keybuf, outbuf;
+    vccrypt_mac_context_t context;
+
+    //create key buffer
+    ASSERT_EQ(0, vccrypt_buffer_init(&keybuf, &alloc_opts, sizeof(KEY)));
+    memcpy(keybuf.data, KEY, sizeof(KEY));
+
+    //initialize MAC
+    ASSERT_EQ(0, vccrypt_mac_init(&options, &context, &keybuf));
+
+    //create output buffer
+    ASSERT_EQ(0, vccrypt_buffer_init(&outbuf, &alloc_opts, options.mac_size));
+
+    //MAC the same message several times with one instance
+    for (int i = 0; i < 3; ++i)
+    {
+        memset(outbuf.data, 0, outbuf.size);
+
+        ASSERT_EQ(0, vccrypt_mac_digest(&context, DATA, sizeof(DATA)));
+        ASSERT_EQ(0, vccrypt_mac_finalize(&context, &outbuf));
+
+        EXPECT_EQ(0,
+            memcmp(outbuf.data, EXPECTED_HMAC, sizeof(EXPECTED_HMAC)));
+    }
+
+    //clean up
+    dispose((disposable_t*)&outbuf);
+    dispose((disposable_t*)&context);
+    dispose((disposable_t*)&keybuf);
+}
+
+/**
+ * Reset discards a partial message and keeps the key.
+ */
+TEST_F(vccrypt_hmac512_256_ref_test, reset)
+{
+    const uint8_t KEY[] = {
+        0x4a, 0x65, 0x66, 0x65
+    };
+    const uint8_t DATA[] = {
+        0x77, 0x68, 0x61, 0x74, 0x20, 0x64, 0x6f, 0x20,
+        0x79, 0x61, 0x20, 0x77, 0x61, 0x6e, 0x74, 0x20,
+        0x66, 0x6f, 0x72, 0x20, 0x6e, 0x6f, 0x74, 0x68,
+        0x69, 0x6e, 0x67, 0x3f
+    };
+    const uint8_t EXPECTED_HMAC[] = {
+        0x6d, 0xf7, 0xb2, 0x46, 0x30, 0xd5, 0xcc, 0xb2,
+        0xee, 0x33, 0x54, 0x07, 0x08, 0x1a, 0x87, 0x18,
+        0x8c, 0x22, 0x14, 0x89, 0x76, 0x8f, 0xa2, 0x02,
+        0x05, 0x13, 0xb2, 0xd5, 0x93, 0x35, 0x94, 0x56
+    };
+
+    vccrypt_buffer_t keybuf, outbuf;
+    vccrypt_mac_context_t context;
+
+    //create key buffer
+    ASSERT_EQ(0, vccrypt_buffer_init(&keybuf, &alloc_opts, sizeof(KEY)));
+    memcpy(keybuf.data, KEY, sizeof(KEY));
+
+    //initialize MAC
+    ASSERT_EQ(0, vccrypt_mac_init(&options, &context, &keybuf));
+
+    //digest part of a message that is then abandoned
+    ASSERT_EQ(0, vccrypt_mac_digest(&context, DATA, 5));
+    ASSERT_EQ(0, vccrypt_mac_reset(&context));
+
+    //reset right after init is also fine
+    ASSERT_EQ(0, vccrypt_mac_reset(&context));
+
+    //digest input
+    ASSERT_EQ(0, vccrypt_mac_digest(&context, DATA, sizeof(DATA)));
+
+    //create output buffer
+    ASSERT_EQ(0, vccrypt_buffer_init(&outbuf, &alloc_opts, options.mac_size));
+
+    //finalize hmac
+    ASSERT_EQ(0, vccrypt_mac_finalize(&context, &outbuf));
+
+    //the HMAC output should match our expected HMAC
+    ASSERT_EQ(0, memcmp(outbuf.data, EXPECTED_HMAC, sizeof(EXPECTED_HMAC)));
+
+    //a NULL context is rejected
+    EXPECT_EQ(VCCRYPT_ERROR_MAC_RESET_INVALID_ARG, vccrypt_mac_reset(NULL));
+
+    //clean up
+    dispose((disposable_t*)&outbuf);
+    dispose((disposable_t*)&context);
+    dispose((disposable_t*)&keybuf);
+}
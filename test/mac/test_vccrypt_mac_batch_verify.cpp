@@ -0,0 +1,267 @@
+/**
+ * \file test_vccrypt_mac_batch_verify.cpp
+ *
+ * Unit tests for batch MAC verification.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <gtest/gtest.h>
+#include <string.h>
+#include <vccrypt/mac.h>
+#include <vpr/allocator/malloc_allocator.h>
+#include <vector>
+
+class vccrypt_mac_batch_verify_test : public ::testing::Test {
+protected:
+    void SetUp() override
+    {
+        vccrypt_mac_register_SHA_2_256_HMAC();
+        vccrypt_mac_register_SHA_2_512_HMAC();
+        vccrypt_mac_register_SHA_2_512_256_HMAC();
+
+        malloc_allocator_options_init(&alloc_opts);
+
+        /* message sizes around the one and two block padding boundaries. */
+        for (size_t i = 0; i < 300; i += 13)
+        {
+            sizes.push_back(i);
+        }
+        sizes.push_back(111);
+        sizes.push_back(112);
+        sizes.push_back(127);
+        sizes.push_back(128);
+        sizes.push_back(239);
+        sizes.push_back(240);
+        sizes.push_back(1000);
+
+        /* key sizes around the block size, where long keys are hashed. */
+        const size_t key_sizes[] = { 1, 32, 64, 127, 128, 129, 200 };
+        const size_t key_count = sizeof(key_sizes) / sizeof(key_sizes[0]);
+
+        for (size_t i = 0; i < sizes.size(); ++i)
+        {
+            uint8_t* msg = new uint8_t[sizes[i] + 1];
+            for (size_t j = 0; j < sizes[i]; ++j)
+            {
+                msg[j] = (uint8_t)(i * 31 + j * 17);
+            }
+            data.push_back(msg);
+
+            vccrypt_buffer_t key;
+            size_t key_size = key_sizes[i % key_count];
+            EXPECT_EQ(0, vccrypt_buffer_init(&key, &alloc_opts, key_size));
+            for (size_t j = 0; j < key_size; ++j)
+            {
+                ((uint8_t*)key.data)[j] = (uint8_t)(i * 7 + j * 13 + 1);
+            }
+            keys.push_back(key);
+        }
+    }
+
+    void TearDown() override
+    {
+        for (size_t i = 0; i < data.size(); ++i)
+        {
+            delete[] data[i];
+            dispose((disposable_t*)&keys[i]);
+        }
+
+        for (size_t i = 0; i < tags.size(); ++i)
+        {
+            delete[] tags[i];
+        }
+
+        dispose((disposable_t*)&alloc_opts);
+    }
+
+    /**
+     * Compute the tag of each item on its own, corrupting every third one.
+     */
+    void make_tags(vccrypt_mac_options_t* options)
+    {
+        for (size_t i = 0; i < data.size(); ++i)
+        {
+            vccrypt_mac_context_t context;
+            vccrypt_buffer_t mac;
+            uint8_t* tag = new uint8_t[options->mac_size];
+
+            ASSERT_EQ(0, vccrypt_mac_init(options, &context, &keys[i]));
+            ASSERT_EQ(0,
+                vccrypt_buffer_init(&mac, &alloc_opts, options->mac_size));
+            if (sizes[i] > 0)
+            {
+                ASSERT_EQ(0, vccrypt_mac_digest(&context, data[i], sizes[i]));
+            }
+            ASSERT_EQ(0, vccrypt_mac_finalize(&context, &mac));
+
+            memcpy(tag, mac.data, options->mac_size);
+            if (i % 3 == 1)
+            {
+                tag[i % options->mac_size] ^= 0x01;
+            }
+            tags.push_back(tag);
+
+            dispose((disposable_t*)&mac);
+            dispose((disposable_t*)&context);
+        }
+    }
+
+    /**
+     * Check that the batch bitmap matches the tags made by make_tags().
+     */
+    void check_batch(vccrypt_mac_options_t* options)
+    {
+        make_tags(options);
+
+        /* start from garbage to check that every bit is written. */
+        std::vector<uint8_t> results((data.size() + 7) / 8, 0xA5);
+
+        ASSERT_EQ(0,
+            vccrypt_mac_batch_verify(
+                options, keys.data(), data.data(), sizes.data(),
+                tags.data(), data.size(), results.data()));
+
+        for (size_t i = 0; i < data.size(); ++i)
+        {
+            bool valid = (results[i / 8] >> (i % 8)) & 1;
+
+            EXPECT_EQ(i % 3 != 1, valid)
+                << "size = " << sizes[i] << ", key size = " << keys[i].size;
+        }
+
+        /* bits past the end of the batch are cleared. */
+        for (size_t i = data.size(); i < results.size() * 8; ++i)
+        {
+            EXPECT_EQ(0, (results[i / 8] >> (i % 8)) & 1);
+        }
+    }
+
+    allocator_options_t alloc_opts;
+    std::vector<size_t> sizes;
+    std::vector<const uint8_t*> data;
+    std::vector<vccrypt_buffer_t> keys;
+    std::vector<const uint8_t*> tags;
+};
+
+/**
+ * An HMAC-SHA-512 batch matches verifying each message on its own.
+ */
+TEST_F(vccrypt_mac_batch_verify_test, hmac_sha_512)
+{
+    vccrypt_mac_options_t options;
+
+    ASSERT_EQ(0,
+        vccrypt_mac_options_init(&options, &alloc_opts,
+            VCCRYPT_MAC_ALGORITHM_SHA_2_512_HMAC));
+
+    check_batch(&options);
+
+    dispose((disposable_t*)&options);
+}
+
+/**
+ * An HMAC-SHA-512/256 batch matches verifying each message on its own.
+ */
+TEST_F(vccrypt_mac_batch_verify_test, hmac_sha_512_256)
+{
+    vccrypt_mac_options_t options;
+
+    ASSERT_EQ(0,
+        vccrypt_mac_options_init(&options, &alloc_opts,
+            VCCRYPT_MAC_ALGORITHM_SHA_2_512_256_HMAC));
+
+    check_batch(&options);
+
+    dispose((disposable_t*)&options);
+}
+
+/**
+ * HMAC-SHA-256 has no batch implementation and verifies each message in turn.
+ */
+TEST_F(vccrypt_mac_batch_verify_test, hmac_sha_256)
+{
+    vccrypt_mac_options_t options;
+
+    ASSERT_EQ(0,
+        vccrypt_mac_options_init(&options, &alloc_opts,
+            VCCRYPT_MAC_ALGORITHM_SHA_2_256_HMAC));
+
+    check_batch(&options);
+
+    dispose((disposable_t*)&options);
+}
+
+/**
+ * Algorithms without a batch implementation verify each message in turn.
+ */
+TEST_F(vccrypt_mac_batch_verify_test, generic_fallback)
+{
+    vccrypt_mac_options_t options;
+
+    ASSERT_EQ(0,
+        vccrypt_mac_options_init(&options, &alloc_opts,
+            VCCRYPT_MAC_ALGORITHM_SHA_2_512_HMAC));
+
+    options.vccrypt_mac_alg_batch_verify = NULL;
+
+    check_batch(&options);
+
+    dispose((disposable_t*)&options);
+}
+
+/**
+ * An empty batch succeeds, and bad arguments are rejected.
+ */
+TEST_F(vccrypt_mac_batch_verify_test, invalid_args)
+{
+    vccrypt_mac_options_t options;
+    vccrypt_buffer_t batch_keys[2] = { keys[1], keys[2] };
+    const uint8_t* msgs[2] = { data[1], NULL };
+    size_t msg_sizes[2] = { sizes[1], 0 };
+    uint8_t tag[VCCRYPT_MAC_SHA_512_MAC_SIZE] = { 0 };
+    const uint8_t* batch_tags[2] = { tag, tag };
+    uint8_t results[1];
+
+    ASSERT_EQ(0,
+        vccrypt_mac_options_init(&options, &alloc_opts,
+            VCCRYPT_MAC_ALGORITHM_SHA_2_512_HMAC));
+
+    EXPECT_EQ(0,
+        vccrypt_mac_batch_verify(
+            &options, NULL, NULL, NULL, NULL, 0, NULL));
+    EXPECT_EQ(VCCRYPT_ERROR_MAC_BATCH_VERIFY_INVALID_ARG,
+        vccrypt_mac_batch_verify(
+            NULL, batch_keys, msgs, msg_sizes, batch_tags, 2, results));
+    EXPECT_EQ(VCCRYPT_ERROR_MAC_BATCH_VERIFY_INVALID_ARG,
+        vccrypt_mac_batch_verify(
+            &options, batch_keys, msgs, msg_sizes, batch_tags, 2, NULL));
+
+    /* a wrong tag is a result, not an error. */
+    EXPECT_EQ(0,
+        vccrypt_mac_batch_verify(
+            &options, batch_keys, msgs, msg_sizes, batch_tags, 2, results));
+    EXPECT_EQ(0, results[0]);
+
+    /* a missing tag is rejected. */
+    batch_tags[1] = NULL;
+    EXPECT_EQ(VCCRYPT_ERROR_MAC_BATCH_VERIFY_INVALID_ARG,
+        vccrypt_mac_batch_verify(
+            &options, batch_keys, msgs, msg_sizes, batch_tags, 2, results));
+    batch_tags[1] = tag;
+
+    /* an empty key is rejected. */
+    batch_keys[1].size = 0;
+    EXPECT_EQ(VCCRYPT_ERROR_MAC_BATCH_VERIFY_INVALID_ARG,
+        vccrypt_mac_batch_verify(
+            &options, batch_keys, msgs, msg_sizes, batch_tags, 2, results));
+    batch_keys[1].size = keys[2].size;
+
+    /* a NULL message is only allowed when its size is 0. */
+    msgs[0] = NULL;
+    EXPECT_EQ(VCCRYPT_ERROR_MAC_BATCH_VERIFY_INVALID_ARG,
+        vccrypt_mac_batch_verify(
+            &options, batch_keys, msgs, msg_sizes, batch_tags, 2, results));
+
+    dispose((disposable_t*)&options);
+}
@@ -0,0 +1,170 @@
+/**
+ * \file test_vccrypt_mac_verify.cpp
+ *
+ * Unit tests for truncated MAC finalization and MAC verification.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <gtest/gtest.h>
+#include <string.h>
+#include <vccrypt/mac.h>
+#include <vpr/allocator/malloc_allocator.h>
+
+class vccrypt_mac_verify_test : public ::testing::Test {
+protected:
+    void SetUp() override
+    {
+        vccrypt_mac_register_SHA_2_512_HMAC();
+        vccrypt_mac_register_SHA_2_512_256_HMAC();
+
+        malloc_allocator_options_init(&alloc_opts);
+
+        ASSERT_EQ(0, vccrypt_buffer_init(&key, &alloc_opts, 32));
+        for (size_t i = 0; i < key.size; ++i)
+        {
+            ((uint8_t*)key.data)[i] = (uint8_t)(i * 7 + 3);
+        }
+
+        for (size_t i = 0; i < sizeof(data); ++i)
+        {
+            data[i] = (uint8_t)(i * 13 + 5);
+        }
+    }
+
+    void TearDown() override
+    {
+        dispose((disposable_t*)&key);
+        dispose((disposable_t*)&alloc_opts);
+    }
+
+    /**
+     * Compute the full MAC of data with vccrypt_mac_finalize().
+     */
+    void full_mac(vccrypt_mac_options_t* options, uint8_t* mac)
+    {
+        vccrypt_mac_context_t context;
+        vccrypt_buffer_t buffer;
+
+        ASSERT_EQ(0, vccrypt_mac_init(options, &context, &key));
+        ASSERT_EQ(0,
+            vccrypt_buffer_init(&buffer, &alloc_opts, options->mac_size));
+        ASSERT_EQ(0, vccrypt_mac_digest(&context, data, sizeof(data)));
+        ASSERT_EQ(0, vccrypt_mac_finalize(&context, &buffer));
+
+        memcpy(mac, buffer.data, options->mac_size);
+
+        dispose((disposable_t*)&buffer);
+        dispose((disposable_t*)&context);
+    }
+
+    /**
+     * Check truncated finalization and verification for an algorithm,
+     * optionally without its truncated finalize implementation.
+     */
+    void check(uint32_t algorithm, bool generic = false)
+    {
+        vccrypt_mac_options_t options;
+        vccrypt_mac_context_t context;
+        uint8_t expected[VCCRYPT_MAC_MAX_MAC_SIZE];
+        uint8_t mac[VCCRYPT_MAC_MAX_MAC_SIZE + 1];
+
+        ASSERT_EQ(0,
+            vccrypt_mac_options_init(&options, &alloc_opts, algorithm));
+        if (generic)
+        {
+            options.vccrypt_mac_alg_finalize_truncated = NULL;
+        }
+        full_mac(&options, expected);
+        ASSERT_EQ(0, vccrypt_mac_init(&options, &context, &key));
+
+        for (size_t size = 1; size <= options.mac_size; ++size)
+        {
+            /* only the requested bytes are written. */
+            memset(mac, 0xA5, sizeof(mac));
+            ASSERT_EQ(0, vccrypt_mac_digest(&context, data, sizeof(data)));
+            ASSERT_EQ(0, vccrypt_mac_finalize_truncated(&context, mac, size));
+            EXPECT_EQ(0, memcmp(mac, expected, size));
+            EXPECT_EQ(0xA5, mac[size]);
+
+            /* the instance is ready for the next message after a match... */
+            ASSERT_EQ(0, vccrypt_mac_digest(&context, data, sizeof(data)));
+            EXPECT_EQ(0, vccrypt_mac_verify(&context, expected, size));
+
+            /* ...and after a mismatch in the last compared byte. */
+            mac[size - 1] ^= 0x80;
+            ASSERT_EQ(0, vccrypt_mac_digest(&context, data, sizeof(data)));
+            EXPECT_EQ(VCCRYPT_ERROR_MAC_VERIFY_MISMATCH,
+                vccrypt_mac_verify(&context, mac, size));
+        }
+
+        dispose((disposable_t*)&context);
+        dispose((disposable_t*)&options);
+    }
+
+    allocator_options_t alloc_opts;
+    vccrypt_buffer_t key;
+    uint8_t data[200];
+};
+
+/**
+ * Truncated HMAC-SHA-512 MACs are prefixes of the full MAC.
+ */
+TEST_F(vccrypt_mac_verify_test, hmac_sha_512)
+{
+    check(VCCRYPT_MAC_ALGORITHM_SHA_2_512_HMAC);
+}
+
+/**
+ * Truncated HMAC-SHA-512/256 MACs are prefixes of the full MAC.
+ */
+TEST_F(vccrypt_mac_verify_test, hmac_sha_512_256)
+{
+    check(VCCRYPT_MAC_ALGORITHM_SHA_2_512_256_HMAC);
+}
+
+/**
+ * Algorithms without a truncated finalize go through the full MAC.
+ */
+TEST_F(vccrypt_mac_verify_test, generic_fallback)
+{
+    check(VCCRYPT_MAC_ALGORITHM_SHA_2_512_HMAC, true);
+    check(VCCRYPT_MAC_ALGORITHM_SHA_2_512_256_HMAC, true);
+}
+
+/**
+ * Bad arguments are rejected.
+ */
+TEST_F(vccrypt_mac_verify_test, invalid_args)
+{
+    vccrypt_mac_options_t options;
+    vccrypt_mac_context_t context;
+    uint8_t mac[VCCRYPT_MAC_MAX_MAC_SIZE + 1];
+
+    ASSERT_EQ(0,
+        vccrypt_mac_options_init(&options, &alloc_opts,
+            VCCRYPT_MAC_ALGORITHM_SHA_2_512_256_HMAC));
+    ASSERT_EQ(0, vccrypt_mac_init(&options, &context, &key));
+
+    EXPECT_EQ(VCCRYPT_ERROR_MAC_FINALIZE_INVALID_ARG,
+        vccrypt_mac_finalize_truncated(NULL, mac, 16));
+    EXPECT_EQ(VCCRYPT_ERROR_MAC_FINALIZE_INVALID_ARG,
+        vccrypt_mac_finalize_truncated(&context, NULL, 16));
+    EXPECT_EQ(VCCRYPT_ERROR_MAC_FINALIZE_INVALID_ARG,
+        vccrypt_mac_finalize_truncated(&context, mac, 0));
+    EXPECT_EQ(VCCRYPT_ERROR_MAC_FINALIZE_INVALID_ARG,
+        vccrypt_mac_finalize_truncated(
+            &context, mac, options.mac_size + 1));
+
+    EXPECT_EQ(VCCRYPT_ERROR_MAC_VERIFY_INVALID_ARG,
+        vccrypt_mac_verify(NULL, mac, 16));
+    EXPECT_EQ(VCCRYPT_ERROR_MAC_VERIFY_INVALID_ARG,
+        vccrypt_mac_verify(&context, NULL, 16));
+    EXPECT_EQ(VCCRYPT_ERROR_MAC_VERIFY_INVALID_ARG,
+        vccrypt_mac_verify(&context, mac, 0));
+    EXPECT_EQ(VCCRYPT_ERROR_MAC_VERIFY_INVALID_ARG,
+        vccrypt_mac_verify(&context, mac, options.mac_size + 1));
+
+    dispose((disposable_t*)&context);
+    dispose((disposable_t*)&options);
+}
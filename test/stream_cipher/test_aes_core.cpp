@@ -226,3 +226,253 @@ TEST(aes_core_test, AES_256X4_ECB)
         EXPECT_EQ(test_plaintext[i], plaintext[i]);
     }
 }
+
+/**
+ * Fold a run of blocks together with XOR.
+ */
+static void fold_blocks(uint8_t* fold, const uint8_t* blocks, size_t size)
+{
+    memset(fold, 0, 16);
+    for (size_t i = 0; i < size; ++i)
+    {
+        fold[i % 16] ^= blocks[i];
+    }
+}
+
+/**
+ * Test that the selected backend matches known answers for every round
+ * multiplier, and agrees with itself for single blocks and runs of blocks.
+ */
+TEST(aes_core_test, backend_matches_reference)
+{
+    /* the XOR of the ciphertext blocks, for each round multiplier. */
+    const uint8_t expected_fold[4][16] = {
+        { 0x21, 0xe6, 0x8d, 0x2b, 0x65, 0x02, 0x17, 0xce,
+          0xec, 0x1d, 0x6c, 0x75, 0xba, 0x3d, 0x16, 0xbe },
+        { 0xdd, 0x33, 0xf6, 0xec, 0xf1, 0x82, 0xd5, 0xfe,
+          0x3f, 0xa2, 0xa4, 0xc0, 0xdd, 0x6a, 0xdc, 0x50 },
+        { 0xae, 0x6a, 0x8d, 0x8c, 0x94, 0x64, 0x29, 0xf8,
+          0x32, 0x5f, 0xbe, 0x19, 0x9b, 0x05, 0x4b, 0xf7 },
+        { 0x26, 0xd2, 0xb3, 0xbf, 0xed, 0xdd, 0xd8, 0xa1,
+          0x86, 0x7a, 0x68, 0x48, 0xba, 0xc8, 0x76, 0xf0 }
+    };
+    uint8_t key[32];
+    uint8_t plaintext[16 * 21];
+    uint8_t ciphertext[16 * 21];
+    uint8_t decrypted[16 * 21];
+    uint8_t block[16];
+    uint8_t fold[16];
+
+    for (size_t i = 0; i < sizeof(key); ++i)
+    {
+        key[i] = (uint8_t)(i * 37 + 11);
+    }
+
+    for (size_t i = 0; i < sizeof(plaintext); ++i)
+    {
+        plaintext[i] = (uint8_t)(i * 13 + 5);
+    }
+
+    for (int mult = 1; mult <= 4; ++mult)
+    {
+        AES_KEY enc_key, dec_key;
+
+        ASSERT_EQ(0, AES_set_encrypt_key(key, 256, mult, &enc_key));
+        ASSERT_EQ(0, AES_set_decrypt_key(key, 256, mult, &dec_key));
+
+        /* a run of blocks covers both the wide and the partial paths. */
+        AES_encrypt_blocks(
+            plaintext, ciphertext, sizeof(plaintext) / 16, &enc_key);
+        fold_blocks(fold, ciphertext, sizeof(ciphertext));
+        EXPECT_EQ(0, memcmp(expected_fold[mult - 1], fold, sizeof(fold)));
+
+        AES_decrypt_blocks(
+            ciphertext, decrypted, sizeof(ciphertext) / 16, &dec_key);
+        EXPECT_EQ(0, memcmp(plaintext, decrypted, sizeof(plaintext)));
+
+        for (size_t i = 0; i < sizeof(plaintext); i += 16)
+        {
+            AES_encrypt(plaintext + i, block, &enc_key);
+            EXPECT_EQ(0, memcmp(ciphertext + i, block, sizeof(block)));
+
+            AES_decrypt(ciphertext + i, block, &dec_key);
+            EXPECT_EQ(0, memcmp(plaintext + i, block, sizeof(block)));
+        }
+    }
+}
+
+/**
+ * Test that the bitsliced core matches known answers for every round
+ * multiplier, and agrees with itself for partial and full lane groups.
+ */
+TEST(aes_core_test, bitsliced_matches_reference)
+{
+    /* the XOR of the ciphertext blocks, for each round multiplier. */
+    const uint8_t expected_fold[4][16] = {
+        { 0x46, 0x96, 0x11, 0x4d, 0xa1, 0xfb, 0x0c, 0xc5,
+          0x02, 0x77, 0x8a, 0x40, 0xd6, 0x0b, 0x68, 0x46 },
+        { 0x6a, 0xe6, 0x42, 0x1e, 0x9c, 0x93, 0x81, 0x9e,
+          0xaf, 0x3e, 0x20, 0x46, 0x04, 0xb8, 0x61, 0xa4 },
+        { 0x41, 0xda, 0xd9, 0x56, 0xbc, 0x04, 0xda, 0xc3,
+          0x27, 0x1f, 0x80, 0x33, 0x72, 0xe7, 0xb3, 0x8b },
+        { 0x41, 0x94, 0xa9, 0x33, 0xce, 0x23, 0x4d, 0x2e,
+          0xe4, 0x6f, 0x27, 0xda, 0x22, 0x3d, 0x7a, 0x85 }
+    };
+    uint8_t key[32];
+    uint8_t plaintext[16 * 11];
+    uint8_t ciphertext[16 * 11];
+    uint8_t expected[16 * 11];
+    uint8_t decrypted[16 * 11];
+    uint8_t fold[16];
+
+    for (size_t i = 0; i < sizeof(key); ++i)
+    {
+        key[i] = (uint8_t)(i * 101 + 7);
+    }
+
+    for (size_t i = 0; i < sizeof(plaintext); ++i)
+    {
+        plaintext[i] = (uint8_t)(i * 29 + 1);
+    }
+
+    for (int mult = 1; mult <= 4; ++mult)
+    {
+        AES_KEY enc_key, dec_key;
+
+        ASSERT_EQ(0, AES_set_encrypt_key(key, 256, mult, &enc_key));
+        ASSERT_EQ(0, AES_set_decrypt_key(key, 256, mult, &dec_key));
+
+        /* encrypt each block on its own, in a single lane. */
+        for (size_t i = 0; i < sizeof(plaintext); i += 16)
+        {
+            bsaes_encrypt_blocks(plaintext + i, expected + i, 1, &enc_key);
+        }
+
+        fold_blocks(fold, expected, sizeof(expected));
+        EXPECT_EQ(0, memcmp(expected_fold[mult - 1], fold, sizeof(fold)));
+
+        for (size_t blocks = 1; blocks <= sizeof(plaintext) / 16; ++blocks)
+        {
+            memset(ciphertext, 0, sizeof(ciphertext));
+            bsaes_encrypt_blocks(plaintext, ciphertext, blocks, &enc_key);
+            EXPECT_EQ(0, memcmp(expected, ciphertext, 16 * blocks));
+
+            memset(decrypted, 0, sizeof(decrypted));
+            bsaes_decrypt_blocks(expected, decrypted, blocks, &dec_key);
+            EXPECT_EQ(0, memcmp(plaintext, decrypted, 16 * blocks));
+        }
+    }
+}
+
+/**
+ * Multiply two elements of GF(2^8) with the AES polynomial.
+ */
+static uint8_t gf_mul(uint8_t a, uint8_t b)
+{
+    uint8_t p = 0;
+
+    while (b)
+    {
+        if (b & 1)
+        {
+            p ^= a;
+        }
+
+        a = (uint8_t)((a << 1) ^ ((a & 0x80) ? 0x1b : 0));
+        b >>= 1;
+    }
+
+    return p;
+}
+
+/**
+ * Apply InvMixColumns to a column held as a big-endian word.
+ */
+static uint32_t inv_mix_column(uint32_t w)
+{
+    const uint8_t m[4] = { 0x0e, 0x0b, 0x0d, 0x09 };
+    uint8_t a[4], b[4];
+
+    for (int i = 0; i < 4; ++i)
+    {
+        a[i] = (uint8_t)(w >> (24 - 8 * i));
+    }
+
+    for (int i = 0; i < 4; ++i)
+    {
+        b[i] = 0;
+        for (int j = 0; j < 4; ++j)
+        {
+            b[i] ^= gf_mul(a[j], m[(j - i + 4) % 4]);
+        }
+    }
+
+    return ((uint32_t)b[0] << 24) | ((uint32_t)b[1] << 16)
+        | ((uint32_t)b[2] << 8) | (uint32_t)b[3];
+}
+
+/**
+ * Test the key schedules against the FIPS-197 key expansion examples, and
+ * that the decryption schedule is the inverse cipher schedule.
+ */
+TEST(aes_core_test, key_schedule_matches_fips197)
+{
+    const uint8_t key[32] = {
+        0x60, 0x3d, 0xeb, 0x10, 0x15, 0xca, 0x71, 0xbe,
+        0x2b, 0x73, 0xae, 0xf0, 0x85, 0x7d, 0x77, 0x81,
+        0x1f, 0x35, 0x2c, 0x07, 0x3b, 0x61, 0x08, 0xd7,
+        0x2d, 0x98, 0x10, 0xa3, 0x09, 0x14, 0xdf, 0xf4
+    };
+    const uint8_t key128[16] = {
+        0x2b, 0x7e, 0x15, 0x16, 0x28, 0xae, 0xd2, 0xa6,
+        0xab, 0xf7, 0x15, 0x88, 0x09, 0xcf, 0x4f, 0x3c
+    };
+    const uint8_t key192[24] = {
+        0x8e, 0x73, 0xb0, 0xf7, 0xda, 0x0e, 0x64, 0x52,
+        0xc8, 0x10, 0xf3, 0x2b, 0x80, 0x90, 0x79, 0xe5,
+        0x62, 0xf8, 0xea, 0xd2, 0x52, 0x2c, 0x6b, 0x7b
+    };
+    const uint32_t last128[4] = {
+        0xd014f9a8, 0xc9ee2589, 0xe13f0cc8, 0xb6630ca6 };
+    const uint32_t last192[4] = {
+        0xe98ba06f, 0x448c773c, 0x8ecc7204, 0x01002202 };
+    const uint32_t last256[4] = {
+        0xfe4890d1, 0xe6188d0b, 0x046df344, 0x706c631e };
+    AES_KEY enc_key, dec_key;
+
+    ASSERT_EQ(0, AES_set_encrypt_key(key128, 128, 1, &enc_key));
+    ASSERT_EQ(10, enc_key.rounds);
+    EXPECT_EQ(0, memcmp(last128, enc_key.rd_key + 40, sizeof(last128)));
+
+    ASSERT_EQ(0, AES_set_encrypt_key(key192, 192, 1, &enc_key));
+    ASSERT_EQ(12, enc_key.rounds);
+    EXPECT_EQ(0, memcmp(last192, enc_key.rd_key + 48, sizeof(last192)));
+
+    ASSERT_EQ(0, AES_set_encrypt_key(key, 256, 1, &enc_key));
+    ASSERT_EQ(14, enc_key.rounds);
+    EXPECT_EQ(0, memcmp(last256, enc_key.rd_key + 56, sizeof(last256)));
+
+    for (int mult = 1; mult <= 4; ++mult)
+    {
+        ASSERT_EQ(0, AES_set_encrypt_key(key, 256, mult, &enc_key));
+        ASSERT_EQ(0, AES_set_decrypt_key(key, 256, mult, &dec_key));
+
+        int nr = enc_key.rounds;
+        ASSERT_EQ(nr, dec_key.rounds);
+
+        for (int r = 0; r <= nr; ++r)
+        {
+            for (int i = 0; i < 4; ++i)
+            {
+                uint32_t w = enc_key.rd_key[4 * (nr - r) + i];
+
+                if (r > 0 && r < nr)
+                {
+                    w = inv_mix_column(w);
+                }
+
+                EXPECT_EQ(w, dec_key.rd_key[4 * r + i]);
+            }
+        }
+    }
+}
@@ -518,3 +518,92 @@ TEST_F(aes_ctr_test, aes_256_ctr_fips_03)
     dispose((disposable_t*)&key);
     dispose((disposable_t*)&ctx);
 }
+
+/**
+ * Encrypting a large message in uneven pieces should produce the same output
+ * as a block-at-a-time reference keystream, so that the bulk path matches the
+ * byte path across block and batch boundaries.
+ */
+TEST_F(aes_ctr_test, aes_256_4x_ctr_bulk_matches_reference)
+{
+    vccrypt_stream_context_t ctx;
+    vccrypt_buffer_t key;
+
+    const uint8_t KEY[32] = {
+        0x77, 0x6b, 0xef, 0xf2, 0x85, 0x1d, 0xb0, 0x6f,
+        0x4c, 0x8a, 0x05, 0x42, 0xc8, 0x69, 0x6f, 0x6c,
+        0x6a, 0x81, 0xaf, 0x1e, 0xec, 0x96, 0xb4, 0xd3,
+        0x7f, 0xc1, 0xd6, 0x89, 0xe6, 0xc1, 0xc1, 0x04
+    };
+    const size_t CHUNKS[] = { 1, 3, 16, 17, 255, 256, 257, 1024, 7, 4096 };
+    const size_t MESSAGE_SIZE = 8192;
+    uint64_t DUMMY_IV = mmhtonll(0x0102030405060708UL);
+    uint8_t* plaintext = (uint8_t*)malloc(MESSAGE_SIZE);
+    uint8_t* expected = (uint8_t*)malloc(MESSAGE_SIZE);
+    uint8_t* output = (uint8_t*)malloc(MESSAGE_SIZE + 8);
+    uint8_t ctr[16], stream[16];
+    AES_KEY ref_key;
+    size_t offset = 0;
+
+    for (size_t i = 0; i < MESSAGE_SIZE; ++i)
+    {
+        plaintext[i] = (uint8_t)(i * 7 + 3);
+    }
+
+    /* compute the expected ciphertext one block at a time. */
+    ASSERT_EQ(0, AES_set_encrypt_key(KEY, 256, 4, &ref_key));
+    memset(ctr, 0, sizeof(ctr));
+    memcpy(ctr, &DUMMY_IV, sizeof(DUMMY_IV));
+    for (size_t i = 0; i < MESSAGE_SIZE; ++i)
+    {
+        if (i % 16 == 0)
+        {
+            AES_encrypt(ctr, stream, &ref_key);
+            vccrypt_aes_ctr_incr(ctr);
+        }
+
+        expected[i] = plaintext[i] ^ stream[i % 16];
+    }
+
+    ASSERT_EQ(0, vccrypt_buffer_init(&key, &alloc_opts, sizeof(KEY)));
+    ASSERT_EQ(0, vccrypt_buffer_read_data(&key, KEY, sizeof(KEY)));
+    ASSERT_EQ(0, vccrypt_stream_init(&x4_options, &ctx, &key));
+    ASSERT_EQ(0,
+        vccrypt_stream_start_encryption(
+            &ctx, &DUMMY_IV, sizeof(DUMMY_IV), output, &offset));
+
+    /* encrypt the message in uneven chunks. */
+    size_t pos = 0;
+    for (size_t i = 0; pos < MESSAGE_SIZE; ++i)
+    {
+        size_t chunk = CHUNKS[i % (sizeof(CHUNKS) / sizeof(CHUNKS[0]))];
+        if (chunk > MESSAGE_SIZE - pos)
+        {
+            chunk = MESSAGE_SIZE - pos;
+        }
+
+        ASSERT_EQ(0,
+            vccrypt_stream_encrypt(
+                &ctx, plaintext + pos, chunk, output, &offset));
+        pos += chunk;
+    }
+
+    EXPECT_EQ(MESSAGE_SIZE + 8, offset);
+    EXPECT_EQ(0, memcmp(expected, output + 8, MESSAGE_SIZE));
+
+    /* continuing at an arbitrary offset should pick up the same stream. */
+    ASSERT_EQ(0,
+        vccrypt_stream_continue_encryption(
+            &ctx, &DUMMY_IV, sizeof(DUMMY_IV), 1000));
+    offset = 0;
+    ASSERT_EQ(0,
+        vccrypt_stream_encrypt(
+            &ctx, plaintext + 1000, MESSAGE_SIZE - 1000, output, &offset));
+    EXPECT_EQ(0, memcmp(expected + 1000, output, MESSAGE_SIZE - 1000));
+
+    dispose((disposable_t*)&key);
+    dispose((disposable_t*)&ctx);
+    free(plaintext);
+    free(expected);
+    free(output);
+}
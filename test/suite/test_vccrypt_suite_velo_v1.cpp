@@ -194,6 +194,136 @@ TEST_F(vccrypt_suite_velo_v1, keygen_sign)
     dispose((disposable_t*)&signature);
 }
 
+/**
+ * Test that we can expand a private key using the suite, and sign / verify a
+ * message with it.
+ */
+TEST_F(vccrypt_suite_velo_v1, keygen_sign_expanded)
+{
+    const uint8_t message[] = "foo suite bar baz";
+    vccrypt_digital_signature_context_t context;
+
+    //create a buffer for the private key
+    vccrypt_buffer_t priv;
+    ASSERT_EQ(0,
+        vccrypt_suite_buffer_init_for_signature_private_key(&options, &priv));
+
+    //create a buffer for the expanded private key
+    vccrypt_buffer_t expanded;
+    ASSERT_EQ(0,
+        vccrypt_suite_buffer_init_for_signature_expanded_private_key(
+            &options, &expanded));
+    ASSERT_EQ(96U, expanded.size);
+
+    //create a buffer for the public key
+    vccrypt_buffer_t pub;
+    ASSERT_EQ(0,
+        vccrypt_suite_buffer_init_for_signature_public_key(&options, &pub));
+
+    //create a buffer for the signature
+    vccrypt_buffer_t signature;
+    ASSERT_EQ(0,
+        vccrypt_suite_buffer_init_for_signature(&options, &signature));
+
+    //create the digital signature context
+    ASSERT_EQ(0, vccrypt_suite_digital_signature_init(&options, &context));
+
+    //generate a keypair
+    ASSERT_EQ(0,
+        vccrypt_digital_signature_keypair_create(&context, &priv, &pub));
+
+    //expand the private key
+    ASSERT_EQ(0,
+        vccrypt_digital_signature_expand_private_key(
+            &context, &expanded, &priv));
+
+    //sign the message
+    ASSERT_EQ(0,
+        vccrypt_digital_signature_sign_expanded(
+            &context, &signature, &expanded,
+            message, sizeof(message)));
+
+    //verify the signature
+    ASSERT_EQ(0,
+        vccrypt_digital_signature_verify(
+            &context, &signature, &pub,
+            message, sizeof(message)));
+
+    //dispose the digital signature context
+    dispose((disposable_t*)&context);
+
+    //dispose all buffers
+    dispose((disposable_t*)&priv);
+    dispose((disposable_t*)&expanded);
+    dispose((disposable_t*)&pub);
+    dispose((disposable_t*)&signature);
+}
+
+/**
+ * Test that we can prepare a public key using the suite, and verify a message
+ * with it.
+ */
+TEST_F(vccrypt_suite_velo_v1, keygen_verify_prepared)
+{
+    const uint8_t message[] = "foo suite bar baz";
+    vccrypt_digital_signature_context_t context;
+
+    //create a buffer for the private key
+    vccrypt_buffer_t priv;
+    ASSERT_EQ(0,
+        vccrypt_suite_buffer_init_for_signature_private_key(&options, &priv));
+
+    //create a buffer for the public key
+    vccrypt_buffer_t pub;
+    ASSERT_EQ(0,
+        vccrypt_suite_buffer_init_for_signature_public_key(&options, &pub));
+
+    //create a buffer for the prepared public key
+    vccrypt_buffer_t prepared;
+    ASSERT_EQ(0,
+        vccrypt_suite_buffer_init_for_signature_prepared_public_key(
+            &options, &prepared));
+    ASSERT_EQ(1056U, prepared.size);
+
+    //create a buffer for the signature
+    vccrypt_buffer_t signature;
+    ASSERT_EQ(0,
+        vccrypt_suite_buffer_init_for_signature(&options, &signature));
+
+    //create the digital signature context
+    ASSERT_EQ(0, vccrypt_suite_digital_signature_init(&options, &context));
+
+    //generate a keypair
+    ASSERT_EQ(0,
+        vccrypt_digital_signature_keypair_create(&context, &priv, &pub));
+
+    //sign the message
+    ASSERT_EQ(0,
+        vccrypt_digital_signature_sign(
+            &context, &signature, &priv,
+            message, sizeof(message)));
+
+    //prepare the public key
+    ASSERT_EQ(0,
+        vccrypt_digital_signature_prepare_public_key(
+            &context, &prepared, &pub));
+
+    //verify the signature
+    ASSERT_EQ(0,
+        vccrypt_digital_signature_verify_prepared(
+            &context, &signature, &prepared,
+            message, sizeof(message)));
+
+    //dispose the digital signature context
+    dispose((disposable_t*)&context);
+
+    //dispose all buffers
+    dispose((disposable_t*)&priv);
+    dispose((disposable_t*)&pub);
+    dispose((disposable_t*)&prepared);
+    dispose((disposable_t*)&signature);
+}
+
 /**
  * Test that we can use HMAC-SHA-512-256 from the crypto suite.
  */
@@ -250,6 +380,71 @@ TEST_F(vccrypt_suite_velo_v1, hmac_sha_512_256)
     dispose((disposable_t*)&key);
 }
 
+/**
+ * Test that the short MAC fast path computes and verifies HMAC-SHA-512-256
+ * without an output buffer.
+ */
+TEST_F(vccrypt_suite_velo_v1, mac_short_compute_verify)
+{
+    const uint8_t KEY[] = {
+        0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08,
+        0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f, 0x10,
+        0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18,
+        0x19
+    };
+    const uint8_t DATA[] = {
+        0xcd, 0xcd, 0xcd, 0xcd, 0xcd, 0xcd, 0xcd, 0xcd,
+        0xcd, 0xcd, 0xcd, 0xcd, 0xcd, 0xcd, 0xcd, 0xcd,
+        0xcd, 0xcd, 0xcd, 0xcd, 0xcd, 0xcd, 0xcd, 0xcd,
+        0xcd, 0xcd, 0xcd, 0xcd, 0xcd, 0xcd, 0xcd, 0xcd,
+        0xcd, 0xcd, 0xcd, 0xcd, 0xcd, 0xcd, 0xcd, 0xcd,
+        0xcd, 0xcd, 0xcd, 0xcd, 0xcd, 0xcd, 0xcd, 0xcd,
+        0xcd, 0xcd
+    };
+    const uint8_t EXPECTED_HMAC[] = {
+        0x36, 0xd6, 0x0c, 0x8a, 0xa1, 0xd0, 0xbe, 0x85,
+        0x6e, 0x10, 0x80, 0x4c, 0xf8, 0x36, 0xe8, 0x21,
+        0xe8, 0x73, 0x3c, 0xba, 0xfe, 0xae, 0x87, 0x63,
+        0x05, 0x89, 0xfd, 0x0b, 0x9b, 0x0a, 0x2f, 0x4c
+    };
+
+    ASSERT_EQ(sizeof(EXPECTED_HMAC), options.mac_short_opts.mac_size);
+
+    //create a buffer sized for the key
+    vccrypt_buffer_t key;
+    ASSERT_EQ(0, vccrypt_buffer_init(&key, &alloc_opts, sizeof(KEY)));
+    memcpy(key.data, KEY, sizeof(KEY));
+
+    //initialize MAC
+    vccrypt_mac_context_t mac;
+    ASSERT_EQ(0, vccrypt_suite_mac_short_init(&options, &mac, &key));
+
+    //the MAC is written straight to caller memory
+    uint8_t out[sizeof(EXPECTED_HMAC)];
+    ASSERT_EQ(0,
+        vccrypt_suite_mac_short_compute(
+            &options, &mac, DATA, sizeof(DATA), out));
+    ASSERT_EQ(0, memcmp(out, EXPECTED_HMAC, sizeof(EXPECTED_HMAC)));
+
+    //the same instance verifies the next message
+    ASSERT_EQ(0,
+        vccrypt_suite_mac_short_verify(
+            &options, &mac, DATA, sizeof(DATA), EXPECTED_HMAC));
+
+    //a modified MAC is rejected, and the instance is still usable
+    out[sizeof(out) - 1] ^= 0x01;
+    ASSERT_EQ(VCCRYPT_ERROR_MAC_VERIFY_MISMATCH,
+        vccrypt_suite_mac_short_verify(
+            &options, &mac, DATA, sizeof(DATA), out));
+    ASSERT_EQ(0,
+        vccrypt_suite_mac_short_verify(
+            &options, &mac, DATA, sizeof(DATA), EXPECTED_HMAC));
+
+    //clean up
+    dispose((disposable_t*)&mac);
+    dispose((disposable_t*)&key);
+}
+
 /**
  * Test that we can use HMAC-SHA-512 from the crypto suite.
  */